@@ -242,6 +242,17 @@ exists($$PWD/src/test/*.h) {
     INCLUDEPATH *= $$PWD/src/test/
 }
 
+# benchmark build: 'qmake CONFIG+=benchmarks' swaps the program's main for the
+# benchmark driver in bench/ (see bench/Benchmark.h) and runs the Java back-end
+# headless, so benchmarks can run without a display
+CONFIG(benchmarks) {
+    SOURCES -= $$PWD/src/Main.cpp
+    SOURCES *= $$files($$PWD/bench/*.cpp)
+    HEADERS *= $$files($$PWD/bench/*.h)
+    INCLUDEPATH *= $$PWD/bench/
+    DEFINES += SPL_HEADLESS_MODE
+}
+
 # directories listed as "Other files" in left Project pane of Qt Creator
 OTHER_FILES *= res/*
 exists($$PWD/*.txt) {
@@ -358,6 +369,12 @@ unix:!macx {
     LIBS += -lpthread
 }
 
+# shm_open, used by the optional shared-memory back-end transport, lives in
+# librt on Linux systems with older C libraries
+unix:!macx {
+    LIBS += -lrt
+}
+
 # additional flags for clang compiler (default on Mac)
 COMPILERNAME = $$QMAKE_CXX
 COMPILERNAME ~= s|.*/|
@@ -412,6 +429,16 @@ DEFINES += SPL_THROW_ON_INVALID_ITERATOR
 # (we are going to disable these to force more interesting implementations)
 # DEFINES += SPL_BASICGRAPH_VERTEX_EDGE_RICH_MEMBERS
 
+# compile in latency histograms around the program's hot paths (event handling,
+# state changes, Java back-end pipe traffic)? see system/instrument.h
+# the results are printed at exit, or on SIGUSR1, to stderr or $SPL_INSTRUMENT_FILE
+# DEFINES += SPL_ENABLE_INSTRUMENTATION
+
+# record the same hot paths, plus every command sent to the Java back-end, as a
+# timeline in Chrome trace_event format? see system/instrument.h
+# the trace is written at exit to $SPL_TRACE_FILE (default trace.json)
+# DEFINES += SPL_ENABLE_TRACING
+
 # should we throw an error() when operator >> fails on a collection?
 # for years this was true, but the C++ standard says you should just silently
 # set the fail bit on the stream and exit, so that has been made the default.
@@ -435,6 +462,14 @@ CONFIG(debug, debug|release) {
 # make 'release' target be statically linked so it is a stand-alone executable
 CONFIG(release, debug|release) {
     QMAKE_CXXFLAGS += -O2
+
+    # 'qmake CONFIG+=release CONFIG+=unchecked' also drops the index checks on
+    # Vector/Grid element access and the invalid-iterator checks, for programs
+    # that are finished and need the speed; debug builds always keep them
+    # (see SPL_UNCHECKED_COLLECTIONS in collections/collections.h)
+    CONFIG(unchecked) {
+        DEFINES += SPL_UNCHECKED_COLLECTIONS
+    }
     macx {
         QMAKE_POST_LINK += 'macdeployqt $${OUT_PWD}/$${TARGET}.app'
         #QMAKE_POST_LINK += 'macdeployqt $${OUT_PWD}/$${TARGET}.app && rm $${OUT_PWD}/*.o && rm $${OUT_PWD}/Makefile'
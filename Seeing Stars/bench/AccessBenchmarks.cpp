@@ -0,0 +1,178 @@
+/* Benchmarks for tight numeric loops over Vector<int> and Grid<double>, comparing the
+ * checked ways of reaching the elements (operator [], get, iterators) with the unchecked
+ * ones (data, unsafeAt, rowView).
+ *
+ * The Vector workloads sum kLength ints and scale them in place. The Grid workloads sum a
+ * kSide by kSide grid and run one step of a five-point stencil (each cell becomes the
+ * average of itself and its four neighbours) into a second grid. Each row is one pass,
+ * and the line under it is the median time per element. How much the checked forms cost
+ * depends on the build: with SPL_UNCHECKED_COLLECTIONS (qmake CONFIG+=release
+ * CONFIG+=unchecked) they compile down to the unchecked ones, and the header says which
+ * build this is.
+ */
+#include "Benchmark.h"
+#include "error.h"
+#include "grid.h"
+#include "vector.h"
+#include <iomanip>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* How many elements the vector holds, how wide the grid is, and how many times to
+     * run each workload.
+     */
+    const int    kLength = 4000000;
+    const int    kSide   = 1500;
+    const size_t kRounds = 7;
+
+#ifdef SPL_UNCHECKED_COLLECTIONS
+    const string kBuild = "unchecked build";
+#else
+    const string kBuild = "checked build";
+#endif
+
+    /* Keeps the compiler from throwing a result away. */
+    volatile double sink;
+
+    /* Prints an extra line under a row. */
+    void printDetail(ostream& out, const string& label, double value) {
+        out << setw(36) << left << label << right << setw(12) << fixed
+            << setprecision(2) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds runs of a workload and prints a row and the time per element. */
+    void runWorkload(ostream& out, const string& label, long elements,
+                     const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printDetail(out, "  (ns/element)", summary.p50 * 1000 / elements);
+    }
+
+    /* Vector workloads. */
+    void runVector(ostream& out) {
+        Vector<int> vec(kLength);
+        for (int i = 0; i < kLength; i++) vec[i] = i % 1000;
+        const long expected = long(kLength / 1000) * (999 * 1000 / 2);
+
+        printHeader(out, "Vector<int> of " + to_string(kLength) + ", " + kBuild + " (per pass)");
+        runWorkload(out, "sum with operator []", kLength, [&] {
+            long sum = 0;
+            for (int i = 0; i < vec.size(); i++) sum += vec[i];
+            if (sum != expected) error("operator [] sum is wrong.");
+        });
+        runWorkload(out, "sum with iterators", kLength, [&] {
+            long sum = 0;
+            for (int value : vec) sum += value;
+            if (sum != expected) error("iterator sum is wrong.");
+        });
+        runWorkload(out, "sum with unsafeAt", kLength, [&] {
+            long sum = 0;
+            for (int i = 0; i < vec.size(); i++) sum += vec.unsafeAt(i);
+            if (sum != expected) error("unsafeAt sum is wrong.");
+        });
+        runWorkload(out, "sum with data", kLength, [&] {
+            long sum = 0;
+            const int* p = vec.data();
+            for (int i = 0, n = vec.size(); i < n; i++) sum += p[i];
+            if (sum != expected) error("data sum is wrong.");
+        });
+
+        runWorkload(out, "scale with operator []", kLength, [&] {
+            for (int i = 0; i < vec.size(); i++) vec[i] = (vec[i] >> 1) + 7;
+        });
+        runWorkload(out, "scale with data", kLength, [&] {
+            int* p = vec.data();
+            for (int i = 0, n = vec.size(); i < n; i++) p[i] = (p[i] >> 1) + 7;
+        });
+    }
+
+    /* Grid workloads. */
+    void runGrid(ostream& out) {
+        Grid<double> grid(kSide, kSide);
+        for (int r = 0; r < kSide; r++) {
+            for (int c = 0; c < kSide; c++) grid[r][c] = (r * 7 + c * 3) % 11;
+        }
+        Grid<double> next(kSide, kSide);
+        const long cells = long(kSide) * kSide;
+        const long inner = long(kSide - 2) * (kSide - 2);
+
+        printHeader(out, "Grid<double> of " + to_string(kSide) + "x" + to_string(kSide) + ", "
+                    + kBuild + " (per pass)");
+        runWorkload(out, "sum with [][]", cells, [&] {
+            double sum = 0;
+            for (int r = 0; r < grid.numRows(); r++) {
+                for (int c = 0; c < grid.numCols(); c++) sum += grid[r][c];
+            }
+            sink = sum;
+        });
+        runWorkload(out, "sum with get", cells, [&] {
+            double sum = 0;
+            for (int r = 0; r < grid.numRows(); r++) {
+                for (int c = 0; c < grid.numCols(); c++) sum += grid.get(r, c);
+            }
+            sink = sum;
+        });
+        runWorkload(out, "sum with rowView", cells, [&] {
+            double sum = 0;
+            for (int r = 0; r < grid.numRows(); r++) {
+                for (double value : grid.rowView(r)) sum += value;
+            }
+            sink = sum;
+        });
+        runWorkload(out, "sum with data", cells, [&] {
+            double sum = 0;
+            const double* p = grid.data();
+            for (long i = 0; i < cells; i++) sum += p[i];
+            sink = sum;
+        });
+
+        runWorkload(out, "stencil with [][]", inner, [&] {
+            for (int r = 1; r < kSide - 1; r++) {
+                for (int c = 1; c < kSide - 1; c++) {
+                    next[r][c] = (grid[r][c] + grid[r - 1][c] + grid[r + 1][c]
+                                  + grid[r][c - 1] + grid[r][c + 1]) * 0.2;
+                }
+            }
+            sink = next[kSide / 2][kSide / 2];
+        });
+        runWorkload(out, "stencil with unsafeAt", inner, [&] {
+            for (int r = 1; r < kSide - 1; r++) {
+                for (int c = 1; c < kSide - 1; c++) {
+                    next.unsafeAt(r, c) = (grid.unsafeAt(r, c) + grid.unsafeAt(r - 1, c)
+                                           + grid.unsafeAt(r + 1, c) + grid.unsafeAt(r, c - 1)
+                                           + grid.unsafeAt(r, c + 1)) * 0.2;
+                }
+            }
+            sink = next[kSide / 2][kSide / 2];
+        });
+        runWorkload(out, "stencil with rowView", inner, [&] {
+            const Grid<double>& source = grid;
+            for (int r = 1; r < kSide - 1; r++) {
+                Grid<double>::ConstRowView above = source.rowView(r - 1);
+                Grid<double>::ConstRowView here = source.rowView(r);
+                Grid<double>::ConstRowView below = source.rowView(r + 1);
+                Grid<double>::RowView target = next.rowView(r);
+                for (int c = 1; c < kSide - 1; c++) {
+                    target[c] = (here[c] + above[c] + below[c] + here[c - 1] + here[c + 1]) * 0.2;
+                }
+            }
+            sink = next[kSide / 2][kSide / 2];
+        });
+    }
+}
+
+BENCHMARK(uncheckedAccess) {
+    runVector(out);
+    runGrid(out);
+}
@@ -0,0 +1,206 @@
+/* Benchmarks for BTreeMap (see btreemap.h) against the AVL-tree Map, with std::map for
+ * reference, on maps too large to fit in cache.
+ *
+ * Each map gets kKeys random int keys. The workloads build the map, look up every key, walk
+ * the whole map in order, answer kRanges queries for the entries in a range of about
+ * kRangeKeys keys, and remove every key. Keys are looked up and removed in a different
+ * order from the one they went in, so that no map gains from having been allocated in the
+ * same order it is searched. Map has no range queries, so it sits that one out.
+ * Each row is one pass, and the line under it is the median time per key. Where the C
+ * library can say how much of the heap is in use, the bytes per entry of each map are
+ * printed too.
+ */
+#include "Benchmark.h"
+#include "btreemap.h"
+#include "error.h"
+#include "map.h"
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+using namespace std;
+
+namespace {
+    /* How many keys go in each map, and how many times to run each workload. */
+    const size_t kKeys   = 1000000;
+    const size_t kRounds = 5;
+
+    /* How many range queries to answer, and about how many keys each range holds. */
+    const size_t kRanges    = 20000;
+    const size_t kRangeKeys = 100;
+
+    /* kKeys distinct keys in a scrambled order, spread over the non-negative ints. */
+    vector<int> randomKeys() {
+        vector<int> result;
+        for (size_t i = 0; i < kKeys; i++) {
+            result.push_back(int((uint32_t(i) * 2654435761u) >> 1));
+        }
+        return result;
+    }
+
+    /* The same keys in another scrambled order: kProbeStride and kKeys have no common factor. */
+    const size_t kProbeStride = 7919;
+    vector<int> probeOrder(const vector<int>& keys) {
+        vector<int> result;
+        for (size_t i = 0; i < kKeys; i++) {
+            result.push_back(keys[i * kProbeStride % kKeys]);
+        }
+        return result;
+    }
+
+    /* Bytes of heap in use, or -1 if the C library can't say. */
+    long heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+        struct mallinfo2 info = mallinfo2();
+        return long(info.uordblks + info.hblkhd);
+#else
+        return -1;
+#endif
+    }
+
+    /* The same operations on each kind of map. */
+    void putKey(Map<int, int>& map, int key, int value)      { map.put(key, value); }
+    void putKey(BTreeMap<int, int>& map, int key, int value) { map.put(key, value); }
+    void putKey(std::map<int, int>& map, int key, int value) { map[key] = value; }
+
+    int getKey(const Map<int, int>& map, int key)      { return map.get(key); }
+    int getKey(const BTreeMap<int, int>& map, int key) { return map.get(key); }
+    int getKey(const std::map<int, int>& map, int key) {
+        auto it = map.find(key);
+        return it == map.end() ? 0 : it->second;
+    }
+
+    void removeKey(Map<int, int>& map, int key)      { map.remove(key); }
+    void removeKey(BTreeMap<int, int>& map, int key) { map.remove(key); }
+    void removeKey(std::map<int, int>& map, int key) { map.erase(key); }
+
+    template <typename MapType> long sumValues(const MapType& map) {
+        long sum = 0;
+        map.mapAll([&](int, int value) { sum += value; });
+        return sum;
+    }
+    long sumValues(const std::map<int, int>& map) {
+        long sum = 0;
+        for (const auto& entry: map) sum += entry.second;
+        return sum;
+    }
+
+    long sumRange(const BTreeMap<int, int>& map, int low, int high) {
+        long sum = 0;
+        map.mapRange(low, high, [&](int, int value) { sum += value; });
+        return sum;
+    }
+    long sumRange(const std::map<int, int>& map, int low, int high) {
+        long sum = 0;
+        for (auto it = map.lower_bound(low); it != map.end() && it->first < high; ++it) {
+            sum += it->second;
+        }
+        return sum;
+    }
+
+    /* Prints an extra line under a row. */
+    void printDetail(ostream& out, const string& label, double value) {
+        out << setw(36) << left << label << right << setw(12) << fixed
+            << setprecision(1) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds runs of a workload, each after running setup untimed, and prints a row
+     * and the time per key.
+     */
+    void runWorkload(ostream& out, const string& label, size_t keys,
+                     const function<void ()>& setup, const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            setup();
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printDetail(out, "  (ns/key)", summary.p50 * 1000 / keys);
+    }
+
+    template <typename MapType>
+    void fill(MapType& map, const vector<int>& keys) {
+        for (size_t i = 0; i < kKeys; i++) putKey(map, keys[i], int(i));
+    }
+
+    template <typename MapType>
+    void runCommon(ostream& out, const string& name, const vector<int>& keys) {
+        vector<int> probes = probeOrder(keys);
+        MapType map;
+        auto clear = [&] { map = MapType(); };
+        auto refill = [&] { if (int(map.size()) != int(kKeys)) { map = MapType(); fill(map, keys); } };
+
+        runWorkload(out, name + " insert", kKeys, clear, [&] { fill(map, keys); });
+
+        runWorkload(out, name + " lookup", kKeys, refill, [&] {
+            long sum = 0;
+            for (size_t i = 0; i < kKeys; i++) sum += getKey(map, probes[i]);
+            if (sum != long(kKeys) * long(kKeys - 1) / 2) error(name + " lost keys.");
+        });
+
+        runWorkload(out, name + " iterate", kKeys, refill, [&] {
+            if (sumValues(map) != long(kKeys) * long(kKeys - 1) / 2) {
+                error(name + " gave the wrong sum.");
+            }
+        });
+
+        long before = heapInUse();
+        MapType measured;
+        fill(measured, keys);
+        long after = heapInUse();
+        if (before >= 0) printDetail(out, "  (bytes/entry)", double(after - before) / kKeys);
+    }
+
+    template <typename MapType>
+    void runRanges(ostream& out, const string& name, const vector<int>& keys) {
+        MapType map;
+        fill(map, keys);
+        /* The keys are spread evenly, so a range this wide holds about kRangeKeys of them. */
+        int width = int(kRangeKeys * (uint32_t(INT32_MAX) / kKeys));
+        runWorkload(out, name + " range", kRanges * kRangeKeys, [] {}, [&] {
+            long sum = 0;
+            for (size_t i = 0; i < kRanges; i++) {
+                int low = keys[i] % (INT32_MAX - width);
+                sum += sumRange(map, low, low + width);
+            }
+            if (sum <= 0) error(name + " found nothing in range.");
+        });
+    }
+
+    template <typename MapType>
+    void runRemove(ostream& out, const string& name, const vector<int>& keys) {
+        vector<int> probes = probeOrder(keys);
+        MapType map;
+        runWorkload(out, name + " remove", kKeys, [&] { fill(map, keys); }, [&] {
+            for (size_t i = 0; i < kKeys; i++) removeKey(map, probes[i]);
+            if (map.size() != 0) error(name + " kept keys.");
+        });
+    }
+}
+
+BENCHMARK(btreeMap) {
+    printHeader(out, to_string(kKeys) + " int keys (per pass)");
+    vector<int> keys = randomKeys();
+    runCommon<Map<int, int>>(out, "Map", keys);
+    runCommon<BTreeMap<int, int>>(out, "BTreeMap", keys);
+    runCommon<std::map<int, int>>(out, "std::map", keys);
+
+    printHeader(out, to_string(kRanges) + " ranges of ~" + to_string(kRangeKeys) + " keys (per pass)");
+    runRanges<BTreeMap<int, int>>(out, "BTreeMap", keys);
+    runRanges<std::map<int, int>>(out, "std::map", keys);
+
+    printHeader(out, "remove " + to_string(kKeys) + " int keys (per pass)");
+    runRemove<Map<int, int>>(out, "Map", keys);
+    runRemove<BTreeMap<int, int>>(out, "BTreeMap", keys);
+    runRemove<std::map<int, int>>(out, "std::map", keys);
+}
@@ -0,0 +1,18 @@
+#include "Benchmark.h"
+#include "console.h"
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+namespace {
+    /* Environment variable restricting which benchmarks run. If set, only benchmarks whose
+     * names contain its value are run.
+     */
+    const char* const kFilterVariable = "STARS_BENCHMARK";
+}
+
+int main() {
+    const char* filter = getenv(kFilterVariable);
+    runBenchmarks(cout, filter? filter : "");
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+using namespace std;
+
+namespace {
+    /* All registered benchmarks, by name. This lives in a function so that it exists before
+     * any of the static BenchmarkRegistrars that fill it are constructed.
+     */
+    map<string, BenchmarkFunction>& allBenchmarks() {
+        static map<string, BenchmarkFunction> benchmarks;
+        return benchmarks;
+    }
+
+    /* Column widths for the result tables. */
+    const int kLabelWidth  = 36;
+    const int kNumberWidth = 12;
+
+    /* Returns the given percentile of a sorted, nonempty list of values. */
+    double percentileOf(const vector<double>& sorted, double percent) {
+        size_t index = size_t(percent / 100.0 * (sorted.size() - 1) + 0.5);
+        return sorted[min(index, sorted.size() - 1)];
+    }
+}
+
+BenchmarkRegistrar::BenchmarkRegistrar(const string& name, BenchmarkFunction benchmark) {
+    allBenchmarks()[name] = benchmark;
+}
+
+void runBenchmarks(ostream& out, const string& filter) {
+    for (const auto& entry: allBenchmarks()) {
+        if (entry.first.find(filter) == string::npos) continue;
+
+        out << "=== " << entry.first << " ===" << endl;
+        entry.second(out);
+        out << endl;
+    }
+}
+
+Stopwatch::Stopwatch() {
+    restart();
+}
+
+void Stopwatch::restart() {
+    start = chrono::steady_clock::now();
+}
+
+double Stopwatch::elapsedMicroseconds() const {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+double Stopwatch::elapsedSeconds() const {
+    return elapsedMicroseconds() / 1e6;
+}
+
+Summary summarize(vector<double> latencies, double elapsedSeconds) {
+    Summary result = { latencies.size(), 0, 0, 0, 0 };
+    if (latencies.empty()) return result;
+
+    sort(latencies.begin(), latencies.end());
+    result.perSecond = elapsedSeconds > 0? latencies.size() / elapsedSeconds : 0;
+    result.p50 = percentileOf(latencies, 50);
+    result.p99 = percentileOf(latencies, 99);
+    result.max = latencies.back();
+    return result;
+}
+
+void printHeader(ostream& out, const string& title) {
+    out << left  << setw(kLabelWidth)  << title
+        << right << setw(kNumberWidth) << "count"
+                 << setw(kNumberWidth) << "ops/sec"
+                 << setw(kNumberWidth) << "p50 (us)"
+                 << setw(kNumberWidth) << "p99 (us)"
+                 << setw(kNumberWidth) << "max (us)" << endl;
+}
+
+void printRow(ostream& out, const string& label, const Summary& summary) {
+    out << fixed << setprecision(1)
+        << left  << setw(kLabelWidth)  << label
+        << right << setw(kNumberWidth) << summary.count
+                 << setw(kNumberWidth) << summary.perSecond
+                 << setw(kNumberWidth) << summary.p50
+                 << setw(kNumberWidth) << summary.p99
+                 << setw(kNumberWidth) << summary.max << endl;
+}
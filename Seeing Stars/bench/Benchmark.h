@@ -0,0 +1,92 @@
+#ifndef Benchmark_Included
+#define Benchmark_Included
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* A small framework for the benchmark build. Building the project with CONFIG+=benchmarks
+ * (see the .pro file) replaces the program's main function with one that runs every
+ * benchmark registered with the BENCHMARK macro, or just the ones whose names contain the
+ * value of the STARS_BENCHMARK environment variable, and prints their results as tables.
+ *
+ * A benchmark is just a function that does some work, times it, and prints what it found.
+ * The helpers here take care of the timing and formatting so that every benchmark reports
+ * in the same units.
+ */
+
+/* Type: BenchmarkFunction
+ *
+ * A benchmark. It should print its results to the given stream.
+ */
+using BenchmarkFunction = std::function<void (std::ostream &)>;
+
+/* Type: BenchmarkRegistrar
+ *
+ * Adds a benchmark to the list of benchmarks to run when constructed. Use the BENCHMARK
+ * macro rather than making these directly.
+ */
+class BenchmarkRegistrar {
+public:
+    BenchmarkRegistrar(const std::string& name, BenchmarkFunction benchmark);
+};
+
+/* Macro: BENCHMARK
+ *
+ * Defines and registers a benchmark:
+ *
+ *     BENCHMARK(pipeRoundTrips) {
+ *         ... time things, print to out ...
+ *     }
+ */
+#define BENCHMARK(name)                                                \
+    static void name(std::ostream& out);                               \
+    static BenchmarkRegistrar name##Registrar(#name, name);            \
+    static void name(std::ostream& out)
+
+/* Runs every registered benchmark whose name contains the given filter, in order of name. */
+void runBenchmarks(std::ostream& out, const std::string& filter);
+
+/* Type: Stopwatch
+ *
+ * Measures elapsed time from when it was made (or last restarted).
+ */
+class Stopwatch {
+public:
+    Stopwatch();
+
+    void restart();
+    double elapsedMicroseconds() const;
+    double elapsedSeconds() const;
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+/* Type: Summary
+ *
+ * Statistics about a set of timed operations. Latencies are in microseconds.
+ */
+struct Summary {
+    std::size_t count;
+    double perSecond;   // Operations per second of wall-clock time
+    double p50;
+    double p99;
+    double max;
+};
+
+/* Summarizes a set of per-operation latencies, in microseconds, that took the given total
+ * wall-clock time to collect.
+ */
+Summary summarize(std::vector<double> latencies, double elapsedSeconds);
+
+/* Prints a table heading, and then one row of statistics. The label column is wide enough
+ * for a short description of what was measured.
+ */
+void printHeader(std::ostream& out, const std::string& title);
+void printRow(std::ostream& out, const std::string& label, const Summary& summary);
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef ChainedHashMap_Included
+#define ChainedHashMap_Included
+
+#include "hashcode.h"
+#include "vector.h"
+
+/* Type: ChainedHashMap
+ *
+ * The bucket-chained hash table HashMap used to be, kept here so the hash map benchmarks
+ * can measure the flat table against it. It has just enough of the old interface for the
+ * benchmarks: the tables, hash function, load factor and growth policy are exactly as they
+ * were, but there is no iterator, copying or version checking.
+ */
+template <typename KeyType, typename ValueType>
+class ChainedHashMap {
+public:
+    ChainedHashMap() {
+        createBuckets(kInitialBucketCount);
+    }
+
+    ~ChainedHashMap() {
+        deleteBuckets(buckets);
+    }
+
+    ChainedHashMap(const ChainedHashMap&) = delete;
+    ChainedHashMap& operator =(const ChainedHashMap&) = delete;
+
+    bool containsKey(const KeyType& key) const {
+        return findCell(hashCode(key) % nBuckets, key) != nullptr;
+    }
+
+    ValueType get(const KeyType& key) const {
+        Cell* cp = findCell(hashCode(key) % nBuckets, key);
+        return cp? cp->value : ValueType();
+    }
+
+    void put(const KeyType& key, const ValueType& value) {
+        (*this)[key] = value;
+    }
+
+    void remove(const KeyType& key) {
+        int bucket = hashCode(key) % nBuckets;
+        Cell* parent;
+        Cell* cp = findCell(bucket, key, parent);
+        if (cp) {
+            if (!parent) {
+                buckets[bucket] = cp->next;
+            } else {
+                parent->next = cp->next;
+            }
+            delete cp;
+            numEntries--;
+        }
+    }
+
+    int size() const {
+        return numEntries;
+    }
+
+    ValueType& operator [](const KeyType& key) {
+        int bucket = hashCode(key) % nBuckets;
+        Cell* cp = findCell(bucket, key);
+        if (!cp) {
+            if (numEntries > kMaxLoadPercentage * nBuckets / 100.0) {
+                expandAndRehash();
+                bucket = hashCode(key) % nBuckets;
+            }
+            cp = new Cell;
+            cp->key = key;
+            cp->value = ValueType();
+            cp->next = buckets[bucket];
+            buckets[bucket] = cp;
+            numEntries++;
+        }
+        return cp->value;
+    }
+
+    /* Calls fn(key, value) for every entry, in the order iterating over the old HashMap
+     * visited them.
+     */
+    template <typename FunctorType>
+    void mapAll(FunctorType fn) const {
+        for (int i = 0; i < buckets.size(); i++) {
+            for (Cell* cp = buckets.get(i); cp != nullptr; cp = cp->next) {
+                fn(cp->key, cp->value);
+            }
+        }
+    }
+
+private:
+    static const int kInitialBucketCount = 101;
+    static const int kMaxLoadPercentage = 70;
+
+    struct Cell {
+        KeyType key;
+        ValueType value;
+        Cell* next;
+    };
+
+    Vector<Cell*> buckets;
+    int nBuckets;
+    int numEntries;
+
+    void createBuckets(int count) {
+        buckets = Vector<Cell*>(count, nullptr);
+        nBuckets = count;
+        numEntries = 0;
+    }
+
+    void deleteBuckets(Vector<Cell*>& toDelete) {
+        for (int i = 0; i < toDelete.size(); i++) {
+            Cell* cp = toDelete[i];
+            while (cp) {
+                Cell* np = cp->next;
+                delete cp;
+                cp = np;
+            }
+            toDelete[i] = nullptr;
+        }
+    }
+
+    void expandAndRehash() {
+        Vector<Cell*> oldBuckets = buckets;
+        createBuckets(oldBuckets.size() * 2 + 1);
+        for (int i = 0; i < oldBuckets.size(); i++) {
+            for (Cell* cp = oldBuckets[i]; cp != nullptr; cp = cp->next) {
+                put(cp->key, cp->value);
+            }
+        }
+        deleteBuckets(oldBuckets);
+    }
+
+    Cell* findCell(int bucket, const KeyType& key) const {
+        Cell* dummy;
+        return findCell(bucket, key, dummy);
+    }
+
+    Cell* findCell(int bucket, const KeyType& key, Cell*& parent) const {
+        parent = nullptr;
+        Cell* cp = buckets.get(bucket);
+        while (cp && !(key == cp->key)) {
+            parent = cp;
+            cp = cp->next;
+        }
+        return cp;
+    }
+};
+
+#endif
@@ -0,0 +1,68 @@
+/* Benchmarks for the star gallery (see StarGalleryReactor.h), which draws every star up to
+ * some size into one Raster and shows it as a single image. Drawing and uploading are timed
+ * separately, for galleries of increasing size, in an area the size of the program's canvas.
+ */
+#include "Benchmark.h"
+#include "StarGalleryReactor.h"
+#include "Raster.h"
+#include "private/platform.h"
+#include "gbufferedimage.h"
+#include "gobjects.h"
+#include <iomanip>
+#include <sstream>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* Same size as the gallery gets in the program (the canvas, less the caption). */
+    const int kWidth  = 500;
+    const int kHeight = 776;
+
+    /* How many times to draw and upload each gallery. */
+    const size_t kRounds = 10;
+
+    size_t linesIn(const GalleryLayout& layout) {
+        size_t result = 0;
+        for (const StarType& type: layout.stars) {
+            result += type.numPoints;
+        }
+        return result;
+    }
+}
+
+BENCHMARK(galleryRender) {
+    printHeader(out, "render and upload gallery");
+
+    for (size_t maxPoints: { 40, 100, 200, 300 }) {
+        GalleryLayout layout = galleryLayoutFor(maxPoints, kWidth, kHeight);
+        Raster raster(kWidth, kHeight);
+        GBufferedImage image(kWidth, kHeight, 0xFFFFFF);
+        GRect sync(0, 0, 1, 1);
+
+        vector<double> renders, uploads;
+        Stopwatch renderTotal;
+        double uploadSeconds = 0;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            raster.fill(Raster::kOpaque | 0xFFFFFF);
+            renderGallery(layout, raster);
+            renders.push_back(timer.elapsedMicroseconds());
+
+            /* Start from a blank image each time, so every round uploads the whole gallery. */
+            image.fill(0xFFFFFF);
+            Stopwatch upload;
+            image.setPixels(raster.data(), kWidth, kHeight, kWidth);
+            stanfordcpplib::getPlatform()->gobject_getBounds(&sync);
+            uploads.push_back(upload.elapsedMicroseconds());
+            uploadSeconds += upload.elapsedSeconds();
+        }
+        double renderSeconds = renderTotal.elapsedSeconds() - uploadSeconds;
+
+        ostringstream label;
+        label << "n <= " << maxPoints << ": " << layout.stars.size() << " stars, "
+              << linesIn(layout) << " lines";
+        out << label.str() << endl;
+        printRow(out, "  draw into Raster", summarize(renders, renderSeconds));
+        printRow(out, "  setPixels + round trip", summarize(uploads, uploadSeconds));
+    }
+}
@@ -0,0 +1,171 @@
+/* Benchmarks for searching a large BasicGraph directly, the way a client would write the
+ * search with the library's collections, against searching a snapshot of it made with
+ * freeze (see FrozenGraphGen in basicgraph.h).
+ *
+ * The graph has kVertices vertices, each with an edge to the next one around a ring, so
+ * that every vertex can be reached, and kExtraEdges more edges to random vertices, with
+ * random weights. Each workload searches the whole graph from one vertex: breadth first,
+ * depth first, and with Dijkstra's algorithm. Freezing the graph is timed too, since a
+ * snapshot only pays for itself once it has been searched enough. Each row is one pass,
+ * and the line under it is the median time per edge.
+ */
+#include "Benchmark.h"
+#include "basicgraph.h"
+#include "error.h"
+#include "hashmap.h"
+#include "hashset.h"
+#include "priorityqueue.h"
+#include "queue.h"
+#include "stack.h"
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* The graph's size, and how many times to run each workload. */
+    const int    kVertices   = 100000;
+    const int    kExtraEdges = 7;
+    const size_t kRounds     = 5;
+
+    /* A cheap, repeatable stream of pseudorandom numbers. */
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    void buildGraph(BasicGraph& graph) {
+        vector<Vertex*> vertices;
+        for (int i = 0; i < kVertices; i++) {
+            vertices.push_back(graph.addVertex("v" + to_string(i)));
+        }
+        uint32_t state = 2463534242u;
+        for (int i = 0; i < kVertices; i++) {
+            graph.addEdge(vertices[i], vertices[(i + 1) % kVertices], 1 + nextRandom(state) % 100);
+            for (int j = 0; j < kExtraEdges; j++) {
+                Vertex* to = vertices[nextRandom(state) % kVertices];
+                graph.addEdge(vertices[i], to, 1 + nextRandom(state) % 100);
+            }
+        }
+    }
+
+    /* Searches of the graph itself, as a client of BasicGraph would write them. */
+    int graphBfs(const BasicGraph& graph, Vertex* start) {
+        HashSet<Vertex*> reached;
+        Queue<Vertex*> queue;
+        reached.add(start);
+        queue.enqueue(start);
+        int visited = 0;
+        while (!queue.isEmpty()) {
+            Vertex* v = queue.dequeue();
+            visited++;
+            for (Edge* edge : graph.getEdgeSet(v)) {
+                if (!reached.contains(edge->finish)) {
+                    reached.add(edge->finish);
+                    queue.enqueue(edge->finish);
+                }
+            }
+        }
+        return visited;
+    }
+
+    int graphDfs(const BasicGraph& graph, Vertex* start) {
+        HashSet<Vertex*> visited;
+        Stack<Vertex*> stack;
+        stack.push(start);
+        while (!stack.isEmpty()) {
+            Vertex* v = stack.pop();
+            if (!visited.contains(v)) {
+                visited.add(v);
+                for (Edge* edge : graph.getEdgeSet(v)) {
+                    if (!visited.contains(edge->finish)) {
+                        stack.push(edge->finish);
+                    }
+                }
+            }
+        }
+        return visited.size();
+    }
+
+    int graphDijkstra(const BasicGraph& graph, Vertex* start) {
+        HashMap<Vertex*, double> distance;
+        HashSet<Vertex*> done;
+        PriorityQueue<Vertex*> queue;
+        distance[start] = 0;
+        queue.enqueue(start, 0);
+        while (!queue.isEmpty()) {
+            Vertex* v = queue.dequeue();
+            if (done.contains(v)) continue;
+            done.add(v);
+            double base = distance[v];
+            for (Edge* edge : graph.getEdgeSet(v)) {
+                double through = base + edge->cost;
+                if (!distance.containsKey(edge->finish) || through < distance[edge->finish]) {
+                    distance[edge->finish] = through;
+                    queue.enqueue(edge->finish, through);
+                }
+            }
+        }
+        return done.size();
+    }
+
+    /* The same searches of a snapshot. */
+    template <typename TraversalType> int countAll(TraversalType traversal) {
+        int visited = 0;
+        for (Vertex* v : traversal) {
+            if (v) visited++;
+        }
+        return visited;
+    }
+
+    /* Prints an extra line under a row. */
+    void printDetail(ostream& out, const string& label, double value) {
+        out << setw(36) << left << label << right << setw(12) << fixed
+            << setprecision(1) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds runs of a workload and prints a row and the time per edge. */
+    void runWorkload(ostream& out, const string& label, int edges, const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printDetail(out, "  (ns/edge)", summary.p50 * 1000 / edges);
+    }
+
+    void checkVisited(const string& label, int visited) {
+        if (visited != kVertices) error(label + " missed some vertices.");
+    }
+}
+
+BENCHMARK(frozenGraph) {
+    BasicGraph graph;
+    buildGraph(graph);
+    int edges = graph.edgeCount();
+    Vertex* start = graph.getVertex("v0");
+    printHeader(out, to_string(kVertices) + " vertices, " + to_string(edges) + " edges (per pass)");
+
+    runWorkload(out, "BasicGraph bfs", edges, [&] { checkVisited("bfs", graphBfs(graph, start)); });
+    runWorkload(out, "BasicGraph dfs", edges, [&] { checkVisited("dfs", graphDfs(graph, start)); });
+    runWorkload(out, "BasicGraph dijkstra", edges, [&] {
+        checkVisited("dijkstra", graphDijkstra(graph, start));
+    });
+
+    FrozenGraph frozen;
+    runWorkload(out, "freeze", edges, [&] { frozen = graph.freeze(); });
+    runWorkload(out, "FrozenGraph bfs", edges, [&] { checkVisited("bfs", countAll(frozen.bfs(start))); });
+    runWorkload(out, "FrozenGraph dfs", edges, [&] { checkVisited("dfs", countAll(frozen.dfs(start))); });
+    runWorkload(out, "FrozenGraph dijkstra", edges, [&] {
+        checkVisited("dijkstra", countAll(frozen.dijkstra(start)));
+    });
+}
@@ -0,0 +1,164 @@
+/* Benchmarks for HashMap against the bucket-chained table it used to be (ChainedHashMap.h)
+ * and against std::unordered_map, with int keys and with string keys. Each round builds a
+ * map of kKeys entries from scratch and times, in turn, inserting them all, looking them
+ * all up, looking up as many keys that aren't there, visiting every entry, and removing
+ * them all. A row is one of those phases, and the line under it is the median time it
+ * took per key.
+ */
+#include "Benchmark.h"
+#include "ChainedHashMap.h"
+#include "error.h"
+#include "hashmap.h"
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* How many keys go in each map, and how many times to build it. */
+    const size_t kKeys   = 100000;
+    const size_t kRounds = 10;
+
+    /* The phases of a round, in the order they're run. */
+    const vector<string> kPhases = { "insert", "lookup (hit)", "lookup (miss)", "iterate", "remove" };
+
+    /* Distinct keys, shuffled so that nothing is inserted in order. Half of them go in the
+     * map and the other half are the misses.
+     */
+    vector<int> intKeys() {
+        vector<int> result;
+        uint32_t state = 12345;
+        for (size_t i = 0; i < 2 * kKeys; i++) {
+            /* Multiplying by an odd constant permutes the 32-bit integers, so these are distinct. */
+            result.push_back(int((uint32_t(i) * 2654435761u) & 0x7FFFFFFF));
+            state = state * 1664525u + 1013904223u;
+            swap(result[i], result[state % (i + 1)]);
+        }
+        return result;
+    }
+
+    vector<string> stringKeys() {
+        vector<string> result;
+        for (int key: intKeys()) {
+            result.push_back("star-" + to_string(key));
+        }
+        return result;
+    }
+
+    /* The same operations on each kind of map. */
+    template <typename Key> void insertKey(HashMap<Key, int>& map, const Key& key, int value) {
+        map.put(key, value);
+    }
+    template <typename Key> void insertKey(ChainedHashMap<Key, int>& map, const Key& key, int value) {
+        map.put(key, value);
+    }
+    template <typename Key> void insertKey(unordered_map<Key, int>& map, const Key& key, int value) {
+        map[key] = value;
+    }
+
+    template <typename Key> bool hasKey(const HashMap<Key, int>& map, const Key& key) {
+        return map.containsKey(key);
+    }
+    template <typename Key> bool hasKey(const ChainedHashMap<Key, int>& map, const Key& key) {
+        return map.containsKey(key);
+    }
+    template <typename Key> bool hasKey(const unordered_map<Key, int>& map, const Key& key) {
+        return map.count(key) != 0;
+    }
+
+    template <typename Key> void removeKey(HashMap<Key, int>& map, const Key& key) {
+        map.remove(key);
+    }
+    template <typename Key> void removeKey(ChainedHashMap<Key, int>& map, const Key& key) {
+        map.remove(key);
+    }
+    template <typename Key> void removeKey(unordered_map<Key, int>& map, const Key& key) {
+        map.erase(key);
+    }
+
+    template <typename Key> long sumValues(const HashMap<Key, int>& map) {
+        long sum = 0;
+        map.mapAll([&](const Key&, int value) { sum += value; });
+        return sum;
+    }
+    template <typename Key> long sumValues(const ChainedHashMap<Key, int>& map) {
+        long sum = 0;
+        map.mapAll([&](const Key&, int value) { sum += value; });
+        return sum;
+    }
+    template <typename Key> long sumValues(const unordered_map<Key, int>& map) {
+        long sum = 0;
+        for (const auto& entry: map) sum += entry.second;
+        return sum;
+    }
+
+    /* Runs kRounds rounds with one kind of map and prints a row for each phase. The results
+     * of the lookups are checked, so a broken map can't win.
+     */
+    template <typename Map, typename Key>
+    void runRounds(ostream& out, const string& name, const vector<Key>& keys) {
+        vector<vector<double>> latencies(kPhases.size());
+        vector<double> elapsed(kPhases.size());
+        long expectedSum = long(kKeys) * long(kKeys - 1) / 2;
+
+        for (size_t round = 0; round < kRounds; round++) {
+            Map map;
+            size_t found = 0;
+            long sum = 0;
+
+            for (size_t phase = 0; phase < kPhases.size(); phase++) {
+                Stopwatch timer;
+                switch (phase) {
+                case 0:
+                    for (size_t i = 0; i < kKeys; i++) insertKey(map, keys[i], int(i));
+                    break;
+                case 1:
+                    for (size_t i = 0; i < kKeys; i++) found += hasKey(map, keys[i]);
+                    break;
+                case 2:
+                    for (size_t i = kKeys; i < 2 * kKeys; i++) found += hasKey(map, keys[i]);
+                    break;
+                case 3:
+                    sum = sumValues(map);
+                    break;
+                case 4:
+                    for (size_t i = 0; i < kKeys; i++) removeKey(map, keys[i]);
+                    break;
+                }
+                latencies[phase].push_back(timer.elapsedMicroseconds());
+                elapsed[phase] += timer.elapsedSeconds();
+            }
+
+            if (found != kKeys || sum != expectedSum || map.size() != 0) {
+                error(name + " gave the wrong answer.");
+            }
+        }
+
+        for (size_t phase = 0; phase < kPhases.size(); phase++) {
+            Summary summary = summarize(latencies[phase], elapsed[phase]);
+            printRow(out, name + " " + kPhases[phase], summary);
+            out << setw(36) << left << "  (ns/key)" << right << setw(12) << fixed
+                << setprecision(1) << summary.p50 * 1000 / kKeys << endl;
+            out.unsetf(ios::floatfield);
+        }
+    }
+
+    template <typename Key>
+    void runAllMaps(ostream& out, const vector<Key>& keys) {
+        runRounds<HashMap<Key, int>>(out, "HashMap", keys);
+        runRounds<ChainedHashMap<Key, int>>(out, "chained", keys);
+        runRounds<unordered_map<Key, int>>(out, "unordered_map", keys);
+    }
+}
+
+BENCHMARK(hashMapIntKeys) {
+    printHeader(out, to_string(kKeys) + " int keys (per phase)");
+    runAllMaps(out, intKeys());
+}
+
+BENCHMARK(hashMapStringKeys) {
+    printHeader(out, to_string(kKeys) + " string keys (per phase)");
+    runAllMaps(out, stringKeys());
+}
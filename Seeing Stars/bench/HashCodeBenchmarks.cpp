@@ -0,0 +1,218 @@
+/* Benchmarks for the hashCode functions in hashcode.h, against the byte-at-a-time djb2 hash
+ * and identity integer hash they replaced. Each key set is one that real programs hash:
+ * file names shaped like the ones in the assignment's grabbag, URLs, integers that are
+ * packed (row, column) pairs, and pointers to heap nodes.
+ *
+ * For each key set and hash there is a row timing a pass over every key, and under it the
+ * median time per key, the fraction of keys whose hash codes are distinct, and the average
+ * number of keys a lookup would have to look at in a chained table of 2^k buckets indexed by
+ * the low bits of the hash code (about 1.4 for a good hash at this load). Strings of
+ * increasing length are timed separately to show throughput.
+ */
+#include "Benchmark.h"
+#include "Grabbag.h"
+#include "hashcode.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* Roughly how many keys are in each set, and how many passes to time over each. */
+    const size_t kKeys   = 100000;
+    const size_t kRounds = 20;
+
+    /* The hash codes these functions replaced. */
+    const int kLegacySeed       = 5381;
+    const int kLegacyMultiplier = 33;
+    const int kLegacyMask       = unsigned(-1) >> 1;
+
+    int legacyHashCode(const string& str) {
+        unsigned hash = kLegacySeed;
+        for (char ch: str) {
+            hash = kLegacyMultiplier * hash + ch;
+        }
+        return int(hash & kLegacyMask);
+    }
+
+    int legacyHashCode(int key) {
+        return key & kLegacyMask;
+    }
+
+    int legacyHashCode(void* key) {
+        return int(reinterpret_cast<long>(key)) & kLegacyMask;
+    }
+
+    /* The stems of the file names in the grabbag, such as "Done" from "states/Done73.state",
+     * or a few typical ones if the grabbag isn't where the program would look for it.
+     */
+    vector<string> grabbagStems() {
+        set<string> stems;
+        ifstream input("assignment.grabbag");
+        if (input) {
+            Grabbag grabbag(input);
+            for (string name: grabbag.filenames()) {
+                name = name.substr(name.find('/') + 1);
+                name = name.substr(0, name.find('.'));
+                while (!name.empty() && isdigit(name.back())) name.pop_back();
+                stems.insert(name);
+            }
+        }
+        if (stems.empty()) {
+            stems = { "Animate", "Done", "Find", "HonorCode", "NiceTry", "Welcome" };
+        }
+        return vector<string>(stems.begin(), stems.end());
+    }
+
+    /* Names like "states/HonorCode17Done.state", numbered the way the grabbag's are. */
+    vector<string> filenameKeys() {
+        vector<string> stems = grabbagStems();
+        vector<string> result;
+        for (size_t i = 0; result.size() < kKeys; i++) {
+            const string& stem = stems[i % stems.size()];
+            string number = to_string(i / stems.size());
+            result.push_back("states/" + stem + number + ".state");
+            result.push_back("states/" + stem + number + "Done.state");
+        }
+        return result;
+    }
+
+    vector<string> urlKeys() {
+        const vector<string> sections = { "lectures", "handouts", "psets", "sections" };
+        vector<string> result;
+        for (size_t i = 0; result.size() < kKeys; i++) {
+            result.push_back("https://web.stanford.edu/class/cs103/" + sections[i % sections.size()] +
+                             "/" + to_string(i / 100 % 30) + "/page" + to_string(i % 100) +
+                             ".html?session=" + to_string(i / 3000));
+        }
+        return result;
+    }
+
+    /* (row, column) pairs packed as row * 1024 + column, as a Grid-backed program might. */
+    vector<int> gridKeys() {
+        vector<int> result;
+        for (int row = 0; result.size() < kKeys; row++) {
+            for (int column = 0; column < 400; column++) {
+                result.push_back(row * 1024 + column);
+            }
+        }
+        return result;
+    }
+
+    struct Node {
+        double payload[4];
+    };
+
+    vector<void*> pointerKeys(vector<unique_ptr<Node>>& nodes) {
+        vector<void*> result;
+        for (size_t i = 0; i < kKeys; i++) {
+            nodes.emplace_back(new Node());
+            result.push_back(nodes.back().get());
+        }
+        return result;
+    }
+
+    /* Fraction of the codes that no other key shares. */
+    double distinctFraction(const vector<int>& codes) {
+        unordered_set<int> distinct(codes.begin(), codes.end());
+        return double(distinct.size()) / codes.size();
+    }
+
+    /* Average number of keys a successful lookup compares against in a chained table with a
+     * power-of-two number of buckets, at least one per key, indexed by the code's low bits.
+     */
+    double keysPerLookup(const vector<int>& codes) {
+        size_t buckets = 1;
+        while (buckets < codes.size()) buckets *= 2;
+        vector<size_t> chainLengths(buckets);
+        for (int code: codes) {
+            chainLengths[size_t(code) & (buckets - 1)]++;
+        }
+        double total = 0;
+        for (size_t length: chainLengths) {
+            total += length * (length + 1) / 2.0;
+        }
+        return total / codes.size();
+    }
+
+    void printExtra(ostream& out, const string& label, double value, int precision) {
+        out << setw(36) << left << "  (" + label + ")" << right << setw(12) << fixed
+            << setprecision(precision) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds passes of hash over keys and prints a row with the quality of its codes. */
+    template <typename Key, typename Hash>
+    void runHash(ostream& out, const string& label, const vector<Key>& keys, Hash hash) {
+        vector<int> codes(keys.size());
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            for (size_t i = 0; i < keys.size(); i++) {
+                codes[i] = hash(keys[i]);
+            }
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printExtra(out, "ns/key", summary.p50 * 1000 / keys.size(), 1);
+        printExtra(out, "distinct codes %", 100 * distinctFraction(codes), 2);
+        printExtra(out, "keys/lookup", keysPerLookup(codes), 2);
+    }
+
+    template <typename Key>
+    void compareHashes(ostream& out, const string& name, const vector<Key>& keys) {
+        runHash(out, "djb2 " + name, keys, [](const Key& key) { return legacyHashCode(key); });
+        runHash(out, "hashCode " + name, keys, [](const Key& key) { return hashCode(key); });
+    }
+}
+
+BENCHMARK(hashCodeQuality) {
+    printHeader(out, "hash every key (per pass)");
+
+    compareHashes(out, "filenames", filenameKeys());
+    compareHashes(out, "URLs", urlKeys());
+    compareHashes(out, "grid cells", gridKeys());
+
+    vector<unique_ptr<Node>> nodes;
+    compareHashes(out, "pointers", pointerKeys(nodes));
+}
+
+BENCHMARK(hashCodeThroughput) {
+    printHeader(out, "hash one string (per pass of 1000)");
+
+    for (size_t length: { 8, 64, 1024, 16384 }) {
+        vector<string> keys;
+        for (size_t i = 0; i < 1000; i++) {
+            string key(length, 'a');
+            for (size_t j = 0; j < length; j++) key[j] = char('a' + (i + j * 7) % 26);
+            keys.push_back(key);
+        }
+
+        for (bool legacy: { true, false }) {
+            vector<double> latencies;
+            Stopwatch total;
+            int sink = 0;
+            for (size_t round = 0; round < kRounds; round++) {
+                Stopwatch timer;
+                for (const string& key: keys) {
+                    sink ^= legacy? legacyHashCode(key) : hashCode(key);
+                }
+                latencies.push_back(timer.elapsedMicroseconds());
+            }
+
+            Summary summary = summarize(latencies, total.elapsedSeconds());
+            printRow(out, string(legacy? "djb2 " : "hashCode ") + to_string(length) + " bytes", summary);
+            printExtra(out, "MB/s", length * keys.size() / summary.p50, 1);
+            if (sink == -1) out << endl;   // keeps the hashing from being optimized away
+        }
+    }
+}
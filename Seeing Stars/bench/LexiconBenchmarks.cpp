@@ -0,0 +1,224 @@
+/* Benchmarks for loading a DawgLexicon from a binary lexicon file against loading it from a
+ * lexicon image of the same words (see private/dawgimage.h), and for looking words up in
+ * each.
+ *
+ * There is no lexicon file in the tree, so the workloads make one: kWords random words of
+ * kMinLength to kMaxLength letters, built into a trie and written out in the binary lexicon
+ * format (a trie is a DAWG that shares nothing, so it is bigger than a real lexicon of as
+ * many words, which only makes loading slower). The image is made from that file with
+ * DawgImage::convert, as tools/dawgimage.cpp does, and both files are removed afterwards.
+ * Each row is one pass; the line under a load row is the median time per lexicon, and the
+ * line under a lookup row the median time per lookup. Where the C library can say how much
+ * of the heap is in use, the bytes each loaded lexicon keeps on the heap are printed too;
+ * a mapped image keeps its edges in the page cache instead, shared with every other
+ * process that maps it.
+ */
+#include "Benchmark.h"
+#include "dawglexicon.h"
+#include "error.h"
+#include "private/dawgimage.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+using namespace std;
+
+namespace {
+    /* How many words the lexicon has, how long they are, how many lookups each lookup
+     * pass makes, and how many times to run each workload.
+     */
+    const int    kWords     = 200000;
+    const int    kMinLength = 3;
+    const int    kMaxLength = 12;
+    const int    kLookups   = 1000000;
+    const size_t kRounds    = 7;
+
+    const string kDawgFile  = "lexicon-benchmark.dat";
+    const string kImageFile = "lexicon-benchmark.dawgimg";
+
+    /* A cheap, repeatable stream of pseudorandom numbers. */
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /* The words, sorted and without duplicates, with the early letters of the alphabet
+     * more common than the late ones so that the words share prefixes the way real ones do.
+     */
+    vector<string> makeWords() {
+        uint32_t state = 2463534242u;
+        vector<string> words;
+        for (int i = 0; i < kWords; i++) {
+            int length = kMinLength + int(nextRandom(state) % (kMaxLength - kMinLength + 1));
+            string word;
+            for (int j = 0; j < length; j++) {
+                uint32_t r = nextRandom(state) % 26;
+                word += char('a' + r * r / 26);
+            }
+            words.push_back(word);
+        }
+        sort(words.begin(), words.end());
+        words.erase(unique(words.begin(), words.end()), words.end());
+        return words;
+    }
+
+    /* A node of the trie, with its children in alphabetical order. */
+    struct TrieNode {
+        bool accept;
+        vector<pair<char, int>> children;
+    };
+
+    /* Writes the words to a file in the binary lexicon format, with the edges in
+     * big-endian order. Each node's children are one run of edges, laid out breadth
+     * first, with the root's run at index 0.
+     */
+    void writeDawgFile(const vector<string>& words, const string& filename) {
+        vector<TrieNode> nodes(1, TrieNode{ false, {} });
+        for (const string& word : words) {
+            int node = 0;
+            for (char ch : word) {
+                vector<pair<char, int>>& children = nodes[node].children;
+                if (children.empty() || children.back().first != ch) {
+                    children.push_back(make_pair(ch, int(nodes.size())));
+                    int child = int(nodes.size());
+                    nodes.push_back(TrieNode{ false, {} });
+                    node = child;
+                } else {
+                    node = children.back().second;
+                }
+            }
+            nodes[node].accept = true;
+        }
+
+        vector<uint32_t> runStart(nodes.size(), 0);
+        vector<int> order(1, 0);
+        uint32_t edgeCount = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            runStart[order[i]] = edgeCount;
+            for (const pair<char, int>& child : nodes[order[i]].children) {
+                edgeCount++;
+                if (!nodes[child.second].children.empty()) order.push_back(child.second);
+            }
+        }
+
+        vector<unsigned char> bytes;
+        for (int node : order) {
+            const vector<pair<char, int>>& children = nodes[node].children;
+            for (size_t j = 0; j < children.size(); j++) {
+                const TrieNode& child = nodes[children[j].second];
+                uint32_t edge = uint32_t(children[j].first - 'a' + 1)
+                        | (j + 1 == children.size() ? 1u << 5 : 0u)
+                        | (child.accept ? 1u << 6 : 0u)
+                        | (runStart[children[j].second] << 8);
+                bytes.push_back((unsigned char) (edge >> 24));
+                bytes.push_back((unsigned char) (edge >> 16));
+                bytes.push_back((unsigned char) (edge >> 8));
+                bytes.push_back((unsigned char) edge);
+            }
+        }
+
+        ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+        out << "DAWG:0:" << bytes.size() << ":";
+        out.write(reinterpret_cast<const char*>(bytes.data()), streamsize(bytes.size()));
+        if (out.fail()) error("couldn't write " + filename);
+    }
+
+    void writeImageFile(const string& dawgFile, const string& imageFile) {
+        ifstream dawg(dawgFile.c_str(), ios::in | ios::binary);
+        ofstream image(imageFile.c_str(), ios::out | ios::binary | ios::trunc);
+        string errorMessage;
+        if (!stanfordcpplib::DawgImage::convert(dawg, image, errorMessage)) {
+            error("couldn't convert " + dawgFile + ": " + errorMessage);
+        }
+    }
+
+    /* Bytes of heap in use, or -1 if the C library can't say. */
+    long heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+        struct mallinfo2 info = mallinfo2();
+        return long(info.uordblks + info.hblkhd);
+#else
+        return -1;
+#endif
+    }
+
+    /* Prints an extra line under a row. */
+    void printDetail(ostream& out, const string& label, double value) {
+        out << setw(36) << left << label << right << setw(12) << fixed
+            << setprecision(1) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds runs of a workload and prints a row and the time per item. */
+    void runWorkload(ostream& out, const string& label, const string& unit, long items,
+                     const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printDetail(out, "  (" + unit + ")", summary.p50 * 1000 / items);
+    }
+
+    /* Times loading one file, then looking words up in what it loaded. */
+    void runFile(ostream& out, const string& name, const string& filename,
+                 const vector<string>& words, const vector<string>& probes, int expectedHits) {
+        runWorkload(out, "load " + name, "ns/lexicon", 1, [&] {
+            DawgLexicon lexicon(filename);
+            if (lexicon.size() != int(words.size())) error(name + " lost words.");
+        });
+
+        long before = heapInUse();
+        DawgLexicon lexicon(filename);
+        long after = heapInUse();
+        if (before >= 0) printDetail(out, "  (heap bytes/lexicon)", double(after - before));
+
+        runWorkload(out, "contains, " + name, "ns/lookup", kLookups, [&] {
+            int hits = 0;
+            for (const string& probe : probes) {
+                if (lexicon.contains(probe)) hits++;
+            }
+            if (hits != expectedHits) error(name + " found the wrong words.");
+        });
+    }
+}
+
+BENCHMARK(lexiconImage) {
+    vector<string> words = makeWords();
+    writeDawgFile(words, kDawgFile);
+    writeImageFile(kDawgFile, kImageFile);
+
+    // half of the lookups are words; the other half are words with their last letter changed
+    uint32_t state = 88172645u;
+    vector<string> probes;
+    for (int i = 0; i < kLookups; i++) {
+        string probe = words[nextRandom(state) % words.size()];
+        if (i % 2) probe.back() = char('a' + nextRandom(state) % 26);
+        probes.push_back(probe);
+    }
+    int expectedHits = 0;
+    for (const string& probe : probes) {
+        if (binary_search(words.begin(), words.end(), probe)) expectedHits++;
+    }
+
+    printHeader(out, to_string(words.size()) + " words (per pass)");
+    runFile(out, "binary lexicon file", kDawgFile, words, probes, expectedHits);
+    runFile(out, "lexicon image", kImageFile, words, probes, expectedHits);
+
+    remove(kDawgFile.c_str());
+    remove(kImageFile.c_str());
+}
@@ -0,0 +1,139 @@
+/* Benchmarks for Map's node allocation policies (see nodepool.h): the default NodePool,
+ * NodeHeap (one new/delete per node, as Map used to do), and std::map for reference.
+ *
+ * The insert-heavy workloads build a map of kKeys random keys, and then churn it by removing
+ * and re-adding keys, which is where reusing freed nodes pays off. The iterate-heavy
+ * workload walks every entry of a map that was built in random order, which is where having
+ * the nodes close together pays off. The last one builds many small maps, as BasicGraph's
+ * edge sets are. Each row is one pass, and the line under it is the median time per entry.
+ */
+#include "Benchmark.h"
+#include "error.h"
+#include "map.h"
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* How many keys go in the large maps, and how many times to run each workload. */
+    const size_t kKeys   = 200000;
+    const size_t kRounds = 10;
+
+    /* How many small maps to build, and how many entries go in each. */
+    const size_t kSmallMaps       = 20000;
+    const size_t kSmallMapEntries = 8;
+
+    /* kKeys distinct keys in a scrambled order. */
+    vector<int> randomKeys() {
+        vector<int> result;
+        for (size_t i = 0; i < kKeys; i++) {
+            result.push_back(int((uint32_t(i) * 2654435761u) >> 1));
+        }
+        return result;
+    }
+
+    /* The same operations on each kind of map. */
+    template <template <typename> class A> void putKey(Map<int, int, A>& map, int key, int value) {
+        map.put(key, value);
+    }
+    void putKey(std::map<int, int>& map, int key, int value) {
+        map[key] = value;
+    }
+
+    template <template <typename> class A> void removeKey(Map<int, int, A>& map, int key) {
+        map.remove(key);
+    }
+    void removeKey(std::map<int, int>& map, int key) {
+        map.erase(key);
+    }
+
+    template <template <typename> class A> long sumValues(const Map<int, int, A>& map) {
+        long sum = 0;
+        map.mapAll([&](int, int value) { sum += value; });
+        return sum;
+    }
+    long sumValues(const std::map<int, int>& map) {
+        long sum = 0;
+        for (const auto& entry: map) sum += entry.second;
+        return sum;
+    }
+
+    /* Times kRounds runs of a workload and prints a row and the time per entry. */
+    void runWorkload(ostream& out, const string& label, size_t entries,
+                     const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        out << setw(36) << left << "  (ns/entry)" << right << setw(12) << fixed
+            << setprecision(1) << summary.p50 * 1000 / entries << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    template <typename MapType>
+    void runInsertHeavy(ostream& out, const string& name, const vector<int>& keys) {
+        runWorkload(out, name + " insert", kKeys, [&] {
+            MapType map;
+            for (size_t i = 0; i < kKeys; i++) putKey(map, keys[i], int(i));
+            if (int(map.size()) != int(kKeys)) error(name + " lost keys.");
+        });
+
+        MapType map;
+        for (size_t i = 0; i < kKeys; i++) putKey(map, keys[i], int(i));
+        runWorkload(out, name + " remove/re-add", kKeys, [&] {
+            for (size_t i = 0; i < kKeys; i += 2) removeKey(map, keys[i]);
+            for (size_t i = 0; i < kKeys; i += 2) putKey(map, keys[i], int(i));
+        });
+    }
+
+    template <typename MapType>
+    void runIterateHeavy(ostream& out, const string& name, const vector<int>& keys) {
+        MapType map;
+        for (size_t i = 0; i < kKeys; i++) putKey(map, keys[i], int(i));
+        long expected = long(kKeys) * long(kKeys - 1) / 2;
+        runWorkload(out, name + " iterate", kKeys, [&] {
+            if (sumValues(map) != expected) error(name + " gave the wrong sum.");
+        });
+    }
+
+    template <typename MapType>
+    void runSmallMaps(ostream& out, const string& name) {
+        runWorkload(out, name + " small maps", kSmallMaps * kSmallMapEntries, [&] {
+            vector<MapType> maps(kSmallMaps);
+            for (size_t i = 0; i < kSmallMaps; i++) {
+                for (size_t j = 0; j < kSmallMapEntries; j++) {
+                    putKey(maps[i], int(j * 7 % kSmallMapEntries), int(j));
+                }
+            }
+        });
+    }
+}
+
+BENCHMARK(mapInsertHeavy) {
+    printHeader(out, to_string(kKeys) + " int keys (per pass)");
+    vector<int> keys = randomKeys();
+    runInsertHeavy<Map<int, int>>(out, "NodePool", keys);
+    runInsertHeavy<Map<int, int, NodeHeap>>(out, "NodeHeap", keys);
+    runInsertHeavy<std::map<int, int>>(out, "std::map", keys);
+
+    printHeader(out, to_string(kSmallMaps) + " maps of " + to_string(kSmallMapEntries) + " (per pass)");
+    runSmallMaps<Map<int, int>>(out, "NodePool");
+    runSmallMaps<Map<int, int, NodeHeap>>(out, "NodeHeap");
+    runSmallMaps<std::map<int, int>>(out, "std::map");
+}
+
+BENCHMARK(mapIterateHeavy) {
+    printHeader(out, to_string(kKeys) + " int keys (per pass)");
+    vector<int> keys = randomKeys();
+    runIterateHeavy<Map<int, int>>(out, "NodePool", keys);
+    runIterateHeavy<Map<int, int, NodeHeap>>(out, "NodeHeap", keys);
+    runIterateHeavy<std::map<int, int>>(out, "std::map", keys);
+}
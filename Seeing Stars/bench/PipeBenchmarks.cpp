@@ -0,0 +1,154 @@
+/* Benchmarks for the pipe between this program and the Java back-end. Every Platform call
+ * turns into a line of text sent to the back-end, and calls that return a value then block
+ * until a line comes back, so these measure what each kind of call costs end to end.
+ *
+ * None of these make a window, so they work with the back-end running headless.
+ */
+#include "Benchmark.h"
+#include "private/platform.h"
+#include "gevents.h"
+#include "gobjects.h"
+#include "ginteractors.h"
+#include "gtimer.h"
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* How many times to repeat each measurement. */
+    const size_t kRounds = 200;
+
+    /* How many timer events to wait for, and the timer period. */
+    const size_t kTimerEvents       = 500;
+    const double kTimerMilliseconds = 1;
+
+    stanfordcpplib::Platform& platform() {
+        return *stanfordcpplib::getPlatform();
+    }
+
+    /* Fire-and-forget calls don't wait for the back-end, so the only way to see what they
+     * cost is to follow them with a call that does; the back-end handles commands in order,
+     * so it can't answer that one until it's done with all the others.
+     */
+    void sync(GObject* object) {
+        platform().gobject_getBounds(object);
+    }
+}
+
+/* Batches of setLocation calls, each batch followed by one round trip, as happens when a
+ * reactor moves a lot of objects in response to a single event.
+ */
+BENCHMARK(pipeFireAndForget) {
+    GRect rect(0, 0, 10, 10);
+
+    printHeader(out, "gobject_setLocation batch");
+    for (size_t batchSize: { 1, 10, 100, 1000 }) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            for (size_t i = 0; i < batchSize; i++) {
+                platform().gobject_setLocation(&rect, double(i), double(round));
+            }
+            sync(&rect);
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        /* Report per batch, but make the throughput column count individual calls. */
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        summary.perSecond *= batchSize;
+        printRow(out, "batch of " + to_string(batchSize) + " (per batch)", summary);
+    }
+}
+
+/* Calls that block on the back-end's reply, with replies of different sizes. */
+BENCHMARK(pipeResultCalls) {
+    GRect rect(0, 0, 10, 10);
+
+    printHeader(out, "round trip");
+    {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            platform().gobject_getBounds(&rect);
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+        printRow(out, "gobject_getBounds", summarize(latencies, total.elapsedSeconds()));
+    }
+
+    /* Text sent to a formatted pane has to be split into several lines once it passes the
+     * pipe's maximum command length (2KB), so payloads straddle that boundary.
+     */
+    GFormattedPane pane;
+    for (size_t payload: { 16, 1024, 4096, 65536 }) {
+        platform().gformattedpane_setText(&pane, string(payload, 'x'));
+
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            platform().gformattedpane_getText(&pane);
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+        printRow(out, "gformattedpane_getText " + to_string(payload) + "B",
+                 summarize(latencies, total.elapsedSeconds()));
+    }
+
+    for (size_t payload: { 16, 1024, 4096, 65536 }) {
+        string text(payload, 'x');
+
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            platform().gformattedpane_setText(&pane, text);
+            sync(&rect);
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+        printRow(out, "gformattedpane_setText " + to_string(payload) + "B",
+                 summarize(latencies, total.elapsedSeconds()));
+    }
+}
+
+/* Events originate in the back-end and reach us as replies to a wait or poll command. */
+BENCHMARK(pipeEvents) {
+    printHeader(out, "events");
+
+    /* Polling with nothing to report is a plain round trip through the event machinery. */
+    {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            getNextEvent(TIMER_EVENT);
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+        printRow(out, "getNextEvent (empty queue)", summarize(latencies, total.elapsedSeconds()));
+    }
+
+    /* A fast timer should deliver an event every period. Anything the pipe adds shows up as
+     * a longer gap between consecutive events, or as fewer events per second.
+     */
+    {
+        GTimer timer(kTimerMilliseconds);
+        vector<double> gaps;
+
+        timer.start();
+        waitForEvent(TIMER_EVENT);
+        Stopwatch total;
+        Stopwatch gap;
+        for (size_t i = 0; i < kTimerEvents; i++) {
+            waitForEvent(TIMER_EVENT);
+            gaps.push_back(gap.elapsedMicroseconds());
+            gap.restart();
+        }
+        double elapsed = total.elapsedSeconds();
+        timer.stop();
+
+        ostringstream label;
+        label << "timer gap (" << kTimerMilliseconds << "ms period)";
+        printRow(out, label.str(), summarize(gaps, elapsed));
+    }
+}
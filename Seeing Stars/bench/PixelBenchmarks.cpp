@@ -0,0 +1,163 @@
+/* Benchmarks for getting pixels into a GBufferedImage: one setRGB call per pixel, a whole
+ * Grid through fromGrid, and a raw buffer through setPixels, both as a full frame and as a
+ * small dirty region of a large image. Each upload is followed by a round trip so that the
+ * time includes the back-end reading everything it was sent.
+ *
+ * Rates are in megapixels per second of image kept up to date: each frame counts every pixel
+ * of the image, however few of them were passed in or had to be sent.
+ */
+#include "Benchmark.h"
+#include "private/platform.h"
+#include "gbufferedimage.h"
+#include "gobjects.h"
+#include "grid.h"
+#include <cstdint>
+#include <iomanip>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* Size of the large image, and of the small one used for setRGB (which is too slow to
+     * try on the large one).
+     */
+    const int kWidth       = 512;
+    const int kHeight      = 512;
+    const int kSmallWidth  = 64;
+    const int kSmallHeight = 64;
+
+    /* Size of the region that changes in the dirty-region benchmarks. */
+    const int kSpriteSize = 32;
+
+    /* How many uploads to time in each configuration. */
+    const size_t kRounds = 20;
+
+    /* A frame whose every pixel differs from the one in the previous round. */
+    void makeNoise(vector<uint32_t>& pixels, size_t round) {
+        uint32_t state = uint32_t(round) * 2654435761u + 1;
+        for (uint32_t& pixel: pixels) {
+            state = state * 1664525u + 1013904223u;
+            pixel = (state >> 8) | 0x010101;
+            if (round % 2 == 1) pixel ^= 0x808080;
+        }
+    }
+
+    /* Times kRounds uploads of pixelsPerRound pixels each and prints a row for them, then
+     * the rate in megapixels per second underneath.
+     */
+    void runUploads(ostream& out, const string& label, size_t pixelsPerRound,
+                    const function<void (size_t)>& upload) {
+        GRect sync(0, 0, 1, 1);
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            upload(round);
+            stanfordcpplib::getPlatform()->gobject_getBounds(&sync);
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        out << setw(36) << left << "  (megapixels/sec)" << right << setw(12) << fixed
+            << setprecision(2) << summary.perSecond * pixelsPerRound / 1e6 << endl;
+        out.unsetf(ios::floatfield);
+    }
+}
+
+/* Every pixel changes every frame: the worst case for any update scheme. */
+BENCHMARK(pixelFullFrames) {
+    printHeader(out, "upload (per frame)");
+
+    {
+        GBufferedImage image(kSmallWidth, kSmallHeight);
+        vector<uint32_t> pixels(kSmallWidth * kSmallHeight);
+        runUploads(out, "setRGB per pixel 64x64", pixels.size(), [&](size_t round) {
+            makeNoise(pixels, round);
+            for (int y = 0; y < kSmallHeight; y++) {
+                for (int x = 0; x < kSmallWidth; x++) {
+                    image.setRGB(x, y, int(pixels[y * kSmallWidth + x]));
+                }
+            }
+        });
+    }
+
+    GBufferedImage image(kWidth, kHeight);
+    vector<uint32_t> pixels(kWidth * kHeight);
+    runUploads(out, "fromGrid 512x512", pixels.size(), [&](size_t round) {
+        makeNoise(pixels, round);
+        Grid<int> grid(kHeight, kWidth);
+        for (int y = 0; y < kHeight; y++) {
+            for (int x = 0; x < kWidth; x++) {
+                grid[y][x] = int(pixels[y * kWidth + x]);
+            }
+        }
+        image.fromGrid(grid);
+    });
+
+    runUploads(out, "setPixels 512x512", pixels.size(), [&](size_t round) {
+        makeNoise(pixels, round);
+        image.setPixels(pixels.data(), kWidth, kHeight, kWidth);
+    });
+}
+
+/* A small square moves across a flat background, as when a few things animate over a
+ * prerendered picture.
+ */
+BENCHMARK(pixelDirtyRegions) {
+    printHeader(out, "moving 32x32 sprite on 512x512");
+
+    const uint32_t background = 0x101030;
+    const uint32_t sprite     = 0xffee88;
+    auto spriteX = [](size_t round) { return int(round * 7) % (kWidth - kSpriteSize); };
+
+    /* The old way: change the Grid, then send it all. */
+    {
+        GBufferedImage image(kWidth, kHeight, int(background));
+        Grid<int> grid(kHeight, kWidth, int(background));
+        runUploads(out, "fromGrid (whole image)", size_t(kWidth) * kHeight, [&](size_t round) {
+            grid.fill(int(background));
+            for (int y = 0; y < kSpriteSize; y++) {
+                for (int x = 0; x < kSpriteSize; x++) {
+                    grid[kHeight / 2 + y][spriteX(round) + x] = int(sprite);
+                }
+            }
+            image.fromGrid(grid);
+        });
+    }
+
+    /* Redraw the whole frame into a buffer and let setPixels find what changed. */
+    {
+        GBufferedImage image(kWidth, kHeight, int(background));
+        vector<uint32_t> frame(kWidth * kHeight);
+        runUploads(out, "setPixels (whole image)", frame.size(), [&](size_t round) {
+            fill(frame.begin(), frame.end(), background);
+            for (int y = 0; y < kSpriteSize; y++) {
+                for (int x = 0; x < kSpriteSize; x++) {
+                    frame[(kHeight / 2 + y) * kWidth + spriteX(round) + x] = sprite;
+                }
+            }
+            image.setPixels(frame.data(), kWidth, kHeight, kWidth);
+        });
+    }
+
+    /* Pass just the dirty rectangle: the union of the sprite's old and new positions, cut
+     * out of the full frame buffer by way of the stride.
+     */
+    {
+        GBufferedImage image(kWidth, kHeight, int(background));
+        vector<uint32_t> frame(kWidth * kHeight, background);
+        int lastX = spriteX(0);
+        runUploads(out, "setPixels (dirty region)", size_t(kWidth) * kHeight, [&](size_t round) {
+            int x = spriteX(round);
+            for (int y = 0; y < kSpriteSize; y++) {
+                fill_n(&frame[(kHeight / 2 + y) * kWidth + lastX], kSpriteSize, background);
+                fill_n(&frame[(kHeight / 2 + y) * kWidth + x], kSpriteSize, sprite);
+            }
+            int minX = min(x, lastX);
+            int maxX = max(x, lastX) + kSpriteSize;
+            image.setPixels(&frame[(kHeight / 2) * kWidth + minX], minX, kHeight / 2,
+                            maxX - minX, kSpriteSize, kWidth);
+            lastX = x;
+        });
+    }
+}
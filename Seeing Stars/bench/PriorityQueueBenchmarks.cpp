@@ -0,0 +1,226 @@
+/* Benchmarks for PriorityQueue as the frontier of Dijkstra's algorithm on large random
+ * graphs, comparing the ways a client can deal with a vertex whose distance improves, and
+ * for building a queue all at once with the range constructor.
+ *
+ * Each graph has kEdgesPerVertex edges out of every vertex: one to the next vertex around
+ * a ring, so that every vertex can be reached, and the rest to random vertices, with
+ * random weights. The graph is kept in flat arrays, so that the time goes to the queue
+ * rather than to finding the edges. The searches are:
+ *
+ *   - lazy: enqueue the vertex again at its new distance and skip the stale entries as
+ *     they come out, which is all a client could do without decrease-key;
+ *   - handle: keep the Handle that enqueue returned for each vertex, and change the
+ *     vertex's priority through it;
+ *   - by value: changePriority(vertex, distance), which has to search the queue for the
+ *     vertex. That makes the whole search O(V^2), so it only runs on the small graph.
+ *
+ * Each row is one pass, and the line under it is the median time per edge (or per
+ * element, for the build).
+ */
+#include "Benchmark.h"
+#include "error.h"
+#include "priorityqueue.h"
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* The graphs' sizes, how many elements the build workloads use, and how many times
+     * to run each workload.
+     */
+    const int    kSmallVertices  = 5000;
+    const int    kLargeVertices  = 500000;
+    const int    kEdgesPerVertex = 8;
+    const int    kBuildSize      = 1000000;
+    const size_t kRounds         = 5;
+
+    const double kInfinity = numeric_limits<double>::infinity();
+
+    /* A graph in compressed sparse row form: the edges out of vertex v are the ones from
+     * index first[v] up to first[v + 1].
+     */
+    struct Graph {
+        int vertices;
+        vector<int> first;
+        vector<int> target;
+        vector<double> weight;
+    };
+
+    /* A cheap, repeatable stream of pseudorandom numbers. */
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    Graph makeGraph(int vertices) {
+        Graph graph;
+        graph.vertices = vertices;
+        uint32_t state = 2463534242u;
+        for (int v = 0; v < vertices; v++) {
+            graph.first.push_back(int(graph.target.size()));
+            graph.target.push_back((v + 1) % vertices);
+            graph.weight.push_back(1 + nextRandom(state) % 100);
+            for (int j = 1; j < kEdgesPerVertex; j++) {
+                graph.target.push_back(int(nextRandom(state) % vertices));
+                graph.weight.push_back(1 + nextRandom(state) % 100);
+            }
+        }
+        graph.first.push_back(int(graph.target.size()));
+        return graph;
+    }
+
+    /* The three searches from vertex 0. Each returns the sum of the shortest distances,
+     * rounded down, so that they can be checked against each other.
+     */
+    long lazyDijkstra(const Graph& graph) {
+        vector<double> distance(graph.vertices, kInfinity);
+        vector<bool> done(graph.vertices, false);
+        PriorityQueue<int> queue;
+        distance[0] = 0;
+        queue.enqueue(0, 0);
+        long total = 0;
+        while (!queue.isEmpty()) {
+            int v = queue.dequeue();
+            if (done[v]) continue;
+            done[v] = true;
+            total += long(distance[v]);
+            for (int e = graph.first[v]; e < graph.first[v + 1]; e++) {
+                int w = graph.target[e];
+                double through = distance[v] + graph.weight[e];
+                if (through < distance[w]) {
+                    distance[w] = through;
+                    queue.enqueue(w, through);
+                }
+            }
+        }
+        return total;
+    }
+
+    long handleDijkstra(const Graph& graph) {
+        vector<double> distance(graph.vertices, kInfinity);
+        vector<PriorityQueue<int>::Handle> handles(graph.vertices);
+        PriorityQueue<int> queue;
+        distance[0] = 0;
+        handles[0] = queue.enqueue(0, 0);
+        long total = 0;
+        while (!queue.isEmpty()) {
+            int v = queue.dequeue();
+            total += long(distance[v]);
+            for (int e = graph.first[v]; e < graph.first[v + 1]; e++) {
+                int w = graph.target[e];
+                double through = distance[v] + graph.weight[e];
+                if (through < distance[w]) {
+                    if (queue.contains(handles[w])) {
+                        queue.changePriority(handles[w], through);
+                    } else {
+                        handles[w] = queue.enqueue(w, through);
+                    }
+                    distance[w] = through;
+                }
+            }
+        }
+        return total;
+    }
+
+    long valueDijkstra(const Graph& graph) {
+        vector<double> distance(graph.vertices, kInfinity);
+        vector<bool> reached(graph.vertices, false);
+        PriorityQueue<int> queue;
+        distance[0] = 0;
+        reached[0] = true;
+        queue.enqueue(0, 0);
+        long total = 0;
+        while (!queue.isEmpty()) {
+            int v = queue.dequeue();
+            total += long(distance[v]);
+            for (int e = graph.first[v]; e < graph.first[v + 1]; e++) {
+                int w = graph.target[e];
+                double through = distance[v] + graph.weight[e];
+                if (through < distance[w]) {
+                    if (reached[w]) {
+                        queue.changePriority(w, through);
+                    } else {
+                        reached[w] = true;
+                        queue.enqueue(w, through);
+                    }
+                    distance[w] = through;
+                }
+            }
+        }
+        return total;
+    }
+
+    /* Prints an extra line under a row. */
+    void printDetail(ostream& out, const string& label, double value) {
+        out << setw(36) << left << label << right << setw(12) << fixed
+            << setprecision(1) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds runs of a workload and prints a row and the time per item. */
+    void runWorkload(ostream& out, const string& label, const string& unit, long items,
+                     const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printDetail(out, "  (ns/" + unit + ")", summary.p50 * 1000 / items);
+    }
+
+    void runGraph(ostream& out, int vertices, bool byValue) {
+        Graph graph = makeGraph(vertices);
+        long edges = long(graph.target.size());
+        long expected = lazyDijkstra(graph);
+        printHeader(out, "Dijkstra, " + to_string(vertices) + " vertices, " + to_string(edges)
+                    + " edges (per pass)");
+
+        runWorkload(out, "lazy", "edge", edges, [&] {
+            if (lazyDijkstra(graph) != expected) error("lazy search got the wrong distances.");
+        });
+        runWorkload(out, "handle", "edge", edges, [&] {
+            if (handleDijkstra(graph) != expected) error("handle search got the wrong distances.");
+        });
+        if (byValue) {
+            runWorkload(out, "by value", "edge", edges, [&] {
+                if (valueDijkstra(graph) != expected) error("by-value search got the wrong distances.");
+            });
+        }
+    }
+
+    void runBuild(ostream& out) {
+        vector<pair<double, int>> pairs;
+        uint32_t state = 88172645u;
+        for (int i = 0; i < kBuildSize; i++) {
+            pairs.push_back(make_pair(double(nextRandom(state) % 1000000), i));
+        }
+        printHeader(out, "Building a queue of " + to_string(kBuildSize) + " elements (per pass)");
+
+        runWorkload(out, "enqueue one by one", "element", kBuildSize, [&] {
+            PriorityQueue<int> queue;
+            for (const pair<double, int>& p : pairs) queue.enqueue(p.second, p.first);
+            if (queue.size() != kBuildSize) error("enqueue lost elements.");
+        });
+        runWorkload(out, "range constructor", "element", kBuildSize, [&] {
+            PriorityQueue<int> queue(pairs.begin(), pairs.end());
+            if (queue.size() != kBuildSize) error("range constructor lost elements.");
+        });
+    }
+}
+
+BENCHMARK(priorityQueue) {
+    runGraph(out, kSmallVertices, true);
+    runGraph(out, kLargeVertices, false);
+    runBuild(out);
+}
@@ -0,0 +1,67 @@
+/* Benchmarks for Raster's anti-aliased drawing, which renderStar uses to draw a star into
+ * an image. Stars of increasing size are drawn the way the window shows them, with lines as
+ * thick as StarLine::kThickness and points as large as StarPoint::kRadius, once with opaque
+ * lines and once with translucent ones, which have to be blended into what's underneath.
+ */
+#include "Benchmark.h"
+#include "Raster.h"
+#include "Star.h"
+#include <cmath>
+#include <sstream>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* Same size as the program's canvas. */
+    const int kSize = 500;
+
+    /* How many times to draw each star. */
+    const size_t kRounds = 20;
+
+    const uint32_t kBackground  = Raster::kOpaque | 0xFFFFFF;
+    const uint32_t kPointColor  = Raster::kOpaque | 0x000080;
+
+    /* Draws { numPoints / stepSize } in the layout radialLayoutFor gives it. */
+    void drawStar(Raster& raster, size_t numPoints, size_t stepSize, uint32_t lineColor) {
+        double radius = kSize / 2.0 - StarPoint::kRadius - 20;
+        vector<double> xs, ys;
+        for (size_t i = 0; i < numPoints; i++) {
+            double theta = 3 * M_PI / 2 - 2 * M_PI * i / numPoints;
+            xs.push_back(kSize / 2.0 + radius * cos(theta));
+            ys.push_back(kSize / 2.0 - radius * sin(theta));
+        }
+
+        for (size_t src = 0; src < numPoints; src++) {
+            size_t dst = (src + stepSize) % numPoints;
+            raster.strokeLine(xs[src], ys[src], xs[dst], ys[dst], StarLine::kThickness, lineColor);
+        }
+        for (size_t i = 0; i < numPoints; i++) {
+            raster.fillDisc(xs[i], ys[i], StarPoint::kRadius, kPointColor);
+        }
+    }
+}
+
+BENCHMARK(rasterStars) {
+    printHeader(out, "draw anti-aliased star into Raster");
+
+    for (size_t numPoints: { 10, 50, 200 }) {
+        size_t stepSize = (numPoints - 1) / 2;
+
+        for (uint32_t lineColor: { Raster::kOpaque | 0x0000FF, 0x800000FFu }) {
+            Raster raster(kSize, kSize);
+            vector<double> latencies;
+            Stopwatch total;
+            for (size_t round = 0; round < kRounds; round++) {
+                Stopwatch timer;
+                raster.fill(kBackground);
+                drawStar(raster, numPoints, stepSize, lineColor);
+                latencies.push_back(timer.elapsedMicroseconds());
+            }
+
+            ostringstream label;
+            label << "{ " << numPoints << " / " << stepSize << " }, "
+                  << ((lineColor >> 24) == 0xFF? "opaque" : "translucent");
+            printRow(out, label.str(), summarize(latencies, total.elapsedSeconds()));
+        }
+    }
+}
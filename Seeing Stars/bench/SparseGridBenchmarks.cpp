@@ -0,0 +1,212 @@
+/* Benchmarks for SparseGrid's cell storage policies (see sparsecells.h) on a grid of a
+ * million by a million cells, against the map of maps SparseGrid used to keep its cells in.
+ *
+ * Each grid gets kCells cells set, either scattered at random over the whole grid or
+ * clustered in square patches of kPatchSide by kPatchSide cells, which is what a drawing or
+ * a game board tends to look like. The workloads set every cell, read every cell back in a
+ * different order from the one it was set in, read as many cells that were never set, and
+ * visit every set cell with mapAll. Each row is one pass, and the line under it is the
+ * median time per cell. Where the C library can say how much of the heap is in use, the
+ * bytes per cell of each grid are printed too. Tiles only pay off when cells cluster: with
+ * cells scattered, every one of them gets a tile of its own.
+ */
+#include "Benchmark.h"
+#include "error.h"
+#include "map.h"
+#include "sparsegrid.h"
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+using namespace std;
+
+namespace {
+    /* The grid's size, how many cells are set, and how many times to run each workload. */
+    const int    kSide   = 1000000;
+    const size_t kCells  = 500000;
+    const size_t kRounds = 5;
+
+    /* Clustered cells fill whole patches this many cells on a side. */
+    const int kPatchSide = 64;
+
+    /* A cell's coordinates. */
+    struct Cell {
+        int row;
+        int col;
+    };
+
+    /* Scrambles i into a well-spread 32-bit value. */
+    uint32_t scramble(uint32_t i) {
+        i ^= i >> 16;
+        i *= 0x7feb352du;
+        i ^= i >> 15;
+        i *= 0x846ca68bu;
+        i ^= i >> 16;
+        return i;
+    }
+
+    /* kCells cells, distinct as long as the grid is much bigger than kCells. */
+    vector<Cell> scatteredCells() {
+        vector<Cell> result;
+        for (size_t i = 0; i < kCells; i++) {
+            result.push_back({int(scramble(uint32_t(2 * i)) % kSide),
+                              int(scramble(uint32_t(2 * i + 1)) % kSide)});
+        }
+        return result;
+    }
+
+    /* kCells cells filling patches in turn, with the patches placed at random. */
+    vector<Cell> clusteredCells() {
+        const size_t patchCells = size_t(kPatchSide) * kPatchSide;
+        vector<Cell> result;
+        for (size_t i = 0; i < kCells; i++) {
+            uint32_t patch = uint32_t(i / patchCells);
+            int within = int(i % patchCells);
+            int top = int(scramble(2 * patch) % (kSide / kPatchSide)) * kPatchSide;
+            int left = int(scramble(2 * patch + 1) % (kSide / kPatchSide)) * kPatchSide;
+            result.push_back({top + within / kPatchSide, left + within % kPatchSide});
+        }
+        return result;
+    }
+
+    /* The same cells in another scrambled order: kProbeStride and kCells have no common factor. */
+    const size_t kProbeStride = 7919;
+    vector<Cell> probeOrder(const vector<Cell>& cells) {
+        vector<Cell> result;
+        for (size_t i = 0; i < kCells; i++) {
+            result.push_back(cells[i * kProbeStride % kCells]);
+        }
+        return result;
+    }
+
+    /* Cells in the same rows as the given ones, one column over from a patch or a set cell. */
+    vector<Cell> missingCells(const vector<Cell>& cells) {
+        vector<Cell> result;
+        for (const Cell& cell: cells) {
+            result.push_back({cell.row, ((cell.col / kPatchSide + 1) * kPatchSide) % kSide});
+        }
+        return result;
+    }
+
+    /* Bytes of heap in use, or -1 if the C library can't say. */
+    long heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+        struct mallinfo2 info = mallinfo2();
+        return long(info.uordblks + info.hblkhd);
+#else
+        return -1;
+#endif
+    }
+
+    /* The map of maps, as SparseGrid stored its cells before it had storage policies. */
+    typedef Map<int, Map<int, int>> NestedMaps;
+
+    /* The same operations on each kind of grid. */
+    template <typename GridType> void makeGrid(GridType& grid) { grid.resize(kSide, kSide); }
+    void makeGrid(NestedMaps& grid) { grid.clear(); }
+
+    template <typename GridType>
+    void setCell(GridType& grid, const Cell& cell, int value) { grid.set(cell.row, cell.col, value); }
+    void setCell(NestedMaps& grid, const Cell& cell, int value) { grid[cell.row][cell.col] = value; }
+
+    template <typename GridType>
+    int getCell(const GridType& grid, const Cell& cell) { return grid.get(cell.row, cell.col); }
+    /* A const Map hands back a copy of the row, as it did for the old SparseGrid::get. */
+    int getCell(const NestedMaps& grid, const Cell& cell) {
+        if (!grid.containsKey(cell.row)) return 0;
+        return grid[cell.row].get(cell.col);
+    }
+
+    template <typename GridType> long sumCells(const GridType& grid) {
+        long sum = 0;
+        grid.mapAll([&](int value) { sum += value; });
+        return sum;
+    }
+    long sumCells(const NestedMaps& grid) {
+        long sum = 0;
+        grid.mapAll([&](int, const Map<int, int>& row) {
+            row.mapAll([&](int, int value) { sum += value; });
+        });
+        return sum;
+    }
+
+    /* Prints an extra line under a row. */
+    void printDetail(ostream& out, const string& label, double value) {
+        out << setw(36) << left << label << right << setw(12) << fixed
+            << setprecision(1) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds runs of a workload, each after running setup untimed, and prints a row
+     * and the time per cell.
+     */
+    void runWorkload(ostream& out, const string& label,
+                     const function<void ()>& setup, const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            setup();
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printDetail(out, "  (ns/cell)", summary.p50 * 1000 / kCells);
+    }
+
+    template <typename GridType>
+    void fill(GridType& grid, const vector<Cell>& cells) {
+        for (size_t i = 0; i < kCells; i++) setCell(grid, cells[i], 1);
+    }
+
+    template <typename GridType>
+    void runGrid(ostream& out, const string& name, const vector<Cell>& cells) {
+        vector<Cell> probes = probeOrder(cells);
+        vector<Cell> misses = missingCells(probes);
+        GridType grid;
+        auto clear = [&] { grid = GridType(); makeGrid(grid); };
+        auto refill = [&] { if (sumCells(grid) != long(kCells)) { clear(); fill(grid, cells); } };
+
+        runWorkload(out, name + " set", clear, [&] { fill(grid, cells); });
+
+        runWorkload(out, name + " get", refill, [&] {
+            long sum = 0;
+            for (size_t i = 0; i < kCells; i++) sum += getCell(grid, probes[i]);
+            if (sum != long(kCells)) error(name + " lost cells.");
+        });
+
+        runWorkload(out, name + " get unset", refill, [&] {
+            long sum = 0;
+            for (size_t i = 0; i < kCells; i++) sum += getCell(grid, misses[i]);
+            if (sum != 0) error(name + " found cells that were never set.");
+        });
+
+        runWorkload(out, name + " mapAll", refill, [&] {
+            if (sumCells(grid) != long(kCells)) error(name + " gave the wrong sum.");
+        });
+
+        long before = heapInUse();
+        GridType measured;
+        makeGrid(measured);
+        fill(measured, cells);
+        long after = heapInUse();
+        if (before >= 0) printDetail(out, "  (bytes/cell)", double(after - before) / kCells);
+    }
+
+    void runAll(ostream& out, const string& title, const vector<Cell>& cells) {
+        printHeader(out, to_string(kCells) + " " + title + " cells (per pass)");
+        runGrid<NestedMaps>(out, "Map of Maps", cells);
+        runGrid<SparseGrid<int>>(out, "SparseGrid (hashed)", cells);
+        runGrid<SparseGrid<int, TiledCells>>(out, "SparseGrid (tiled)", cells);
+    }
+}
+
+BENCHMARK(sparseGrid) {
+    runAll(out, "scattered", scatteredCells());
+    runAll(out, "clustered", clusteredCells());
+}
@@ -0,0 +1,78 @@
+/* Scaling benchmark for the tiled star renderer (see StarRenderer.h): one very large star is
+ * drawn on one thread with renderScene, then with renderSceneTiled on thread pools of 1, 2,
+ * 4, ... workers up to the number of cores. Every tiled image is checked against the
+ * single-threaded one, since the renderer promises the same output for any number of threads.
+ */
+#include "Benchmark.h"
+#include "StarRenderer.h"
+#include "error.h"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace {
+    /* A star with tens of thousands of long edges, in an image large enough for many tiles. */
+    const StarType kStar = { 20000, 7001 };
+    const int kSize = 1000;
+
+    /* How many times to draw the star each way. */
+    const size_t kRounds = 3;
+
+    const uint32_t kBackground = Raster::kOpaque | 0xFFFFFF;
+
+    /* Thread counts to try: powers of two up to the number of cores, and the number of cores. */
+    vector<int> threadCounts() {
+        int cores = max(1, int(thread::hardware_concurrency()));
+        vector<int> result;
+        for (int count = 1; count < cores; count *= 2) {
+            result.push_back(count);
+        }
+        result.push_back(cores);
+        return result;
+    }
+
+    Summary timeRendering(Raster& raster, function<void ()> render) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            raster.fill(kBackground);
+            render();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+        return summarize(latencies, total.elapsedSeconds());
+    }
+}
+
+BENCHMARK(tiledRenderScaling) {
+    StarScene scene = sceneFor(kStar, kSize, kSize);
+
+    ostringstream title;
+    title << "render " << kStar << " (" << scene.size() << " strokes)";
+    printHeader(out, title.str());
+
+    Raster expected(kSize, kSize);
+    printRow(out, "renderScene, 1 thread", timeRendering(expected, [&] {
+        renderScene(scene, expected);
+    }));
+
+    for (int threads: threadCounts()) {
+        ThreadPool pool(threads);
+        Raster raster(kSize, kSize);
+        ostringstream label;
+        label << "renderSceneTiled, " << threads << (threads == 1? " thread" : " threads");
+        printRow(out, label.str(), timeRendering(raster, [&] {
+            renderSceneTiled(scene, raster, pool);
+        }));
+
+        ThreadPoolStats stats = pool.getStats();
+        out << "  " << stats.tasksRun << " tiles drawn, " << stats.steals << " stolen, "
+            << stats.idleSeconds << "s idle" << endl;
+
+        if (!equal(raster.data(), raster.data() + kSize * kSize, expected.data())) {
+            error("Tiled rendering with " + to_string(threads) + " threads changed the image.");
+        }
+    }
+}
@@ -0,0 +1,220 @@
+/* Benchmarks for building many short Vectors and SmallVectors, the way a tokenizer builds
+ * token lists or a shape builds its list of points, against std::vector doing the same.
+ *
+ * Each workload builds kVectors vectors of between kMinLength and kMaxLength elements,
+ * one element at a time, and reads them back: token lists of short strings, and point
+ * lists of pairs of ints. A Vector keeps as many elements as fit in 64 bytes inside the
+ * object itself (all eight points, but only two strings), and a SmallVector<T, kInline>
+ * keeps its first kInline elements there, so a short enough one never touches the heap; a
+ * std::vector allocates as soon as it has an element, and again every time it doubles.
+ * The growth workload adds kLength long strings to a single vector, which is where moving
+ * the elements rather than copying them on growth shows. The self-append workload does the
+ * same, but moves each string out of the vector's own last element, so that on every growth
+ * the value being added lives in the array that growth frees; it checks that the string
+ * reaches the end intact. Each row is one pass, and the line under it is the median time
+ * per vector (or per element, for growth). Where the C
+ * library can say how much of the heap is in use, the bytes per vector of a batch kept
+ * alive are printed too; that includes the vector objects themselves, since they're kept
+ * in an array.
+ */
+#include "Benchmark.h"
+#include "error.h"
+#include "vector.h"
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+using namespace std;
+
+namespace {
+    /* How many vectors to build, how long they are, and how many times to run each workload. */
+    const int    kVectors   = 200000;
+    const int    kMinLength = 2;
+    const int    kMaxLength = 8;
+    const size_t kRounds    = 7;
+
+    /* How many elements a SmallVector keeps inline: enough for the longest vectors here. */
+    const int kInline = kMaxLength;
+
+    /* How many strings the growth workload adds, and how long each one is. */
+    const int kLength       = 1000000;
+    const int kStringLength = 40;
+
+    /* A point in a point list. */
+    struct Point {
+        int x;
+        int y;
+    };
+
+    /* A cheap, repeatable stream of pseudorandom numbers. */
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /* The length of each vector, and the words the token lists are made of. */
+    vector<int> makeLengths() {
+        uint32_t state = 2463534242u;
+        vector<int> result;
+        for (int i = 0; i < kVectors; i++) {
+            result.push_back(kMinLength + int(nextRandom(state) % (kMaxLength - kMinLength + 1)));
+        }
+        return result;
+    }
+
+    const vector<string> kWords = { "star", "points", "radius", "angle", "fill", "x", "y", "=", "(", ")" };
+
+    /* Bytes of heap in use, or -1 if the C library can't say. */
+    long heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+        struct mallinfo2 info = mallinfo2();
+        return long(info.uordblks + info.hblkhd);
+#else
+        return -1;
+#endif
+    }
+
+    /* The same workloads for either kind of vector. */
+    template <typename VectorType>
+    void buildTokens(vector<VectorType>& lists, const vector<int>& lengths) {
+        for (int i = 0; i < kVectors; i++) {
+            VectorType tokens;
+            for (int j = 0; j < lengths[i]; j++) {
+                tokens.push_back(kWords[(i + j) % kWords.size()]);
+            }
+            lists.push_back(std::move(tokens));
+        }
+    }
+
+    template <typename VectorType>
+    void buildPoints(vector<VectorType>& lists, const vector<int>& lengths) {
+        for (int i = 0; i < kVectors; i++) {
+            VectorType points;
+            for (int j = 0; j < lengths[i]; j++) {
+                points.push_back(Point{ i, j });
+            }
+            lists.push_back(std::move(points));
+        }
+    }
+
+    template <typename VectorType> long countTokens(const vector<VectorType>& lists) {
+        long total = 0;
+        for (const VectorType& tokens : lists) {
+            for (const string& token : tokens) total += long(token.size());
+        }
+        return total;
+    }
+
+    template <typename VectorType> long sumPoints(const vector<VectorType>& lists) {
+        long total = 0;
+        for (const VectorType& points : lists) {
+            for (const Point& point : points) total += point.y;
+        }
+        return total;
+    }
+
+    /* Prints an extra line under a row. */
+    void printDetail(ostream& out, const string& label, double value) {
+        out << setw(36) << left << label << right << setw(12) << fixed
+            << setprecision(1) << value << endl;
+        out.unsetf(ios::floatfield);
+    }
+
+    /* Times kRounds runs of a workload and prints a row and the time per item. */
+    void runWorkload(ostream& out, const string& label, const string& unit, long items,
+                     const function<void ()>& workload) {
+        vector<double> latencies;
+        Stopwatch total;
+        for (size_t round = 0; round < kRounds; round++) {
+            Stopwatch timer;
+            workload();
+            latencies.push_back(timer.elapsedMicroseconds());
+        }
+
+        Summary summary = summarize(latencies, total.elapsedSeconds());
+        printRow(out, label, summary);
+        printDetail(out, "  (ns/" + unit + ")", summary.p50 * 1000 / items);
+    }
+
+    /* Builds and reads back token lists and point lists of one kind of vector. */
+    template <typename TokenList, typename PointList>
+    void runShort(ostream& out, const string& name, const vector<int>& lengths) {
+        long expectedTokens = 0;
+        long expectedPoints = 0;
+        {
+            vector<std::vector<string>> tokens;
+            buildTokens(tokens, lengths);
+            expectedTokens = countTokens(tokens);
+            vector<std::vector<Point>> points;
+            buildPoints(points, lengths);
+            expectedPoints = sumPoints(points);
+        }
+
+        runWorkload(out, name + " token lists", "vector", kVectors, [&] {
+            vector<TokenList> lists;
+            lists.reserve(kVectors);
+            buildTokens(lists, lengths);
+            if (countTokens(lists) != expectedTokens) error(name + " lost tokens.");
+        });
+        runWorkload(out, name + " point lists", "vector", kVectors, [&] {
+            vector<PointList> lists;
+            lists.reserve(kVectors);
+            buildPoints(lists, lengths);
+            if (sumPoints(lists) != expectedPoints) error(name + " lost points.");
+        });
+
+        long before = heapInUse();
+        vector<PointList> kept;
+        kept.reserve(kVectors);
+        buildPoints(kept, lengths);
+        long after = heapInUse();
+        if (before >= 0) printDetail(out, "  (point list bytes/vector)", double(after - before) / kVectors);
+    }
+
+    /* Adds kLength long strings to one vector. */
+    template <typename VectorType>
+    void runGrowth(ostream& out, const string& name) {
+        const string value(kStringLength, '*');
+        runWorkload(out, name + " growth", "element", kLength, [&] {
+            VectorType strings;
+            for (int i = 0; i < kLength; i++) strings.push_back(value);
+            if (int(strings.size()) != kLength) error(name + " lost strings.");
+        });
+    }
+
+    /* Adds kLength strings to one vector, each moved out of the vector's last element. */
+    template <typename VectorType>
+    void runSelfAppend(ostream& out, const string& name) {
+        const string value(kStringLength, '*');
+        runWorkload(out, name + " self-append", "element", kLength, [&] {
+            VectorType strings;
+            strings.push_back(value);
+            for (int i = 1; i < kLength; i++) strings.push_back(std::move(strings.back()));
+            if (int(strings.size()) != kLength || strings.back() != value) {
+                error(name + " lost the string it appended from itself.");
+            }
+        });
+    }
+}
+
+BENCHMARK(shortVectors) {
+    vector<int> lengths = makeLengths();
+    printHeader(out, to_string(kVectors) + " vectors of " + to_string(kMinLength) + " to "
+                + to_string(kMaxLength) + " elements (per pass)");
+    runShort<std::vector<string>, std::vector<Point>>(out, "std::vector", lengths);
+    runShort<Vector<string>, Vector<Point>>(out, "Vector", lengths);
+    runShort<SmallVector<string, kInline>, SmallVector<Point, kInline>>(out, "SmallVector", lengths);
+
+    printHeader(out, to_string(kLength) + " strings of " + to_string(kStringLength)
+                + " characters in one vector (per pass)");
+    runGrowth<std::vector<string>>(out, "std::vector");
+    runGrowth<Vector<string>>(out, "Vector");
+    runSelfAppend<std::vector<string>>(out, "std::vector");
+    runSelfAppend<Vector<string>>(out, "Vector");
+    runSelfAppend<SmallVector<string, kInline>>(out, "SmallVector");
+}
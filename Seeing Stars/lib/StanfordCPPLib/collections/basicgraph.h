@@ -10,6 +10,9 @@
  * See BasicGraph.cpp for implementation of some non-template members.
  *
  * @author Marty Stepp
+ * @version 2026/10/19
+ * - added freeze and FrozenGraph, a compact read-only snapshot of a graph
+ *   with breadth-first, depth-first and Dijkstra traversals
  * @version 2018/03/10
  * - added methods front, back, toMap
  * - added operator << for various collections of Vertex* and Edge*
@@ -68,13 +71,20 @@
 #ifndef _basicgraph_h
 #define _basicgraph_h
 
+#include <algorithm>
+#include <functional>
 #include <initializer_list>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
+#include "collections.h"
+#include "error.h"
 #include "gmath.h"
 #include "graph.h"
 #include "grid.h"
+#include "hashmap.h"
 #include "hashset.h"
 #include "linkedlist.h"
 #include "observable.h"
@@ -88,6 +98,9 @@
 template <typename V = void*, typename E = void*>
 class EdgeGen;
 
+template <typename V, typename E>
+class FrozenGraphGen;
+
 /*
  * Canonical Vertex (Node) structure implementation needed by Graph class template.
  * Each Vertex structure represents a single vertex in the graph.
@@ -332,10 +345,302 @@ public:
     VertexGen<V, E>* operator [](const std::string& name);
     const VertexGen<V, E>* operator [](const std::string& name) const;
 
+    /*
+     * Method: freeze
+     * Usage: FrozenGraph frozen = graph.freeze();
+     * -------------------------------------------
+     * Returns a read-only snapshot of the graph as it is now, laid out in
+     * flat arrays so that searching it is much faster than searching the
+     * graph itself.  See <code>FrozenGraphGen</code> below.  The snapshot
+     * goes out of date as soon as a vertex or edge is added to or removed
+     * from the graph; freeze the graph again to get a new one.
+     */
+    FrozenGraphGen<V, E> freeze() const;
+
 private:
     bool m_resetEnabled;
 };
 
+/*
+ * Class: FrozenGraphGen<V, E>
+ * ---------------------------
+ * A read-only snapshot of a BasicGraph in compressed sparse row form.
+ * Each vertex has an index from 0 to vertexCount() - 1, in the order the
+ * graph's vertex set lists them, and the edges leaving vertex i are the
+ * indexes edgeBegin(i) up to but not including edgeEnd(i), again in the
+ * graph's order.  The vertices, the edge targets and the edge weights each
+ * sit in one array, so a search walks memory in order instead of chasing
+ * pointers from one set node to the next.
+ *
+ * The snapshot copies each edge's cost when it is made, and does not see
+ * later changes to the cost fields.  It must not outlive its graph.
+ *
+ *<pre>
+ *    FrozenGraph frozen = graph.freeze();
+ *    for (Vertex* v : frozen.bfs("a")) {
+ *        cout << v->name << endl;
+ *    }
+ *    FrozenGraph::Traversal paths = frozen.dijkstra("a");
+ *    for (auto it = paths.begin(); it != paths.end(); ++it) {
+ *        cout << (*it)->name << " is " << it.distance() << " away" << endl;
+ *    }
+ *</pre>
+ */
+template <typename V, typename E>
+class FrozenGraphGen {
+public:
+    class Traversal;
+
+    /*
+     * Constructor: FrozenGraphGen
+     * Usage: FrozenGraph frozen;
+     * --------------------------
+     * Creates an empty snapshot that belongs to no graph.  Use
+     * <code>graph.freeze()</code> to make a useful one.
+     */
+    FrozenGraphGen();
+
+    /*
+     * Methods: bfs, dfs, dijkstra
+     * Usage: for (Vertex* v : frozen.bfs(start)) ...
+     *        for (Vertex* v : frozen.dfs(start)) ...
+     *        for (Vertex* v : frozen.dijkstra(start)) ...
+     * -----------------------------------------------
+     * Returns a single-pass range over the vertices reachable from the
+     * start vertex, in breadth-first order, in depth-first (preorder)
+     * order, or in order of their shortest-path distance from the start.
+     * The range's iterators also report each vertex's distance from the
+     * start and the vertex before it on the way there.  Throws an error if
+     * the start vertex is not in the snapshot or the graph has changed
+     * since it was frozen, and <code>dijkstra</code> throws one if any edge
+     * has a negative weight.
+     */
+    Traversal bfs(VertexGen<V, E>* start) const;
+    Traversal bfs(const std::string& start) const;
+    Traversal dfs(VertexGen<V, E>* start) const;
+    Traversal dfs(const std::string& start) const;
+    Traversal dijkstra(VertexGen<V, E>* start) const;
+    Traversal dijkstra(const std::string& start) const;
+
+    /*
+     * Methods: edgeBegin, edgeEnd
+     * Usage: for (int e = frozen.edgeBegin(i); e < frozen.edgeEnd(i); e++) ...
+     * ------------------------------------------------------------------------
+     * Returns the index of the first edge leaving the vertex with the given
+     * index, and one past the index of its last edge.
+     */
+    int edgeBegin(int index) const;
+    int edgeEnd(int index) const;
+
+    /*
+     * Method: edgeCount
+     * Usage: int m = frozen.edgeCount();
+     * ----------------------------------
+     * Returns the number of edges in the snapshot.
+     */
+    int edgeCount() const;
+
+    /*
+     * Methods: edgeTarget, edgeWeight
+     * Usage: int j = frozen.edgeTarget(e);
+     *        double w = frozen.edgeWeight(e);
+     * ---------------------------------------
+     * Returns the index of the vertex the edge with the given index leads
+     * to, or the edge's cost when the graph was frozen.
+     */
+    int edgeTarget(int edge) const;
+    double edgeWeight(int edge) const;
+
+    /*
+     * Methods: getEdge, getVertex
+     * Usage: Edge* edge = frozen.getEdge(e);
+     *        Vertex* v = frozen.getVertex(i);
+     * ---------------------------------------
+     * Returns the graph's edge or vertex with the given index.
+     */
+    EdgeGen<V, E>* getEdge(int edge) const;
+    VertexGen<V, E>* getVertex(int index) const;
+
+    /*
+     * Method: indexOf
+     * Usage: int i = frozen.indexOf(v);
+     * ---------------------------------
+     * Returns the index of the given vertex, or -1 if it is not in the
+     * snapshot.
+     */
+    int indexOf(VertexGen<V, E>* v) const;
+    int indexOf(const std::string& name) const;
+
+    /*
+     * Method: isCurrent
+     * Usage: if (frozen.isCurrent()) ...
+     * ----------------------------------
+     * Returns <code>true</code> if no vertex or edge has been added to or
+     * removed from the graph since the snapshot was made.
+     */
+    bool isCurrent() const;
+
+    /*
+     * Method: vertexCount
+     * Usage: int n = frozen.vertexCount();
+     * ------------------------------------
+     * Returns the number of vertices in the snapshot.
+     */
+    int vertexCount() const;
+
+    /*
+     * Class: Traversal
+     * ----------------
+     * A search of the snapshot from one start vertex.  The search runs a
+     * step each time its iterator is advanced, so a loop that stops early
+     * does no more work than it needs.  A traversal can be walked once;
+     * all iterators from the same traversal share its progress.  It reads
+     * from its snapshot as it goes, so keep the snapshot in a variable:
+     * <code>for (Vertex* v : graph.freeze().bfs(start))</code> would search
+     * a snapshot that is already gone.
+     */
+    class Traversal {
+    public:
+        class iterator : public std::iterator<std::input_iterator_tag, VertexGen<V, E>*> {
+        public:
+            iterator() : m_traversal(nullptr), itr_version(0) {
+                // empty
+            }
+
+            iterator& operator ++() {
+                stanfordcpplib::collections::checkVersion(*m_traversal->m_frozen->m_graph, *this);
+                m_traversal->advance();
+                return *this;
+            }
+
+            iterator operator ++(int) {
+                iterator copy(*this);
+                operator++();
+                return copy;
+            }
+
+            bool operator ==(const iterator& rhs) const {
+                return atEnd() == rhs.atEnd();
+            }
+
+            bool operator !=(const iterator& rhs) const {
+                return !(*this == rhs);
+            }
+
+            VertexGen<V, E>* operator *() const {
+                stanfordcpplib::collections::checkVersion(*m_traversal->m_frozen->m_graph, *this);
+                return m_traversal->m_frozen->m_vertices[m_traversal->m_current];
+            }
+
+            /*
+             * Returns the current vertex's distance from the start: the number
+             * of edges on the way there for bfs and dfs, or the total weight
+             * of the shortest path for dijkstra.
+             */
+            double distance() const {
+                return m_traversal->m_distance[m_traversal->m_current];
+            }
+
+            /*
+             * Returns the index of the current vertex in the snapshot.
+             */
+            int index() const {
+                return m_traversal->m_current;
+            }
+
+            /*
+             * Returns the vertex the search reached the current one from, or
+             * nullptr for the start vertex.
+             */
+            VertexGen<V, E>* previous() const {
+                int prev = m_traversal->m_previous[m_traversal->m_current];
+                return prev < 0 ? nullptr : m_traversal->m_frozen->m_vertices[prev];
+            }
+
+            unsigned int version() const {
+                return itr_version;
+            }
+
+        private:
+            Traversal* m_traversal;
+            unsigned int itr_version;
+
+            iterator(Traversal* traversal)
+                    : m_traversal(traversal),
+                      itr_version(traversal->m_frozen->m_version) {
+                // empty
+            }
+
+            bool atEnd() const {
+                return !m_traversal || m_traversal->m_current < 0;
+            }
+
+            friend class Traversal;
+        };
+
+        iterator begin() {
+            return iterator(this);
+        }
+
+        iterator end() {
+            return iterator();
+        }
+
+    private:
+        /* The kinds of search */
+        enum Order { BREADTH_FIRST, DEPTH_FIRST, SHORTEST_PATH };
+
+        /* An entry in the Dijkstra frontier, ordered so the nearest comes out first */
+        typedef std::pair<double, int> Entry;
+
+        /* Instance variables */
+        const FrozenGraphGen* m_frozen;
+        Order m_order;
+        int m_current;                      // index of the current vertex, or -1 when done
+        std::vector<double> m_distance;     // distance from the start, for each vertex
+        std::vector<int> m_previous;        // index of the vertex before it, or -1
+        std::vector<bool> m_reached;        // whether the search has reached each vertex
+        std::vector<int> m_pending;         // bfs queue, or dfs stack of vertex indexes
+        std::vector<int> m_nextEdge;        // dfs: next edge to follow from each vertex
+        std::vector<Entry> m_heap;          // dijkstra: min-heap of tentative distances
+        std::size_t m_queueHead;            // bfs: index of the front of the queue
+
+        /* Private methods */
+        Traversal(const FrozenGraphGen* frozen, Order order, int start);
+        void advance();
+        void advanceBreadthFirst();
+        void advanceDepthFirst();
+        void advanceShortestPath();
+
+        friend class FrozenGraphGen;
+    };
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    /* Instance variables */
+    const BasicGraphGen<V, E>* m_graph;     // graph the snapshot was made from
+    unsigned int m_version;                 // the graph's version at the time
+    std::vector<VertexGen<V, E>*> m_vertices;
+    std::vector<int> m_offsets;             // edges of vertex i are [m_offsets[i], m_offsets[i+1])
+    std::vector<int> m_targets;             // target vertex index of each edge
+    std::vector<double> m_weights;          // cost of each edge
+    std::vector<EdgeGen<V, E>*> m_edges;
+    HashMap<VertexGen<V, E>*, int> m_indexes;   // each vertex's index plus one; 0 if absent
+    bool m_negativeWeights;                 // whether any edge cost is negative
+
+    /* Private methods */
+    explicit FrozenGraphGen(const BasicGraphGen<V, E>& graph);
+    int checkStart(int index, const std::string& member) const;
+
+    friend class BasicGraphGen<V, E>;
+};
+
 /*
  * Hash function for BasicGraphGen.
  */
@@ -373,6 +678,11 @@ typedef EdgeGen<void*, void*> Edge;
 typedef BasicGraphGen<void*, void*> BasicGraph;
 #define BasicGraphV BasicGraphGen
 
+/*
+ * Defines a FrozenGraph to be a snapshot of a BasicGraph.
+ */
+typedef FrozenGraphGen<void*, void*> FrozenGraph;
+
 /*
  * Hash function for BasicGraph.
  */
@@ -839,6 +1149,11 @@ const VertexGen<V, E>* BasicGraphGen<V, E>::operator [](const std::string& name)
     return this->getVertex(name);
 }
 
+template <typename V, typename E>
+FrozenGraphGen<V, E> BasicGraphGen<V, E>::freeze() const {
+    return FrozenGraphGen<V, E>(*this);
+}
+
 template <typename V, typename E>
 void BasicGraphGen<V, E>::scanArcData(TokenScanner& scanner, EdgeGen<V, E>* edge, EdgeGen<V, E>* inverse) {
     std::string colon = scanner.nextToken();   // ":", skip over
@@ -876,6 +1191,272 @@ int hashCode(const BasicGraphGen<V, E>& graph) {
     return (code & hashMask());
 }
 
+
+/*
+ * FrozenGraph member implementations
+ */
+template <typename V, typename E>
+FrozenGraphGen<V, E>::FrozenGraphGen()
+        : m_graph(nullptr),
+          m_version(0),
+          m_offsets(1, 0),
+          m_negativeWeights(false) {
+    // empty
+}
+
+/*
+ * Implementation notes: FrozenGraphGen constructor
+ * ------------------------------------------------
+ * The first pass numbers the vertices, so that the second can turn each
+ * edge's finish vertex into an index as it lays the edges out vertex by
+ * vertex.
+ */
+template <typename V, typename E>
+FrozenGraphGen<V, E>::FrozenGraphGen(const BasicGraphGen<V, E>& graph)
+        : m_graph(&graph),
+          m_version(graph.version()),
+          m_negativeWeights(false) {
+    int vertexCount = graph.vertexCount();
+    int edgeCount = graph.edgeCount();
+    m_vertices.reserve(vertexCount);
+    m_offsets.reserve(vertexCount + 1);
+    m_targets.reserve(edgeCount);
+    m_weights.reserve(edgeCount);
+    m_edges.reserve(edgeCount);
+
+    for (VertexGen<V, E>* v : graph.getVertexSet()) {
+        m_vertices.push_back(v);
+        m_indexes.put(v, int(m_vertices.size()));
+    }
+    for (VertexGen<V, E>* v : m_vertices) {
+        m_offsets.push_back(int(m_targets.size()));
+        for (EdgeGen<V, E>* edge : v->arcs) {
+            m_targets.push_back(m_indexes.get(edge->finish) - 1);
+            m_weights.push_back(edge->cost);
+            m_edges.push_back(edge);
+            if (edge->cost < 0) {
+                m_negativeWeights = true;
+            }
+        }
+    }
+    m_offsets.push_back(int(m_targets.size()));
+}
+
+template <typename V, typename E>
+typename FrozenGraphGen<V, E>::Traversal FrozenGraphGen<V, E>::bfs(VertexGen<V, E>* start) const {
+    return Traversal(this, Traversal::BREADTH_FIRST, checkStart(indexOf(start), "bfs"));
+}
+
+template <typename V, typename E>
+typename FrozenGraphGen<V, E>::Traversal FrozenGraphGen<V, E>::bfs(const std::string& start) const {
+    return Traversal(this, Traversal::BREADTH_FIRST, checkStart(indexOf(start), "bfs"));
+}
+
+template <typename V, typename E>
+typename FrozenGraphGen<V, E>::Traversal FrozenGraphGen<V, E>::dfs(VertexGen<V, E>* start) const {
+    return Traversal(this, Traversal::DEPTH_FIRST, checkStart(indexOf(start), "dfs"));
+}
+
+template <typename V, typename E>
+typename FrozenGraphGen<V, E>::Traversal FrozenGraphGen<V, E>::dfs(const std::string& start) const {
+    return Traversal(this, Traversal::DEPTH_FIRST, checkStart(indexOf(start), "dfs"));
+}
+
+template <typename V, typename E>
+typename FrozenGraphGen<V, E>::Traversal FrozenGraphGen<V, E>::dijkstra(VertexGen<V, E>* start) const {
+    return Traversal(this, Traversal::SHORTEST_PATH, checkStart(indexOf(start), "dijkstra"));
+}
+
+template <typename V, typename E>
+typename FrozenGraphGen<V, E>::Traversal FrozenGraphGen<V, E>::dijkstra(const std::string& start) const {
+    return Traversal(this, Traversal::SHORTEST_PATH, checkStart(indexOf(start), "dijkstra"));
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::edgeBegin(int index) const {
+    return m_offsets[index];
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::edgeEnd(int index) const {
+    return m_offsets[index + 1];
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::edgeCount() const {
+    return int(m_targets.size());
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::edgeTarget(int edge) const {
+    return m_targets[edge];
+}
+
+template <typename V, typename E>
+double FrozenGraphGen<V, E>::edgeWeight(int edge) const {
+    return m_weights[edge];
+}
+
+template <typename V, typename E>
+EdgeGen<V, E>* FrozenGraphGen<V, E>::getEdge(int edge) const {
+    return m_edges[edge];
+}
+
+template <typename V, typename E>
+VertexGen<V, E>* FrozenGraphGen<V, E>::getVertex(int index) const {
+    return m_vertices[index];
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::indexOf(VertexGen<V, E>* v) const {
+    return m_indexes.get(v) - 1;
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::indexOf(const std::string& name) const {
+    return m_graph ? indexOf(m_graph->getVertex(name)) : -1;
+}
+
+template <typename V, typename E>
+bool FrozenGraphGen<V, E>::isCurrent() const {
+    return m_graph && m_graph->version() == m_version;
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::vertexCount() const {
+    return int(m_vertices.size());
+}
+
+template <typename V, typename E>
+int FrozenGraphGen<V, E>::checkStart(int index, const std::string& member) const {
+    if (!isCurrent()) {
+        error("FrozenGraph::" + member + ": the graph has changed since it was frozen");
+    }
+    if (index < 0) {
+        error("FrozenGraph::" + member + ": start vertex is not in the graph");
+    }
+    if (member == "dijkstra" && m_negativeWeights) {
+        error("FrozenGraph::dijkstra: the graph has an edge with negative weight");
+    }
+    return index;
+}
+
+/*
+ * Implementation notes: Traversal
+ * -------------------------------
+ * Each kind of search keeps the current vertex until the iterator moves
+ * past it, and only then follows its edges; the start vertex is current
+ * as soon as the traversal is made.  Breadth-first search reaches each
+ * vertex once and queues it; depth-first search keeps a stack of the
+ * vertices on the path down from the start, with how far along its edges
+ * each one has got, so that it visits vertices in the same order as the
+ * recursive version would.  Dijkstra's algorithm keeps a heap of
+ * tentative distances and skips the stale entries left behind when a
+ * vertex's distance improves, which is cheaper than updating the heap in
+ * place.
+ */
+template <typename V, typename E>
+FrozenGraphGen<V, E>::Traversal::Traversal(const FrozenGraphGen* frozen, Order order, int start)
+        : m_frozen(frozen),
+          m_order(order),
+          m_current(start),
+          m_distance(frozen->m_vertices.size(), std::numeric_limits<double>::infinity()),
+          m_previous(frozen->m_vertices.size(), -1),
+          m_reached(frozen->m_vertices.size(), false),
+          m_queueHead(0) {
+    m_distance[start] = 0;
+    m_reached[start] = true;
+    if (order == BREADTH_FIRST) {
+        m_pending.push_back(start);
+    } else if (order == DEPTH_FIRST) {
+        m_nextEdge.assign(frozen->m_offsets.begin(), frozen->m_offsets.end() - 1);
+        m_pending.push_back(start);
+    }
+}
+
+template <typename V, typename E>
+void FrozenGraphGen<V, E>::Traversal::advance() {
+    if (m_current < 0) {
+        return;
+    }
+    if (m_order == BREADTH_FIRST) {
+        advanceBreadthFirst();
+    } else if (m_order == DEPTH_FIRST) {
+        advanceDepthFirst();
+    } else {
+        advanceShortestPath();
+    }
+}
+
+template <typename V, typename E>
+void FrozenGraphGen<V, E>::Traversal::advanceBreadthFirst() {
+    const int* targets = m_frozen->m_targets.data();
+    int from = m_current;
+    for (int e = m_frozen->m_offsets[from], end = m_frozen->m_offsets[from + 1]; e < end; e++) {
+        int to = targets[e];
+        if (!m_reached[to]) {
+            m_reached[to] = true;
+            m_distance[to] = m_distance[from] + 1;
+            m_previous[to] = from;
+            m_pending.push_back(to);
+        }
+    }
+    m_queueHead++;
+    m_current = m_queueHead < m_pending.size() ? m_pending[m_queueHead] : -1;
+}
+
+template <typename V, typename E>
+void FrozenGraphGen<V, E>::Traversal::advanceDepthFirst() {
+    const int* targets = m_frozen->m_targets.data();
+    while (!m_pending.empty()) {
+        int from = m_pending.back();
+        int end = m_frozen->m_offsets[from + 1];
+        while (m_nextEdge[from] < end) {
+            int to = targets[m_nextEdge[from]++];
+            if (!m_reached[to]) {
+                m_reached[to] = true;
+                m_distance[to] = m_distance[from] + 1;
+                m_previous[to] = from;
+                m_pending.push_back(to);
+                m_current = to;
+                return;
+            }
+        }
+        m_pending.pop_back();
+    }
+    m_current = -1;
+}
+
+template <typename V, typename E>
+void FrozenGraphGen<V, E>::Traversal::advanceShortestPath() {
+    const int* targets = m_frozen->m_targets.data();
+    const double* weights = m_frozen->m_weights.data();
+    int from = m_current;
+    for (int e = m_frozen->m_offsets[from], end = m_frozen->m_offsets[from + 1]; e < end; e++) {
+        int to = targets[e];
+        double distance = m_distance[from] + weights[e];
+        if (!m_reached[to] && distance < m_distance[to]) {
+            m_distance[to] = distance;
+            m_previous[to] = from;
+            m_heap.push_back(Entry(distance, to));
+            std::push_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+        }
+    }
+
+    // m_reached marks the vertices whose distances are final
+    m_current = -1;
+    while (!m_heap.empty()) {
+        Entry nearest = m_heap.front();
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+        m_heap.pop_back();
+        if (!m_reached[nearest.second]) {
+            m_reached[nearest.second] = true;
+            m_current = nearest.second;
+            break;
+        }
+    }
+}
+
 /*
  * Overloaded operator to print a set of edge pointers.
  * Normally it is unwise to override operators for printing pointers,
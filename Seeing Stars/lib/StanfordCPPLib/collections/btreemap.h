@@ -0,0 +1,1283 @@
+/*
+ * File: btreemap.h
+ * ----------------
+ * This file exports the template class <code>BTreeMap</code>, which
+ * maintains a collection of <i>key</i>-<i>value</i> pairs in the same
+ * order as a <code>Map</code>, using a B+ tree instead of a binary tree.
+ *
+ * A <code>BTreeMap</code> can stand in for a <code>Map</code> whose key type
+ * has a <code>&lt;</code> operator.  It keeps many keys side by side in each
+ * node, so looking up a key in a large map touches a handful of nodes rather
+ * than one node per level of a binary tree, and walking the map in order is
+ * a walk along arrays.  It also answers range queries: see
+ * <code>lowerBound</code>, <code>upperBound</code> and <code>mapRange</code>.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#ifndef _btreemap_h
+#define _btreemap_h
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <sstream>
+#include <utility>
+#include "collections.h"
+#include "error.h"
+#include "hashcode.h"
+#include "vector.h"
+
+namespace stanfordcpplib {
+namespace collections {
+
+/*
+ * Returns how many entries of the given size a B-tree node holds: as many as
+ * fit in about 1KB, but never fewer than 16 or more than 64.
+ */
+constexpr int btreeNodeCapacity(std::size_t entryBytes) {
+    return entryBytes * 64 <= 1024 ? 64
+         : entryBytes * 16 >= 1024 ? 16
+         : int(1024 / entryBytes);
+}
+
+} // namespace collections
+} // namespace stanfordcpplib
+
+/*
+ * Class: BTreeMap<KeyType,ValueType>
+ * ----------------------------------
+ * This class maintains an association between <b><i>keys</i></b> and
+ * <b><i>values</i></b>, ordered by the <code>&lt;</code> operator on keys.
+ * Its interface matches the commonly used parts of <code>Map</code>'s.
+ */
+template <typename KeyType, typename ValueType>
+class BTreeMap {
+public:
+    /* Forward declaration */
+    class iterator;
+
+    /*
+     * Constructor: BTreeMap
+     * Usage: BTreeMap<KeyType,ValueType> map;
+     * ---------------------------------------
+     * Initializes a new empty map that associates keys and values of the
+     * specified types.
+     */
+    BTreeMap();
+
+    /*
+     * Constructor: BTreeMap
+     * Usage: BTreeMap<KeyType,ValueType> map {{"a", 1}, {"b", 2}, {"c", 3}};
+     * ----------------------------------------------------------------------
+     * Initializes a new map that stores the given pairs.
+     */
+    BTreeMap(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Destructor: ~BTreeMap
+     * ---------------------
+     * Frees any heap storage associated with this map.
+     */
+    virtual ~BTreeMap();
+
+    /*
+     * Method: add
+     * Usage: map.add(key, value);
+     * ---------------------------
+     * Associates <code>key</code> with <code>value</code> in this map.
+     * A synonym for the put method.
+     */
+    void add(const KeyType& key, const ValueType& value);
+
+    /*
+     * Method: addAll
+     * Usage: map.addAll(map2);
+     * ------------------------
+     * Adds all key/value pairs from the given map to this map.
+     * Identical in behavior to putAll.
+     */
+    BTreeMap& addAll(const BTreeMap& map2);
+    BTreeMap& addAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Method: back
+     * Usage: KeyType key = map.back();
+     * --------------------------------
+     * Returns the largest key in the map.  If the map is empty, generates
+     * an error.
+     */
+    KeyType back() const;
+
+    /*
+     * Method: clear
+     * Usage: map.clear();
+     * -------------------
+     * Removes all entries from this map.
+     */
+    void clear();
+
+    /*
+     * Method: containsKey
+     * Usage: if (map.containsKey(key)) ...
+     * ------------------------------------
+     * Returns <code>true</code> if there is an entry for <code>key</code>
+     * in this map.
+     */
+    bool containsKey(const KeyType& key) const;
+
+    /*
+     * Method: equals
+     * Usage: if (map.equals(map2)) ...
+     * --------------------------------
+     * Returns <code>true</code> if the two maps contain exactly the same
+     * key/value pairs, and <code>false</code> otherwise.
+     */
+    bool equals(const BTreeMap& map2) const;
+
+    /*
+     * Method: front
+     * Usage: KeyType key = map.front();
+     * ---------------------------------
+     * Returns the smallest key in the map.  If the map is empty, generates
+     * an error.
+     */
+    KeyType front() const;
+
+    /*
+     * Method: get
+     * Usage: ValueType value = map.get(key);
+     * --------------------------------------
+     * Returns the value associated with <code>key</code> in this map.
+     * If <code>key</code> is not found, <code>get</code> returns the
+     * default value for <code>ValueType</code>.
+     */
+    ValueType get(const KeyType& key) const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (map.isEmpty()) ...
+     * -----------------------------
+     * Returns <code>true</code> if this map contains no entries.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Method: keys
+     * Usage: Vector<KeyType> keys = map.keys();
+     * -----------------------------------------
+     * Returns a collection containing all keys in this map, in ascending
+     * order.
+     */
+    Vector<KeyType> keys() const;
+
+    /*
+     * Method: lowerBound
+     * Usage: BTreeMap<KeyType,ValueType>::iterator it = map.lowerBound(key);
+     * ----------------------------------------------------------------------
+     * Returns an iterator positioned at the first key in this map that is not
+     * less than <code>key</code>, or <code>end()</code> if there is none.
+     */
+    iterator lowerBound(const KeyType& key) const;
+
+    /*
+     * Method: mapAll
+     * Usage: map.mapAll(fn);
+     * ----------------------
+     * Iterates through the map entries and calls <code>fn(key, value)</code>
+     * for each one.  The keys are processed in ascending order.
+     */
+    void mapAll(void (*fn)(KeyType, ValueType)) const;
+    void mapAll(void (*fn)(const KeyType&, const ValueType&)) const;
+
+    template <typename FunctorType>
+    void mapAll(FunctorType fn) const;
+
+    /*
+     * Method: mapRange
+     * Usage: map.mapRange(low, high, fn);
+     * -----------------------------------
+     * Calls <code>fn(key, value)</code> for each entry whose key is at least
+     * <code>low</code> and less than <code>high</code>, in ascending order.
+     */
+    template <typename FunctorType>
+    void mapRange(const KeyType& low, const KeyType& high, FunctorType fn) const;
+
+    /*
+     * Method: put
+     * Usage: map.put(key, value);
+     * ---------------------------
+     * Associates <code>key</code> with <code>value</code> in this map.
+     * Any previous value associated with <code>key</code> is replaced
+     * by the new value.
+     */
+    void put(const KeyType& key, const ValueType& value);
+
+    /*
+     * Method: putAll
+     * Usage: map.putAll(map2);
+     * ------------------------
+     * Adds all key/value pairs from the given map to this map.
+     * If both maps contain a pair for the same key, the one from map2 will
+     * replace the one from this map.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     * Returns a reference to this map.
+     */
+    BTreeMap& putAll(const BTreeMap& map2);
+    BTreeMap& putAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Method: remove
+     * Usage: map.remove(key);
+     * -----------------------
+     * Removes any entry for <code>key</code> from this map.
+     */
+    void remove(const KeyType& key);
+
+    /*
+     * Method: size
+     * Usage: int nEntries = map.size();
+     * ---------------------------------
+     * Returns the number of entries in this map.
+     */
+    int size() const;
+
+    /*
+     * Method: toString
+     * Usage: string str = map.toString();
+     * -----------------------------------
+     * Converts the map to a printable string representation.
+     */
+    std::string toString() const;
+
+    /*
+     * Method: upperBound
+     * Usage: BTreeMap<KeyType,ValueType>::iterator it = map.upperBound(key);
+     * ----------------------------------------------------------------------
+     * Returns an iterator positioned at the first key in this map that is
+     * greater than <code>key</code>, or <code>end()</code> if there is none.
+     */
+    iterator upperBound(const KeyType& key) const;
+
+    /*
+     * Method: values
+     * Usage: Vector<ValueType> values = map.values();
+     * -----------------------------------------------
+     * Returns a collection containing all values in this map, in the order
+     * of their keys.
+     */
+    Vector<ValueType> values() const;
+
+    /*
+     * Operator: []
+     * Usage: map[key]
+     * ---------------
+     * Selects the value associated with <code>key</code>.  This syntax
+     * makes it easy to think of a map as an "associative array"
+     * indexed by the key type.  If <code>key</code> is already present
+     * in the map, this function returns a reference to its associated
+     * value.  If key is not present in the map, a new entry is created
+     * whose value is set to the default for the value type.
+     */
+    ValueType& operator [](const KeyType& key);
+    ValueType operator [](const KeyType& key) const;
+
+    /*
+     * Operator: ==
+     * Usage: if (map1 == map2) ...
+     * ----------------------------
+     * Compares two maps for equality.
+     */
+    bool operator ==(const BTreeMap& map2) const;
+
+    /*
+     * Operator: !=
+     * Usage: if (map1 != map2) ...
+     * ----------------------------
+     * Compares two maps for inequality.
+     */
+    bool operator !=(const BTreeMap& map2) const;
+
+    /*
+     * Operators: <, >, <=, >=
+     * Usage: if (map1 < map2) ...
+     * ---------------------------
+     * Relational operators to compare two maps.
+     * The <, >, <=, >= operators require that the ValueType has a < operator
+     * so that the elements can be compared pairwise.
+     */
+    bool operator <(const BTreeMap& map2) const;
+    bool operator <=(const BTreeMap& map2) const;
+    bool operator >(const BTreeMap& map2) const;
+    bool operator >=(const BTreeMap& map2) const;
+
+    /*
+     * Additional BTreeMap operations
+     * ------------------------------
+     * In addition to the methods listed in this interface, the BTreeMap
+     * class supports the following operations:
+     *
+     *   - Stream I/O using the << and >> operators
+     *   - Deep copying for the copy constructor and assignment operator
+     *   - Iteration using the range-based for statement and STL iterators
+     *
+     * All iteration proceeds in ascending order of the keys, which is the
+     * order a Map with the default comparison function uses.
+     */
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes:
+     * ---------------------
+     * The map is represented as a B+ tree.  Every entry lives in a leaf,
+     * which holds its keys in one array and their values in another, and
+     * the leaves are linked in key order for iteration.  An internal node
+     * holds up to INTERNAL_CAPACITY keys separating its children: the key
+     * before child i+1 is the smallest key in that child's subtree, so a
+     * search takes the child after the last separator not greater than the
+     * key it wants.  Every node but the root is at least half full, and all
+     * the leaves are at the same depth.
+     */
+
+private:
+    /* Constant definitions */
+    static const int LEAF_CAPACITY = stanfordcpplib::collections::btreeNodeCapacity(
+            sizeof(KeyType) + sizeof(ValueType));
+    static const int INTERNAL_CAPACITY = stanfordcpplib::collections::btreeNodeCapacity(
+            sizeof(KeyType) + sizeof(void*));
+    static const int LEAF_MINIMUM = LEAF_CAPACITY / 2;
+    static const int INTERNAL_MINIMUM = INTERNAL_CAPACITY / 2;
+
+    /* Type definitions for the nodes of the tree */
+    struct Node {
+        bool isLeaf;             /* Which kind of node this is          */
+        int count;               /* Number of keys in use               */
+
+        explicit Node(bool leaf) : isLeaf(leaf), count(0) {}
+    };
+
+    struct Leaf : Node {
+        KeyType keys[LEAF_CAPACITY];       /* Keys in ascending order   */
+        ValueType values[LEAF_CAPACITY];   /* The corresponding values  */
+        Leaf* prev;                        /* Leaf with smaller keys    */
+        Leaf* next;                        /* Leaf with larger keys     */
+
+        Leaf() : Node(true), keys(), values(), prev(nullptr), next(nullptr) {}
+    };
+
+    struct Internal : Node {
+        KeyType keys[INTERNAL_CAPACITY];          /* Separator keys     */
+        Node* children[INTERNAL_CAPACITY + 1];    /* Subtrees           */
+
+        Internal() : Node(false), keys(), children() {}
+    };
+
+    /* Instance variables */
+    Node* root;                  /* Root of the tree, or null if empty  */
+    Leaf* firstLeaf;             /* Leaf holding the smallest keys      */
+    Leaf* lastLeaf;              /* Leaf holding the largest keys       */
+    int nodeCount;               /* Number of entries in the map        */
+    unsigned int m_version = 0;  /* structure version for detecting invalid iterators */
+
+    /* Private methods */
+    static int leafPosition(const Leaf* leaf, const KeyType& key);
+    static int childPosition(const Internal* node, const KeyType& key);
+    Leaf* findLeaf(const KeyType& key) const;
+    const ValueType* findValue(const KeyType& key) const;
+    ValueType& findOrInsert(const KeyType& key);
+    ValueType* insert(Node* node, const KeyType& key, KeyType& separator, Node*& sibling);
+    void insertChild(Internal* node, int index, const KeyType& separator, Node* child,
+                     KeyType& upSeparator, Node*& sibling);
+    bool erase(Node* node, const KeyType& key);
+    void rebalance(Internal* parent, int index);
+    void mergeChildren(Internal* parent, int index);
+    void deleteTree(Node* node);
+    Node* copyTree(const Node* node, Leaf*& previousLeaf);
+    void deepCopy(const BTreeMap& src);
+
+public:
+    /*
+     * Hidden features
+     * ---------------
+     * The remainder of this file consists of the code required to
+     * support deep copying and iteration.  Including these methods in
+     * the public portion of the interface would make that interface more
+     * difficult to understand for the average client.
+     */
+
+    /*
+     * Deep copying support
+     * --------------------
+     * This copy constructor and operator= are defined to make a
+     * deep copy, making it possible to pass/return maps by value
+     * and assign from one map to another.
+     */
+    BTreeMap& operator =(const BTreeMap& src) {
+        if (this != &src) {
+            clear();
+            deepCopy(src);
+        }
+        return *this;
+    }
+
+    BTreeMap(const BTreeMap& src)
+            : root(nullptr), firstLeaf(nullptr), lastLeaf(nullptr), nodeCount(0) {
+        deepCopy(src);
+    }
+
+    /*
+     * Iterator support
+     * ----------------
+     * The classes in the StanfordCPPLib collection implement input
+     * iterators so that they work symmetrically with respect to the
+     * corresponding STL classes.  An iterator is a position in a leaf;
+     * the end of the map is the position after the last leaf.
+     */
+    class iterator : public std::iterator<std::input_iterator_tag, KeyType> {
+    private:
+        const BTreeMap* mp;          // pointer to the map
+        Leaf* leaf;                  // leaf holding the current key, or null at the end
+        int index;                   // index of the current key in the leaf
+        unsigned int itr_version;
+
+    public:
+        iterator()
+                : mp(nullptr),
+                  leaf(nullptr),
+                  index(0),
+                  itr_version(0) {
+            /* Empty */
+        }
+
+        iterator(const BTreeMap* theMap, Leaf* theLeaf, int theIndex)
+                : mp(theMap),
+                  leaf(theLeaf),
+                  index(theIndex),
+                  itr_version(theMap->version()) {
+            if (leaf && index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+        }
+
+        iterator& operator ++() {
+            stanfordcpplib::collections::checkVersion(*mp, *this);
+            if (++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        iterator operator ++(int) {
+            stanfordcpplib::collections::checkVersion(*mp, *this);
+            iterator copy(*this);
+            operator++();
+            return copy;
+        }
+
+        bool operator ==(const iterator& rhs) const {
+            return mp == rhs.mp && leaf == rhs.leaf && index == rhs.index;
+        }
+
+        bool operator !=(const iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+        KeyType& operator *() {
+            stanfordcpplib::collections::checkVersion(*mp, *this);
+            return leaf->keys[index];
+        }
+
+        KeyType* operator ->() {
+            stanfordcpplib::collections::checkVersion(*mp, *this);
+            return &leaf->keys[index];
+        }
+
+        /*
+         * Returns the value associated with the current key.
+         */
+        ValueType& value() {
+            stanfordcpplib::collections::checkVersion(*mp, *this);
+            return leaf->values[index];
+        }
+
+        unsigned int version() const {
+            return itr_version;
+        }
+
+        friend class BTreeMap;
+    };
+
+    /*
+     * Returns an iterator positioned at the first key of the map.
+     */
+    iterator begin() const {
+        return iterator(this, firstLeaf, 0);
+    }
+
+    /*
+     * Returns an iterator positioned just past the last key of the map.
+     */
+    iterator end() const {
+        return iterator(this, nullptr, 0);
+    }
+
+    /*
+     * Returns the internal version of this collection.
+     * This is used to check for invalid iterators and issue error messages.
+     */
+    unsigned int version() const;
+};
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>::BTreeMap()
+        : root(nullptr), firstLeaf(nullptr), lastLeaf(nullptr), nodeCount(0) {
+    // empty
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>::BTreeMap(std::initializer_list<std::pair<KeyType, ValueType> > list)
+        : root(nullptr), firstLeaf(nullptr), lastLeaf(nullptr), nodeCount(0) {
+    putAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>::~BTreeMap() {
+    clear();
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::add(const KeyType& key, const ValueType& value) {
+    put(key, value);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::addAll(const BTreeMap& map2) {
+    return putAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::addAll(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    return putAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+KeyType BTreeMap<KeyType, ValueType>::back() const {
+    if (isEmpty()) {
+        error("BTreeMap::back: map is empty");
+    }
+    return lastLeaf->keys[lastLeaf->count - 1];
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::clear() {
+    deleteTree(root);
+    root = nullptr;
+    firstLeaf = lastLeaf = nullptr;
+    nodeCount = 0;
+    m_version++;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::containsKey(const KeyType& key) const {
+    return findValue(key) != nullptr;
+}
+
+/*
+ * Implementation notes: equals
+ * ----------------------------
+ * Both maps hold their entries in key order, so they can be compared by
+ * walking their leaves side by side.
+ */
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::equals(const BTreeMap& map2) const {
+    if (this == &map2) {
+        return true;
+    }
+    if (nodeCount != map2.nodeCount) {
+        return false;
+    }
+    const Leaf* leaf1 = firstLeaf;
+    const Leaf* leaf2 = map2.firstLeaf;
+    int i1 = 0;
+    int i2 = 0;
+    for (int n = 0; n < nodeCount; n++) {
+        if (!(leaf1->keys[i1] == leaf2->keys[i2])
+                || !(leaf1->values[i1] == leaf2->values[i2])) {
+            return false;
+        }
+        if (++i1 == leaf1->count) {
+            leaf1 = leaf1->next;
+            i1 = 0;
+        }
+        if (++i2 == leaf2->count) {
+            leaf2 = leaf2->next;
+            i2 = 0;
+        }
+    }
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+KeyType BTreeMap<KeyType, ValueType>::front() const {
+    if (isEmpty()) {
+        error("BTreeMap::front: map is empty");
+    }
+    return firstLeaf->keys[0];
+}
+
+template <typename KeyType, typename ValueType>
+ValueType BTreeMap<KeyType, ValueType>::get(const KeyType& key) const {
+    const ValueType* value = findValue(key);
+    return value ? *value : ValueType();
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::isEmpty() const {
+    return nodeCount == 0;
+}
+
+template <typename KeyType, typename ValueType>
+Vector<KeyType> BTreeMap<KeyType, ValueType>::keys() const {
+    Vector<KeyType> keyset;
+    for (const Leaf* leaf = firstLeaf; leaf; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            keyset.add(leaf->keys[i]);
+        }
+    }
+    return keyset;
+}
+
+template <typename KeyType, typename ValueType>
+typename BTreeMap<KeyType, ValueType>::iterator
+BTreeMap<KeyType, ValueType>::lowerBound(const KeyType& key) const {
+    if (!root) {
+        return end();
+    }
+    Leaf* leaf = findLeaf(key);
+    return iterator(this, leaf, leafPosition(leaf, key));
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
+    for (const Leaf* leaf = firstLeaf; leaf; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            fn(leaf->keys[i], leaf->values[i]);
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&, const ValueType&)) const {
+    for (const Leaf* leaf = firstLeaf; leaf; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            fn(leaf->keys[i], leaf->values[i]);
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename FunctorType>
+void BTreeMap<KeyType, ValueType>::mapAll(FunctorType fn) const {
+    for (const Leaf* leaf = firstLeaf; leaf; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            fn(leaf->keys[i], leaf->values[i]);
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename FunctorType>
+void BTreeMap<KeyType, ValueType>::mapRange(const KeyType& low, const KeyType& high,
+                                            FunctorType fn) const {
+    if (!root) {
+        return;
+    }
+    const Leaf* leaf = findLeaf(low);
+    for (int i = leafPosition(leaf, low); leaf; leaf = leaf->next, i = 0) {
+        for (; i < leaf->count; i++) {
+            if (!(leaf->keys[i] < high)) {
+                return;
+            }
+            fn(leaf->keys[i], leaf->values[i]);
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::put(const KeyType& key, const ValueType& value) {
+    findOrInsert(key) = value;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::putAll(const BTreeMap& map2) {
+    map2.mapAll([this](const KeyType& key, const ValueType& value) {
+        put(key, value);
+    });
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::putAll(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    for (const std::pair<KeyType, ValueType>& pair : list) {
+        put(pair.first, pair.second);
+    }
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::remove(const KeyType& key) {
+    if (!root || !erase(root, key)) {
+        return;
+    }
+    nodeCount--;
+    m_version++;
+    if (root->count == 0) {
+        if (root->isLeaf) {
+            delete static_cast<Leaf*>(root);
+            root = nullptr;
+            firstLeaf = lastLeaf = nullptr;
+        } else {
+            Internal* oldRoot = static_cast<Internal*>(root);
+            root = oldRoot->children[0];
+            delete oldRoot;
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+int BTreeMap<KeyType, ValueType>::size() const {
+    return nodeCount;
+}
+
+template <typename KeyType, typename ValueType>
+std::string BTreeMap<KeyType, ValueType>::toString() const {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+template <typename KeyType, typename ValueType>
+typename BTreeMap<KeyType, ValueType>::iterator
+BTreeMap<KeyType, ValueType>::upperBound(const KeyType& key) const {
+    if (!root) {
+        return end();
+    }
+    Leaf* leaf = findLeaf(key);
+    int index = leafPosition(leaf, key);
+    if (index < leaf->count && !(key < leaf->keys[index])) {
+        index++;
+    }
+    return iterator(this, leaf, index);
+}
+
+template <typename KeyType, typename ValueType>
+Vector<ValueType> BTreeMap<KeyType, ValueType>::values() const {
+    Vector<ValueType> values;
+    for (const Leaf* leaf = firstLeaf; leaf; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            values.add(leaf->values[i]);
+        }
+    }
+    return values;
+}
+
+template <typename KeyType, typename ValueType>
+unsigned int BTreeMap<KeyType, ValueType>::version() const {
+    return m_version;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType& BTreeMap<KeyType, ValueType>::operator [](const KeyType& key) {
+    return findOrInsert(key);
+}
+
+template <typename KeyType, typename ValueType>
+ValueType BTreeMap<KeyType, ValueType>::operator [](const KeyType& key) const {
+    return get(key);
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator ==(const BTreeMap& map2) const {
+    return equals(map2);
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator !=(const BTreeMap& map2) const {
+    return !equals(map2);
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator <(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) < 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator <=(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) <= 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator >(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) > 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator >=(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) >= 0;
+}
+
+/*
+ * Implementation notes: leafPosition, childPosition
+ * -------------------------------------------------
+ * Binary searches within a node.  leafPosition is the index of the first key
+ * not less than the given one; childPosition is the index of the child whose
+ * subtree would hold the given key, which is the index of the first separator
+ * greater than it.  Each step halves the range without branching on the
+ * comparison, which for simple keys the compiler turns into a conditional
+ * move: a search through random keys would mispredict half its branches.
+ */
+template <typename KeyType, typename ValueType>
+int BTreeMap<KeyType, ValueType>::leafPosition(const Leaf* leaf, const KeyType& key) {
+    if (leaf->count == 0) {
+        return 0;
+    }
+    const KeyType* base = leaf->keys;
+    for (int n = leaf->count; n > 1; n -= n / 2) {
+        base += (base[n / 2] < key) ? n / 2 : 0;
+    }
+    return int(base - leaf->keys) + (*base < key ? 1 : 0);
+}
+
+template <typename KeyType, typename ValueType>
+int BTreeMap<KeyType, ValueType>::childPosition(const Internal* node, const KeyType& key) {
+    const KeyType* base = node->keys;
+    for (int n = node->count; n > 1; n -= n / 2) {
+        base += (key < base[n / 2]) ? 0 : n / 2;
+    }
+    return int(base - node->keys) + (key < *base ? 0 : 1);
+}
+
+template <typename KeyType, typename ValueType>
+typename BTreeMap<KeyType, ValueType>::Leaf*
+BTreeMap<KeyType, ValueType>::findLeaf(const KeyType& key) const {
+    Node* node = root;
+    while (!node->isLeaf) {
+        const Internal* internal = static_cast<const Internal*>(node);
+        node = internal->children[childPosition(internal, key)];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+template <typename KeyType, typename ValueType>
+const ValueType* BTreeMap<KeyType, ValueType>::findValue(const KeyType& key) const {
+    if (!root) {
+        return nullptr;
+    }
+    const Leaf* leaf = findLeaf(key);
+    int index = leafPosition(leaf, key);
+    if (index < leaf->count && !(key < leaf->keys[index])) {
+        return &leaf->values[index];
+    }
+    return nullptr;
+}
+
+/*
+ * Implementation notes: findOrInsert
+ * ----------------------------------
+ * Returns the value for the key, adding an entry for it if there isn't one.
+ * If the root splits, the tree grows a new root above the two halves.
+ */
+template <typename KeyType, typename ValueType>
+ValueType& BTreeMap<KeyType, ValueType>::findOrInsert(const KeyType& key) {
+    if (!root) {
+        root = firstLeaf = lastLeaf = new Leaf;
+    }
+    KeyType separator;
+    Node* sibling;
+    ValueType* value = insert(root, key, separator, sibling);
+    if (sibling) {
+        Internal* newRoot = new Internal;
+        newRoot->keys[0] = std::move(separator);
+        newRoot->children[0] = root;
+        newRoot->children[1] = sibling;
+        newRoot->count = 1;
+        root = newRoot;
+    }
+    return *value;
+}
+
+/*
+ * Implementation notes: insert
+ * ----------------------------
+ * Finds or adds the key in the subtree rooted at node and returns a pointer
+ * to its value.  If the node had to split to make room, the new node holding
+ * its upper half is returned through sibling, along with the separator to
+ * put before it in the parent; otherwise sibling is set to null.  A full
+ * leaf keeps the lower half of its keys, plus the new one if it belongs
+ * there.
+ */
+template <typename KeyType, typename ValueType>
+ValueType* BTreeMap<KeyType, ValueType>::insert(Node* node, const KeyType& key,
+                                                KeyType& separator, Node*& sibling) {
+    sibling = nullptr;
+    if (!node->isLeaf) {
+        Internal* internal = static_cast<Internal*>(node);
+        int index = childPosition(internal, key);
+        KeyType childSeparator;
+        Node* childSibling;
+        ValueType* value = insert(internal->children[index], key, childSeparator, childSibling);
+        if (childSibling) {
+            insertChild(internal, index, childSeparator, childSibling, separator, sibling);
+        }
+        return value;
+    }
+
+    Leaf* leaf = static_cast<Leaf*>(node);
+    int index = leafPosition(leaf, key);
+    if (index < leaf->count && !(key < leaf->keys[index])) {
+        return &leaf->values[index];
+    }
+
+    if (leaf->count == LEAF_CAPACITY) {
+        Leaf* right = new Leaf;
+        int half = LEAF_CAPACITY / 2;
+        std::move(leaf->keys + half, leaf->keys + LEAF_CAPACITY, right->keys);
+        std::move(leaf->values + half, leaf->values + LEAF_CAPACITY, right->values);
+        right->count = LEAF_CAPACITY - half;
+        leaf->count = half;
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next) {
+            leaf->next->prev = right;
+        } else {
+            lastLeaf = right;
+        }
+        leaf->next = right;
+        sibling = right;
+
+        if (index > half) {
+            leaf = right;
+            index -= half;
+        }
+    }
+
+    std::move_backward(leaf->keys + index, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+    std::move_backward(leaf->values + index, leaf->values + leaf->count,
+                       leaf->values + leaf->count + 1);
+    leaf->keys[index] = key;
+    leaf->values[index] = ValueType();
+    leaf->count++;
+    nodeCount++;
+    m_version++;
+
+    if (sibling) {
+        separator = static_cast<Leaf*>(sibling)->keys[0];
+    }
+    return &leaf->values[index];
+}
+
+/*
+ * Implementation notes: insertChild
+ * ---------------------------------
+ * Puts child into node just after children[index], with the given separator
+ * before it.  A full node is split around its middle key, which moves up to
+ * the parent as upSeparator, with the upper half returned through sibling.
+ */
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::insertChild(Internal* node, int index,
+                                               const KeyType& separator, Node* child,
+                                               KeyType& upSeparator, Node*& sibling) {
+    if (node->count < INTERNAL_CAPACITY) {
+        std::move_backward(node->keys + index, node->keys + node->count,
+                           node->keys + node->count + 1);
+        std::move_backward(node->children + index + 1, node->children + node->count + 1,
+                           node->children + node->count + 2);
+        node->keys[index] = separator;
+        node->children[index + 1] = child;
+        node->count++;
+        return;
+    }
+
+    /* Lay out all the keys and children, then deal them out to the two halves */
+    KeyType keys[INTERNAL_CAPACITY + 1];
+    Node* children[INTERNAL_CAPACITY + 2];
+    std::move(node->keys, node->keys + index, keys);
+    keys[index] = separator;
+    std::move(node->keys + index, node->keys + INTERNAL_CAPACITY, keys + index + 1);
+    std::copy(node->children, node->children + index + 1, children);
+    children[index + 1] = child;
+    std::copy(node->children + index + 1, node->children + INTERNAL_CAPACITY + 1,
+              children + index + 2);
+
+    int half = (INTERNAL_CAPACITY + 1) / 2;
+    Internal* right = new Internal;
+    std::move(keys, keys + half, node->keys);
+    std::copy(children, children + half + 1, node->children);
+    node->count = half;
+    upSeparator = std::move(keys[half]);
+    std::move(keys + half + 1, keys + INTERNAL_CAPACITY + 1, right->keys);
+    std::copy(children + half + 1, children + INTERNAL_CAPACITY + 2, right->children);
+    right->count = INTERNAL_CAPACITY - half;
+    std::fill(node->keys + half, node->keys + INTERNAL_CAPACITY, KeyType());
+    sibling = right;
+}
+
+/*
+ * Implementation notes: erase
+ * ---------------------------
+ * Removes the key from the subtree rooted at node, returning whether it was
+ * there.  A child left less than half full borrows from or merges with one of
+ * its neighbours, so the node may itself be left short for its parent to fix.
+ * Separators aren't updated when the smallest key of a subtree is removed:
+ * a separator only has to be no greater than the keys to its right and
+ * greater than those to its left, which stays true.
+ */
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::erase(Node* node, const KeyType& key) {
+    if (!node->isLeaf) {
+        Internal* internal = static_cast<Internal*>(node);
+        int index = childPosition(internal, key);
+        Node* child = internal->children[index];
+        if (!erase(child, key)) {
+            return false;
+        }
+        if (child->isLeaf ? child->count < LEAF_MINIMUM : child->count < INTERNAL_MINIMUM) {
+            rebalance(internal, index);
+        }
+        return true;
+    }
+
+    Leaf* leaf = static_cast<Leaf*>(node);
+    int index = leafPosition(leaf, key);
+    if (index == leaf->count || key < leaf->keys[index]) {
+        return false;
+    }
+    std::move(leaf->keys + index + 1, leaf->keys + leaf->count, leaf->keys + index);
+    std::move(leaf->values + index + 1, leaf->values + leaf->count, leaf->values + index);
+    leaf->count--;
+    leaf->keys[leaf->count] = KeyType();
+    leaf->values[leaf->count] = ValueType();
+    return true;
+}
+
+/*
+ * Implementation notes: rebalance
+ * -------------------------------
+ * Tops up parent->children[index], which has one entry too few, from a
+ * neighbour that can spare one, or else merges it with a neighbour.
+ */
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::rebalance(Internal* parent, int index) {
+    Node* child = parent->children[index];
+    Node* left = index > 0 ? parent->children[index - 1] : nullptr;
+    Node* right = index < parent->count ? parent->children[index + 1] : nullptr;
+    int minimum = INTERNAL_MINIMUM;
+    if (child->isLeaf) {
+        minimum = LEAF_MINIMUM;
+    }
+
+    if (left && left->count > minimum) {
+        if (child->isLeaf) {
+            Leaf* to = static_cast<Leaf*>(child);
+            Leaf* from = static_cast<Leaf*>(left);
+            std::move_backward(to->keys, to->keys + to->count, to->keys + to->count + 1);
+            std::move_backward(to->values, to->values + to->count, to->values + to->count + 1);
+            from->count--;
+            to->keys[0] = std::move(from->keys[from->count]);
+            to->values[0] = std::move(from->values[from->count]);
+            from->keys[from->count] = KeyType();
+            from->values[from->count] = ValueType();
+            parent->keys[index - 1] = to->keys[0];
+        } else {
+            Internal* to = static_cast<Internal*>(child);
+            Internal* from = static_cast<Internal*>(left);
+            std::move_backward(to->keys, to->keys + to->count, to->keys + to->count + 1);
+            std::move_backward(to->children, to->children + to->count + 1,
+                               to->children + to->count + 2);
+            to->keys[0] = std::move(parent->keys[index - 1]);
+            to->children[0] = from->children[from->count];
+            from->count--;
+            parent->keys[index - 1] = std::move(from->keys[from->count]);
+            from->keys[from->count] = KeyType();
+        }
+        child->count++;
+    } else if (right && right->count > minimum) {
+        if (child->isLeaf) {
+            Leaf* to = static_cast<Leaf*>(child);
+            Leaf* from = static_cast<Leaf*>(right);
+            to->keys[to->count] = std::move(from->keys[0]);
+            to->values[to->count] = std::move(from->values[0]);
+            std::move(from->keys + 1, from->keys + from->count, from->keys);
+            std::move(from->values + 1, from->values + from->count, from->values);
+            from->count--;
+            from->keys[from->count] = KeyType();
+            from->values[from->count] = ValueType();
+            parent->keys[index] = from->keys[0];
+        } else {
+            Internal* to = static_cast<Internal*>(child);
+            Internal* from = static_cast<Internal*>(right);
+            to->keys[to->count] = std::move(parent->keys[index]);
+            to->children[to->count + 1] = from->children[0];
+            parent->keys[index] = std::move(from->keys[0]);
+            std::move(from->keys + 1, from->keys + from->count, from->keys);
+            std::move(from->children + 1, from->children + from->count + 1, from->children);
+            from->count--;
+            from->keys[from->count] = KeyType();
+        }
+        child->count++;
+    } else if (left) {
+        mergeChildren(parent, index - 1);
+    } else {
+        mergeChildren(parent, index);
+    }
+}
+
+/*
+ * Implementation notes: mergeChildren
+ * -----------------------------------
+ * Moves everything in parent->children[index + 1] onto the end of
+ * parent->children[index], and removes the emptied child and the separator
+ * before it from the parent.  An internal child also takes that separator,
+ * which lies between the two children's keys.
+ */
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::mergeChildren(Internal* parent, int index) {
+    Node* left = parent->children[index];
+    Node* right = parent->children[index + 1];
+    if (left->isLeaf) {
+        Leaf* to = static_cast<Leaf*>(left);
+        Leaf* from = static_cast<Leaf*>(right);
+        std::move(from->keys, from->keys + from->count, to->keys + to->count);
+        std::move(from->values, from->values + from->count, to->values + to->count);
+        to->count += from->count;
+        to->next = from->next;
+        if (from->next) {
+            from->next->prev = to;
+        } else {
+            lastLeaf = to;
+        }
+        delete from;
+    } else {
+        Internal* to = static_cast<Internal*>(left);
+        Internal* from = static_cast<Internal*>(right);
+        to->keys[to->count] = std::move(parent->keys[index]);
+        std::move(from->keys, from->keys + from->count, to->keys + to->count + 1);
+        std::copy(from->children, from->children + from->count + 1,
+                  to->children + to->count + 1);
+        to->count += from->count + 1;
+        delete from;
+    }
+
+    std::move(parent->keys + index + 1, parent->keys + parent->count, parent->keys + index);
+    std::move(parent->children + index + 2, parent->children + parent->count + 1,
+              parent->children + index + 1);
+    parent->count--;
+    parent->keys[parent->count] = KeyType();
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::deleteTree(Node* node) {
+    if (!node) {
+        return;
+    }
+    if (node->isLeaf) {
+        delete static_cast<Leaf*>(node);
+    } else {
+        Internal* internal = static_cast<Internal*>(node);
+        for (int i = 0; i <= internal->count; i++) {
+            deleteTree(internal->children[i]);
+        }
+        delete internal;
+    }
+}
+
+/*
+ * Implementation notes: copyTree
+ * ------------------------------
+ * Copies the subtree rooted at node, linking each leaf it copies after
+ * previousLeaf, which is the last leaf copied so far.
+ */
+template <typename KeyType, typename ValueType>
+typename BTreeMap<KeyType, ValueType>::Node*
+BTreeMap<KeyType, ValueType>::copyTree(const Node* node, Leaf*& previousLeaf) {
+    if (node->isLeaf) {
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        Leaf* copy = new Leaf;
+        std::copy(leaf->keys, leaf->keys + leaf->count, copy->keys);
+        std::copy(leaf->values, leaf->values + leaf->count, copy->values);
+        copy->count = leaf->count;
+        copy->prev = previousLeaf;
+        if (previousLeaf) {
+            previousLeaf->next = copy;
+        } else {
+            firstLeaf = copy;
+        }
+        previousLeaf = copy;
+        return copy;
+    }
+
+    const Internal* internal = static_cast<const Internal*>(node);
+    Internal* copy = new Internal;
+    std::copy(internal->keys, internal->keys + internal->count, copy->keys);
+    for (int i = 0; i <= internal->count; i++) {
+        copy->children[i] = copyTree(internal->children[i], previousLeaf);
+    }
+    copy->count = internal->count;
+    return copy;
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::deepCopy(const BTreeMap& src) {
+    if (src.root) {
+        Leaf* previousLeaf = nullptr;
+        root = copyTree(src.root, previousLeaf);
+        lastLeaf = previousLeaf;
+    }
+    nodeCount = src.nodeCount;
+    m_version++;
+}
+
+/*
+ * Implementation notes: << and >>
+ * -------------------------------
+ * The insertion and extraction operators use the template facilities in
+ * strlib.h to read and write generic values in a way that treats strings
+ * specially.
+ */
+template <typename KeyType, typename ValueType>
+std::ostream& operator <<(std::ostream& os, const BTreeMap<KeyType, ValueType>& map) {
+    return stanfordcpplib::collections::writeMap(os, map);
+}
+
+template <typename KeyType, typename ValueType>
+std::istream& operator >>(std::istream& is, BTreeMap<KeyType, ValueType>& map) {
+    KeyType key;
+    ValueType value;
+    return stanfordcpplib::collections::readMap(is, map, key, value,
+                                                /* descriptor */ std::string("BTreeMap::operator >>"));
+}
+
+/*
+ * Template hash function for B-tree maps.
+ * Requires the key and value types in the BTreeMap to have a hashCode function.
+ */
+template <typename K, typename V>
+int hashCode(const BTreeMap<K, V>& map) {
+    return stanfordcpplib::collections::hashCodeMap(map);
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _btreemap_h
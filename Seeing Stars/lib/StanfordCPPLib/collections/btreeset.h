@@ -0,0 +1,470 @@
+/*
+ * File: btreeset.h
+ * ----------------
+ * This file exports the <code>BTreeSet</code> class, which stores a set of
+ * distinct elements in ascending order, as a <code>Set</code> does, in a
+ * <code>BTreeMap</code> instead of a <code>Map</code>.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#ifndef _btreeset_h
+#define _btreeset_h
+
+#include <initializer_list>
+#include <iostream>
+#include <sstream>
+#include "btreemap.h"
+#include "collections.h"
+#include "error.h"
+#include "hashcode.h"
+
+/*
+ * Class: BTreeSet<ValueType>
+ * --------------------------
+ * This class stores a collection of distinct elements, ordered by the
+ * <code>&lt;</code> operator.  Its interface matches the commonly used
+ * parts of <code>Set</code>'s, and adds range queries.
+ */
+template <typename ValueType>
+class BTreeSet {
+public:
+    /* Iterators walk the keys of the underlying map */
+    typedef typename BTreeMap<ValueType, bool>::iterator iterator;
+
+    /*
+     * Constructor: BTreeSet
+     * Usage: BTreeSet<ValueType> set;
+     * -------------------------------
+     * Initializes an empty set of the specified element type.
+     */
+    BTreeSet();
+
+    /*
+     * Constructor: BTreeSet
+     * Usage: BTreeSet<ValueType> set {1, 2, 3};
+     * -----------------------------------------
+     * Initializes a new set that stores the given elements.
+     */
+    BTreeSet(std::initializer_list<ValueType> list);
+
+    /*
+     * Destructor: ~BTreeSet
+     * ---------------------
+     * Frees any heap storage associated with this set.
+     */
+    virtual ~BTreeSet();
+
+    /*
+     * Method: add
+     * Usage: set.add(value);
+     * ----------------------
+     * Adds an element to this set, if it was not already there.
+     */
+    void add(const ValueType& value);
+
+    /*
+     * Method: addAll
+     * Usage: set.addAll(set2);
+     * ------------------------
+     * Adds all elements of the given other set to this set.
+     * You can also pass an initializer list such as {1, 2, 3}.
+     * Returns a reference to this set.
+     */
+    BTreeSet& addAll(const BTreeSet& set2);
+    BTreeSet& addAll(std::initializer_list<ValueType> list);
+
+    /*
+     * Method: back
+     * Usage: ValueType value = set.back();
+     * ------------------------------------
+     * Returns the largest element of the set.  If the set is empty,
+     * generates an error.
+     */
+    ValueType back() const;
+
+    /*
+     * Method: clear
+     * Usage: set.clear();
+     * -------------------
+     * Removes all elements from this set.
+     */
+    void clear();
+
+    /*
+     * Method: contains
+     * Usage: if (set.contains(value)) ...
+     * -----------------------------------
+     * Returns <code>true</code> if the specified value is in this set.
+     */
+    bool contains(const ValueType& value) const;
+
+    /*
+     * Method: equals
+     * Usage: if (set.equals(set2)) ...
+     * --------------------------------
+     * Returns <code>true</code> if the two sets contain exactly the same
+     * elements, and <code>false</code> otherwise.
+     */
+    bool equals(const BTreeSet& set2) const;
+
+    /*
+     * Method: first
+     * Usage: ValueType value = set.first();
+     * -------------------------------------
+     * Returns the first value in the set in the order established by the
+     * <code>foreach</code> macro.  If the set is empty, generates an error.
+     */
+    ValueType first() const;
+
+    /*
+     * Method: front
+     * Usage: ValueType value = set.front();
+     * -------------------------------------
+     * Returns the smallest element of the set.  If the set is empty,
+     * generates an error.  Identical in behavior to first.
+     */
+    ValueType front() const;
+
+    /*
+     * Method: insert
+     * Usage: set.insert(value);
+     * -------------------------
+     * Adds an element to this set, if it was not already there.  This
+     * method is exported for compatibility with the STL <code>set</code> class.
+     */
+    void insert(const ValueType& value);
+
+    /*
+     * Method: isEmpty
+     * Usage: if (set.isEmpty()) ...
+     * -----------------------------
+     * Returns <code>true</code> if this set contains no elements.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Method: lowerBound
+     * Usage: BTreeSet<ValueType>::iterator it = set.lowerBound(value);
+     * ----------------------------------------------------------------
+     * Returns an iterator positioned at the first element not less than
+     * <code>value</code>, or <code>end()</code> if there is none.
+     */
+    iterator lowerBound(const ValueType& value) const;
+
+    /*
+     * Method: mapAll
+     * Usage: set.mapAll(fn);
+     * ----------------------
+     * Iterates through the elements of the set in ascending order and calls
+     * <code>fn(value)</code> for each one.
+     */
+    void mapAll(void (*fn)(ValueType)) const;
+    void mapAll(void (*fn)(const ValueType&)) const;
+
+    template <typename FunctorType>
+    void mapAll(FunctorType fn) const;
+
+    /*
+     * Method: mapRange
+     * Usage: set.mapRange(low, high, fn);
+     * -----------------------------------
+     * Calls <code>fn(value)</code> for each element that is at least
+     * <code>low</code> and less than <code>high</code>, in ascending order.
+     */
+    template <typename FunctorType>
+    void mapRange(const ValueType& low, const ValueType& high, FunctorType fn) const;
+
+    /*
+     * Method: remove
+     * Usage: set.remove(value);
+     * -------------------------
+     * Removes an element from this set.  If the value was not
+     * contained in the set, no error is generated and the set
+     * remains unchanged.
+     */
+    void remove(const ValueType& value);
+
+    /*
+     * Method: size
+     * Usage: int count = set.size();
+     * ------------------------------
+     * Returns the number of elements in this set.
+     */
+    int size() const;
+
+    /*
+     * Method: toString
+     * Usage: string str = set.toString();
+     * -----------------------------------
+     * Converts the set to a printable string representation.
+     */
+    std::string toString() const;
+
+    /*
+     * Method: upperBound
+     * Usage: BTreeSet<ValueType>::iterator it = set.upperBound(value);
+     * ----------------------------------------------------------------
+     * Returns an iterator positioned at the first element greater than
+     * <code>value</code>, or <code>end()</code> if there is none.
+     */
+    iterator upperBound(const ValueType& value) const;
+
+    /*
+     * Operator: ==
+     * Usage: set1 == set2
+     * -------------------
+     * Returns <code>true</code> if <code>set1</code> and <code>set2</code>
+     * contain the same elements.
+     */
+    bool operator ==(const BTreeSet& set2) const;
+
+    /*
+     * Operator: !=
+     * Usage: set1 != set2
+     * -------------------
+     * Returns <code>true</code> if <code>set1</code> and <code>set2</code>
+     * are different.
+     */
+    bool operator !=(const BTreeSet& set2) const;
+
+    /*
+     * Operators: <, >, <=, >=
+     * Usage: if (set1 < set2) ...
+     * ---------------------------
+     * Relational operators to compare two sets.
+     */
+    bool operator <(const BTreeSet& set2) const;
+    bool operator <=(const BTreeSet& set2) const;
+    bool operator >(const BTreeSet& set2) const;
+    bool operator >=(const BTreeSet& set2) const;
+
+    /*
+     * Additional BTreeSet operations
+     * ------------------------------
+     * In addition to the methods listed in this interface, the BTreeSet
+     * class supports the following operations:
+     *
+     *   - Stream I/O using the << and >> operators
+     *   - Deep copying for the copy constructor and assignment operator
+     *   - Iteration using the range-based for statement and STL iterators
+     *
+     * The iteration forms process the BTreeSet in ascending order.
+     */
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    BTreeMap<ValueType, bool> map;       /* Map used to store the element     */
+
+public:
+    /*
+     * Iterator support
+     * ----------------
+     * A set's iterators are its map's, which visit the elements as keys.
+     */
+    iterator begin() const {
+        return map.begin();
+    }
+
+    iterator end() const {
+        return map.end();
+    }
+};
+
+template <typename ValueType>
+BTreeSet<ValueType>::BTreeSet() {
+    // empty
+}
+
+template <typename ValueType>
+BTreeSet<ValueType>::BTreeSet(std::initializer_list<ValueType> list) {
+    addAll(list);
+}
+
+template <typename ValueType>
+BTreeSet<ValueType>::~BTreeSet() {
+    /* Empty */
+}
+
+template <typename ValueType>
+void BTreeSet<ValueType>::add(const ValueType& value) {
+    map.put(value, true);
+}
+
+template <typename ValueType>
+BTreeSet<ValueType>& BTreeSet<ValueType>::addAll(const BTreeSet& set2) {
+    for (const ValueType& value : set2) {
+        this->add(value);
+    }
+    return *this;
+}
+
+template <typename ValueType>
+BTreeSet<ValueType>& BTreeSet<ValueType>::addAll(std::initializer_list<ValueType> list) {
+    for (const ValueType& value : list) {
+        this->add(value);
+    }
+    return *this;
+}
+
+template <typename ValueType>
+ValueType BTreeSet<ValueType>::back() const {
+    if (isEmpty()) {
+        error("BTreeSet::back: set is empty");
+    }
+    return map.back();
+}
+
+template <typename ValueType>
+void BTreeSet<ValueType>::clear() {
+    map.clear();
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::contains(const ValueType& value) const {
+    return map.containsKey(value);
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::equals(const BTreeSet& set2) const {
+    return map.equals(set2.map);
+}
+
+template <typename ValueType>
+ValueType BTreeSet<ValueType>::first() const {
+    if (isEmpty()) {
+        error("BTreeSet::first: set is empty");
+    }
+    return map.front();
+}
+
+template <typename ValueType>
+ValueType BTreeSet<ValueType>::front() const {
+    if (isEmpty()) {
+        error("BTreeSet::front: set is empty");
+    }
+    return map.front();
+}
+
+template <typename ValueType>
+void BTreeSet<ValueType>::insert(const ValueType& value) {
+    map.put(value, true);
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::isEmpty() const {
+    return map.isEmpty();
+}
+
+template <typename ValueType>
+typename BTreeSet<ValueType>::iterator
+BTreeSet<ValueType>::lowerBound(const ValueType& value) const {
+    return map.lowerBound(value);
+}
+
+template <typename ValueType>
+void BTreeSet<ValueType>::mapAll(void (*fn)(ValueType)) const {
+    map.mapAll([fn](const ValueType& value, bool) { fn(value); });
+}
+
+template <typename ValueType>
+void BTreeSet<ValueType>::mapAll(void (*fn)(const ValueType&)) const {
+    map.mapAll([fn](const ValueType& value, bool) { fn(value); });
+}
+
+template <typename ValueType>
+template <typename FunctorType>
+void BTreeSet<ValueType>::mapAll(FunctorType fn) const {
+    map.mapAll([&fn](const ValueType& value, bool) { fn(value); });
+}
+
+template <typename ValueType>
+template <typename FunctorType>
+void BTreeSet<ValueType>::mapRange(const ValueType& low, const ValueType& high,
+                                   FunctorType fn) const {
+    map.mapRange(low, high, [&fn](const ValueType& value, bool) { fn(value); });
+}
+
+template <typename ValueType>
+void BTreeSet<ValueType>::remove(const ValueType& value) {
+    map.remove(value);
+}
+
+template <typename ValueType>
+int BTreeSet<ValueType>::size() const {
+    return map.size();
+}
+
+template <typename ValueType>
+std::string BTreeSet<ValueType>::toString() const {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+template <typename ValueType>
+typename BTreeSet<ValueType>::iterator
+BTreeSet<ValueType>::upperBound(const ValueType& value) const {
+    return map.upperBound(value);
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::operator ==(const BTreeSet& set2) const {
+    return equals(set2);
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::operator !=(const BTreeSet& set2) const {
+    return !equals(set2);
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::operator <(const BTreeSet& set2) const {
+    return stanfordcpplib::collections::compare(*this, set2) < 0;
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::operator <=(const BTreeSet& set2) const {
+    return stanfordcpplib::collections::compare(*this, set2) <= 0;
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::operator >(const BTreeSet& set2) const {
+    return stanfordcpplib::collections::compare(*this, set2) > 0;
+}
+
+template <typename ValueType>
+bool BTreeSet<ValueType>::operator >=(const BTreeSet& set2) const {
+    return stanfordcpplib::collections::compare(*this, set2) >= 0;
+}
+
+template <typename ValueType>
+std::ostream& operator <<(std::ostream& os, const BTreeSet<ValueType>& set) {
+    return stanfordcpplib::collections::writeCollection(os, set);
+}
+
+template <typename ValueType>
+std::istream& operator >>(std::istream& is, BTreeSet<ValueType>& set) {
+    ValueType element;
+    return stanfordcpplib::collections::readCollection(is, set, element, /* descriptor */ "BTreeSet::operator >>");
+}
+
+/*
+ * Template hash function for B-tree sets.
+ * Requires the element type in the BTreeSet to have a hashCode function.
+ */
+template <typename T>
+int hashCode(const BTreeSet<T>& set) {
+    return stanfordcpplib::collections::hashCodeCollection(set);
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _btreeset_h
@@ -8,6 +8,9 @@
  * Used to implement comparison operators like < and >= on collections.
  *
  * @author Marty Stepp
+ * @version 2026/10/19
+ * - added SPL_UNCHECKED_COLLECTIONS, which turns off checkVersion and the
+ *   index checks on Vector and Grid element access
  * @version 2017/12/12
  * - added equalsDouble for collections of double values (can't compare with ==)
  * @version 2017/10/18
@@ -34,13 +37,28 @@
 #include "random.h"
 #include "strlib.h"
 
+/*
+ * Build flag: SPL_UNCHECKED_COLLECTIONS
+ * -------------------------------------
+ * When this is defined, Vector and Grid no longer check the indexes passed
+ * to operator [], get and set, and iterators no longer check whether their
+ * collection has changed, even if SPL_THROW_ON_INVALID_ITERATOR is also
+ * defined.  A bad index or a stale iterator then reads or writes the wrong
+ * memory instead of signaling an error, so this is only for finished
+ * programs that need the speed; the .pro file defines it for release
+ * builds made with CONFIG+=unchecked, and never for debug builds.
+ *
+ * Code that needs a tight loop to be fast in every build can use the
+ * explicitly unchecked data, unsafeAt and rowView members instead.
+ */
+
 namespace stanfordcpplib {
 namespace collections {
 
-#ifdef SPL_THROW_ON_INVALID_ITERATOR
+#if defined(SPL_THROW_ON_INVALID_ITERATOR) && !defined(SPL_UNCHECKED_COLLECTIONS)
 template <typename CollectionType, typename IteratorType>
 void checkVersion(const CollectionType& coll, const IteratorType& itr,
-                  const std::string& memberName = "") {
+                  const char* memberName = "") {
     unsigned int collVersion = coll.version();
     unsigned int itrVersion = itr.version();
     if (itrVersion != collVersion) {
@@ -53,10 +71,10 @@ void checkVersion(const CollectionType& coll, const IteratorType& itr,
         error(msg);
     }
 }
-#else // SPL_THROW_ON_INVALID_ITERATOR
+#else // SPL_THROW_ON_INVALID_ITERATOR && !SPL_UNCHECKED_COLLECTIONS
 template <typename CollectionType, typename IteratorType>
 void checkVersion(const CollectionType&, const IteratorType&,
-                  const std::string& = "") {
+                  const char* = "") {
     // empty
 }
 #endif
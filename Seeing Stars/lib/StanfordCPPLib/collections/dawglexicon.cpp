@@ -14,7 +14,14 @@
  * This lexicon implementation only has the code to load/search the DAWG.
  * The DAWG builder code is quite a bit more intricate, see Julie Zelenski
  * if you need it.
+ *
+ * The DAWG can also come from a lexicon image (see private/dawgimage.h),
+ * whose edges are already in this machine's byte order and are used where
+ * the image is mapped, without being copied.
  * 
+ * @version 2026/10/19
+ * - added loading of lexicon images through DawgImage
+ * - copies share a lexicon image rather than copying its edges
  * @version 2018/03/10
  * - added method front
  * @version 2017/11/14
@@ -48,6 +55,7 @@
 #include "error.h"
 #include "hashcode.h"
 #include "strlib.h"
+#include "private/dawgimage.h"
 
 static uint32_t my_ntohl(uint32_t arg);
 
@@ -105,9 +113,7 @@ DawgLexicon::DawgLexicon(std::initializer_list<std::string> list) :
 }
 
 DawgLexicon::~DawgLexicon() {
-    if (edges) {
-        delete[] edges;
-    }
+    releaseEdges();
 }
 
 void DawgLexicon::add(const std::string& word) {
@@ -133,16 +139,22 @@ DawgLexicon& DawgLexicon::addAll(std::initializer_list<std::string> list) {
 }
 
 /*
- * Check for DAWG in first 4 to identify as special binary format,
- * otherwise assume ASCII, one word per line
+ * Check for an image's magic number or DAWG in first 4 to identify as
+ * special binary format, otherwise assume ASCII, one word per line
  */
 void DawgLexicon::addWordsFromFile(std::istream& input) {
-    char firstFour[4], expected[] = "DAWG";
+    char prefix[stanfordcpplib::DawgImage::MAGIC_LENGTH], expected[] = "DAWG";
     if (input.fail()) {
         error("DawgLexicon::addWordsFromFile: Couldn't read input");
     }
-    input.read(firstFour, 4);
-    if (strncmp(firstFour, expected, 4) == 0) {
+    input.read(prefix, sizeof(prefix));
+    size_t prefixLength = size_t(input.gcount());
+    input.clear();
+    if (stanfordcpplib::DawgImage::isImage(prefix, prefixLength)) {
+        std::string errorMessage;
+        input.seekg(0);
+        useImage(stanfordcpplib::DawgImage::read(input, errorMessage), errorMessage);
+    } else if (prefixLength >= 4 && strncmp(prefix, expected, 4) == 0) {
         if (otherWords.size() != 0) {
             error("DawgLexicon::addWordsFromFile: Binary files require an empty lexicon");
         }
@@ -166,15 +178,23 @@ void DawgLexicon::addWordsFromFile(const std::string& filename) {
     if (input.fail()) {
         error("DawgLexicon::addWordsFromFile: Couldn't open lexicon file " + filename);
     }
+    char prefix[stanfordcpplib::DawgImage::MAGIC_LENGTH];
+    input.read(prefix, sizeof(prefix));
+    if (stanfordcpplib::DawgImage::isImage(prefix, size_t(input.gcount()))) {
+        // an image in a file of its own can be mapped rather than read
+        input.close();
+        std::string errorMessage;
+        useImage(stanfordcpplib::DawgImage::open(filename, errorMessage), errorMessage);
+        return;
+    }
+    input.clear();
+    input.seekg(0);
     addWordsFromFile(input);
     input.close();
 }
 
 void DawgLexicon::clear() {
-    if (edges) {
-        delete[] edges;
-    }
-    edges = start = nullptr;
+    releaseEdges();
     numEdges = numDawgWords = 0;
     otherWords.clear();
 }
@@ -386,6 +406,11 @@ void DawgLexicon::deepCopy(const DawgLexicon& src) {
     if (!src.edges) {
         edges = nullptr;
         start = nullptr;
+    } else if (src.image) {
+        image = src.image;
+        numEdges = src.numEdges;
+        edges = src.edges;
+        start = src.start;
     } else {
         numEdges = src.numEdges;
         edges = new Edge[src.numEdges];
@@ -441,6 +466,7 @@ void DawgLexicon::readBinaryFile(std::istream& input) {
             || startIndex < 0 || numBytes < 0) {
         error("DawgLexicon::addWordsFromFile: Improperly formed lexicon file");
     }
+    releaseEdges();
     numEdges = numBytes / sizeof(Edge);
     edges = new Edge[numEdges];
     start = &edges[startIndex];
@@ -479,6 +505,15 @@ void DawgLexicon::readBinaryFile(const std::string& filename) {
     input.close();
 }
 
+void DawgLexicon::releaseEdges() {
+    if (image) {
+        image.reset();
+    } else if (edges) {
+        delete[] edges;
+    }
+    edges = start = nullptr;
+}
+
 /*
  * Implementation notes: traceToLastEdge
  * -------------------------------------
@@ -501,11 +536,35 @@ DawgLexicon::Edge* DawgLexicon::traceToLastEdge(const std::string& s) const {
     return curEdge;
 }
 
+/*
+ * Implementation notes: useImage
+ * ------------------------------
+ * The lexicon uses the image's edges where they are.  Nothing here writes
+ * to the edges, so casting away const is safe even though a mapped image is
+ * read-only.  The word count comes from the image too, so nothing walks the
+ * DAWG, and its pages are only touched as words are looked up.
+ */
+void DawgLexicon::useImage(stanfordcpplib::DawgImage* newImage, const std::string& errorMessage) {
+    if (!newImage) {
+        error("DawgLexicon::addWordsFromFile: " + errorMessage);
+    }
+    if (otherWords.size() != 0) {
+        delete newImage;
+        error("DawgLexicon::addWordsFromFile: Binary files require an empty lexicon");
+    }
+    releaseEdges();
+    image.reset(newImage);
+    numEdges = int(image->edgeCount());
+    numDawgWords = int(image->wordCount());
+    if (numEdges > 0) {
+        edges = reinterpret_cast<Edge*>(const_cast<uint32_t*>(image->edges()));
+        start = &edges[image->startIndex()];
+    }
+}
+
 DawgLexicon& DawgLexicon::operator =(const DawgLexicon& src) {
     if (this != &src) {
-        if (edges) {
-            delete[] edges;
-        }
+        releaseEdges();
         deepCopy(src);
     }
     return *this;
@@ -4,6 +4,8 @@
  * This file exports the <code>DawgLexicon</code> class, which is a
  * compact structure for storing a list of words.
  * 
+ * @version 2026/10/19
+ * - added loading of lexicon images, which are mapped into memory rather than read
  * @version 2018/03/10
  * - added method front
  * @version 2017/11/14
@@ -33,11 +35,16 @@
 #define _dawglexicon_h
 
 #include <initializer_list>
+#include <memory>
 #include <set>
 #include <string>
 #include "set.h"
 #include "stack.h"
 
+namespace stanfordcpplib {
+class DawgImage;
+}
+
 /*
  * Class: DawgLexicon
  * ------------------
@@ -90,6 +97,11 @@ public:
      *<pre>
      *    DawgLexicon english("English.dat");
      *</pre>
+     *
+     * A binary lexicon file can also be converted into a lexicon image with
+     * the <code>dawgimage</code> tool, and the image read in the same way.
+     * An image is mapped into memory rather than read, so it loads at once
+     * however big it is, and processes that load the same image share it.
      */
     DawgLexicon();
     DawgLexicon(std::istream& input);
@@ -141,6 +153,8 @@ public:
      * Usage: lex.addWordsFromFile(filename);
      * --------------------------------------
      * Reads the file and adds all of its words to the lexicon.
+     * If the file is a lexicon image, it is mapped into memory rather than
+     * read; like a binary lexicon file, it requires an empty lexicon.
      */
     void addWordsFromFile(const std::string& filename);
     
@@ -400,6 +414,7 @@ private:
     int numEdges;
     int numDawgWords;
     Set<std::string> otherWords;
+    std::shared_ptr<stanfordcpplib::DawgImage> image;   // owns edges, if set
 
 public:
     /*
@@ -411,7 +426,8 @@ public:
      * the lexicon, including all words, are copied.  Making copies is
      * generally avoided because of the expense and thus, lexicons are
      * typically passed by reference.  When a copy is needed, these
-     * operations are supported.
+     * operations are supported.  A lexicon image is shared by the copies
+     * rather than copied, since it never changes.
      */
     DawgLexicon(const DawgLexicon& src);
     DawgLexicon& operator =(const DawgLexicon& src);
@@ -537,6 +553,8 @@ private:
     void readBinaryFile(const std::string& filename);
     void deepCopy(const DawgLexicon& src);
     int countDawgWords(Edge* start) const;
+    void releaseEdges();
+    void useImage(stanfordcpplib::DawgImage* newImage, const std::string& errorMessage);
 
     unsigned int charToOrd(char ch) const {
         return ((unsigned int)(tolower(ch) - 'a' + 1));
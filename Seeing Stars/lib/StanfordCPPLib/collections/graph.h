@@ -5,6 +5,8 @@
  * to represent <b><i>graphs,</i></b> which consist of a set of
  * <b><i>nodes</i></b> (vertices) and a set of <b><i>arcs</i></b> (edges).
  * 
+ * @version 2026/10/19
+ * - added version, so that snapshots of a graph can tell when it changes
  * @version 2018/03/10
  * - added methods front, back
  * - fixed compiler issue with getArcSet call
@@ -654,6 +656,7 @@ private:
     Set<ArcType*> arcs;                    /* The set of arcs in the graph  */
     Map<std::string, NodeType*> nodeMap;   /* A map from names to nodes     */
     GraphComparator comparator;            /* The comparator for this graph */
+    unsigned int m_version = 0;            /* Bumped whenever nodes or arcs change */
 
 public:
     /*
@@ -665,6 +668,13 @@ public:
     Graph& operator =(const Graph& src);
     Graph(const Graph& src);
 
+    /*
+     * Returns the internal version of this graph, which changes whenever a
+     * node or arc is added or removed.
+     * This is used to check for out-of-date snapshots and invalid iterators.
+     */
+    unsigned int version() const;
+
     static int compare(NodeType* n1, NodeType* n2) {
         if (n1 == n2) {
             return 0;
@@ -778,6 +788,7 @@ ArcType* Graph<NodeType, ArcType>::addArc(ArcType* arc) {
     }
     arc->start->arcs.add(arc);
     arcs.add(arc);
+    m_version++;
     return arc;
 }
 
@@ -805,6 +816,7 @@ NodeType* Graph<NodeType, ArcType>::addNode(const std::string& name) {
 template <typename NodeType, typename ArcType>
 NodeType* Graph<NodeType, ArcType>::addNode(NodeType* node) {
     verifyNotNull(node, "addNode");
+    m_version++;
     NodeType* existingNode = getNode(node->name);
     if (existingNode) {
         *existingNode = *node;   // copy state from parameter
@@ -847,6 +859,7 @@ void Graph<NodeType, ArcType>::clear() {
     arcs.clear();
     nodes.clear();
     nodeMap.clear();
+    m_version++;
 }
 
 template <typename NodeType, typename ArcType>
@@ -1212,6 +1225,7 @@ void Graph<NodeType, ArcType>::removeArc(ArcType* arc) {
     arc->start->arcs.remove(arc);
     arcs.remove(arc);
     delete arc;
+    m_version++;
 }
 
 /*
@@ -1248,6 +1262,7 @@ void Graph<NodeType, ArcType>::removeNode(NodeType* node) {
     nodes.remove(node);
     nodeMap.remove(node->name);
     delete node;
+    m_version++;
 }
 
 /*
@@ -1332,6 +1347,11 @@ std::string Graph<NodeType, ArcType>::toString() const {
     return os.str();
 }
 
+template <typename NodeType, typename ArcType>
+unsigned int Graph<NodeType, ArcType>::version() const {
+    return m_version;
+}
+
 /*
  * Implementation notes: operator =, copy constructor
  * -------------------------------------------------
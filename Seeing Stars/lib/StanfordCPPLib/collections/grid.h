@@ -4,6 +4,9 @@
  * This file exports the <code>Grid</code> class, which offers a
  * convenient abstraction for representing a two-dimensional array.
  *
+ * @version 2026/10/19
+ * - added data, unsafeAt and rowView for unchecked access to the elements
+ * - index checks on element access compile out under SPL_UNCHECKED_COLLECTIONS
  * @version 2018/03/12
  * - added overloads that accept GridLocation: get, inBounds, locations, set, operator []
  * @version 2018/03/10
@@ -80,6 +83,9 @@ public:
     /* Forward reference */
     class GridRow;
     class GridRowConst;
+    template <typename ElementType> class BasicRowView;
+    typedef BasicRowView<ValueType> RowView;
+    typedef BasicRowView<const ValueType> ConstRowView;
 
     /*
      * Constructor: Grid
@@ -131,6 +137,19 @@ public:
      */
     void clear();
 
+    /*
+     * Method: data
+     * Usage: double* p = grid.data();
+     * -------------------------------
+     * Returns a pointer to the grid's first element.  The elements sit one
+     * after another in memory in row-major order, so the element at
+     * <code>(row, col)</code> is <code>p[row * grid.numCols() + col]</code>.
+     * Nothing checks the indexes used with the pointer.  The pointer is good
+     * until the grid is resized or assigned to.
+     */
+    ValueType* data();
+    const ValueType* data() const;
+
     /*
      * Method: equals
      * Usage: if (grid.equals(grid2)) ...
@@ -319,6 +338,33 @@ public:
             std::string colSeparator = ", ",
             std::string rowSeparator = ",\n ") const;
 
+    /*
+     * Method: rowView
+     * Usage: Grid<double>::RowView r = grid.rowView(row);
+     *        for (double& value : grid.rowView(row)) ...
+     * ---------------------------------------------------
+     * Returns a view of one row of the grid: <code>r[col]</code> is the
+     * element at <code>(row, col)</code>, <code>r.size()</code> is the
+     * number of columns, and <code>r.begin()</code> and <code>r.end()</code>
+     * are plain pointers.  The row index is checked once here, so a grid
+     * with no columns gives an empty view of each of its rows; the column
+     * indexes used with the view are never checked.  The view is good until
+     * the grid is resized or assigned to.
+     */
+    RowView rowView(int row);
+    ConstRowView rowView(int row) const;
+
+    /*
+     * Method: unsafeAt
+     * Usage: ValueType& val = grid.unsafeAt(row, col);
+     * ------------------------------------------------
+     * Returns the element at the specified row/col location in this grid,
+     * like <code>grid[row][col]</code> but without checking the indexes,
+     * even in builds that check them for <code>grid[row][col]</code>.
+     */
+    ValueType& unsafeAt(int row, int col);
+    const ValueType& unsafeAt(int row, int col) const;
+
     /*
      * Method: width
      * Usage: int nCols = grid.width();
@@ -422,7 +468,24 @@ private:
      */
     void checkIndexes(int row, int col,
                       int rowMax, int colMax,
-                      std::string prefix) const;
+                      const char* prefix) const;
+    void indexError(int row, int col,
+                    int rowMax, int colMax,
+                    const char* prefix) const;
+
+    /*
+     * Checks the indexes for element access (get, set, operator []) as
+     * checkIndexes does, and notes a write, unless SPL_UNCHECKED_COLLECTIONS
+     * is defined.
+     */
+    void checkAccess(int row, int col, const char* prefix) const;
+
+    /*
+     * Checks a row index alone, for members that don't take a column, unless
+     * SPL_UNCHECKED_COLLECTIONS is defined.
+     */
+    void checkRow(int row, const char* prefix) const;
+    void noteWrite();
     int gridCompare(const Grid& grid2) const;
 
     /*
@@ -562,13 +625,13 @@ public:
         }
 
         ValueType& operator [](int col) {
-            gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
-            gp->m_version++;
+            gp->checkAccess(row, col, "operator [][]");
+            gp->noteWrite();
             return gp->elements[(row * gp->nCols) + col];
         }
 
         ValueType operator [](int col) const {
-            gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
+            gp->checkAccess(row, col, "operator [][]");
             return gp->elements[(row * gp->nCols) + col];
         }
 
@@ -595,7 +658,7 @@ public:
         }
 
         const ValueType operator [](int col) const {
-            gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
+            gp->checkAccess(row, col, "operator [][]");
             return gp->elements[(row * gp->nCols) + col];
         }
 
@@ -611,6 +674,49 @@ public:
         friend class Grid;
     };
     friend class GridRowConst;
+
+    /*
+     * Class: Grid<ValueType>::BasicRowView<ElementType>
+     * -------------------------------------------------
+     * The span-like view returned by rowView: RowView for a grid that can
+     * be changed, ConstRowView for a const grid.
+     */
+    template <typename ElementType>
+    class BasicRowView {
+    public:
+        BasicRowView() : first(nullptr), length(0) {
+            /* Empty */
+        }
+
+        ElementType& operator [](int col) const {
+            return first[col];
+        }
+
+        ElementType* begin() const {
+            return first;
+        }
+
+        ElementType* end() const {
+            return first + length;
+        }
+
+        ElementType* data() const {
+            return first;
+        }
+
+        int size() const {
+            return length;
+        }
+
+    private:
+        BasicRowView(ElementType* theFirst, int theLength) : first(theFirst), length(theLength) {
+            /* Empty */
+        }
+
+        ElementType* first;
+        int length;
+        friend class Grid;
+    };
 };
 
 template <typename ValueType>
@@ -691,6 +797,16 @@ void Grid<ValueType>::clear() {
     }
 }
 
+template <typename ValueType>
+ValueType* Grid<ValueType>::data() {
+    return elements;
+}
+
+template <typename ValueType>
+const ValueType* Grid<ValueType>::data() const {
+    return elements;
+}
+
 template <typename ValueType>
 bool Grid<ValueType>::equals(const Grid<ValueType>& grid2) const {
     // optimization: if literally same grid, stop
@@ -730,13 +846,13 @@ ValueType Grid<ValueType>::front() const {
 
 template <typename ValueType>
 ValueType Grid<ValueType>::get(int row, int col) {
-    checkIndexes(row, col, nRows-1, nCols-1, "get");
+    checkAccess(row, col, "get");
     return elements[(row * nCols) + col];
 }
 
 template <typename ValueType>
 const ValueType& Grid<ValueType>::get(int row, int col) const {
-    checkIndexes(row, col, nRows-1, nCols-1, "get");
+    checkAccess(row, col, "get");
     return elements[(row * nCols) + col];
 }
 
@@ -891,9 +1007,9 @@ void Grid<ValueType>::resize(int numRows, int numCols, bool retain) {
 
 template <typename ValueType>
 void Grid<ValueType>::set(int row, int col, const ValueType& value) {
-    checkIndexes(row, col, nRows - 1, nCols - 1, "set");
+    checkAccess(row, col, "set");
     elements[(row * nCols) + col] = value;
-    m_version++;
+    noteWrite();
 }
 
 template <typename ValueType>
@@ -943,6 +1059,28 @@ std::string Grid<ValueType>::toString2D(
     return os.str();
 }
 
+template <typename ValueType>
+typename Grid<ValueType>::RowView Grid<ValueType>::rowView(int row) {
+    checkRow(row, "rowView");
+    return RowView(elements + (row * nCols), nCols);
+}
+
+template <typename ValueType>
+typename Grid<ValueType>::ConstRowView Grid<ValueType>::rowView(int row) const {
+    checkRow(row, "rowView");
+    return ConstRowView(elements + (row * nCols), nCols);
+}
+
+template <typename ValueType>
+ValueType& Grid<ValueType>::unsafeAt(int row, int col) {
+    return elements[(row * nCols) + col];
+}
+
+template <typename ValueType>
+const ValueType& Grid<ValueType>::unsafeAt(int row, int col) const {
+    return elements[(row * nCols) + col];
+}
+
 template <typename ValueType>
 int Grid<ValueType>::width() const {
     return nCols;
@@ -955,7 +1093,7 @@ typename Grid<ValueType>::GridRow Grid<ValueType>::operator [](int row) {
 
 template <typename ValueType>
 ValueType& Grid<ValueType>::operator [](const GridLocation& loc) {
-    checkIndexes(loc.row, loc.col, nRows-1, nCols-1, "operator []");
+    checkAccess(loc.row, loc.col, "operator []");
     return elements[(loc.row * nCols) + loc.col];
 }
 
@@ -967,7 +1105,7 @@ Grid<ValueType>::operator [](int row) const {
 
 template <typename ValueType>
 const ValueType& Grid<ValueType>::operator [](const GridLocation& loc) const {
-    checkIndexes(loc.row, loc.col, nRows-1, nCols-1, "operator []");
+    checkAccess(loc.row, loc.col, "operator []");
     return elements[(loc.row * nCols) + loc.col];
 }
 
@@ -1004,22 +1142,68 @@ bool Grid<ValueType>::operator >=(const Grid& grid2) const {
 template <typename ValueType>
 void Grid<ValueType>::checkIndexes(int row, int col,
                                    int rowMax, int colMax,
-                                   std::string prefix) const {
+                                   const char* prefix) const {
+    if (row < 0 || row > rowMax || col < 0 || col > colMax) {
+        indexError(row, col, rowMax, colMax, prefix);
+    }
+}
+
+/*
+ * Implementation notes: indexError
+ * --------------------------------
+ * The message is built here rather than in checkIndexes, so that the check
+ * itself is small enough to inline into every element access.
+ */
+template <typename ValueType>
+void Grid<ValueType>::indexError(int row, int col,
+                                 int rowMax, int colMax,
+                                 const char* prefix) const {
     const int rowMin = 0;
     const int colMin = 0;
-    if (row < rowMin || row > rowMax || col < colMin || col > colMax) {
+    std::ostringstream out;
+    out << "Grid::" << prefix << ": (" << row << ", " << col << ")"
+        << " is outside of valid range [";
+    if (rowMin < rowMax && colMin < colMax) {
+        out << "(" << rowMin << ", " << colMin <<  ")..("
+            << rowMax << ", " << colMax << ")";
+    } else if (rowMin == rowMax && colMin == colMax) {
+        out << "(" << rowMin << ", " << colMin <<  ")";
+    } // else min > max, no range, empty grid
+    out << "]";
+    error(out.str());
+}
+
+template <typename ValueType>
+void Grid<ValueType>::checkAccess(int row, int col, const char* prefix) const {
+#ifdef SPL_UNCHECKED_COLLECTIONS
+    (void) row;
+    (void) col;
+    (void) prefix;
+#else
+    checkIndexes(row, col, nRows - 1, nCols - 1, prefix);
+#endif // SPL_UNCHECKED_COLLECTIONS
+}
+
+template <typename ValueType>
+void Grid<ValueType>::checkRow(int row, const char* prefix) const {
+#ifdef SPL_UNCHECKED_COLLECTIONS
+    (void) row;
+    (void) prefix;
+#else
+    if (row < 0 || row >= nRows) {
         std::ostringstream out;
-        out << "Grid::" << prefix << ": (" << row << ", " << col << ")"
-            << " is outside of valid range [";
-        if (rowMin < rowMax && colMin < colMax) {
-            out << "(" << rowMin << ", " << colMin <<  ")..("
-                << rowMax << ", " << colMax << ")";
-        } else if (rowMin == rowMax && colMin == colMax) {
-            out << "(" << rowMin << ", " << colMin <<  ")";
-        } // else min > max, no range, empty grid
-        out << "]";
+        out << "Grid::" << prefix << ": row " << row
+            << " is outside of valid range [0.." << (nRows - 1) << "]";
         error(out.str());
     }
+#endif // SPL_UNCHECKED_COLLECTIONS
+}
+
+template <typename ValueType>
+void Grid<ValueType>::noteWrite() {
+#ifndef SPL_UNCHECKED_COLLECTIONS
+    m_version++;
+#endif // SPL_UNCHECKED_COLLECTIONS
 }
 
 template <typename ValueType>
@@ -3,6 +3,10 @@
  * ------------------
  * This file implements the interface declared in hashcode.h.
  *
+ * @version 2026/10/19
+ * - strings and byte ranges hashed a word at a time, wyhash-style
+ * - integers, pointers and floating-point values run through a mixer
+ * - hash codes seeded per process (fixed by the SPL_HASH_SEED variable)
  * @version 2017/10/21
  * - added hash codes for short, unsigned integers
  * @version 2015/07/05
@@ -10,13 +14,165 @@
  */
 
 #include "hashcode.h"
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include "error.h"
 
-static const int HASH_SEED = 5381;               // Starting point for first cycle
 static const int HASH_MULTIPLIER = 33;           // Multiplier for each cycle
 static const int HASH_MASK = unsigned(-1) >> 1;  // All 1 bits except the sign
 
+/*
+ * Implementation notes: hash seed
+ * -------------------------------
+ * Every hash code depends on a 64-bit seed chosen when the first one is
+ * computed, so that a set of keys that happens to collide badly (or was
+ * chosen to) in one run won't in the next.  The seed is taken from the
+ * SPL_HASH_SEED environment variable if that is set, which makes the order
+ * of HashMap and HashSet iteration repeatable from run to run.  The setting
+ * is parsed as an unsigned long long, since an unsigned long is only 32 bits
+ * on Windows, and anything that isn't a whole 64-bit number (decimal, 0x hex
+ * or 0 octal) is an error rather than a quietly different seed.
+ */
+static std::uint64_t processSeed() {
+    static const std::uint64_t seed = [] {
+        const char* setting = std::getenv("SPL_HASH_SEED");
+        if (setting && *setting) {
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long fixed = std::strtoull(setting, &end, 0);
+            if (!std::isdigit(static_cast<unsigned char>(setting[0]))
+                    || *end != '\0' || errno == ERANGE) {
+                error(std::string("SPL_HASH_SEED must be an unsigned 64-bit integer, not \"")
+                      + setting + "\"");
+            }
+            return std::uint64_t(fixed);
+        }
+        std::uint64_t entropy = std::uint64_t(
+                std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        try {
+            std::random_device device;
+            entropy ^= (std::uint64_t(device()) << 32) | device();
+        } catch (...) {
+            // fall back on the clock alone
+        }
+        return entropy;
+    }();
+    return seed;
+}
+
+/*
+ * Implementation notes: hashing
+ * -----------------------------
+ * Byte ranges are hashed with a version of Wang Yi's wyhash, which reads
+ * eight bytes at a time and folds them in with 64x64->128-bit multiplies.
+ * Integers, pointers, and the bits of floating-point values go through a
+ * single multiply-and-fold round of the same kind.  Either way, every bit
+ * of the key affects every bit of the result, so keys that differ only in
+ * a few bits (consecutive integers, aligned pointers, file names that
+ * differ in one digit) end up spread across the whole range of hash codes
+ * rather than in a handful of neighboring buckets.
+ */
+namespace {
+const std::uint64_t SECRET0 = UINT64_C(0xa0761d6478bd642f);
+const std::uint64_t SECRET1 = UINT64_C(0xe7037ed1a0b428db);
+const std::uint64_t SECRET2 = UINT64_C(0x8ebc6af09c88c6e3);
+const std::uint64_t SECRET3 = UINT64_C(0x589965cc75374cc3);
+
+/* Multiplies a by b and folds the 128-bit product into 64 bits. */
+inline std::uint64_t multiplyFold(std::uint64_t a, std::uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = a;
+    product *= b;
+    return std::uint64_t(product) ^ std::uint64_t(product >> 64);
+#else
+    std::uint64_t aHigh = a >> 32, aLow = a & 0xFFFFFFFF;
+    std::uint64_t bHigh = b >> 32, bLow = b & 0xFFFFFFFF;
+    std::uint64_t highHigh = aHigh * bHigh, highLow = aHigh * bLow;
+    std::uint64_t lowHigh = aLow * bHigh, lowLow = aLow * bLow;
+    std::uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+    std::uint64_t low = (middle << 32) | (lowLow & 0xFFFFFFFF);
+    std::uint64_t high = highHigh + (highLow >> 32) + (middle >> 32);
+    return low ^ high;
+#endif
+}
+
+inline std::uint64_t read8(const unsigned char* bytes) {
+    std::uint64_t result;
+    std::memcpy(&result, bytes, sizeof(result));
+    return result;
+}
+
+inline std::uint64_t read4(const unsigned char* bytes) {
+    std::uint32_t result;
+    std::memcpy(&result, bytes, sizeof(result));
+    return result;
+}
+
+/* Reads 1 to 3 bytes as one value, touching each byte at most once. */
+inline std::uint64_t read1to3(const unsigned char* bytes, std::size_t length) {
+    return (std::uint64_t(bytes[0]) << 16) | (std::uint64_t(bytes[length >> 1]) << 8) | bytes[length - 1];
+}
+
+std::uint64_t hashWords(const unsigned char* bytes, std::size_t length) {
+    std::uint64_t seed = processSeed();
+    seed ^= multiplyFold(seed ^ SECRET0, SECRET1);
+
+    std::uint64_t a, b;
+    if (length <= 16) {
+        if (length >= 4) {
+            std::size_t middle = (length >> 3) << 2;
+            a = (read4(bytes) << 32) | read4(bytes + middle);
+            b = (read4(bytes + length - 4) << 32) | read4(bytes + length - 4 - middle);
+        } else if (length > 0) {
+            a = read1to3(bytes, length);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        std::size_t remaining = length;
+        if (remaining > 48) {
+            // three independent lanes, so the multiplies can overlap
+            std::uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = multiplyFold(read8(bytes) ^ SECRET1, read8(bytes + 8) ^ seed);
+                lane1 = multiplyFold(read8(bytes + 16) ^ SECRET2, read8(bytes + 24) ^ lane1);
+                lane2 = multiplyFold(read8(bytes + 32) ^ SECRET3, read8(bytes + 40) ^ lane2);
+                bytes += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (remaining > 16) {
+            seed = multiplyFold(read8(bytes) ^ SECRET1, read8(bytes + 8) ^ seed);
+            bytes += 16;
+            remaining -= 16;
+        }
+        // the last 16 bytes, which may overlap ones already read
+        a = read8(bytes + remaining - 16);
+        b = read8(bytes + remaining - 8);
+    }
+    return multiplyFold(SECRET1 ^ length, multiplyFold(a ^ SECRET1, b ^ seed));
+}
+
+std::uint64_t hashWord(std::uint64_t word) {
+    return multiplyFold(word ^ processSeed() ^ SECRET0, SECRET1);
+}
+
+int toHashCode(std::uint64_t hash) {
+    return int(hash & HASH_MASK);
+}
+}
+
 int hashSeed() {
-    return HASH_SEED;
+    return toHashCode(processSeed());
 }
 
 int hashMultiplier() {
@@ -27,85 +183,64 @@ int hashMask() {
     return HASH_MASK;
 }
 
-/*
- * Implementation notes: hashCode
- * ------------------------------
- * This function takes a string key and uses it to derive a hash code,
- * which is a nonnegative integer related to the key by a deterministic
- * function that distributes keys well across the space of integers.
- * The general method is called linear congruence, which is also used
- * in random-number generators.  The specific algorithm used here is
- * called djb2 after the initials of its inventor, Daniel J. Bernstein,
- * Professor of Mathematics at the University of Illinois at Chicago.
- */
+int hashBytes(const void* bytes, std::size_t length) {
+    return toHashCode(hashWords(static_cast<const unsigned char*>(bytes), length));
+}
 
 int hashCode(bool key) {
-    return (int) key;
+    return toHashCode(hashWord(key));
 }
 
 int hashCode(char key) {
-    return key;
+    return toHashCode(hashWord(std::uint64_t(key)));
 }
 
 int hashCode(double key) {
-    char* byte = (char*) &key;
-    unsigned hash = HASH_SEED;
-    for (int i = 0; i < (int) sizeof(double); i++) {
-        hash = HASH_MULTIPLIER * hash + (int) *byte++;
+    // 0.0 and -0.0 are equal, so must hash the same
+    if (std::fpclassify(key) == FP_ZERO) {
+        key = 0.0;
     }
-    return hash & HASH_MASK;
+    std::uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return toHashCode(hashWord(bits));
 }
 
 int hashCode(float key) {
-    char* byte = (char*) &key;
-    unsigned hash = HASH_SEED;
-    for (int i = 0; i < (int) sizeof(float); i++) {
-        hash = HASH_MULTIPLIER * hash + (int) *byte++;
-    }
-    return hash & HASH_MASK;
+    return hashCode(double(key));
 }
 
 int hashCode(int key) {
-    return key & HASH_MASK;
+    return toHashCode(hashWord(std::uint64_t(key)));
 }
 
 int hashCode(unsigned int key) {
-    return key & HASH_MASK;
+    return toHashCode(hashWord(key));
 }
 
 int hashCode(long key) {
-    return int(key) & HASH_MASK;
+    return toHashCode(hashWord(std::uint64_t(key)));
 }
 
 int hashCode(unsigned long key) {
-    return int(key) & HASH_MASK;
+    return toHashCode(hashWord(key));
 }
 
 int hashCode(short key) {
-    return int(key) & HASH_MASK;
+    return toHashCode(hashWord(std::uint64_t(key)));
 }
 
 int hashCode(unsigned short key) {
-    return int(key) & HASH_MASK;
+    return toHashCode(hashWord(key));
 }
 
 int hashCode(const char* str) {
-    unsigned hash = HASH_SEED;
-    for (int i = 0; str && str[i] != 0; i++) {
-        hash = HASH_MULTIPLIER * hash + str[i];
-    }
-    return int(hash & HASH_MASK);
+    return str ? hashBytes(str, std::strlen(str)) : hashBytes("", 0);
 }
 
 int hashCode(const std::string& str) {
-    unsigned hash = HASH_SEED;
-    int n = str.length();
-    for (int i = 0; i < n; i++) {
-        hash = HASH_MULTIPLIER * hash + str[i];
-    }
-    return int(hash & HASH_MASK);
+    return hashBytes(str.data(), str.length());
 }
 
 int hashCode(void* key) {
-    return hashCode(reinterpret_cast<long>(key));
+    return toHashCode(hashWord(reinterpret_cast<std::uintptr_t>(key)));
 }
@@ -5,6 +5,9 @@
  * These functions are used by the HashMap and HashSet collections, as well as
  * by other collections that wish to be used as elements within HashMaps/Sets.
  *
+ * @version 2026/10/19
+ * - hash codes are now well mixed and seeded per process
+ * - added hashBytes function
  * @version 2017/10/21
  * - added hash codes for short, unsigned integers
  * @version 2017/09/29
@@ -17,6 +20,7 @@
 #ifndef _hashcode_h
 #define _hashcode_h
 
+#include <cstddef>
 #include <string>
 
 /*
@@ -26,6 +30,11 @@
  * Returns a hash code for the specified key, which is always a
  * nonnegative integer.  This function is overloaded to support
  * all of the primitive types and the C++ <code>string</code> type.
+ *
+ * Hash codes are only meaningful within a single run of a program: they
+ * are seeded differently each time, and so is the order in which HashMap
+ * and HashSet visit their elements.  Setting the SPL_HASH_SEED environment
+ * variable to a number fixes the seed, for runs that must be repeatable.
  */
 int hashCode(bool key);
 int hashCode(char key);
@@ -41,11 +50,21 @@ int hashCode(const char* str);
 int hashCode(const std::string& str);
 int hashCode(void* key);
 
+/*
+ * Function: hashBytes
+ * Usage: int hash = hashBytes(data, length);
+ * ------------------------------------------
+ * Returns a hash code for the given number of bytes starting at data.
+ * This is how strings are hashed, and is useful for writing hashCode
+ * functions for types whose values are sequences of bytes.
+ */
+int hashBytes(const void* bytes, std::size_t length);
+
 /*
  * Constants that are used to help implement these functions
  * (see hashcode.h for example usage)
  */
-int hashSeed();         // Starting point for first cycle
+int hashSeed();         // Starting point for first cycle (differs from run to run)
 int hashMultiplier();   // Multiplier for each cycle
 int hashMask();         // All 1 bits except the sign
 
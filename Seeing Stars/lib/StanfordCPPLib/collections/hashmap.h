@@ -4,6 +4,9 @@
  * This file exports the <code>HashMap</code> class, which stores
  * a set of <i>key</i>-<i>value</i> pairs.
  * 
+ * @version 2026/10/19
+ * - replaced bucket chaining with a flat open-addressing table that probes
+ *   16 control bytes at a time (with SSE2 where available)
  * @version 2018/03/10
  * - added methods front, back
  * @version 2017/11/30
@@ -40,16 +43,83 @@
 #ifndef _hashmap_h
 #define _hashmap_h
 
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <initializer_list>
 #include <map>
+#include <new>
 #include <string>
 #include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
 #include "vector.h"
 
+namespace stanfordcpplib {
+namespace collections {
+
+/*
+ * Returns a bit mask with bit i set for each of the 16 control bytes
+ * group[0..15] that equals the given value.
+ */
+inline unsigned int matchControlBytes(const signed char* group, signed char value) {
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < 16; i++) {
+        if (group[i] == value) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/*
+ * Returns a bit mask with bit i set for each of the 16 control bytes
+ * group[0..15] that marks a free (empty or deleted) slot.  Those are
+ * exactly the negative bytes, so SSE2 can read them off the sign bits.
+ */
+inline unsigned int matchFreeControlBytes(const signed char* group) {
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return unsigned(_mm_movemask_epi8(bytes));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < 16; i++) {
+        if (group[i] < 0) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/*
+ * Returns the index of the lowest set bit of a nonzero mask.
+ */
+inline int lowestBitIndex(unsigned int mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+} // namespace collections
+} // namespace stanfordcpplib
+
 /*
  * Class: HashMap<KeyType,ValueType>
  * ---------------------------------
@@ -423,139 +493,244 @@ public:
     /*
      * Implementation notes:
      * ---------------------
-     * The HashMap class is represented using a hash table that uses
-     * bucket chaining to resolve collisions.
+     * The HashMap class is represented using a flat open-addressing hash
+     * table in the style of Google's "Swiss tables".  Keys and values live
+     * directly in one array of slots, and a parallel array holds one control
+     * byte per slot saying whether it is empty, deleted, or full, and for a
+     * full slot, seven bits of its key's hash.  The slots are divided into
+     * groups of 16, and a lookup checks all the control bytes of a group at
+     * once (with a single SSE2 comparison where available), only comparing
+     * keys in the slots whose bytes match.  Most lookups touch one group and
+     * compare one key, with no pointers to chase.
     */
 private:
     /* Constant definitions */
-    static const int INITIAL_BUCKET_COUNT = 101;
-    static const int MAX_LOAD_PERCENTAGE = 70;
+    static const int GROUP_SIZE = 16;           // slots per group; must match the SSE2 width
+    static const int MAX_LOAD_EIGHTHS = 7;      // fill at most 7/8 of the slots
+
+    /* Control byte values; a full slot's control byte is 0-127. */
+    static const signed char CTRL_EMPTY = -128;
+    static const signed char CTRL_DELETED = -2;
 
-    /* Type definition for cells in the bucket chain */
-    struct Cell {
+    /* Type definition for the slots holding the entries */
+    struct Slot {
         KeyType key;
         ValueType value;
-        Cell* next;
     };
 
     /* Instance variables */
-    Vector<Cell*> buckets;
-    int nBuckets;
+    signed char* ctrl;           // one control byte per slot
+    Slot* slots;                 // uninitialized except where ctrl says full
+    int capacity;                // 0, or a power of two at least GROUP_SIZE
     int numEntries;
-    unsigned int m_version = 0; // structure version for detecting invalid iterators
+    int growthLeft;              // how many empty slots can still be filled before rehashing
+    unsigned int m_version = 0;  // structure version for detecting invalid iterators
 
     /* Private methods */
 
     /*
-     * Private method: createBuckets
-     * Usage: createBuckets(nBuckets);
-     * -------------------------------
-     * Sets up the vector of buckets to have nBuckets entries, each null.
-     * If asked to make empty vector, makes one bucket just to simplify
-     * handling elsewhere.
+     * Private method: hashFor
+     * Usage: std::size_t hash = hashFor(key);
+     * ---------------------------------------
+     * Returns the key's hash code with its bits well mixed.  The hashCode
+     * functions in hashcode.h already are, but ones written for other types
+     * (often by combining fields with hashCode2 and friends) may not be, so
+     * codes are spread out again here before being used to pick a group and
+     * a control byte.
+     */
+    static std::size_t hashFor(const KeyType& key) {
+        // the finalizer from MurmurHash3
+        std::uint64_t hash = unsigned(hashCode(key));
+        hash ^= hash >> 33;
+        hash *= UINT64_C(0xFF51AFD7ED558CCD);
+        hash ^= hash >> 33;
+        hash *= UINT64_C(0xC4CEB9FE1A85EC53);
+        return hash ^ (hash >> 33);
+    }
+
+    /*
+     * Private method: controlFor
+     * Usage: signed char h2 = controlFor(hash);
+     * -----------------------------------------
+     * Returns the control byte for a full slot holding a key with this hash.
+     */
+    static signed char controlFor(std::size_t hash) {
+        return (signed char) (hash & 0x7F);
+    }
+
+    /*
+     * Private method: allocate
+     * Usage: allocate(capacity);
+     * --------------------------
+     * Sets up empty arrays with room for the given number of slots, without
+     * freeing any that were there before.
      */
-    void createBuckets(int nBuckets) {
-        if (nBuckets == 0) {
-            nBuckets = 1;
+    void allocate(int capacity) {
+        this->capacity = capacity;
+        growthLeft = capacity / 8 * MAX_LOAD_EIGHTHS;
+        if (capacity == 0) {
+            ctrl = nullptr;
+            slots = nullptr;
+        } else {
+            ctrl = new signed char[capacity];
+            std::memset(ctrl, CTRL_EMPTY, capacity);
+            slots = static_cast<Slot*>(::operator new(sizeof(Slot) * capacity));
         }
-        buckets = Vector<Cell*>(nBuckets, nullptr);
-        this->nBuckets = nBuckets;
+    }
+
+    /*
+     * Private method: deallocate
+     * Usage: deallocate();
+     * --------------------
+     * Destroys every entry and frees the arrays, leaving the map with no
+     * slots at all.
+     */
+    void deallocate() {
+        for (int i = 0; i < capacity; i++) {
+            if (ctrl[i] >= 0) {
+                slots[i].~Slot();
+            }
+        }
+        delete[] ctrl;
+        ::operator delete(slots);
+        allocate(0);
         numEntries = 0;
     }
 
     /*
-     * Private method: deleteBuckets
-     * Usage: deleteBuckets(buckets);
-     * ------------------------------
-     * Deletes all the cells in the linked lists contained in vector.
+     * Private method: findIndex
+     * Usage: int index = findIndex(key, hash);
+     * ----------------------------------------
+     * Returns the index of the slot holding key, or -1 if there isn't one.
+     * Groups are probed in the order 0, 1, 3, 6, 10, ... groups past the
+     * first, which visits every group when there are a power of two of them.
+     * A key can't be past a group with an empty slot in it, since it would
+     * have gone into that slot.
      */
-    void deleteBuckets(Vector<Cell*>& buckets) {
-        for (int i = 0; i < buckets.size(); i++) {
-            Cell* cp = buckets[i];
-            while (cp) {
-                Cell* np = cp->next;
-                delete cp;
-                cp = np;
+    int findIndex(const KeyType& key, std::size_t hash) const {
+        if (numEntries == 0) {
+            return -1;
+        }
+        std::size_t groupMask = capacity / GROUP_SIZE - 1;
+        std::size_t group = (hash >> 7) & groupMask;
+        for (std::size_t step = 1; ; step++) {
+            const signed char* groupCtrl = ctrl + group * GROUP_SIZE;
+            unsigned int matches = stanfordcpplib::collections::matchControlBytes(groupCtrl, controlFor(hash));
+            for (; matches != 0; matches &= matches - 1) {
+                int index = int(group * GROUP_SIZE) + stanfordcpplib::collections::lowestBitIndex(matches);
+                if (slots[index].key == key) {
+                    return index;
+                }
             }
-            buckets[i] = nullptr;
+            if (stanfordcpplib::collections::matchControlBytes(groupCtrl, CTRL_EMPTY) != 0) {
+                return -1;
+            }
+            group = (group + step) & groupMask;
         }
     }
 
     /*
-     * Private method: expandAndRehash
-     * Usage: expandAndRehash();
-     * -------------------------
-     * This method is used to increase the number of buckets in the map
-     * and then rehashes all existing entries and adds them into new buckets.
-     * This operation is used when the load factor (i.e. the number of cells
-     * per bucket) has increased enough to warrant this O(N) operation to
-     * enlarge and redistribute the entries.
+     * Private method: findInsertIndex
+     * Usage: int index = findInsertIndex(hash);
+     * -----------------------------------------
+     * Returns the index of the first empty or deleted slot in the probe
+     * sequence for the given hash.  There must be at least one free slot.
      */
-    void expandAndRehash() {
-        Vector<Cell*> oldBuckets = buckets;
-        createBuckets(oldBuckets.size() * 2 + 1);
-        for (int i = 0; i < oldBuckets.size(); i++) {
-            for (Cell* cp = oldBuckets[i]; cp != nullptr; cp = cp->next) {
-                put(cp->key, cp->value);
+    int findInsertIndex(std::size_t hash) const {
+        std::size_t groupMask = capacity / GROUP_SIZE - 1;
+        std::size_t group = (hash >> 7) & groupMask;
+        for (std::size_t step = 1; ; step++) {
+            unsigned int free = stanfordcpplib::collections::matchFreeControlBytes(ctrl + group * GROUP_SIZE);
+            if (free != 0) {
+                return int(group * GROUP_SIZE) + stanfordcpplib::collections::lowestBitIndex(free);
             }
+            group = (group + step) & groupMask;
         }
-        deleteBuckets(oldBuckets);
     }
 
     /*
-     * Private method: findCell
-     * Usage: Cell* cp = findCell(bucket, key);
-     *        Cell* cp = findCell(bucket, key, parent);
-     * ------------------------------------------------
-     * Finds a cell in the chain for the specified bucket that matches key.
-     * If a match is found, the return value is a pointer to the cell containing
-     * the matching key.  If no match is found, the function returns nullptr.
-     * If the optional third argument is supplied, it is filled in with the
-     * cell preceding the matching cell to allow the client to splice out
-     * the target cell in the delete call.  If parent is null, it indicates
-     * that the cell is the first cell in the bucket chain.
+     * Private method: nextFullIndex
+     * Usage: int index = nextFullIndex(index);
+     * ----------------------------------------
+     * Returns the index of the first full slot at or after the given one,
+     * or capacity if there are none.
      */
-    Cell* findCell(int bucket, const KeyType& key) const {
-        Cell *dummy;
-        return findCell(bucket, key, dummy);
+    int nextFullIndex(int index) const {
+        while (index < capacity) {
+            int groupStart = index - index % GROUP_SIZE;
+            unsigned int full = ~stanfordcpplib::collections::matchFreeControlBytes(ctrl + groupStart)
+                    & (0xFFFFu << (index - groupStart)) & 0xFFFFu;
+            if (full != 0) {
+                return groupStart + stanfordcpplib::collections::lowestBitIndex(full);
+            }
+            index = groupStart + GROUP_SIZE;
+        }
+        return capacity;
     }
 
-    Cell* findCell(int bucket, const KeyType& key, Cell*& parent) const {
-        parent = nullptr;
-        Cell* cp = buckets.get(bucket);
-        while (cp && !(key == cp->key)) {
-            parent = cp;
-            cp = cp->next;
+    /*
+     * Private method: rehash
+     * Usage: rehash(newCapacity);
+     * ---------------------------
+     * Moves every entry into a fresh table with the given number of slots,
+     * which also clears out any deleted slots.
+     */
+    void rehash(int newCapacity) {
+        signed char* oldCtrl = ctrl;
+        Slot* oldSlots = slots;
+        int oldCapacity = capacity;
+
+        allocate(newCapacity);
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldCtrl[i] >= 0) {
+                std::size_t hash = hashFor(oldSlots[i].key);
+                int index = findInsertIndex(hash);
+                new (&slots[index]) Slot(std::move(oldSlots[i]));
+                ctrl[index] = controlFor(hash);
+                oldSlots[i].~Slot();
+            }
+        }
+        growthLeft -= numEntries;
+
+        delete[] oldCtrl;
+        ::operator delete(oldSlots);
+    }
+
+    /*
+     * Private method: makeRoomForInsert
+     * Usage: makeRoomForInsert();
+     * ---------------------------
+     * Makes sure another entry can go in an empty slot.  If the table is
+     * full mostly of deleted slots, it is rehashed at the same size to clear
+     * them out; otherwise it doubles in size.
+     */
+    void makeRoomForInsert() {
+        if (growthLeft > 0) {
+            return;
+        }
+        if (capacity == 0) {
+            rehash(GROUP_SIZE);
+        } else if (numEntries < capacity / 16 * MAX_LOAD_EIGHTHS) {
+            rehash(capacity);
+        } else {
+            rehash(capacity * 2);
         }
-        return cp;
     }
 
     void deepCopy(const HashMap& src) {
-        createBuckets(src.nBuckets);
-        for (int i = 0; i < src.nBuckets; i++) {
-            // BUGFIX: was just calling put(), which reversed the chains;
-            // now deep-copy the chains exactly as they were to preserve hashcode
-            Cell* endOfChain = nullptr;
-            for (Cell* cp = src.buckets.get(i); cp != nullptr; cp = cp->next) {
-                // put(cp->key, cp->value);
-                
-                // copy the cell and put at end of bucket list
-                Cell* copy = new Cell();
-                copy->key = cp->key;
-                copy->value = cp->value;
-                copy->next = nullptr;
-                if (!endOfChain) {
-                    // first node in bucket
-                    buckets.set(i, copy);
-                } else {
-                    // not first node; put after existing node
-                    endOfChain->next = copy;
-                    endOfChain = copy;
-                }
-                endOfChain = copy;
-                numEntries++;
+        // copy slot for slot, so that the copy iterates in the same order
+        // and has the same hash code as the original
+        allocate(src.capacity);
+        if (capacity > 0) {
+            std::memcpy(ctrl, src.ctrl, capacity);
+        }
+        for (int i = 0; i < capacity; i++) {
+            if (ctrl[i] >= 0) {
+                new (&slots[i]) Slot(src.slots[i]);
             }
         }
+        numEntries = src.numEntries;
+        growthLeft = src.growthLeft;
         m_version++;
     }
 
@@ -578,7 +753,7 @@ public:
      */
     HashMap& operator =(const HashMap& src) {
         if (this != &src) {
-            clear();
+            deallocate();
             deepCopy(src);
         }
         return *this;
@@ -598,52 +773,37 @@ public:
     class iterator : public std::iterator<std::input_iterator_tag, KeyType> {
     private:
         const HashMap* mp;           /* Pointer to the map           */
-        int bucket;                  /* Index of current bucket      */
+        int index;                   /* Index of current slot        */
         unsigned int itr_version;    /* Version for checking for modification */
-        Cell* cp;                    /* Current cell in bucket chain */
 
     public:
         iterator()
                 : mp(nullptr),
-                  bucket(0),
-                  itr_version(0),
-                  cp(nullptr) {
+                  index(0),
+                  itr_version(0) {
             // empty
         }
 
         iterator(const HashMap* mp, bool end)
                 : mp(mp),
-                  bucket(0),
-                  itr_version(0),
-                  cp(nullptr) {
+                  index(0),
+                  itr_version(0) {
             if (mp) {
                 itr_version = mp->version();
             }
-            if (end) {
-                bucket = mp->nBuckets;
-            } else {
-                bucket = 0;
-                cp = mp->buckets.get(bucket);
-                while (!cp && ++bucket < mp->nBuckets) {
-                    cp = mp->buckets.get(bucket);
-                }
-            }
+            index = end ? mp->capacity : mp->nextFullIndex(0);
         }
 
         iterator(const iterator& it)
                 : mp(it.mp),
-                  bucket(it.bucket),
-                  itr_version(it.itr_version),
-                  cp(it.cp) {
+                  index(it.index),
+                  itr_version(it.itr_version) {
             // empty
         }
 
         iterator& operator ++() {
             stanfordcpplib::collections::checkVersion(*mp, *this);
-            cp = cp->next;
-            while (!cp && ++bucket < mp->nBuckets) {
-                cp = mp->buckets.get(bucket);
-            }
+            index = mp->nextFullIndex(index + 1);
             return *this;
         }
 
@@ -655,7 +815,7 @@ public:
         }
 
         bool operator ==(const iterator& rhs) {
-            return mp == rhs.mp && bucket == rhs.bucket && cp == rhs.cp;
+            return mp == rhs.mp && index == rhs.index;
         }
 
         bool operator !=(const iterator& rhs) {
@@ -664,12 +824,12 @@ public:
 
         KeyType& operator *() {
             stanfordcpplib::collections::checkVersion(*mp, *this);
-            return cp->key;
+            return mp->slots[index].key;
         }
 
         KeyType* operator ->() {
             stanfordcpplib::collections::checkVersion(*mp, *this);
-            return &cp->key;
+            return &mp->slots[index].key;
         }
 
         unsigned int version() const {
@@ -705,29 +865,31 @@ public:
 /*
  * Implementation notes: HashMap class
  * -----------------------------------
- * In this map implementation, the entries are stored in a hashtable.
- * The hashtable keeps a vector of "buckets", where each bucket is a
- * linked list of elements that share the same hash code (i.e. hash
- * collisions are resolved by chaining). The buckets are dynamically
- * allocated so that we can change the the number of buckets (rehash)
- * when the load factor becomes too high. The map should provide O(1)
+ * In this map implementation, the entries are stored in an open-addressing
+ * hashtable.  Each key goes in the first free slot along its probe sequence,
+ * so looking it up means walking the same sequence, one 16-slot group at a
+ * time, until the key or an empty slot turns up.  Removing a key leaves a
+ * "deleted" marker behind unless nothing can have probed past it, and the
+ * table is rebuilt (doubling in size unless it is mostly deleted markers)
+ * once 7/8 of its slots have been used.  The map should provide O(1)
  * performance on the put/remove/get operations.
  */
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::HashMap() {
-    createBuckets(INITIAL_BUCKET_COUNT);
+    allocate(0);
+    numEntries = 0;
 }
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::HashMap(std::initializer_list<std::pair<KeyType, ValueType> > list) {
-    createBuckets(INITIAL_BUCKET_COUNT);
+    allocate(0);
+    numEntries = 0;
     putAll(list);
 }
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::~HashMap() {
-    deleteBuckets(buckets);
-    numEntries = 0;
+    deallocate();
 }
 
 template <typename KeyType, typename ValueType>
@@ -752,34 +914,23 @@ KeyType HashMap<KeyType, ValueType>::back() const {
         error("HashMap::back: map is empty");
     }
 
-    // find last non-null bucket
-    Cell* cell = nullptr;
-    for (int i = buckets.size() - 1; i >= 0; i--) {
-        cell = buckets[i];
-        if (cell) {
-            // find last non-null cell within bucket
-            while (cell->next) {
-                cell = cell->next;
-            }
-            return cell->key;
-        }
+    // find last full slot
+    int index = capacity - 1;
+    while (ctrl[index] < 0) {
+        index--;
     }
-
-    // we should never get here
-    error("HashMap::back: never found a non-empty cell bucket");
-    return cell->key;
+    return slots[index].key;
 }
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::clear() {
-    deleteBuckets(buckets);
-    numEntries = 0;
+    deallocate();
     m_version++;
 }
 
 template <typename KeyType, typename ValueType>
 bool HashMap<KeyType, ValueType>::containsKey(const KeyType& key) const {
-    return findCell(hashCode(key) % nBuckets, key) != nullptr;
+    return findIndex(key, hashFor(key)) >= 0;
 }
 
 template <typename KeyType, typename ValueType>
@@ -797,11 +948,11 @@ KeyType HashMap<KeyType, ValueType>::front() const {
 
 template <typename KeyType, typename ValueType>
 ValueType HashMap<KeyType, ValueType>::get(const KeyType& key) const {
-    Cell* cp = findCell(hashCode(key) % nBuckets, key);
-    if (!cp) {
+    int index = findIndex(key, hashFor(key));
+    if (index < 0) {
         return ValueType();
     }
-    return cp->value;
+    return slots[index].value;
 }
 
 template <typename KeyType, typename ValueType>
@@ -820,30 +971,24 @@ Vector<KeyType> HashMap<KeyType, ValueType>::keys() const {
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != nullptr; cp = cp->next) {
-            fn(cp->key, cp->value);
-        }
+    for (int i = nextFullIndex(0); i < capacity; i = nextFullIndex(i + 1)) {
+        fn(slots[i].key, slots[i].value);
     }
 }
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&,
                                                    const ValueType&)) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != nullptr; cp = cp->next) {
-            fn(cp->key, cp->value);
-        }
+    for (int i = nextFullIndex(0); i < capacity; i = nextFullIndex(i + 1)) {
+        fn(slots[i].key, slots[i].value);
     }
 }
 
 template <typename KeyType, typename ValueType>
 template <typename FunctorType>
 void HashMap<KeyType, ValueType>::mapAll(FunctorType fn) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != nullptr; cp = cp->next) {
-            fn(cp->key, cp->value);
-        }
+    for (int i = nextFullIndex(0); i < capacity; i = nextFullIndex(i + 1)) {
+        fn(slots[i].key, slots[i].value);
     }
 }
 
@@ -872,16 +1017,18 @@ HashMap<KeyType, ValueType>& HashMap<KeyType, ValueType>::putAll(
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::remove(const KeyType& key) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell *parent;
-    Cell* cp = findCell(bucket, key, parent);
-    if (cp) {
-        if (!parent) {
-            buckets[bucket] = cp->next;
+    int index = findIndex(key, hashFor(key));
+    if (index >= 0) {
+        slots[index].~Slot();
+        // a lookup only probes past this group if it has no empty slots,
+        // so if it does have one, this slot can go back to being empty too
+        int groupStart = index - index % GROUP_SIZE;
+        if (stanfordcpplib::collections::matchControlBytes(ctrl + groupStart, CTRL_EMPTY) != 0) {
+            ctrl[index] = CTRL_EMPTY;
+            growthLeft++;
         } else {
-            parent->next = cp->next;
+            ctrl[index] = CTRL_DELETED;
         }
-        delete cp;
         numEntries--;
         m_version++;
     }
@@ -953,22 +1100,20 @@ Vector<ValueType> HashMap<KeyType, ValueType>::values() const {
 
 template <typename KeyType, typename ValueType>
 ValueType& HashMap<KeyType, ValueType>::operator [](const KeyType& key) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell* cp = findCell(bucket, key);
-    if (!cp) {
-        if (numEntries > MAX_LOAD_PERCENTAGE * nBuckets / 100.0) {
-            expandAndRehash();
-            bucket = hashCode(key) % nBuckets;
+    std::size_t hash = hashFor(key);
+    int index = findIndex(key, hash);
+    if (index < 0) {
+        makeRoomForInsert();
+        index = findInsertIndex(hash);
+        new (&slots[index]) Slot{key, ValueType()};
+        if (ctrl[index] == CTRL_EMPTY) {
+            growthLeft--;
         }
-        cp = new Cell;
-        cp->key = key;
-        cp->value = ValueType();
-        cp->next = buckets[bucket];
-        buckets[bucket] = cp;
+        ctrl[index] = controlFor(hash);
         numEntries++;
         m_version++;
     }
-    return cp->value;
+    return slots[index].value;
 }
 
 template <typename KeyType, typename ValueType>
@@ -4,6 +4,9 @@
  * This file exports the template class <code>Map</code>, which
  * maintains a collection of <i>key</i>-<i>value</i> pairs.
  * 
+ * @version 2026/10/19
+ * - tree nodes come from a per-map NodePool by default (see nodepool.h);
+ *   the allocation policy is an optional third template argument
  * @version 2018/03/19
  * - added constructors that accept a comparison function
  * @version 2018/03/10
@@ -46,6 +49,7 @@
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
+#include "nodepool.h"
 #include "stack.h"
 #include "vector.h"
 
@@ -57,7 +61,8 @@
  * specified using templates, which makes it possible to use
  * this structure with any data type.
  */
-template <typename KeyType, typename ValueType>
+template <typename KeyType, typename ValueType,
+          template <typename> class NodeAllocator = NodePool>
 class Map {
 public:
     /*
@@ -449,6 +454,8 @@ public:
      * The map class is represented using a binary search tree.  The
      * specific implementation used here is the classic AVL algorithm
      * developed by Georgii Adel'son-Vel'skii and Evgenii Landis in 1962.
+     * Nodes are allocated through the NodeAllocator policy, which by default
+     * carves them out of a few large blocks owned by this map.
      */
 
 private:
@@ -570,6 +577,7 @@ private:
     BSTNode* root;      // pointer to the root of the tree
     int nodeCount;      // number of entries in the map
     Comparator* cmpp;   // pointer to the comparator
+    NodeAllocator<BSTNode> nodeAllocator;   // where the nodes come from
     unsigned int m_version = 0; // structure version for detecting invalid iterators
 
     // private methods
@@ -611,11 +619,7 @@ private:
     ValueType* addNode(BSTNode*& t, const KeyType& key, bool& heightFlag) {
         heightFlag = false;
         if (!t)  {
-            t = new BSTNode();
-            t->key = key;
-            t->value = ValueType();
-            t->bf = BST_IN_BALANCE;
-            t->left = t->right = nullptr;
+            t = new (nodeAllocator.allocate()) BSTNode{key, ValueType(), nullptr, nullptr, BST_IN_BALANCE};
             heightFlag = true;
             nodeCount++;
             return &t->value;
@@ -687,12 +691,12 @@ private:
         BSTNode* toDelete = t;
         if (!t->left) {
             t = t->right;
-            delete toDelete;
+            destroyNode(toDelete);
             nodeCount--;
             return true;
         } else if (!t->right) {
             t = t->left;
-            delete toDelete;
+            destroyNode(toDelete);
             nodeCount--;
             return true;
         } else {
@@ -840,10 +844,20 @@ private:
         if (t) {
             deleteTree(t->left);
             deleteTree(t->right);
-            delete t;
+            destroyNode(t);
         }
     }
 
+    /*
+     * Implementation notes: destroyNode(t)
+     * ------------------------------------
+     * Destroys a single node and gives its storage back to the allocator.
+     */
+    void destroyNode(BSTNode* t) {
+        t->~BSTNode();
+        nodeAllocator.deallocate(t);
+    }
+
     /*
      * Implementation notes: mapAll
      * ----------------------------
@@ -886,10 +900,7 @@ private:
         if (!t) {
             return nullptr;
         } else {
-            BSTNode* np = new BSTNode;
-            np->key = t->key;
-            np->value = t->value;
-            np->bf = t->bf;
+            BSTNode* np = new (nodeAllocator.allocate()) BSTNode{t->key, t->value, nullptr, nullptr, t->bf};
             np->left = copyTree(t->left);
             np->right = copyTree(t->right);
             return np;
@@ -1087,48 +1098,48 @@ public:
     unsigned int version() const;
 };
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>::Map() : root(nullptr), nodeCount(0) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>::Map() : root(nullptr), nodeCount(0) {
     cmpp = new TemplateComparator<std::less<KeyType> >(std::less<KeyType>());
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>::Map(bool lessFunc(KeyType, KeyType))
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>::Map(bool lessFunc(KeyType, KeyType))
         : root(nullptr), nodeCount(0) {
     cmpp = new FunctionComparator((void*) lessFunc);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>::Map(bool lessFunc(const KeyType&, const KeyType&))
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>::Map(bool lessFunc(const KeyType&, const KeyType&))
         : root(nullptr), nodeCount(0) {
     cmpp = new FunctionConstRefComparator((void*) lessFunc);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>::Map(std::initializer_list<std::pair<KeyType, ValueType> > list)
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>::Map(std::initializer_list<std::pair<KeyType, ValueType> > list)
         : root(nullptr), nodeCount(0) {
     cmpp = new TemplateComparator<std::less<KeyType> >(std::less<KeyType>());
     putAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>::Map(std::initializer_list<std::pair<KeyType, ValueType> > list,
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>::Map(std::initializer_list<std::pair<KeyType, ValueType> > list,
                              bool lessFunc(KeyType, KeyType))
         : root(nullptr), nodeCount(0) {
     cmpp = new FunctionComparator((void*) lessFunc);
     putAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>::Map(std::initializer_list<std::pair<KeyType, ValueType> > list,
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>::Map(std::initializer_list<std::pair<KeyType, ValueType> > list,
                              bool lessFunc(const KeyType&, const KeyType&))
         : root(nullptr), nodeCount(0) {
     cmpp = new FunctionConstRefComparator((void*) lessFunc);
     putAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>::~Map() {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>::~Map() {
     clear();
     if (cmpp) {
         delete cmpp;
@@ -1136,25 +1147,25 @@ Map<KeyType, ValueType>::~Map() {
     }
 }
 
-template <typename KeyType, typename ValueType>
-void Map<KeyType, ValueType>::add(const KeyType& key,
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+void Map<KeyType, ValueType, NodeAllocator>::add(const KeyType& key,
                                   const ValueType& value) {
     put(key, value);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::addAll(const Map& map2) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::addAll(const Map& map2) {
     return putAll(map2);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::addAll(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::addAll(
         std::initializer_list<std::pair<KeyType, ValueType> > list) {
     return putAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-KeyType Map<KeyType, ValueType>::back() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+KeyType Map<KeyType, ValueType, NodeAllocator>::back() const {
     if (isEmpty()) {
         error("Map::back: map is empty");
     }
@@ -1165,34 +1176,34 @@ KeyType Map<KeyType, ValueType>::back() const {
     return node->key;
 }
 
-template <typename KeyType, typename ValueType>
-void Map<KeyType, ValueType>::clear() {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+void Map<KeyType, ValueType, NodeAllocator>::clear() {
     deleteTree(root);
     root = nullptr;
     nodeCount = 0;
     m_version++;
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::containsKey(const KeyType& key) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::containsKey(const KeyType& key) const {
     return findNode(root, key) != nullptr;
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::equals(const Map<KeyType, ValueType>& map2) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::equals(const Map<KeyType, ValueType, NodeAllocator>& map2) const {
     return stanfordcpplib::collections::equalsMap(*this, map2);
 }
 
-template <typename KeyType, typename ValueType>
-KeyType Map<KeyType, ValueType>::front() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+KeyType Map<KeyType, ValueType, NodeAllocator>::front() const {
     if (isEmpty()) {
         error("Map::front: map is empty");
     }
     return *begin();
 }
 
-template <typename KeyType, typename ValueType>
-ValueType Map<KeyType, ValueType>::get(const KeyType& key) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+ValueType Map<KeyType, ValueType, NodeAllocator>::get(const KeyType& key) const {
     ValueType* vp = findNode(root, key);
     if (!vp) {
         return ValueType();
@@ -1200,13 +1211,13 @@ ValueType Map<KeyType, ValueType>::get(const KeyType& key) const {
     return *vp;
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::isEmpty() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::isEmpty() const {
     return nodeCount == 0;
 }
 
-template <typename KeyType,typename ValueType>
-Vector<KeyType> Map<KeyType, ValueType>::keys() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Vector<KeyType> Map<KeyType, ValueType, NodeAllocator>::keys() const {
     Vector<KeyType> keyset;
     for (const KeyType& key : *this) {
         keyset.add(key);
@@ -1214,41 +1225,41 @@ Vector<KeyType> Map<KeyType, ValueType>::keys() const {
     return keyset;
 }
 
-template <typename KeyType, typename ValueType>
-void Map<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+void Map<KeyType, ValueType, NodeAllocator>::mapAll(void (*fn)(KeyType, ValueType)) const {
     mapAll(root, fn);
 }
 
-template <typename KeyType, typename ValueType>
-void Map<KeyType, ValueType>::mapAll(void (*fn)(const KeyType &,
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+void Map<KeyType, ValueType, NodeAllocator>::mapAll(void (*fn)(const KeyType &,
                                                 const ValueType &)) const {
     mapAll(root, fn);
 }
 
-template <typename KeyType, typename ValueType>
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
 template <typename FunctorType>
-void Map<KeyType, ValueType>::mapAll(FunctorType fn) const {
+void Map<KeyType, ValueType, NodeAllocator>::mapAll(FunctorType fn) const {
     mapAll(root, fn);
 }
 
-template <typename KeyType, typename ValueType>
-void Map<KeyType, ValueType>::put(const KeyType& key,
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+void Map<KeyType, ValueType, NodeAllocator>::put(const KeyType& key,
                                   const ValueType& value) {
     bool dummy;
     *addNode(root, key, dummy) = value;
     m_version++;
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::putAll(const Map& map2) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::putAll(const Map& map2) {
     for (const KeyType& key : map2) {
         put(key, map2.get(key));
     }
     return *this;
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::putAll(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::putAll(
         std::initializer_list<std::pair<KeyType, ValueType> > list) {
     for (const std::pair<KeyType, ValueType>& pair : list) {
         put(pair.first, pair.second);
@@ -1256,14 +1267,14 @@ Map<KeyType, ValueType>& Map<KeyType, ValueType>::putAll(
     return *this;
 }
 
-template <typename KeyType, typename ValueType>
-void Map<KeyType, ValueType>::remove(const KeyType& key) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+void Map<KeyType, ValueType, NodeAllocator>::remove(const KeyType& key) {
     removeNode(root, key);
     m_version++;
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::removeAll(const Map& map2) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::removeAll(const Map& map2) {
     for (const KeyType& key : map2) {
         if (containsKey(key) && get(key) == map2.get(key)) {
             remove(key);
@@ -1272,8 +1283,8 @@ Map<KeyType, ValueType>& Map<KeyType, ValueType>::removeAll(const Map& map2) {
     return *this;
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::removeAll(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::removeAll(
         std::initializer_list<std::pair<KeyType, ValueType> > list) {
     for (const std::pair<KeyType, ValueType>& pair : list) {
         if (containsKey(pair.first) && get(pair.first) == pair.second) {
@@ -1283,8 +1294,8 @@ Map<KeyType, ValueType>& Map<KeyType, ValueType>::removeAll(
     return *this;
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::retainAll(const Map& map2) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::retainAll(const Map& map2) {
     Vector<KeyType> toRemove;
     for (const KeyType& key : *this) {
         if (!map2.containsKey(key) || get(key) != map2.get(key)) {
@@ -1297,21 +1308,21 @@ Map<KeyType, ValueType>& Map<KeyType, ValueType>::retainAll(const Map& map2) {
     return *this;
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::retainAll(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::retainAll(
         std::initializer_list<std::pair<KeyType, ValueType> > list) {
-    Map<KeyType, ValueType> map2(list);
+    Map<KeyType, ValueType, NodeAllocator> map2(list);
     retainAll(map2);
     return *this;
 }
 
-template <typename KeyType, typename ValueType>
-int Map<KeyType, ValueType>::size() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+int Map<KeyType, ValueType, NodeAllocator>::size() const {
     return nodeCount;
 }
 
-template <typename KeyType, typename ValueType>
-std::map<KeyType, ValueType> Map<KeyType, ValueType>::toStlMap() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+std::map<KeyType, ValueType> Map<KeyType, ValueType, NodeAllocator>::toStlMap() const {
     std::map<KeyType, ValueType> result;
     for (const KeyType& key : *this) {
         result[key] = this->get(key);
@@ -1319,15 +1330,15 @@ std::map<KeyType, ValueType> Map<KeyType, ValueType>::toStlMap() const {
     return result;
 }
 
-template <typename KeyType, typename ValueType>
-std::string Map<KeyType, ValueType>::toString() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+std::string Map<KeyType, ValueType, NodeAllocator>::toString() const {
     std::ostringstream os;
     os << *this;
     return os.str();
 }
 
-template <typename KeyType,typename ValueType>
-Vector<ValueType> Map<KeyType, ValueType>::values() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Vector<ValueType> Map<KeyType, ValueType, NodeAllocator>::values() const {
     Vector<ValueType> values;
     for (const KeyType& key : *this) {
         values.add(this->get(key));
@@ -1335,121 +1346,121 @@ Vector<ValueType> Map<KeyType, ValueType>::values() const {
     return values;
 }
 
-template <typename KeyType,typename ValueType>
-unsigned int  Map<KeyType, ValueType>::version() const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+unsigned int  Map<KeyType, ValueType, NodeAllocator>::version() const {
     return m_version;
 }
 
-template <typename KeyType, typename ValueType>
-ValueType & Map<KeyType, ValueType>::operator [](const KeyType& key) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+ValueType & Map<KeyType, ValueType, NodeAllocator>::operator [](const KeyType& key) {
     bool dummy;
     return *addNode(root, key, dummy);
 }
 
-template <typename KeyType, typename ValueType>
-ValueType Map<KeyType, ValueType>::operator [](const KeyType& key) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+ValueType Map<KeyType, ValueType, NodeAllocator>::operator [](const KeyType& key) const {
     return get(key);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType> Map<KeyType, ValueType>::operator +(const Map& map2) const {
-    Map<KeyType, ValueType> result = *this;
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator> Map<KeyType, ValueType, NodeAllocator>::operator +(const Map& map2) const {
+    Map<KeyType, ValueType, NodeAllocator> result = *this;
     return result.putAll(map2);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType> Map<KeyType, ValueType>::operator +(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator> Map<KeyType, ValueType, NodeAllocator>::operator +(
         std::initializer_list<std::pair<KeyType, ValueType> > list) const {
-    Map<KeyType, ValueType> result = *this;
+    Map<KeyType, ValueType, NodeAllocator> result = *this;
     return result.putAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::operator +=(const Map& map2) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::operator +=(const Map& map2) {
     return putAll(map2);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::operator +=(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::operator +=(
         std::initializer_list<std::pair<KeyType, ValueType> > list) {
     return putAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType> Map<KeyType, ValueType>::operator -(const Map& map2) const {
-    Map<KeyType, ValueType> result = *this;
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator> Map<KeyType, ValueType, NodeAllocator>::operator -(const Map& map2) const {
+    Map<KeyType, ValueType, NodeAllocator> result = *this;
     return result.removeAll(map2);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType> Map<KeyType, ValueType>::operator -(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator> Map<KeyType, ValueType, NodeAllocator>::operator -(
         std::initializer_list<std::pair<KeyType, ValueType> > list) const {
-    Map<KeyType, ValueType> result = *this;
+    Map<KeyType, ValueType, NodeAllocator> result = *this;
     return result.removeAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::operator -=(const Map& map2) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::operator -=(const Map& map2) {
     return removeAll(map2);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::operator -=(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::operator -=(
         std::initializer_list<std::pair<KeyType, ValueType> > list) {
     return removeAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType> Map<KeyType, ValueType>::operator *(const Map& map2) const {
-    Map<KeyType, ValueType> result = *this;
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator> Map<KeyType, ValueType, NodeAllocator>::operator *(const Map& map2) const {
+    Map<KeyType, ValueType, NodeAllocator> result = *this;
     return result.retainAll(map2);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType> Map<KeyType, ValueType>::operator *(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator> Map<KeyType, ValueType, NodeAllocator>::operator *(
         std::initializer_list<std::pair<KeyType, ValueType> > list) const {
-    Map<KeyType, ValueType> result = *this;
+    Map<KeyType, ValueType, NodeAllocator> result = *this;
     return result.retainAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::operator *=(const Map& map2) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::operator *=(const Map& map2) {
     return retainAll(map2);
 }
 
-template <typename KeyType, typename ValueType>
-Map<KeyType, ValueType>& Map<KeyType, ValueType>::operator *=(
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+Map<KeyType, ValueType, NodeAllocator>& Map<KeyType, ValueType, NodeAllocator>::operator *=(
         std::initializer_list<std::pair<KeyType, ValueType> > list) {
     return retainAll(list);
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::operator ==(const Map& map2) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::operator ==(const Map& map2) const {
     return equals(map2);
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::operator !=(const Map& map2) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::operator !=(const Map& map2) const {
     return !equals(map2);   // BUGFIX 2016/01/27, thanks to O. Zeng
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::operator <(const Map& map2) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::operator <(const Map& map2) const {
     return stanfordcpplib::collections::compareMaps(*this, map2) < 0;
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::operator <=(const Map& map2) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::operator <=(const Map& map2) const {
     return stanfordcpplib::collections::compareMaps(*this, map2) <= 0;
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::operator >(const Map& map2) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::operator >(const Map& map2) const {
     return stanfordcpplib::collections::compareMaps(*this, map2) > 0;
 }
 
-template <typename KeyType, typename ValueType>
-bool Map<KeyType, ValueType>::operator >=(const Map& map2) const {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+bool Map<KeyType, ValueType, NodeAllocator>::operator >=(const Map& map2) const {
     return stanfordcpplib::collections::compareMaps(*this, map2) >= 0;
 }
 
@@ -1460,14 +1471,14 @@ bool Map<KeyType, ValueType>::operator >=(const Map& map2) const {
  * strlib.h to read and write generic values in a way that treats strings
  * specially.
  */
-template <typename KeyType, typename ValueType>
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
 std::ostream& operator <<(std::ostream& os,
-                          const Map<KeyType, ValueType>& map) {
+                          const Map<KeyType, ValueType, NodeAllocator>& map) {
     return stanfordcpplib::collections::writeMap(os, map);
 }
 
-template <typename KeyType, typename ValueType>
-std::istream& operator >>(std::istream& is, Map<KeyType,ValueType>& map) {
+template <typename KeyType, typename ValueType, template <typename> class NodeAllocator>
+std::istream& operator >>(std::istream& is, Map<KeyType, ValueType, NodeAllocator>& map) {
     KeyType key;
     ValueType value;
     return stanfordcpplib::collections::readMap(is, map, key, value, /* descriptor */ std::string("Map::operator >>"));
@@ -1477,8 +1488,8 @@ std::istream& operator >>(std::istream& is, Map<KeyType,ValueType>& map) {
  * Template hash function for maps.
  * Requires the key and value types in the Map to have a hashCode function.
  */
-template <typename K, typename V>
-int hashCode(const Map<K, V>& map) {
+template <typename K, typename V, template <typename> class A>
+int hashCode(const Map<K, V, A>& map) {
     return stanfordcpplib::collections::hashCodeMap(map);
 }
 
@@ -1489,8 +1500,8 @@ int hashCode(const Map<K, V>& map) {
  * Returns a randomly chosen key of the given map.
  * Throws an error if the map is empty.
  */
-template <typename K, typename V>
-const K& randomKey(const Map<K, V>& map) {
+template <typename K, typename V, template <typename> class A>
+const K& randomKey(const Map<K, V, A>& map) {
     if (map.isEmpty()) {
         error("randomKey: empty map was passed");
     }
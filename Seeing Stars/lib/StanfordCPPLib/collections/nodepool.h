@@ -0,0 +1,212 @@
+/*
+ * File: nodepool.h
+ * ----------------
+ * This file exports the <code>NodePool</code> and <code>NodeHeap</code>
+ * class templates, which are the node allocation policies for the
+ * tree-based collections.  A <code>Map</code> (and so every <code>Set</code>
+ * and <code>BasicGraph</code>, which are built on maps) gets its tree nodes
+ * from a <code>NodePool</code> unless another policy is named as its third
+ * template argument:
+ *
+ *<pre>
+ *    Map<string, int> pooled;                 // same as Map<string, int, NodePool>
+ *    Map<string, int, NodeHeap> unpooled;     // one new/delete per node
+ *</pre>
+ *
+ * A policy is a class template taking the node type.  It must provide
+ * <code>allocate()</code>, returning uninitialized storage for one node, and
+ * <code>deallocate(node)</code>, taking back storage whose node has already
+ * been destroyed.  Each collection has its own allocator, and never copies it.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#ifndef _nodepool_h
+#define _nodepool_h
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/*
+ * Class: NodePool<NodeType>
+ * -------------------------
+ * Hands out nodes from blocks of memory.  The first block holds a few nodes,
+ * so that small collections stay small, and each one after that is twice
+ * the size of the last, up to a limit; blocks big enough to span several
+ * cache lines start on a cache-line boundary.  Freed nodes go on a free
+ * list and are reused before any more of a block is used.  All the blocks
+ * are released once the last node has been given back.
+ *
+ * Keeping a tree's nodes side by side like this makes adding a node much
+ * cheaper than a trip to the general-purpose allocator, and makes walking
+ * the tree touch fewer cache lines.
+ */
+template <typename NodeType>
+class NodePool {
+public:
+    NodePool();
+    ~NodePool();
+
+    /*
+     * Method: allocate
+     * Usage: NodeType* node = new (pool.allocate()) NodeType(...);
+     * ------------------------------------------------------------
+     * Returns uninitialized storage for one node.
+     */
+    NodeType* allocate();
+
+    /*
+     * Method: deallocate
+     * Usage: node->~NodeType(); pool.deallocate(node);
+     * ------------------------------------------------
+     * Takes back the storage for a node that has been destroyed.
+     */
+    void deallocate(NodeType* node);
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    /* Constant definitions */
+    static const std::size_t CACHE_LINE_SIZE = 64;
+    static const std::size_t FIRST_BLOCK_NODES = 4;
+    static const std::size_t MIN_ALIGNED_BLOCK_BYTES = 1024;
+    static const std::size_t MAX_BLOCK_BYTES = 16384;
+
+    /* A node's storage, which holds the free list link while it is free */
+    union Slot {
+        Slot* nextFree;
+        alignas(NodeType) unsigned char storage[sizeof(NodeType)];
+    };
+
+    /* Bookkeeping at the end of each block, after its nodes */
+    struct BlockHeader {
+        BlockHeader* next;       // the block allocated before this one
+        void* memory;            // what to pass to operator delete
+    };
+
+    /* Instance variables */
+    Slot* freeList;              // nodes given back, most recent first
+    Slot* unused;                // next never-used slot in the newest block
+    Slot* unusedEnd;             // end of the newest block
+    BlockHeader* blocks;         // newest block first
+    std::size_t nextBlockNodes;  // size of the next block to allocate
+    std::size_t liveNodes;       // nodes handed out and not yet given back
+
+    /* Private methods */
+    void addBlock();
+    void releaseBlocks();
+
+    /* Each collection makes its own pool, so pools are never copied */
+    NodePool(const NodePool&) = delete;
+    NodePool& operator =(const NodePool&) = delete;
+};
+
+/*
+ * Class: NodeHeap<NodeType>
+ * -------------------------
+ * Allocates each node separately with operator new, as the collections did
+ * before they had allocation policies.
+ */
+template <typename NodeType>
+class NodeHeap {
+public:
+    NodeType* allocate() {
+        return static_cast<NodeType*>(::operator new(sizeof(NodeType)));
+    }
+
+    void deallocate(NodeType* node) {
+        ::operator delete(node);
+    }
+};
+
+template <typename NodeType>
+NodePool<NodeType>::NodePool()
+        : freeList(nullptr),
+          unused(nullptr),
+          unusedEnd(nullptr),
+          blocks(nullptr),
+          nextBlockNodes(FIRST_BLOCK_NODES),
+          liveNodes(0) {
+    // empty
+}
+
+template <typename NodeType>
+NodePool<NodeType>::~NodePool() {
+    releaseBlocks();
+}
+
+template <typename NodeType>
+NodeType* NodePool<NodeType>::allocate() {
+    Slot* slot;
+    if (freeList) {
+        slot = freeList;
+        freeList = slot->nextFree;
+    } else {
+        if (unused == unusedEnd) {
+            addBlock();
+        }
+        slot = unused++;
+    }
+    liveNodes++;
+    return reinterpret_cast<NodeType*>(slot->storage);
+}
+
+template <typename NodeType>
+void NodePool<NodeType>::deallocate(NodeType* node) {
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->nextFree = freeList;
+    freeList = slot;
+    if (--liveNodes == 0) {
+        releaseBlocks();
+    }
+}
+
+/*
+ * Implementation notes: addBlock
+ * ------------------------------
+ * operator new only promises alignment suitable for any fundamental type,
+ * so a large block asks for an extra cache line and starts at the first
+ * cache-line boundary within it.  Small blocks aren't worth the padding.
+ * The header goes after the nodes, where a Slot-aligned address is also
+ * suitably aligned for it.
+ */
+template <typename NodeType>
+void NodePool<NodeType>::addBlock() {
+    std::size_t nodeBytes = nextBlockNodes * sizeof(Slot);
+    bool alignToLine = nodeBytes >= MIN_ALIGNED_BLOCK_BYTES;
+    std::uintptr_t lineMask = alignToLine ? CACHE_LINE_SIZE - 1 : 0;
+    void* memory = ::operator new(nodeBytes + sizeof(BlockHeader) + lineMask);
+    std::uintptr_t address = (reinterpret_cast<std::uintptr_t>(memory) + lineMask) & ~lineMask;
+    unsigned char* start = reinterpret_cast<unsigned char*>(address);
+
+    BlockHeader* header = new (start + nodeBytes) BlockHeader;
+    header->next = blocks;
+    header->memory = memory;
+    blocks = header;
+
+    unused = reinterpret_cast<Slot*>(start);
+    unusedEnd = unused + nextBlockNodes;
+    if ((nextBlockNodes * 2) * sizeof(Slot) <= MAX_BLOCK_BYTES) {
+        nextBlockNodes *= 2;
+    }
+}
+
+template <typename NodeType>
+void NodePool<NodeType>::releaseBlocks() {
+    while (blocks) {
+        BlockHeader* next = blocks->next;
+        ::operator delete(blocks->memory);
+        blocks = next;
+    }
+    freeList = unused = unusedEnd = nullptr;
+    nextBlockNodes = FIRST_BLOCK_NODES;
+}
+
+#endif // _nodepool_h
@@ -4,6 +4,10 @@
  * This file exports the <code>PriorityQueue</code> class, a
  * collection in which values are processed in priority order.
  * 
+ * @version 2026/10/19
+ * - heap is now 4-ary, and sifts entries along a hole rather than swapping
+ * - enqueue returns a Handle; changePriority and contains take one in O(log n)
+ * - added constructor that builds the heap from a range of pairs in O(n)
  * @version 2016/11/07
  * - small const-correctness bug fix in front() / back() (courtesy Truman Cranor)
  * @version 2016/10/14
@@ -45,8 +49,10 @@
 #ifndef _priorityqueue_h
 #define _priorityqueue_h
 
+#include <algorithm>
 #include <cmath>
 #include <initializer_list>
+#include <iterator>
 #include <utility>
 #include "collections.h"
 #include "error.h"
@@ -67,6 +73,37 @@
 template <typename ValueType>
 class PriorityQueue {
 public:
+    /*
+     * Class: PriorityQueue<ValueType>::Handle
+     * ---------------------------------------
+     * Identifies one entry in a priority queue, as returned by
+     * <code>enqueue</code>, so that its priority can be changed without
+     * searching the queue for it.  A handle stops referring to its entry
+     * once that entry is dequeued or the queue is cleared, and
+     * <code>contains</code> says whether it still does.  A default-constructed
+     * handle refers to nothing.
+     */
+    class Handle {
+    public:
+        Handle()
+                : slot(-1),
+                  sequence(-1) {
+            // empty
+        }
+
+    private:
+        Handle(int theSlot, long theSequence)
+                : slot(theSlot),
+                  sequence(theSequence) {
+            // empty
+        }
+
+        int slot;         // index into the queue's slot table
+        long sequence;    // the entry's enqueue sequence number
+
+        friend class PriorityQueue;
+    };
+
     /*
      * Constructor: PriorityQueue
      * Usage: PriorityQueue<ValueType> pq;
@@ -85,6 +122,18 @@ public:
      */
     PriorityQueue(std::initializer_list<std::pair<double, ValueType> > list);
 
+    /*
+     * Constructor: PriorityQueue
+     * Usage: PriorityQueue<ValueType> pq(pairs.begin(), pairs.end());
+     * ---------------------------------------------------------------
+     * Initializes a new priority queue that stores the (priority, value)
+     * pairs in the given range.  The heap is built in one pass, in time
+     * linear in the number of pairs, which is faster than enqueuing them
+     * one by one.  Pairs of equal priority are dequeued in range order.
+     */
+    template <typename InputIterator>
+    PriorityQueue(InputIterator begin, InputIterator end);
+
     /*
      * Destructor: ~PriorityQueue
      * --------------------------
@@ -98,7 +147,7 @@ public:
      * -------------------------------
      * A synonym for the enqueue method.
      */
-    void add(const ValueType& value, double priority);
+    Handle add(const ValueType& value, double priority);
     
     /*
      * Method: back
@@ -117,9 +166,22 @@ public:
      * priority in the queue.
      * Throws an error if the element value is not present in the queue, or if the
      * new priority passed is not at least as urgent as its current priority.
+     * This form must search the queue for the value; the form that takes
+     * a handle does not.
      */
     void changePriority(ValueType value, double newPriority);
 
+    /*
+     * Method: changePriority
+     * Usage: pq.changePriority(handle, newPriority);
+     * ----------------------------------------------
+     * Gives the entry identified by <code>handle</code> the specified new
+     * priority, which may be more or less urgent than its old one, in
+     * O(log n) time.  Throws an error if the handle no longer refers to an
+     * entry in this queue.
+     */
+    void changePriority(Handle handle, double newPriority);
+
     /*
      * Method: clear
      * Usage: pq.clear();
@@ -127,6 +189,16 @@ public:
      * Removes all elements from the priority queue.
      */
     void clear();
+
+    /*
+     * Method: contains
+     * Usage: if (pq.contains(handle)) ...
+     * -----------------------------------
+     * Returns <code>true</code> if the given handle still refers to an
+     * entry in this queue, that is, if the value it was returned for has
+     * not yet been dequeued.
+     */
+    bool contains(Handle handle) const;
     
     /*
      * Method: dequeue
@@ -145,9 +217,10 @@ public:
      * Adds <code>value</code> to the queue with the specified priority.
      * Lower priority numbers correspond to higher priorities, which
      * means that all priority 1 elements are dequeued before any
-     * priority 2 elements.
+     * priority 2 elements.  Returns a handle to the new entry, which
+     * may be passed to <code>changePriority</code>.
      */
-    void enqueue(const ValueType& value, double priority);
+    Handle enqueue(const ValueType& value, double priority);
     
     /*
      * Method: equals
@@ -262,30 +335,49 @@ public:
      * Implementation notes: PriorityQueue data structure
      * --------------------------------------------------
      * The PriorityQueue class is implemented using a data structure called
-     * a heap.
+     * a heap, stored in a Vector.  Each node has up to four children rather
+     * than two: the children of the entry at index i are at 4i+1 to 4i+4.
+     * That halves the height of the tree, and the four children sit next
+     * to each other in memory, so a dequeue touches about half as many
+     * cache lines as it would in a binary heap.
+     *
+     * Each entry has a slot in a table that records where in the heap the
+     * entry is, and the table is updated every time an entry moves.  A
+     * Handle names the slot, along with the entry's sequence number so that
+     * a handle to a dequeued entry can't be mistaken for a later entry
+     * that was given the same slot.
      */
 private:
+    /* Constant definitions */
+    static const int ARITY = 4;
+
     /* Type used for each heap entry */
     struct HeapEntry {
         ValueType value;
         double priority;
         long sequence;
+        int slot;
     };
 
     /* Instance variables */
     Vector<HeapEntry> heap;
+    Vector<int> slots;         // slot -> heap index, or -1 if the slot is free
+    Vector<int> freeSlots;     // slots to reuse before adding new ones
     long enqueueCount;
-    int backIndex;
+    int backSlot;              // slot of the least urgent entry, or -1 if unknown
     int count;
-    int capacity;
 
     /* Private function prototypes */
     const HeapEntry& heapGet(int index) const;
 #ifdef PQUEUE_COMPARISON_OPERATORS_ENABLED
     int pqCompare(const PriorityQueue& other) const;
 #endif // PQUEUE_COMPARISON_OPERATORS_ENABLED
-    bool takesPriority(int i1, int i2);
-    void swapHeapEntries(int i1, int i2);
+    int allocateSlot();
+    double checkPriority(double priority, const char* member) const;
+    void noteBack(int slot);
+    void siftDown(int index);
+    void siftUp(int index);
+    bool takesPriority(const HeapEntry& e1, const HeapEntry& e2) const;
 
     /*
      * Iterator support
@@ -403,16 +495,46 @@ public:
 };
 
 template <typename ValueType>
-PriorityQueue<ValueType>::PriorityQueue() {
-    clear();
+PriorityQueue<ValueType>::PriorityQueue()
+        : enqueueCount(0),
+          backSlot(-1),
+          count(0) {
+    // empty
 }
 
 template <typename ValueType>
 PriorityQueue<ValueType>::PriorityQueue(
-        std::initializer_list<std::pair<double, ValueType> > list) {
-    clear();
-    for (std::pair<double, ValueType> pair : list) {
-        enqueue(pair.second, pair.first);
+        std::initializer_list<std::pair<double, ValueType> > list)
+        : PriorityQueue(list.begin(), list.end()) {
+    // empty
+}
+
+/*
+ * Implementation notes: range constructor
+ * ---------------------------------------
+ * The pairs go into the heap array in range order, and then each node
+ * that has children, from the last one back to the root, is sifted down
+ * into place (Floyd's algorithm).  Most nodes are near the bottom and
+ * have little distance to sift, so the whole build takes linear time.
+ */
+template <typename ValueType>
+template <typename InputIterator>
+PriorityQueue<ValueType>::PriorityQueue(InputIterator begin, InputIterator end)
+        : enqueueCount(0),
+          backSlot(-1),
+          count(0) {
+    for (InputIterator it = begin; it != end; ++it) {
+        const std::pair<double, ValueType>& pair = *it;
+        int slot = allocateSlot();
+        slots[slot] = count;
+        heap.add(HeapEntry{pair.second, checkPriority(pair.first, "constructor"),
+                           enqueueCount++, slot});
+        count++;
+    }
+    if (count > 1) {
+        for (int i = (count - 2) / ARITY; i >= 0; i--) {
+            siftDown(i);
+        }
     }
 }
 
@@ -428,16 +550,34 @@ PriorityQueue<ValueType>::~PriorityQueue() {
 }
 
 template <typename ValueType>
-void PriorityQueue<ValueType>::add(const ValueType& value, double priority) {
-    enqueue(value, priority);
+typename PriorityQueue<ValueType>::Handle
+PriorityQueue<ValueType>::add(const ValueType& value, double priority) {
+    return enqueue(value, priority);
 }
 
+/*
+ * Implementation notes: back
+ * --------------------------
+ * The slot of the least urgent entry is kept up to date as entries are
+ * enqueued and reprioritized, but it is forgotten when that entry is
+ * dequeued or made more urgent, and is then found again by looking at
+ * every entry the next time it is asked for.
+ */
 template <typename ValueType>
 ValueType & PriorityQueue<ValueType>::back() {
     if (count == 0) {
         error("PriorityQueue::back: Attempting to read back of an empty queue");
     }
-    return heap[backIndex].value;
+    if (backSlot < 0) {
+        int backIndex = 0;
+        for (int i = 1; i < count; i++) {
+            if (takesPriority(heap[backIndex], heap[i])) {
+                backIndex = i;
+            }
+        }
+        backSlot = heap[backIndex].slot;
+    }
+    return heap[slots[backSlot]].value;
 }
 
 /*
@@ -447,12 +587,7 @@ ValueType & PriorityQueue<ValueType>::back() {
  */
 template <typename ValueType>
 void PriorityQueue<ValueType>::changePriority(ValueType value, double newPriority) {
-    if (std::isnan(newPriority)) {
-        error("PriorityQueue::changePriority: Attempted to use NaN as a priority.");
-    }
-    if (floatingPointEqual(newPriority, -0.0)) {
-        newPriority = 0.0;
-    }
+    newPriority = checkPriority(newPriority, "changePriority");
 
     // find the element in the pqueue; must use a simple iteration over elements
     for (int i = 0; i < count; i++) {
@@ -461,18 +596,13 @@ void PriorityQueue<ValueType>::changePriority(ValueType value, double newPriorit
                 error("PriorityQueue::changePriority: new priority cannot be less urgent than current priority.");
             }
             heap[i].priority = newPriority;
+            if (heap[i].slot == backSlot) {
+                backSlot = -1;
+            }
 
             // after changing the priority, must percolate up to proper level
             // to maintain heap ordering
-            while (i > 0) {
-                int parent = (i - 1) / 2;
-                if (takesPriority(parent, i)) {
-                    break;
-                }
-                swapHeapEntries(parent, i);
-                i = parent;
-            }
-
+            siftUp(i);
             return;
         }
     }
@@ -481,11 +611,49 @@ void PriorityQueue<ValueType>::changePriority(ValueType value, double newPriorit
     error("PriorityQueue::changePriority: Element value not found.");
 }
 
+template <typename ValueType>
+void PriorityQueue<ValueType>::changePriority(Handle handle, double newPriority) {
+    newPriority = checkPriority(newPriority, "changePriority");
+    if (!contains(handle)) {
+        error("PriorityQueue::changePriority: Handle does not refer to a value in the queue.");
+    }
+    int index = slots[handle.slot];
+    double oldPriority = heap[index].priority;
+    heap[index].priority = newPriority;
+    if (newPriority < oldPriority) {
+        if (handle.slot == backSlot) {
+            backSlot = -1;
+        }
+        siftUp(index);
+    } else {
+        noteBack(handle.slot);
+        siftDown(index);
+    }
+}
+
+/*
+ * Implementation notes: clear
+ * ---------------------------
+ * The sequence numbers carry on from where they were rather than
+ * starting over, so that no handle from before the queue was cleared
+ * can match an entry added after.
+ */
 template <typename ValueType>
 void PriorityQueue<ValueType>::clear() {
     heap.clear();
+    slots.clear();
+    freeSlots.clear();
     count = 0;
-    enqueueCount = 0;   // BUGFIX 2014/10/10: was previously using garbage unassigned value
+    backSlot = -1;
+}
+
+template <typename ValueType>
+bool PriorityQueue<ValueType>::contains(Handle handle) const {
+    if (handle.slot < 0 || handle.slot >= slots.size()) {
+        return false;
+    }
+    int index = slots[handle.slot];
+    return index >= 0 && heap[index].sequence == handle.sequence;
 }
 
 /*
@@ -500,59 +668,34 @@ ValueType PriorityQueue<ValueType>::dequeue() {
         error("PriorityQueue::dequeue: Attempting to dequeue an empty queue");
     }
     count--;
-    bool wasBack = (backIndex == count);
-    ValueType value = heap[0].value;
-    swapHeapEntries(0, count);
-    int index = 0;
-    while (true) {
-        int left = 2 * index + 1;
-        int right = 2 * index + 2;
-        if (left >= count) {
-            break;
-        }
-        int child = left;
-        if (right < count && takesPriority(right, left)) {
-            child = right;
-        }
-        if (takesPriority(index, child)) {
-            break;
-        }
-        swapHeapEntries(index, child);
-        index = child;
+    ValueType value = std::move(heap[0].value);
+    int slot = heap[0].slot;
+    slots[slot] = -1;
+    freeSlots.add(slot);
+    if (slot == backSlot) {
+        backSlot = -1;
+    }
+    if (count > 0) {
+        heap[0] = std::move(heap[count]);
     }
-    if (wasBack) {
-        backIndex = index;
+    heap.remove(count);
+    if (count > 0) {
+        siftDown(0);
     }
     return value;
 }
 
 template <typename ValueType>
-void PriorityQueue<ValueType>::enqueue(const ValueType& value, double priority) {
-    if (std::isnan(priority)) {
-        error("PriorityQueue::enqueue: Attempted to use NaN as a priority.");
-    }
-    if (floatingPointEqual(priority, -0.0)) {
-        priority = 0.0;
-    }
-
-    if (count == heap.size()) {
-        heap.add(HeapEntry());
-    }
-    int index = count++;
-    heap[index].value = value;
-    heap[index].priority = priority;
-    heap[index].sequence = enqueueCount++;
-    if (index == 0 || takesPriority(backIndex, index)) {
-        backIndex = index;
-    }
-    while (index > 0) {
-        int parent = (index - 1) / 2;
-        if (takesPriority(parent, index)) {
-            break;
-        }
-        swapHeapEntries(parent, index);
-        index = parent;
-    }
+typename PriorityQueue<ValueType>::Handle
+PriorityQueue<ValueType>::enqueue(const ValueType& value, double priority) {
+    priority = checkPriority(priority, "enqueue");
+    int slot = allocateSlot();
+    long sequence = enqueueCount++;
+    heap.add(HeapEntry{value, priority, sequence, slot});
+    slots[slot] = count;
+    noteBack(slot);
+    siftUp(count++);
+    return Handle(slot, sequence);
 }
 
 template <typename ValueType>
@@ -672,21 +815,98 @@ int PriorityQueue<ValueType>::pqCompare(const PriorityQueue& pq2) const {
 #endif // PQUEUE_COMPARISON_OPERATORS_ENABLED
 
 template <typename ValueType>
-void PriorityQueue<ValueType>::swapHeapEntries(int i1, int i2) {
-    HeapEntry entry = heap[i1];
-    heap[i1] = heap[i2];
-    heap[i2] = entry;
+int PriorityQueue<ValueType>::allocateSlot() {
+    if (freeSlots.isEmpty()) {
+        slots.add(-1);
+        return slots.size() - 1;
+    }
+    return freeSlots.pop_back();
+}
+
+template <typename ValueType>
+double PriorityQueue<ValueType>::checkPriority(double priority, const char* member) const {
+    if (std::isnan(priority)) {
+        error(std::string("PriorityQueue::") + member + ": Attempted to use NaN as a priority.");
+    }
+    if (floatingPointEqual(priority, -0.0)) {
+        priority = 0.0;
+    }
+    return priority;
+}
+
+/*
+ * Records that the entry in the given slot is the least urgent one if it
+ * comes after the current least urgent entry, when that is known.
+ */
+template <typename ValueType>
+void PriorityQueue<ValueType>::noteBack(int slot) {
+    const HeapEntry& entry = heap[slots[slot]];
+    if (count == 0 || (backSlot >= 0 && takesPriority(heap[slots[backSlot]], entry))) {
+        backSlot = slot;
+    }
+}
+
+/*
+ * Implementation notes: siftDown, siftUp
+ * --------------------------------------
+ * Rather than swapping an entry with its parent or child one level at a
+ * time, these methods lift the entry out, move each entry in its way
+ * one level into the hole it leaves, and put the entry down once at
+ * the end, updating the slot table for everything that moved.
+ */
+template <typename ValueType>
+void PriorityQueue<ValueType>::siftDown(int index) {
+    HeapEntry* entries = heap.data();
+    HeapEntry entry = std::move(entries[index]);
+    while (true) {
+        int first = ARITY * index + 1;
+        if (first >= count) {
+            break;
+        }
+        int last = std::min(first + ARITY, count);
+        int child = first;
+        for (int i = first + 1; i < last; i++) {
+            if (takesPriority(entries[i], entries[child])) {
+                child = i;
+            }
+        }
+        if (takesPriority(entry, entries[child])) {
+            break;
+        }
+        entries[index] = std::move(entries[child]);
+        slots.unsafeAt(entries[index].slot) = index;
+        index = child;
+    }
+    slots.unsafeAt(entry.slot) = index;
+    entries[index] = std::move(entry);
+}
+
+template <typename ValueType>
+void PriorityQueue<ValueType>::siftUp(int index) {
+    HeapEntry* entries = heap.data();
+    HeapEntry entry = std::move(entries[index]);
+    while (index > 0) {
+        int parent = (index - 1) / ARITY;
+        if (!takesPriority(entry, entries[parent])) {
+            break;
+        }
+        entries[index] = std::move(entries[parent]);
+        slots.unsafeAt(entries[index].slot) = index;
+        index = parent;
+    }
+    slots.unsafeAt(entry.slot) = index;
+    entries[index] = std::move(entry);
 }
 
 template <typename ValueType>
-bool PriorityQueue<ValueType>::takesPriority(int i1, int i2) {
-    if (heap[i1].priority < heap[i2].priority) {
+bool PriorityQueue<ValueType>::takesPriority(const HeapEntry& e1, const HeapEntry& e2) const {
+    if (e1.priority < e2.priority) {
         return true;
     }
-    if (heap[i1].priority > heap[i2].priority) {
+    if (e1.priority > e2.priority) {
         return false;
     }
-    return (heap[i1].sequence < heap[i2].sequence);
+    return (e1.sequence < e2.sequence);
 }
 
 template <typename ValueType>
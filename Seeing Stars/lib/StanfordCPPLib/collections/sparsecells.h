@@ -0,0 +1,473 @@
+/*
+ * File: sparsecells.h
+ * -------------------
+ * This file exports the <code>HashedCells</code> and <code>TiledCells</code>
+ * class templates, which are the storage policies for <code>SparseGrid</code>.
+ * A <code>SparseGrid</code> keeps its cells in a <code>HashedCells</code>
+ * unless another policy is named as its second template argument:
+ *
+ *<pre>
+ *    SparseGrid<int> scattered(100000, 100000);          // same as SparseGrid<int, HashedCells>
+ *    SparseGrid<int, TiledCells> clustered(4096, 4096);  // cells stored in 16x16 tiles
+ *</pre>
+ *
+ * <code>HashedCells</code> suits cells that are scattered across the grid.
+ * <code>TiledCells</code> suits cells that come in clumps, such as regions of
+ * a map or the area around a path, where most of a tile ends up being used.
+ *
+ * A policy is a class template taking the value type.  It must be copyable,
+ * and provide <code>find(row, col)</code> (const and non-const), returning a
+ * pointer to a cell's value or null if the cell is not set;
+ * <code>findOrInsert(row, col)</code>, returning a reference to a cell's
+ * value after setting the cell to the default value if it wasn't set;
+ * <code>erase(row, col)</code>; <code>size()</code>; <code>clear()</code>; and
+ * <code>forEachCell(fn)</code>, calling <code>fn(row, col, value)</code> for
+ * every set cell in no particular order.  Rows and columns are never
+ * negative.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#ifndef _sparsecells_h
+#define _sparsecells_h
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace stanfordcpplib {
+namespace collections {
+
+/*
+ * Returns a (row, col) pair packed into one 64-bit key.  Keys sort in
+ * row-major order.
+ */
+inline std::uint64_t packCoordinates(int row, int col) {
+    return (std::uint64_t(std::uint32_t(row)) << 32) | std::uint32_t(col);
+}
+
+inline int unpackRow(std::uint64_t key) {
+    return int(key >> 32);
+}
+
+inline int unpackCol(std::uint64_t key) {
+    return int(key & 0xFFFFFFFF);
+}
+
+/*
+ * Class: CoordinateTable<ValueType>
+ * ---------------------------------
+ * A hash table from packed coordinates to values, stored in one flat array
+ * and searched by linear probing.  Removing a key shifts back the keys after
+ * it that were displaced past it, so the table never fills up with markers
+ * for removed keys.
+ */
+template <typename ValueType>
+class CoordinateTable {
+public:
+    CoordinateTable();
+    CoordinateTable(const CoordinateTable& src);
+    CoordinateTable& operator =(const CoordinateTable& src);
+    ~CoordinateTable();
+
+    const ValueType* find(std::uint64_t key) const;
+    ValueType* find(std::uint64_t key);
+    ValueType& findOrInsert(std::uint64_t key);
+    bool erase(std::uint64_t key);
+    int size() const;
+    void clear();
+
+    template <typename FunctorType>
+    void forEach(FunctorType fn) const;      // calls fn(key, value)
+
+private:
+    /* Constant definitions */
+    static const std::uint64_t EMPTY_KEY = ~std::uint64_t(0);    // never a packed key
+    static const int MIN_CAPACITY = 16;
+
+    struct Slot {
+        std::uint64_t key;
+        ValueType value;
+    };
+
+    /* Instance variables */
+    Slot* slots;                 // capacity slots, or null before the first insert
+    int capacity;                // always a power of two
+    int count;
+
+    /* Private methods */
+    int findIndex(std::uint64_t key) const;
+    int homeIndex(std::uint64_t key) const;
+    void rehash(int newCapacity);
+    void deepCopy(const CoordinateTable& src);
+};
+
+template <typename ValueType>
+CoordinateTable<ValueType>::CoordinateTable()
+        : slots(nullptr),
+          capacity(0),
+          count(0) {
+    // empty
+}
+
+template <typename ValueType>
+CoordinateTable<ValueType>::CoordinateTable(const CoordinateTable& src)
+        : slots(nullptr),
+          capacity(0),
+          count(0) {
+    deepCopy(src);
+}
+
+template <typename ValueType>
+CoordinateTable<ValueType>& CoordinateTable<ValueType>::operator =(const CoordinateTable& src) {
+    if (this != &src) {
+        delete[] slots;
+        deepCopy(src);
+    }
+    return *this;
+}
+
+template <typename ValueType>
+CoordinateTable<ValueType>::~CoordinateTable() {
+    delete[] slots;
+}
+
+template <typename ValueType>
+const ValueType* CoordinateTable<ValueType>::find(std::uint64_t key) const {
+    int index = findIndex(key);
+    return index >= 0 ? &slots[index].value : nullptr;
+}
+
+template <typename ValueType>
+ValueType* CoordinateTable<ValueType>::find(std::uint64_t key) {
+    int index = findIndex(key);
+    return index >= 0 ? &slots[index].value : nullptr;
+}
+
+template <typename ValueType>
+ValueType& CoordinateTable<ValueType>::findOrInsert(std::uint64_t key) {
+    int index = findIndex(key);
+    if (index >= 0) {
+        return slots[index].value;
+    }
+    // keep the table at most three quarters full
+    if ((count + 1) * 4 > capacity * 3) {
+        int newCapacity = MIN_CAPACITY;
+        if (capacity > 0) {
+            newCapacity = capacity * 2;
+        }
+        rehash(newCapacity);
+    }
+    int mask = capacity - 1;
+    for (index = homeIndex(key); slots[index].key != EMPTY_KEY; index = (index + 1) & mask) {
+        // keep probing
+    }
+    slots[index].key = key;
+    count++;
+    return slots[index].value;
+}
+
+/*
+ * Implementation notes: erase
+ * ---------------------------
+ * Every key must be reachable by probing forward from its home slot without
+ * passing an empty slot.  After emptying a slot, each key in the run that
+ * follows it is moved back into the hole if its home slot is not between the
+ * hole and where it is now, leaving a new hole behind it.
+ */
+template <typename ValueType>
+bool CoordinateTable<ValueType>::erase(std::uint64_t key) {
+    int hole = findIndex(key);
+    if (hole < 0) {
+        return false;
+    }
+    int mask = capacity - 1;
+    for (int next = (hole + 1) & mask; slots[next].key != EMPTY_KEY; next = (next + 1) & mask) {
+        int home = homeIndex(slots[next].key);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            slots[hole].key = slots[next].key;
+            slots[hole].value = std::move(slots[next].value);
+            hole = next;
+        }
+    }
+    slots[hole].key = EMPTY_KEY;
+    slots[hole].value = ValueType();
+    count--;
+    return true;
+}
+
+template <typename ValueType>
+int CoordinateTable<ValueType>::size() const {
+    return count;
+}
+
+template <typename ValueType>
+void CoordinateTable<ValueType>::clear() {
+    delete[] slots;
+    slots = nullptr;
+    capacity = 0;
+    count = 0;
+}
+
+template <typename ValueType>
+template <typename FunctorType>
+void CoordinateTable<ValueType>::forEach(FunctorType fn) const {
+    for (int i = 0; i < capacity; i++) {
+        if (slots[i].key != EMPTY_KEY) {
+            fn(slots[i].key, slots[i].value);
+        }
+    }
+}
+
+template <typename ValueType>
+int CoordinateTable<ValueType>::findIndex(std::uint64_t key) const {
+    if (count == 0) {
+        return -1;
+    }
+    int mask = capacity - 1;
+    for (int index = homeIndex(key); slots[index].key != EMPTY_KEY; index = (index + 1) & mask) {
+        if (slots[index].key == key) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Implementation notes: homeIndex
+ * -------------------------------
+ * Neighbouring cells have keys that differ only in their low bits, so the
+ * key is put through the MurmurHash3 finalizer before it picks a slot.
+ */
+template <typename ValueType>
+int CoordinateTable<ValueType>::homeIndex(std::uint64_t key) const {
+    key ^= key >> 33;
+    key *= UINT64_C(0xFF51AFD7ED558CCD);
+    key ^= key >> 33;
+    key *= UINT64_C(0xC4CEB9FE1A85EC53);
+    key ^= key >> 33;
+    return int(key & std::uint64_t(capacity - 1));
+}
+
+template <typename ValueType>
+void CoordinateTable<ValueType>::rehash(int newCapacity) {
+    Slot* oldSlots = slots;
+    int oldCapacity = capacity;
+    slots = new Slot[newCapacity]();
+    capacity = newCapacity;
+    for (int i = 0; i < capacity; i++) {
+        slots[i].key = EMPTY_KEY;
+    }
+    int mask = capacity - 1;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i].key != EMPTY_KEY) {
+            int index = homeIndex(oldSlots[i].key);
+            while (slots[index].key != EMPTY_KEY) {
+                index = (index + 1) & mask;
+            }
+            slots[index].key = oldSlots[i].key;
+            slots[index].value = std::move(oldSlots[i].value);
+        }
+    }
+    delete[] oldSlots;
+}
+
+template <typename ValueType>
+void CoordinateTable<ValueType>::deepCopy(const CoordinateTable& src) {
+    capacity = src.capacity;
+    count = src.count;
+    slots = capacity ? new Slot[capacity] : nullptr;
+    for (int i = 0; i < capacity; i++) {
+        slots[i] = src.slots[i];
+    }
+}
+
+} // namespace collections
+} // namespace stanfordcpplib
+
+/*
+ * Class: HashedCells<ValueType>
+ * -----------------------------
+ * Keeps each set cell in a hash table keyed on its packed coordinates, so
+ * finding a cell takes about the same time however large the grid is, and
+ * each cell costs a few bytes more than its key and value.
+ */
+template <typename ValueType>
+class HashedCells {
+public:
+    const ValueType* find(int row, int col) const {
+        return table.find(stanfordcpplib::collections::packCoordinates(row, col));
+    }
+
+    ValueType* find(int row, int col) {
+        return table.find(stanfordcpplib::collections::packCoordinates(row, col));
+    }
+
+    ValueType& findOrInsert(int row, int col) {
+        return table.findOrInsert(stanfordcpplib::collections::packCoordinates(row, col));
+    }
+
+    void erase(int row, int col) {
+        table.erase(stanfordcpplib::collections::packCoordinates(row, col));
+    }
+
+    int size() const {
+        return table.size();
+    }
+
+    void clear() {
+        table.clear();
+    }
+
+    template <typename FunctorType>
+    void forEachCell(FunctorType fn) const {
+        table.forEach([&fn](std::uint64_t key, const ValueType& value) {
+            fn(stanfordcpplib::collections::unpackRow(key),
+               stanfordcpplib::collections::unpackCol(key), value);
+        });
+    }
+
+private:
+    stanfordcpplib::collections::CoordinateTable<ValueType> table;
+};
+
+/*
+ * Class: TiledCells<ValueType>
+ * ----------------------------
+ * Divides the grid into square tiles of TILE_SIZE x TILE_SIZE cells, and
+ * keeps a dense array of cells for each tile that has any cell set, in a
+ * hash table keyed on the tile's packed coordinates.  A tile is allocated
+ * when its first cell is set and freed when its last one is unset.  When
+ * the set cells are clustered, most of each tile is in use and a cell costs
+ * little more than its value; when they are scattered, each one may cost a
+ * whole tile.
+ */
+template <typename ValueType>
+class TiledCells {
+public:
+    TiledCells() : cellCount(0) {}
+
+    TiledCells(const TiledCells& src) : tiles(src.tiles), cellCount(src.cellCount) {
+        copyTiles();
+    }
+
+    TiledCells& operator =(const TiledCells& src) {
+        if (this != &src) {
+            clear();
+            tiles = src.tiles;
+            cellCount = src.cellCount;
+            copyTiles();
+        }
+        return *this;
+    }
+
+    ~TiledCells() {
+        clear();
+    }
+
+    const ValueType* find(int row, int col) const {
+        Tile* const* tile = tiles.find(tileKey(row, col));
+        int index = cellIndex(row, col);
+        return tile && (*tile)->isUsed(index) ? &(*tile)->cells[index] : nullptr;
+    }
+
+    ValueType* find(int row, int col) {
+        Tile** tile = tiles.find(tileKey(row, col));
+        int index = cellIndex(row, col);
+        return tile && (*tile)->isUsed(index) ? &(*tile)->cells[index] : nullptr;
+    }
+
+    ValueType& findOrInsert(int row, int col) {
+        Tile*& tile = tiles.findOrInsert(tileKey(row, col));
+        if (!tile) {
+            tile = new Tile;
+        }
+        int index = cellIndex(row, col);
+        if (!tile->isUsed(index)) {
+            tile->used[index / 64] |= std::uint64_t(1) << (index % 64);
+            tile->count++;
+            cellCount++;
+        }
+        return tile->cells[index];
+    }
+
+    void erase(int row, int col) {
+        Tile** tile = tiles.find(tileKey(row, col));
+        int index = cellIndex(row, col);
+        if (!tile || !(*tile)->isUsed(index)) {
+            return;
+        }
+        (*tile)->used[index / 64] &= ~(std::uint64_t(1) << (index % 64));
+        (*tile)->cells[index] = ValueType();
+        cellCount--;
+        if (--(*tile)->count == 0) {
+            delete *tile;
+            tiles.erase(tileKey(row, col));
+        }
+    }
+
+    int size() const {
+        return cellCount;
+    }
+
+    void clear() {
+        tiles.forEach([](std::uint64_t, Tile* tile) {
+            delete tile;
+        });
+        tiles.clear();
+        cellCount = 0;
+    }
+
+    template <typename FunctorType>
+    void forEachCell(FunctorType fn) const {
+        tiles.forEach([&fn](std::uint64_t key, const Tile* tile) {
+            int baseRow = stanfordcpplib::collections::unpackRow(key) * TILE_SIZE;
+            int baseCol = stanfordcpplib::collections::unpackCol(key) * TILE_SIZE;
+            for (int index = 0; index < TILE_SIZE * TILE_SIZE; index++) {
+                if (tile->isUsed(index)) {
+                    fn(baseRow + index / TILE_SIZE, baseCol + index % TILE_SIZE,
+                       tile->cells[index]);
+                }
+            }
+        });
+    }
+
+private:
+    /* Constant definitions */
+    static const int TILE_SIZE = 16;
+
+    struct Tile {
+        ValueType cells[TILE_SIZE * TILE_SIZE];            // row-major within the tile
+        std::uint64_t used[TILE_SIZE * TILE_SIZE / 64];    // one bit per set cell
+        int count;                                         // number of set cells
+
+        Tile() : cells(), used(), count(0) {}
+
+        bool isUsed(int index) const {
+            return (used[index / 64] >> (index % 64)) & 1;
+        }
+    };
+
+    /* Instance variables */
+    stanfordcpplib::collections::CoordinateTable<Tile*> tiles;
+    int cellCount;
+
+    /* Private methods */
+    static std::uint64_t tileKey(int row, int col) {
+        return stanfordcpplib::collections::packCoordinates(row / TILE_SIZE, col / TILE_SIZE);
+    }
+
+    static int cellIndex(int row, int col) {
+        return (row % TILE_SIZE) * TILE_SIZE + col % TILE_SIZE;
+    }
+
+    /* Replaces each tile pointer copied from another grid with a copy of its tile */
+    void copyTiles() {
+        tiles.forEach([this](std::uint64_t key, Tile* tile) {
+            *tiles.find(key) = new Tile(*tile);
+        });
+    }
+};
+
+#endif // _sparsecells_h
@@ -9,6 +9,11 @@
  * Grid is recommended for use over SparseGrid.
  * 
  * @author Marty Stepp
+ * @version 2026/10/19
+ * - cells are kept in a hash table keyed on packed (row, col) coordinates
+ *   instead of a map of maps; a storage policy from sparsecells.h may be
+ *   named as an optional second template argument
+ * - get and const operator [] no longer set the cells they read
  * @version 2018/03/12
  * - added overloads that accept GridLocation: get, inBounds, isSet, locations,
  *   set, unset, operator []
@@ -43,13 +48,18 @@
 #ifndef _sparsegrid_h
 #define _sparsegrid_h
 
+#include <algorithm>
+#include <cstdint>
 #include <initializer_list>
+#include <utility>
+#include <vector>
 #include "collections.h"
 #include "error.h"
 #include "gridlocation.h"
 #include "hashcode.h"
 #include "map.h"
 #include "random.h"
+#include "sparsecells.h"
 #include "strlib.h"
 #include "vector.h"
 
@@ -59,7 +69,8 @@
  * This class stores an indexed, two-dimensional array.
  */
 
-template <typename ValueType>
+template <typename ValueType,
+          template <typename> class CellStorage = HashedCells>
 class SparseGrid {
 public:
     /* Forward reference */
@@ -124,7 +135,7 @@ public:
      * values as the given other grid.
      * Identical in behavior to the == operator.
      */
-    bool equals(const SparseGrid<ValueType>& grid) const;
+    bool equals(const SparseGrid& grid) const;
 
     /*
      * Method: fill
@@ -397,17 +408,17 @@ public:
     /*
      * Implementation notes: SparseGrid data structure
      * -----------------------------------------------
-     * The SparseGrid is internally managed as a dynamic array of elements.
-     * The array itself is one-dimensional, the logical separation into
-     * rows and columns is done by arithmetic computation.  The layout
-     * is in row-major order, which is to say that the entire first row
-     * is laid out contiguously, followed by the entire second row,
-     * and so on.
+     * The cells that have been set are kept by the CellStorage policy, which
+     * by default is a hash table keyed on each cell's row and column packed
+     * into one 64-bit integer (see sparsecells.h).  Reading or writing a cell
+     * takes about the same time however large the grid is.  The storage keeps
+     * cells in no particular order, so the operations that visit the set
+     * cells in row-major order gather and sort them first.
      */
 
 private:
     /* Instance variables */
-    Map<int, Map<int, ValueType> > elements;  // 2D map of the elements
+    CellStorage<ValueType> cells;  // the cells that have been set
     int nRows;            // The number of rows in the grid
     int nCols;            // The number of columns in the grid
     unsigned int m_version = 0;  // structure version for detecting invalid iterators
@@ -427,6 +438,17 @@ private:
                       std::string prefix) const;
     int gridCompare(const SparseGrid& grid2) const;
 
+    /*
+     * Returns the value at row/col, or a default value if that cell is not set.
+     */
+    const ValueType& valueAt(int row, int col) const;
+
+    /*
+     * Returns the packed coordinates and values of the set cells in
+     * row-major order.
+     */
+    std::vector<std::pair<std::uint64_t, const ValueType*> > sortedCells() const;
+
     /*
      * Hidden features
      * ---------------
@@ -450,19 +472,20 @@ private:
      * are supported.
      */
     void deepCopy(const SparseGrid& grid) {
-        elements = grid.elements;
+        cells = grid.cells;
         nRows = grid.nRows;
         nCols = grid.nCols;
+        m_version++;
     }
 
-    template <typename T>
-    friend const T& randomElement(const SparseGrid<T>& grid);
+    template <typename T, template <typename> class S>
+    friend const T& randomElement(const SparseGrid<T, S>& grid);
 
-    template <typename T>
-    friend std::ostream& operator <<(std::ostream& os, const SparseGrid<T>& grid);
+    template <typename T, template <typename> class S>
+    friend std::ostream& operator <<(std::ostream& os, const SparseGrid<T, S>& grid);
 
-    template <typename T>
-    friend std::istream& operator >>(std::istream& is, SparseGrid<T>& grid);
+    template <typename T, template <typename> class S>
+    friend std::istream& operator >>(std::istream& is, SparseGrid<T, S>& grid);
 
 public:
     SparseGrid& operator =(const SparseGrid& src) {
@@ -481,7 +504,8 @@ public:
      * ----------------
      * The classes in the StanfordCPPLib collection implement input
      * iterators so that they work symmetrically with respect to the
-     * corresponding STL classes.
+     * corresponding STL classes.  Iteration visits every cell of the grid
+     * in row-major order, yielding the default value for cells not set.
      */
     class iterator : public std::iterator<std::input_iterator_tag, ValueType> {
     public:
@@ -524,14 +548,14 @@ public:
             stanfordcpplib::collections::checkVersion(*gp, *this);
             int row = index / gp->nCols;
             int col = index % gp->nCols;
-            return gp->elements[row][col];
+            return gp->valueAt(row, col);
         }
 
-        ValueType* operator ->() {
+        const ValueType* operator ->() {
             stanfordcpplib::collections::checkVersion(*gp, *this);
             int row = index / gp->nCols;
             int col = index % gp->nCols;
-            return &gp->elements[row][col];
+            return &gp->valueAt(row, col);
         }
 
         unsigned int version() const {
@@ -572,12 +596,12 @@ public:
 
         ValueType& operator [](int col) {
             gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
-            return gp->elements[row][col];
+            return gp->cells.findOrInsert(row, col);
         }
 
         const ValueType& operator [](int col) const {
             gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
-            return gp->elements[row][col];
+            return gp->cells.findOrInsert(row, col);
         }
 
     private:
@@ -600,7 +624,7 @@ public:
 
         const ValueType operator [](int col) const {
             gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
-            return gp->elements[row][col];
+            return gp->valueAt(row, col);
         }
 
     private:
@@ -615,26 +639,26 @@ public:
     friend class SparseGridRowConst;
 };
 
-template <typename ValueType>
-SparseGrid<ValueType>::SparseGrid()
+template <typename ValueType, template <typename> class CellStorage>
+SparseGrid<ValueType, CellStorage>::SparseGrid()
         : nRows(0),
           nCols(0) {
     // empty
 }
 
-template <typename ValueType>
-SparseGrid<ValueType>::SparseGrid(int nRows, int nCols) {
+template <typename ValueType, template <typename> class CellStorage>
+SparseGrid<ValueType, CellStorage>::SparseGrid(int nRows, int nCols) {
     resize(nRows, nCols);
 }
 
-template <typename ValueType>
-SparseGrid<ValueType>::SparseGrid(int nRows, int nCols, const ValueType& value) {
+template <typename ValueType, template <typename> class CellStorage>
+SparseGrid<ValueType, CellStorage>::SparseGrid(int nRows, int nCols, const ValueType& value) {
     resize(nRows, nCols);
     fill(value);
 }
 
-template <typename ValueType>
-SparseGrid<ValueType>::SparseGrid(std::initializer_list<std::initializer_list<ValueType> > list)
+template <typename ValueType, template <typename> class CellStorage>
+SparseGrid<ValueType, CellStorage>::SparseGrid(std::initializer_list<std::initializer_list<ValueType> > list)
         : nRows(0),
           nCols(0) {
     // create the grid at the proper size
@@ -660,55 +684,56 @@ SparseGrid<ValueType>::SparseGrid(std::initializer_list<std::initializer_list<Va
 }
 
 
-template <typename ValueType>
-SparseGrid<ValueType>::~SparseGrid() {
+template <typename ValueType, template <typename> class CellStorage>
+SparseGrid<ValueType, CellStorage>::~SparseGrid() {
     // empty
 }
 
-template <typename ValueType>
-ValueType SparseGrid<ValueType>::back() const {
+template <typename ValueType, template <typename> class CellStorage>
+ValueType SparseGrid<ValueType, CellStorage>::back() const {
     if (isEmpty()) {
         error("SparseGrid::back: grid is empty");
     }
-    int lastRow = elements.back();
-    int lastCol = elements[lastRow].back();
-    return elements[lastRow][lastCol];
+    std::uint64_t lastKey = 0;
+    const ValueType* last = nullptr;
+    cells.forEachCell([&](int row, int col, const ValueType& value) {
+        std::uint64_t key = stanfordcpplib::collections::packCoordinates(row, col);
+        if (!last || key > lastKey) {
+            lastKey = key;
+            last = &value;
+        }
+    });
+    return *last;
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::clear() {
-    elements.clear();
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::clear() {
+    cells.clear();
+    m_version++;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::equals(const SparseGrid<ValueType>& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::equals(const SparseGrid& grid2) const {
     // optimization: if literally same grid, stop
     if (this == &grid2) {
         return true;
     }
-    if (nRows != grid2.nRows || nCols != grid2.nCols) {
+    if (nRows != grid2.nRows || nCols != grid2.nCols || size() != grid2.size()) {
         return false;
     }
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                // I have data there; he must, too, and it must be the same data
-                if (!grid2.isSet(row, col) || get(row, col) != grid2.get(row, col)) {
-                    return false;
-                }
-            } else {
-                // I don't have data there; he must also not have it there
-                if (grid2.isSet(row, col)) {
-                    return false;
-                }
-            }
+    // same number of cells set, so each of mine must be set to the same value there
+    bool same = true;
+    cells.forEachCell([&](int row, int col, const ValueType& value) {
+        if (same) {
+            const ValueType* value2 = grid2.cells.find(row, col);
+            same = value2 && !(*value2 != value);
         }
-    }
-    return true;
+    });
+    return same;
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::fill(const ValueType& value) {
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::fill(const ValueType& value) {
     for (int row = 0; row < nRows; row++) {
         for (int col = 0; col < nCols; col++) {
             set(row, col, value);
@@ -716,118 +741,105 @@ void SparseGrid<ValueType>::fill(const ValueType& value) {
     }
 }
 
-template <typename ValueType>
-ValueType SparseGrid<ValueType>::front() const {
+template <typename ValueType, template <typename> class CellStorage>
+ValueType SparseGrid<ValueType, CellStorage>::front() const {
     if (isEmpty()) {
         error("SparseGrid::front: grid is empty");
     }
     return *begin();
 }
 
-template <typename ValueType>
-ValueType SparseGrid<ValueType>::get(int row, int col) {
+template <typename ValueType, template <typename> class CellStorage>
+ValueType SparseGrid<ValueType, CellStorage>::get(int row, int col) {
     checkIndexes(row, col, nRows-1, nCols-1, "get");
-    return elements[row][col];
+    return valueAt(row, col);
 }
 
-template <typename ValueType>
-const ValueType& SparseGrid<ValueType>::get(int row, int col) const {
+template <typename ValueType, template <typename> class CellStorage>
+const ValueType& SparseGrid<ValueType, CellStorage>::get(int row, int col) const {
     checkIndexes(row, col, nRows-1, nCols-1, "get");
-    return elements[row][col];
+    return valueAt(row, col);
 }
 
-template <typename ValueType>
-ValueType SparseGrid<ValueType>::get(const GridLocation& loc) {
+template <typename ValueType, template <typename> class CellStorage>
+ValueType SparseGrid<ValueType, CellStorage>::get(const GridLocation& loc) {
     return get(loc.row, loc.col);
 }
 
-template <typename ValueType>
-const ValueType& SparseGrid<ValueType>::get(const GridLocation& loc) const {
+template <typename ValueType, template <typename> class CellStorage>
+const ValueType& SparseGrid<ValueType, CellStorage>::get(const GridLocation& loc) const {
     return get(loc.row, loc.col);
 }
 
-template <typename ValueType>
-int SparseGrid<ValueType>::height() const {
+template <typename ValueType, template <typename> class CellStorage>
+int SparseGrid<ValueType, CellStorage>::height() const {
     return nRows;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::inBounds(int row, int col) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::inBounds(int row, int col) const {
     return row >= 0 && col >= 0 && row < nRows && col < nCols;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::inBounds(const GridLocation& loc) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::inBounds(const GridLocation& loc) const {
     return inBounds(loc.row, loc.col);
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::isEmpty() const {
-    return elements.isEmpty();
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::isEmpty() const {
+    return cells.size() == 0;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::isSet(int row, int col) const {
-    return inBounds(row, col) && elements.containsKey(row) &&
-            elements[row].containsKey(col);
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::isSet(int row, int col) const {
+    return inBounds(row, col) && cells.find(row, col) != nullptr;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::isSet(const GridLocation& loc) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::isSet(const GridLocation& loc) const {
     return isSet(loc.row, loc.col);
 }
 
-template <typename ValueType>
-GridLocationRange SparseGrid<ValueType>::locations(bool rowMajor) const {
+template <typename ValueType, template <typename> class CellStorage>
+GridLocationRange SparseGrid<ValueType, CellStorage>::locations(bool rowMajor) const {
     return GridLocationRange(0, 0, numRows() - 1, numCols() - 1, rowMajor);
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::mapAll(void (*fn)(ValueType value)) const {
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                fn(get(row, col));
-            }
-        }
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::mapAll(void (*fn)(ValueType value)) const {
+    for (const auto& cell : sortedCells()) {
+        fn(*cell.second);
     }
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::mapAll(void (*fn)(const ValueType& value)) const {
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                fn(get(row, col));
-            }
-        }
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::mapAll(void (*fn)(const ValueType& value)) const {
+    for (const auto& cell : sortedCells()) {
+        fn(*cell.second);
     }
 }
 
-template <typename ValueType>
+template <typename ValueType, template <typename> class CellStorage>
 template <typename FunctorType>
-void SparseGrid<ValueType>::mapAll(FunctorType fn) const {
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                fn(get(row, col));
-            }
-        }
+void SparseGrid<ValueType, CellStorage>::mapAll(FunctorType fn) const {
+    for (const auto& cell : sortedCells()) {
+        fn(*cell.second);
     }
 }
 
-template <typename ValueType>
-int SparseGrid<ValueType>::numCols() const {
+template <typename ValueType, template <typename> class CellStorage>
+int SparseGrid<ValueType, CellStorage>::numCols() const {
     return nCols;
 }
 
-template <typename ValueType>
-int SparseGrid<ValueType>::numRows() const {
+template <typename ValueType, template <typename> class CellStorage>
+int SparseGrid<ValueType, CellStorage>::numRows() const {
     return nRows;
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::resize(int nRows, int nCols, bool retain) {
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::resize(int nRows, int nCols, bool retain) {
     if (nRows < 0 || nCols < 0) {
         std::ostringstream out;
         out << "SparseGrid::resize: Attempt to resize grid to invalid size ("
@@ -843,66 +855,62 @@ void SparseGrid<ValueType>::resize(int nRows, int nCols, bool retain) {
         // if resizing to a smaller size, must evict any row/col entries
         // that exceed the new grid's bounds
         if (nRows < oldnRows || nCols < oldnCols) {
-            Map<int, Map<int, ValueType> > newElements;
-            for (int row : elements) {
-                if (row >= nRows) {
-                    break;   // don't add any entries beyond this row
-                }
-                for (int col : elements[row]) {
-                    if (col >= nCols) {
-                        break;   // don't add any entries beyond this row
-                    }
-                    newElements[row][col] = elements[row][col];
+            std::vector<std::pair<int, int> > evicted;
+            cells.forEachCell([&](int row, int col, const ValueType&) {
+                if (row >= nRows || col >= nCols) {
+                    evicted.push_back(std::make_pair(row, col));
                 }
+            });
+            for (const std::pair<int, int>& cell : evicted) {
+                cells.erase(cell.first, cell.second);
             }
-            elements = newElements;
         }
     } else {
-        elements.clear();
+        cells.clear();
     }
     m_version++;
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::set(int row, int col, const ValueType& value) {
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::set(int row, int col, const ValueType& value) {
     checkIndexes(row, col, nRows-1, nCols-1, "set");
-    elements[row][col] = value;
+    cells.findOrInsert(row, col) = value;
     m_version++;
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::set(const GridLocation& loc, const ValueType& value) {
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::set(const GridLocation& loc, const ValueType& value) {
     set(loc.row, loc.col, value);
 }
 
-template <typename ValueType>
-int SparseGrid<ValueType>::size() const {
-    int count = 0;
-    for (int row : elements) {
-        count += elements[row].size();
-    }
-    return count;
+template <typename ValueType, template <typename> class CellStorage>
+int SparseGrid<ValueType, CellStorage>::size() const {
+    return cells.size();
 }
 
-template <typename ValueType>
-std::string SparseGrid<ValueType>::toString() const {
+template <typename ValueType, template <typename> class CellStorage>
+std::string SparseGrid<ValueType, CellStorage>::toString() const {
     std::ostringstream os;
     os << *this;
     return os.str();
 }
 
-template <typename ValueType>
-std::string SparseGrid<ValueType>::toString2D(
+template <typename ValueType, template <typename> class CellStorage>
+std::string SparseGrid<ValueType, CellStorage>::toString2D(
         std::string rowStart, std::string rowEnd,
         std::string colSeparator, std::string rowSeparator) const {
+    std::vector<int> setRows;
+    for (const auto& cell : sortedCells()) {
+        int row = stanfordcpplib::collections::unpackRow(cell.first);
+        if (setRows.empty() || setRows.back() != row) {
+            setRows.push_back(row);
+        }
+    }
+
     std::ostringstream os;
     os << rowStart;
-    int nRows = numRows();
     int nCols = numCols();
-    for (int i = 0; i < nRows; i++) {
-        if (!elements.containsKey(i) || elements[i].isEmpty()) {
-            continue;
-        }
+    for (int i : setRows) {
         if (i > 0) {
             os << rowSeparator;
         }
@@ -921,37 +929,32 @@ std::string SparseGrid<ValueType>::toString2D(
     return os.str();
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::unset(int row, int col) {
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::unset(int row, int col) {
     checkIndexes(row, col, nRows-1, nCols-1, "unset");
-    if (elements.containsKey(row)) {
-        elements[row].remove(col);
-        if (elements[row].isEmpty()) {
-            elements.remove(row);
-        }
-    }
+    cells.erase(row, col);
     m_version++;
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::unset(const GridLocation& loc) {
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::unset(const GridLocation& loc) {
     unset(loc.row, loc.col);
 }
 
-template <typename ValueType>
-unsigned int SparseGrid<ValueType>::version() const {
+template <typename ValueType, template <typename> class CellStorage>
+unsigned int SparseGrid<ValueType, CellStorage>::version() const {
     return m_version;
 }
 
-template <typename ValueType>
-int SparseGrid<ValueType>::width() const {
+template <typename ValueType, template <typename> class CellStorage>
+int SparseGrid<ValueType, CellStorage>::width() const {
     return nCols;
 }
 
-template <typename ValueType>
-void SparseGrid<ValueType>::checkIndexes(int row, int col,
-                                         int rowMax, int colMax,
-                                         std::string prefix) const {
+template <typename ValueType, template <typename> class CellStorage>
+void SparseGrid<ValueType, CellStorage>::checkIndexes(int row, int col,
+                                                      int rowMax, int colMax,
+                                                      std::string prefix) const {
     const int rowMin = 0;
     const int colMin = 0;
     if (row < rowMin || row > rowMax || col < colMin || col > colMax) {
@@ -969,8 +972,8 @@ void SparseGrid<ValueType>::checkIndexes(int row, int col,
     }
 }
 
-template <typename ValueType>
-int SparseGrid<ValueType>::gridCompare(const SparseGrid& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+int SparseGrid<ValueType, CellStorage>::gridCompare(const SparseGrid& grid2) const {
     int h1 = height();
     int w1 = width();
     int h2 = grid2.height();
@@ -1007,56 +1010,81 @@ int SparseGrid<ValueType>::gridCompare(const SparseGrid& grid2) const {
     return 0;
 }
 
-template <typename ValueType>
-typename SparseGrid<ValueType>::SparseGridRow SparseGrid<ValueType>::operator [](int row) {
+template <typename ValueType, template <typename> class CellStorage>
+const ValueType& SparseGrid<ValueType, CellStorage>::valueAt(int row, int col) const {
+    static const ValueType defaultValue = ValueType();
+    const ValueType* value = cells.find(row, col);
+    return value ? *value : defaultValue;
+}
+
+template <typename ValueType, template <typename> class CellStorage>
+std::vector<std::pair<std::uint64_t, const ValueType*> >
+SparseGrid<ValueType, CellStorage>::sortedCells() const {
+    std::vector<std::pair<std::uint64_t, const ValueType*> > result;
+    result.reserve(cells.size());
+    cells.forEachCell([&result](int row, int col, const ValueType& value) {
+        result.push_back(std::make_pair(stanfordcpplib::collections::packCoordinates(row, col),
+                                        &value));
+    });
+    std::sort(result.begin(), result.end(),
+              [](const std::pair<std::uint64_t, const ValueType*>& a,
+                 const std::pair<std::uint64_t, const ValueType*>& b) {
+        return a.first < b.first;
+    });
+    return result;
+}
+
+template <typename ValueType, template <typename> class CellStorage>
+typename SparseGrid<ValueType, CellStorage>::SparseGridRow
+SparseGrid<ValueType, CellStorage>::operator [](int row) {
     return SparseGridRow(this, row);
 }
 
-template <typename ValueType>
-const typename SparseGrid<ValueType>::SparseGridRowConst
-SparseGrid<ValueType>::operator [](int row) const {
+template <typename ValueType, template <typename> class CellStorage>
+const typename SparseGrid<ValueType, CellStorage>::SparseGridRowConst
+SparseGrid<ValueType, CellStorage>::operator [](int row) const {
     return SparseGridRowConst(const_cast<SparseGrid*>(this), row);
 }
 
-template <typename ValueType>
-ValueType& SparseGrid<ValueType>::operator [](const GridLocation& loc) {
+template <typename ValueType, template <typename> class CellStorage>
+ValueType& SparseGrid<ValueType, CellStorage>::operator [](const GridLocation& loc) {
     checkIndexes(loc.row, loc.col, nRows-1, nCols-1, "operator []");
-    return elements[loc.row][loc.col];
+    return cells.findOrInsert(loc.row, loc.col);
 }
 
-template <typename ValueType>
-const ValueType& SparseGrid<ValueType>::operator [](const GridLocation& loc) const {
+template <typename ValueType, template <typename> class CellStorage>
+const ValueType& SparseGrid<ValueType, CellStorage>::operator [](const GridLocation& loc) const {
     checkIndexes(loc.row, loc.col, nRows-1, nCols-1, "operator []");
-    return elements[loc.row][loc.col];
+    return valueAt(loc.row, loc.col);
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::operator ==(const SparseGrid& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::operator ==(const SparseGrid& grid2) const {
     return equals(grid2);
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::operator !=(const SparseGrid& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::operator !=(const SparseGrid& grid2) const {
     return !equals(grid2);
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::operator <(const SparseGrid& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::operator <(const SparseGrid& grid2) const {
     return gridCompare(grid2) < 0;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::operator <=(const SparseGrid& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::operator <=(const SparseGrid& grid2) const {
     return gridCompare(grid2) <= 0;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::operator >(const SparseGrid& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::operator >(const SparseGrid& grid2) const {
     return gridCompare(grid2) > 0;
 }
 
-template <typename ValueType>
-bool SparseGrid<ValueType>::operator >=(const SparseGrid& grid2) const {
+template <typename ValueType, template <typename> class CellStorage>
+bool SparseGrid<ValueType, CellStorage>::operator >=(const SparseGrid& grid2) const {
     return gridCompare(grid2) >= 0;
 }
 
@@ -1065,26 +1093,57 @@ bool SparseGrid<ValueType>::operator >=(const SparseGrid& grid2) const {
  * -------------------------------
  * The insertion and extraction operators use the template facilities in
  * strlib.h to read and write generic values in a way that treats strings
- * specially.
+ * specially.  The set cells are written as a map from each row to a map
+ * from each column to its value, as they were when SparseGrid stored them
+ * that way, and read back through such a map.
  */
-template <typename ValueType>
-std::ostream& operator <<(std::ostream& os, const SparseGrid<ValueType>& grid) {
-    os << grid.elements << ", " << grid.nRows << " x " << grid.nCols;
+template <typename ValueType, template <typename> class CellStorage>
+std::ostream& operator <<(std::ostream& os, const SparseGrid<ValueType, CellStorage>& grid) {
+    os << "{";
+    int lastRow = -1;
+    for (const auto& cell : grid.sortedCells()) {
+        int row = stanfordcpplib::collections::unpackRow(cell.first);
+        if (row != lastRow) {
+            if (lastRow >= 0) {
+                os << "}, ";
+            }
+            writeGenericValue(os, row, /* forceQuotes */ true);
+            os << ":{";
+            lastRow = row;
+        } else {
+            os << ", ";
+        }
+        writeGenericValue(os, stanfordcpplib::collections::unpackCol(cell.first), /* forceQuotes */ true);
+        os << ":";
+        writeGenericValue(os, *cell.second, /* forceQuotes */ true);
+    }
+    if (lastRow >= 0) {
+        os << "}";
+    }
+    os << "}, " << grid.nRows << " x " << grid.nCols;
     return os;
 }
 
-template <typename ValueType>
-std::istream& operator >>(std::istream& is, SparseGrid<ValueType>& grid) {
+template <typename ValueType, template <typename> class CellStorage>
+std::istream& operator >>(std::istream& is, SparseGrid<ValueType, CellStorage>& grid) {
     // "{...}, 4 x 3"
 
     // read "{...}" (map of elements)
-    if (!(is >> grid.elements)) {
+    Map<int, Map<int, ValueType> > elements;
+    if (!(is >> elements)) {
 #ifdef SPL_ERROR_ON_COLLECTION_PARSE
         error("SparseGrid::operator >>: Invalid elements");
 #endif
         is.setstate(std::ios_base::failbit);
         return is;
     }
+    grid.cells.clear();
+    for (int row : elements) {
+        for (int col : elements[row]) {
+            grid.cells.findOrInsert(row, col) = elements[row][col];
+        }
+    }
+    grid.m_version++;
 
     // throw away ', ' token
     std::string comma;
@@ -1121,8 +1180,8 @@ std::istream& operator >>(std::istream& is, SparseGrid<ValueType>& grid) {
  * Template hash function for sparse grids.
  * Requires the element type in the SparseGrid to have a hashCode function.
  */
-template <typename T>
-int hashCode(const SparseGrid<T>& grid) {
+template <typename T, template <typename> class S>
+int hashCode(const SparseGrid<T, S>& grid) {
     return stanfordcpplib::collections::hashCodeCollection(grid);
 }
 
@@ -1133,17 +1192,21 @@ int hashCode(const SparseGrid<T>& grid) {
  * Returns a randomly chosen element of the given grid.
  * Throws an error if the grid is empty.
  */
-template <typename T>
-const T& randomElement(const SparseGrid<T>& grid) {
+template <typename T, template <typename> class S>
+const T& randomElement(const SparseGrid<T, S>& grid) {
     if (grid.isEmpty()) {
         error("randomElement: empty sparse grid was passed");
     }
-    
-    // pick a non-empty row, then pick a random element from it
-    // TODO: fix, this is NOT evenly distributed when rows/cols are unequal in size
-    int row = randomKey(grid.elements);
-    int col = randomKey(grid.elements[row]);
-    return grid.get(row, col);
+
+    // every set cell is equally likely
+    int index = randomInteger(0, grid.size() - 1);
+    const T* chosen = nullptr;
+    grid.cells.forEachCell([&](int, int, const T& value) {
+        if (index-- == 0) {
+            chosen = &value;
+        }
+    });
+    return *chosen;
 }
 
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
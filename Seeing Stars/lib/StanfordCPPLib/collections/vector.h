@@ -4,6 +4,13 @@
  * This file exports the <code>Vector</code> class, which provides an
  * efficient, safe, convenient replacement for the array type in C++.
  *
+ * @version 2026/10/19
+ * - added data and unsafeAt for unchecked access to the elements
+ * - index checks on element access compile out under SPL_UNCHECKED_COLLECTIONS
+ * - elements live in uninitialized storage and are moved, not copied, on growth
+ * - a Vector stores its first few elements inside itself, if they are small
+ * - added SmallVector, a Vector that stores more of its elements inside itself
+ * - added move constructor and assignment, and add/push_back for rvalues
  * @version 2018/01/07
  * - added front, back, removeFront, removeBack, pop_front, pop_back, push_front
  * @version 2017/11/15
@@ -43,11 +50,15 @@
 #define _vector_h
 
 #include <algorithm>
+#include <cstddef>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
+#include <new>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include "collections.h"
 #include "error.h"
@@ -103,9 +114,11 @@ public:
      * Method: add
      * Usage: vec.add(value);
      * ----------------------
-     * Adds a new value to the end of this vector.
+     * Adds a new value to the end of this vector.  A value passed as
+     * an rvalue, such as a temporary, is moved into the vector.
      */
     void add(const ValueType& value);
+    void add(ValueType&& value);
 
     /*
      * Method: addAll
@@ -146,6 +159,20 @@ public:
      */
     bool contains(const ValueType& value) const;
 
+    /*
+     * Method: data
+     * Usage: int* p = vec.data();
+     * ---------------------------
+     * Returns a pointer to the vector's first element.  The elements sit
+     * one after another in memory, so <code>p[0]</code> through
+     * <code>p[vec.size() - 1]</code> are the vector's elements.  Nothing
+     * checks the indexes used with the pointer, which makes loops over it
+     * as fast as loops over a built-in array.  The pointer is good until
+     * the next time an element is added to or removed from the vector.
+     */
+    ValueType* data();
+    const ValueType* data() const;
+
     /*
      * Method: ensureCapacity
      * Usage: vec.ensureCapacity(n);
@@ -266,6 +293,7 @@ public:
      * with the <code>vector</code> class in the Standard Template Library.
      */
     void push_back(const ValueType& value);
+    void push_back(ValueType&& value);
 
     /*
      * Method: push_front
@@ -385,6 +413,18 @@ public:
      */
     std::string toString() const;
 
+    /*
+     * Method: unsafeAt
+     * Usage: ValueType& val = vec.unsafeAt(index);
+     * --------------------------------------------
+     * Returns the element at the specified index in this vector, like
+     * <code>vec[index]</code> but without checking the index, even in
+     * builds that check it for <code>vec[index]</code>.  An index outside
+     * the vector reads or writes memory that is not part of it.
+     */
+    ValueType& unsafeAt(int index);
+    const ValueType& unsafeAt(int index) const;
+
     /*
      * Operator: []
      * Usage: vec[index]
@@ -483,16 +523,34 @@ private:
     /*
      * Implementation notes: Vector data structure
      * -------------------------------------------
-     * The elements of the Vector are stored in a dynamic array of
-     * the specified element type.  If the space in the array is ever
-     * exhausted, the implementation doubles the array capacity.
+     * The elements of the Vector are stored in an array of the specified
+     * element type, of which only the first count slots hold constructed
+     * values; the rest are raw memory, filled with placement new as
+     * elements are added.  A Vector starts out with localStorage, a buffer
+     * of LOCAL_STORAGE_BYTES inside the object, as its array, so that a
+     * short vector of small elements (a few ints, points or pointers)
+     * never touches the heap.  Element types too big or too strictly
+     * aligned for the buffer start with no array at all.  A SmallVector
+     * passes in a bigger buffer of its own instead.  If the space in the
+     * array is ever exhausted, the implementation moves the elements to a
+     * heap array of twice the capacity.
+     *
+     * Nothing in the class itself depends on sizeof(ValueType), so a
+     * Vector can be a member of its own element type, as in
+     * struct Node { Vector<Node> children; }.  Whether the elements fit
+     * in localStorage is worked out by localCapacity, which only the
+     * constructors and SmallVector use, once ValueType is complete.
      */
+    static const int LOCAL_STORAGE_BYTES = 64;
 
     /* Instance variables */
-    ValueType* elements;        // a dynamic array of the elements
+    ValueType* elements;        // the inline buffer, a heap array, or nullptr
     int capacity;               // the allocated size of the array
     int count;                  // the number of elements in use
     unsigned int m_version = 0; // structure version for detecting invalid iterators
+    int inlineCapacity;         // the number of elements that fit in inlineBuffer
+    ValueType* inlineBuffer;    // localStorage, a SmallVector's buffer, or nullptr
+    alignas(std::max_align_t) unsigned char localStorage[LOCAL_STORAGE_BYTES];
 
     /* Private methods */
 
@@ -504,10 +562,40 @@ private:
      * The prefix parameter represents a text string to place at the start of
      * the error message, generally to help indicate which member threw the error.
      */
-    void checkIndex(int index, int min, int max, std::string prefix) const;
+    void checkIndex(int index, int min, int max, const char* prefix) const;
+    void indexError(int index, int min, int max, const char* prefix) const;
+
+    /*
+     * Checks an index for element access (get, set, operator []) as
+     * checkIndex does, unless SPL_UNCHECKED_COLLECTIONS is defined.
+     */
+    void checkAccess(int index, const char* prefix) const;
 
     void expandCapacity();
     void deepCopy(const Vector& src);
+    void moveFrom(Vector& src);
+
+    /*
+     * Storage management: reallocate moves the elements to a heap array of
+     * the given capacity, and releaseStorage destroys the elements and
+     * returns to the (empty) inline buffer, if there is one.  If appended
+     * is given, reallocate also moves it into the new array just past the
+     * last element, before the old elements move; the caller counts it.
+     */
+    void reallocate(int newCapacity, ValueType* appended = nullptr);
+    void releaseStorage();
+
+    /*
+     * Adds a value that has already been copied or moved out of the
+     * caller's hands; the tail of insert.
+     */
+    void insertOwned(int index, ValueType&& value);
+
+    /*
+     * Moves a value onto the end; the tail of add and push_back for rvalues,
+     * which may be one of this vector's own elements.
+     */
+    void append(ValueType&& value);
 
     /*
      * Hidden features
@@ -529,6 +617,37 @@ public:
     Vector(const Vector& src);
     Vector& operator =(const Vector& src);
 
+    /*
+     * Move support
+     * ------------
+     * Moving a vector takes its heap array if it has one, and otherwise
+     * moves its inline elements one by one.  The vector moved from is
+     * left empty.  The constructor is noexcept whatever the element type,
+     * so that containers of vectors move them rather than copy them; a
+     * condition on the element type's own move would make a Vector of a
+     * type that contains one unmovable.
+     */
+    Vector(Vector&& src) noexcept;
+    Vector& operator =(Vector&& src);
+
+protected:
+    /*
+     * Starts an empty vector whose array is the given buffer, which has
+     * room for bufferCapacity elements.  This is how SmallVector gives a
+     * Vector a bigger inline buffer than localStorage; the buffer must
+     * outlive the elements.  With a null buffer, the vector starts on
+     * localStorage, as the default constructor's does.
+     */
+    Vector(ValueType* buffer, int bufferCapacity);
+
+    /*
+     * Returns the number of elements that fit in localStorage, or 0 if a
+     * ValueType is too big for it or needs stricter alignment than it has.
+     */
+    static constexpr int localCapacity();
+
+public:
+
     /*
      * Operator: ,
      * -----------
@@ -711,70 +830,104 @@ public:
 /*
  * Implementation notes: Vector constructor and destructor
  * -------------------------------------------------------
- * The constructor allocates storage for the dynamic array
- * and initializes the other fields of the object.  The
- * destructor frees the memory used for the array.
+ * Every constructor starts on the empty inline buffer (localStorage, or a
+ * SmallVector's buffer; or no array, for elements that don't fit in
+ * localStorage) and moves to a heap array only if the initial elements
+ * don't fit.  Elements
+ * are copy-constructed in place, so ValueType needs no default
+ * constructor except for the (n, value) form's default argument.  The
+ * destructor destroys the elements and frees any heap array.
  */
 template <typename ValueType>
 Vector<ValueType>::Vector()
         : elements(nullptr),
           capacity(0),
-          count(0) {
-    // empty
+          count(0),
+          inlineCapacity(localCapacity()),
+          inlineBuffer(inlineCapacity > 0 ? reinterpret_cast<ValueType*>(localStorage) : nullptr) {
+    elements = inlineBuffer;
+    capacity = inlineCapacity;
 }
 
 template <typename ValueType>
 Vector<ValueType>::Vector(int n, ValueType value)
-        : elements(nullptr),
-          capacity(n),
-          count(n) {
+        : Vector() {
     if (n < 0) {
         error("Vector::constructor: n cannot be negative: " + integerToString(n));
-    } else if (n > 0) {
-        elements = new ValueType[n];
-        for (int i = 0; i < n; i++) {
-            elements[i] = value;
-        }
+    }
+    if (n > capacity) {
+        reallocate(n);
+    }
+    for (; count < n; count++) {
+        new (elements + count) ValueType(value);
     }
 }
 
 template <typename ValueType>
-Vector<ValueType>::Vector(const std::vector<ValueType>& v) {
-    count = v.size();
-    capacity = v.size();
-    elements = new ValueType[count];
-    for (int i = 0; i < count; i++) {
-        elements[i] = v[i];
+Vector<ValueType>::Vector(const std::vector<ValueType>& v)
+        : Vector() {
+    int n = v.size();
+    if (n > capacity) {
+        reallocate(n);
+    }
+    for (; count < n; count++) {
+        new (elements + count) ValueType(v[count]);
     }
 }
 
 template <typename ValueType>
 Vector<ValueType>::Vector(std::initializer_list<ValueType> list)
-        : count(0) {
-    capacity = list.size();
-    elements = new ValueType[capacity];
-    addAll(list);
+        : Vector() {
+    int n = list.size();
+    if (n > capacity) {
+        reallocate(n);
+    }
+    for (const ValueType& value : list) {
+        new (elements + count) ValueType(value);
+        count++;
+    }
 }
 
 /*
  * Implementation notes: copy constructor and assignment operator
  * --------------------------------------------------------------
  * The constructor and assignment operators follow a standard paradigm,
- * as described in the associated textbook.
+ * as described in the associated textbook.  Assignment keeps this
+ * vector's array if the source's elements fit in it.
  */
 template <typename ValueType>
-Vector<ValueType>::Vector(const Vector& src) {
+Vector<ValueType>::Vector(const Vector& src)
+        : Vector() {
     deepCopy(src);
 }
 
 template <typename ValueType>
-Vector<ValueType>::~Vector() {
-    if (elements) {
-        delete[] elements;
-        elements = nullptr;
+Vector<ValueType>::Vector(Vector&& src) noexcept
+        : Vector() {
+    moveFrom(src);
+}
+
+template <typename ValueType>
+Vector<ValueType>::Vector(ValueType* buffer, int bufferCapacity)
+        : Vector() {
+    if (buffer) {
+        elements = inlineBuffer = buffer;
+        capacity = inlineCapacity = bufferCapacity;
     }
 }
 
+template <typename ValueType>
+Vector<ValueType>::~Vector() {
+    releaseStorage();
+}
+
+template <typename ValueType>
+constexpr int Vector<ValueType>::localCapacity() {
+    return sizeof(ValueType) > LOCAL_STORAGE_BYTES
+            || alignof(ValueType) > alignof(std::max_align_t)
+            ? 0 : LOCAL_STORAGE_BYTES / static_cast<int>(sizeof(ValueType));
+}
+
 /*
  * Implementation notes: Vector methods
  * ------------------------------------
@@ -786,6 +939,11 @@ void Vector<ValueType>::add(const ValueType& value) {
     insert(count, value);
 }
 
+template <typename ValueType>
+void Vector<ValueType>::add(ValueType&& value) {
+    append(std::move(value));
+}
+
 template <typename ValueType>
 Vector<ValueType>& Vector<ValueType>::addAll(const Vector<ValueType>& v) {
     for (const ValueType& value : v) {
@@ -820,12 +978,7 @@ const ValueType& Vector<ValueType>::back() const {
 
 template <typename ValueType>
 void Vector<ValueType>::clear() {
-    if (elements) {
-        delete[] elements;
-    }
-    count = 0;
-    capacity = 0;
-    elements = nullptr;
+    releaseStorage();
     m_version++;
 }
 
@@ -834,21 +987,23 @@ bool Vector<ValueType>::contains(const ValueType& value) const {
     return indexOf(value) >= 0;
 }
 
+template <typename ValueType>
+ValueType* Vector<ValueType>::data() {
+    return elements;
+}
+
+template <typename ValueType>
+const ValueType* Vector<ValueType>::data() const {
+    return elements;
+}
+
 // implementation note: This method is public so clients can guarantee a given
 // capacity.  Internal resizing is automatically done by expandCapacity.
 // See also: expandCapacity
 template <typename ValueType>
 void Vector<ValueType>::ensureCapacity(int cap) {
     if (cap >= 1 && capacity < cap) {
-        capacity = std::max(cap, capacity * 2);
-        ValueType* array = new ValueType[capacity];
-        if (elements) {
-            for (int i = 0; i < count; i++) {
-                array[i] = elements[i];
-            }
-            delete[] elements;
-        }
-        elements = array;
+        reallocate(std::max(cap, capacity * 2));
     }
 }
 
@@ -860,21 +1015,13 @@ bool Vector<ValueType>::equals(const Vector<ValueType>& v) const {
 /*
  * Implementation notes: expandCapacity
  * ------------------------------------
- * This function doubles the array capacity, copies the old elements
+ * This function doubles the array capacity, moves the old elements
  * into the new array, and then frees the old one.
- * See also: ensureCapacity
+ * See also: ensureCapacity, reallocate
  */
 template <typename ValueType>
 void Vector<ValueType>::expandCapacity() {
-    capacity = std::max(1, capacity * 2);
-    ValueType* array = new ValueType[capacity];
-    if (elements) {
-        for (int i = 0; i < count; i++) {
-            array[i] = elements[i];
-        }
-        delete[] elements;
-    }
-    elements = array;
+    reallocate(std::max(1, capacity * 2));
 }
 
 template <typename ValueType>
@@ -895,7 +1042,7 @@ const ValueType& Vector<ValueType>::front() const {
 
 template <typename ValueType>
 const ValueType& Vector<ValueType>::get(int index) const {
-    checkIndex(index, 0, count-1, "get");
+    checkAccess(index, "get");
     return elements[index];
 }
 
@@ -914,18 +1061,47 @@ int Vector<ValueType>::indexOf(const ValueType& value) const {
  * -----------------------------------------
  * These methods must shift the existing elements in the array to
  * make room for a new element or to close up the space left by a
- * deleted one.
+ * deleted one.  Elements are shifted by moving them; the slot past
+ * the last element is raw memory, so it is constructed rather than
+ * assigned, and the slot a removal leaves behind is destroyed.
+ * insert copies the value before anything moves, because it may be
+ * a reference to one of this vector's own elements.  append, which adds
+ * an rvalue without copying it, has the same problem when the vector is
+ * full: growing frees the array the value may live in.  So it moves the
+ * value into the new array first and the old elements after it, the way
+ * std::vector does.
  */
 template <typename ValueType>
 void Vector<ValueType>::insert(int index, const ValueType& value) {
     checkIndex(index, 0, count, "insert");
+    insertOwned(index, ValueType(value));
+}
+
+template <typename ValueType>
+void Vector<ValueType>::append(ValueType&& value) {
+    if (count == capacity) {
+        reallocate(std::max(1, capacity * 2), &value);
+    } else {
+        new (elements + count) ValueType(std::move(value));
+    }
+    count++;
+    m_version++;
+}
+
+template <typename ValueType>
+void Vector<ValueType>::insertOwned(int index, ValueType&& value) {
     if (count == capacity) {
         expandCapacity();
     }
-    for (int i = count; i > index; i--) {
-        elements[i] = elements[i - 1];
+    if (index == count) {
+        new (elements + count) ValueType(std::move(value));
+    } else {
+        new (elements + count) ValueType(std::move(elements[count - 1]));
+        for (int i = count - 1; i > index; i--) {
+            elements[i] = std::move(elements[i - 1]);
+        }
+        elements[index] = std::move(value);
     }
-    elements[index] = value;
     count++;
     m_version++;
 }
@@ -978,7 +1154,7 @@ ValueType Vector<ValueType>::pop_back() {
     if (isEmpty()) {
         error("Vector::pop_back: vector is empty");
     }
-    ValueType last = elements[count - 1];
+    ValueType last = std::move(elements[count - 1]);
     remove(count - 1);
     return last;
 }
@@ -988,7 +1164,7 @@ ValueType Vector<ValueType>::pop_front() {
     if (isEmpty()) {
         error("Vector::pop_front: vector is empty");
     }
-    ValueType first = elements[0];
+    ValueType first = std::move(elements[0]);
     remove(0);
     return first;
 }
@@ -998,6 +1174,11 @@ void Vector<ValueType>::push_back(const ValueType& value) {
     insert(count, value);
 }
 
+template <typename ValueType>
+void Vector<ValueType>::push_back(ValueType&& value) {
+    append(std::move(value));
+}
+
 template <typename ValueType>
 void Vector<ValueType>::push_front(const ValueType& value) {
     insert(0, value);
@@ -1007,8 +1188,9 @@ template <typename ValueType>
 void Vector<ValueType>::remove(int index) {
     checkIndex(index, 0, count-1, "remove");
     for (int i = index; i < count - 1; i++) {
-        elements[i] = elements[i + 1];
+        elements[i] = std::move(elements[i + 1]);
     }
+    elements[count - 1].~ValueType();
     count--;
     m_version++;
 }
@@ -1040,7 +1222,7 @@ void Vector<ValueType>::reverse() {
 
 template <typename ValueType>
 void Vector<ValueType>::set(int index, const ValueType& value) {
-    checkIndex(index, 0, count-1, "set");
+    checkAccess(index, "set");
     elements[index] = value;
 }
 
@@ -1080,11 +1262,7 @@ Vector<ValueType> Vector<ValueType>::subList(int start, int length) const {
 
 template <typename ValueType>
 std::vector<ValueType> Vector<ValueType>::toStlVector() const {
-    std::vector<ValueType> v;
-    for (int i = 0; i < count; i++) {
-        v.push_back(elements[i]);
-    }
-    return v;
+    return std::vector<ValueType>(elements, elements + count);
 }
 
 template <typename ValueType>
@@ -1094,6 +1272,16 @@ std::string Vector<ValueType>::toString() const {
     return os.str();
 }
 
+template <typename ValueType>
+ValueType& Vector<ValueType>::unsafeAt(int index) {
+    return elements[index];
+}
+
+template <typename ValueType>
+const ValueType& Vector<ValueType>::unsafeAt(int index) const {
+    return elements[index];
+}
+
 template <typename ValueType>
 unsigned int Vector<ValueType>::version() const {
     return m_version;
@@ -1107,12 +1295,12 @@ unsigned int Vector<ValueType>::version() const {
  */
 template <typename ValueType>
 ValueType& Vector<ValueType>::operator [](int index) {
-    checkIndex(index, 0, count-1, "operator []");
+    checkAccess(index, "operator []");
     return elements[index];
 }
 template <typename ValueType>
 const ValueType& Vector<ValueType>::operator [](int index) const {
-    checkIndex(index, 0, count-1, "operator []");
+    checkAccess(index, "operator []");
     return elements[index];
 }
 
@@ -1177,47 +1365,145 @@ bool Vector<ValueType>::operator >=(const Vector& v2) const {
 template <typename ValueType>
 Vector<ValueType> & Vector<ValueType>::operator =(const Vector& src) {
     if (this != &src) {
-        if (elements) {
-            delete[] elements;
+        for (int i = 0; i < count; i++) {
+            elements[i].~ValueType();
         }
+        count = 0;
         deepCopy(src);
     }
     return *this;
 }
 
 template <typename ValueType>
-void Vector<ValueType>::checkIndex(int index, int min, int max, std::string prefix) const {
+Vector<ValueType>& Vector<ValueType>::operator =(Vector&& src) {
+    if (this != &src) {
+        releaseStorage();
+        moveFrom(src);
+    }
+    return *this;
+}
+
+template <typename ValueType>
+void Vector<ValueType>::checkIndex(int index, int min, int max, const char* prefix) const {
     if (index < min || index > max) {
-        std::ostringstream out;
-        out << "Vector::" << prefix << ": index of " << index
-            << " is outside of valid range ";
-        if (isEmpty()) {
-            out << " (empty vector)";
-        } else {
-            out << "[";
-            if (min < max) {
-                out << min << ".." << max;
-            } else if (min == max) {
-                out << min;
-            } // else min > max, no range, empty vector
-            out << "]";
-        }
-        error(out.str());
+        indexError(index, min, max, prefix);
     }
 }
 
+/*
+ * Implementation notes: indexError
+ * --------------------------------
+ * The message is built here rather than in checkIndex, so that the check
+ * itself is small enough to inline into every element access.
+ */
+template <typename ValueType>
+void Vector<ValueType>::indexError(int index, int min, int max, const char* prefix) const {
+    std::ostringstream out;
+    out << "Vector::" << prefix << ": index of " << index
+        << " is outside of valid range ";
+    if (isEmpty()) {
+        out << " (empty vector)";
+    } else {
+        out << "[";
+        if (min < max) {
+            out << min << ".." << max;
+        } else if (min == max) {
+            out << min;
+        } // else min > max, no range, empty vector
+        out << "]";
+    }
+    error(out.str());
+}
+
+template <typename ValueType>
+void Vector<ValueType>::checkAccess(int index, const char* prefix) const {
+#ifdef SPL_UNCHECKED_COLLECTIONS
+    (void) index;
+    (void) prefix;
+#else
+    checkIndex(index, 0, count - 1, prefix);
+#endif // SPL_UNCHECKED_COLLECTIONS
+}
+
 // implementation notes:
-// doesn't free this->elements because deepCopy is only called in cases where
-// elements is either null (at construction) or has just been freed (operator =)
+// deepCopy is only called when this vector holds no elements (at construction,
+// or once operator = has destroyed them), so it only grows the array if the
+// source's elements don't fit in it
 template <typename ValueType>
 void Vector<ValueType>::deepCopy(const Vector& src) {
-    count = src.count;
-    capacity = src.count;
-    elements = (capacity == 0) ? nullptr : new ValueType[capacity];
-    for (int i = 0; i < count; i++) {
-        elements[i] = src.elements[i];
+    if (src.count > capacity) {
+        reallocate(src.count);
+    }
+    for (; count < src.count; count++) {
+        new (elements + count) ValueType(src.elements[count]);
+    }
+    m_version++;
+}
+
+// implementation notes:
+// like deepCopy, moveFrom is only called when this vector is empty and back on
+// its inline buffer (if any); src's elements may not fit in that buffer, since
+// src may be a SmallVector with a bigger one
+template <typename ValueType>
+void Vector<ValueType>::moveFrom(Vector& src) {
+    if (src.elements != src.inlineBuffer) {
+        elements = src.elements;
+        capacity = src.capacity;
+        count = src.count;
+        src.elements = src.inlineBuffer;
+        src.capacity = src.inlineCapacity;
+        src.count = 0;
+    } else {
+        if (src.count > capacity) {
+            reallocate(src.count);
+        }
+        for (; count < src.count; count++) {
+            new (elements + count) ValueType(std::move(src.elements[count]));
+        }
+        src.releaseStorage();
     }
     m_version++;
+    src.m_version++;
+}
+
+/*
+ * Implementation notes: reallocate
+ * --------------------------------
+ * The new array is raw memory from operator new, so the elements are
+ * move-constructed into it and then destroyed in the old one.  Moving
+ * leaves the old elements' heap storage (a string's characters, say)
+ * where it is, so growing a vector of strings copies no characters.
+ */
+template <typename ValueType>
+void Vector<ValueType>::reallocate(int newCapacity, ValueType* appended) {
+    ValueType* array = static_cast<ValueType*>(::operator new(sizeof(ValueType) * newCapacity));
+    if (appended) {
+        new (array + count) ValueType(std::move(*appended));
+    }
+    for (int i = 0; i < count; i++) {
+        new (array + i) ValueType(std::move(elements[i]));
+    }
+    for (int i = 0; i < count; i++) {
+        elements[i].~ValueType();
+    }
+    if (elements != inlineBuffer) {
+        ::operator delete(elements);
+    }
+    elements = array;
+    capacity = newCapacity;
+}
+
+template <typename ValueType>
+void Vector<ValueType>::releaseStorage() {
+    for (int i = 0; i < count; i++) {
+        elements[i].~ValueType();
+    }
+    if (elements != inlineBuffer) {
+        ::operator delete(elements);
+    }
+    elements = inlineBuffer;
+    capacity = inlineCapacity;
+    count = 0;
 }
 
 /*
@@ -1280,6 +1566,185 @@ void shuffle(Vector<T>& v) {
     v.shuffle();
 }
 
+/*
+ * Class: SmallVector<ValueType, InlineCapacity>
+ * ---------------------------------------------
+ * This class is a <code>Vector</code> that keeps its first
+ * <code>InlineCapacity</code> elements inside the object itself, so that
+ * a vector that never grows past that many elements never touches the
+ * heap.  A plain Vector already does that for as many elements as fit in
+ * 64 bytes, and a SmallVector with no more inline elements than that is
+ * just a Vector; it is worth using where a program makes many short
+ * vectors of more or bigger elements, such as token lists of strings.
+ * Past the inline capacity it behaves like any other vector.
+ * A SmallVector can be used wherever a Vector can, and copies and moves
+ * to and from one.
+ *
+ * Unlike Vector, SmallVector needs its element type to be complete, so
+ * it can't be a member of its own element type.
+ */
+template <typename ValueType, int InlineCapacity>
+class SmallVector : public Vector<ValueType> {
+public:
+    /*
+     * Constructor: SmallVector
+     * Usage: SmallVector<ValueType, 8> vec;
+     *        SmallVector<ValueType, 8> vec(n, value);
+     *        SmallVector<ValueType, 8> vec {1, 2, 3};
+     * -----------------------------------------------
+     * Initializes a new vector, as the Vector constructors do.
+     */
+    SmallVector();
+    explicit SmallVector(int n, ValueType value = ValueType());
+    SmallVector(std::initializer_list<ValueType> list);
+
+    /*
+     * Copying and moving support
+     * --------------------------
+     * A SmallVector can be copied or moved from another SmallVector or
+     * from any Vector, and assigned in the same ways.
+     */
+    SmallVector(const SmallVector& src);
+    SmallVector(const Vector<ValueType>& src);
+    SmallVector(SmallVector&& src) noexcept(std::is_nothrow_move_constructible<ValueType>::value);
+    SmallVector(Vector<ValueType>&& src) noexcept(std::is_nothrow_move_constructible<ValueType>::value);
+    SmallVector& operator =(const SmallVector& src);
+    SmallVector& operator =(const Vector<ValueType>& src);
+    SmallVector& operator =(SmallVector&& src);
+    SmallVector& operator =(Vector<ValueType>&& src);
+
+    /*
+     * Destructor: ~SmallVector
+     * ------------------------
+     * Destroys the elements before the inline buffer goes away.
+     */
+    virtual ~SmallVector();
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    static_assert(InlineCapacity > 0, "SmallVector needs an inline capacity of at least 1");
+
+    /*
+     * True if the inline elements need a buffer here, because they don't
+     * all fit in Vector's own.
+     */
+    static const bool OWN_BUFFER = InlineCapacity > Vector<ValueType>::localCapacity();
+
+    /* Instance variables */
+    alignas(ValueType) unsigned char inlineStorage[OWN_BUFFER ? InlineCapacity * sizeof(ValueType) : 1];
+
+    /* Private methods */
+
+    /*
+     * Returns the buffer to hand to Vector: inlineStorage, or nullptr if
+     * Vector's own buffer is big enough.
+     */
+    static ValueType* buffer(unsigned char* storage);
+};
+
+/*
+ * Implementation notes: SmallVector
+ * ---------------------------------
+ * Every constructor hands the inline buffer to Vector before the buffer
+ * member is initialized, which is fine, since it is raw storage that
+ * Vector only fills with placement new.  Only its address is taken there,
+ * by the static buffer method; no other member function can be called
+ * until the Vector part exists.  The rest is Vector's doing.
+ */
+template <typename ValueType, int InlineCapacity>
+ValueType* SmallVector<ValueType, InlineCapacity>::buffer(unsigned char* storage) {
+    return OWN_BUFFER ? reinterpret_cast<ValueType*>(storage) : nullptr;
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::SmallVector()
+        : Vector<ValueType>(buffer(inlineStorage), InlineCapacity) {
+    // empty
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::SmallVector(int n, ValueType value)
+        : Vector<ValueType>(buffer(inlineStorage), InlineCapacity) {
+    if (n < 0) {
+        error("SmallVector::constructor: n cannot be negative: " + integerToString(n));
+    }
+    this->ensureCapacity(n);
+    for (int i = 0; i < n; i++) {
+        this->add(value);
+    }
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::SmallVector(std::initializer_list<ValueType> list)
+        : Vector<ValueType>(buffer(inlineStorage), InlineCapacity) {
+    this->addAll(list);
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::SmallVector(const SmallVector& src)
+        : Vector<ValueType>(buffer(inlineStorage), InlineCapacity) {
+    Vector<ValueType>::operator =(src);
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::SmallVector(const Vector<ValueType>& src)
+        : Vector<ValueType>(buffer(inlineStorage), InlineCapacity) {
+    Vector<ValueType>::operator =(src);
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::SmallVector(SmallVector&& src)
+        noexcept(std::is_nothrow_move_constructible<ValueType>::value)
+        : Vector<ValueType>(buffer(inlineStorage), InlineCapacity) {
+    Vector<ValueType>::operator =(std::move(src));
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::SmallVector(Vector<ValueType>&& src)
+        noexcept(std::is_nothrow_move_constructible<ValueType>::value)
+        : Vector<ValueType>(buffer(inlineStorage), InlineCapacity) {
+    Vector<ValueType>::operator =(std::move(src));
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>&
+SmallVector<ValueType, InlineCapacity>::operator =(const SmallVector& src) {
+    Vector<ValueType>::operator =(src);
+    return *this;
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>&
+SmallVector<ValueType, InlineCapacity>::operator =(const Vector<ValueType>& src) {
+    Vector<ValueType>::operator =(src);
+    return *this;
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>&
+SmallVector<ValueType, InlineCapacity>::operator =(SmallVector&& src) {
+    Vector<ValueType>::operator =(std::move(src));
+    return *this;
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>&
+SmallVector<ValueType, InlineCapacity>::operator =(Vector<ValueType>&& src) {
+    Vector<ValueType>::operator =(std::move(src));
+    return *this;
+}
+
+template <typename ValueType, int InlineCapacity>
+SmallVector<ValueType, InlineCapacity>::~SmallVector() {
+    this->clear();
+}
+
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
 
 #endif // _vector_h
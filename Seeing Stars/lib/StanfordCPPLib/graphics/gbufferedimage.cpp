@@ -5,6 +5,9 @@
  * See that file for documentation of each member.
  *
  * @author Marty Stepp
+ * @version 2026/10/19
+ * - added setPixels; pixel strings are built in place rather than a
+ *   character at a time through a stream
  * @version 2017/10/18
  * - fix compiler warnings
  * @version 2017/09/28
@@ -43,6 +46,7 @@
 #include "gbufferedimage.h"
 #include <cstring>
 #include <iomanip>
+#include <vector>
 #include "base64.h"
 #include "filelib.h"
 #include "gmath.h"
@@ -54,6 +58,40 @@
 
 const int GBufferedImage::WIDTH_HEIGHT_MAX = 65535;
 
+namespace {
+// rough length in characters of one fillRegion command, for deciding whether
+// a set of changed rectangles is cheaper to send than the whole image
+const size_t FILL_REGION_COMMAND_LENGTH = 64;
+
+// a rectangle of pixels that all changed to the same color
+struct PixelRun {
+    int x, y, width, height;
+    int rgb;
+};
+
+// builds the pixel string format that the back-end expects: width, then
+// height, as 2 bytes each, then each pixel as 3 bytes (R,G,B); pixelAt(row, col)
+// returns a pixel's RGB value
+template <typename PixelAt>
+std::string makePixelString(int w, int h, PixelAt pixelAt) {
+    std::string out(4 + 3 * size_t(w) * size_t(h), '\0');
+    char* p = &out[0];
+    *p++ = (char) ((w >> 8) & 0xff);
+    *p++ = (char)  (w & 0xff);
+    *p++ = (char) ((h >> 8) & 0xff);
+    *p++ = (char)  (h & 0xff);
+    for (int row = 0; row < h; row++) {
+        for (int col = 0; col < w; col++) {
+            int rgb = pixelAt(row, col);
+            *p++ = (char) ((rgb >> 16) & 0xff);
+            *p++ = (char) ((rgb >> 8) & 0xff);
+            *p++ = (char)  (rgb & 0xff);
+        }
+    }
+    return out;
+}
+} // namespace
+
 int GBufferedImage::createRgbPixel(int red, int green, int blue) {
     if (red < 0 || red > 255 || green < 0 || green > 255 || blue < 0 || blue > 255) {
         error("RGB values must be between 0-255");
@@ -270,39 +308,19 @@ void GBufferedImage::fromGrid(const Grid<int>& grid) {
     m_pixels = grid;
     m_width = grid.width();
     m_height = grid.height();
-
-    // encode the bytes into a base64 string so it can go through
-    // the process pipe to the Java back-end
-    std::string pixelString = GBufferedImage::gridToPixelString(m_pixels);
-    std::string encoded = Base64::encode(pixelString);
-
-    // update the back-end with all of the pretty new pixels
-    stanfordcpplib::getPlatform()->gbufferedimage_updateAllPixels(this, encoded);
+    sendAllPixels();
 }
 
 std::string GBufferedImage::gridToPixelString(const Grid<int>& grid) {
-    // output a base64-encoded version of the image pixels
-    std::ostringstream out;
-
-    // output width as 2 bytes, then height as 2 bytes
-    int w = grid.width();
-    int h = grid.height();
-    out << (char) (((w & 0x0000ff00) >> 8) & 0x000000ff);
-    out << (char)  ((w & 0x000000ff));
-    out << (char) (((h & 0x0000ff00) >> 8) & 0x000000ff);
-    out << (char)  ((h & 0x000000ff));
-    
-    // output each pixel as 3 bytes (R,G,B)
-    for (int row = 0; row < h; row++) {
-        for (int col = 0; col < w; col++) {
-            int rgb = grid[row][col];
-            out << (char) (((rgb & 0x00ff0000) >> 16) & 0x000000ff);
-            out << (char) (((rgb & 0x0000ff00) >> 8) & 0x000000ff);
-            out << (char)   (rgb & 0x000000ff);
-        }
-    }
+    return makePixelString(grid.width(), grid.height(), [&grid](int row, int col) {
+        return grid[row][col];
+    });
+}
 
-    return out.str();
+std::string GBufferedImage::pixelsToPixelString(const uint32_t* pixels, int width, int height, int stride) {
+    return makePixelString(width, height, [pixels, stride](int row, int col) {
+        return (int) (pixels[(size_t) row * stride + col] & 0xffffff);
+    });
 }
 
 double GBufferedImage::getHeight() const {
@@ -418,6 +436,100 @@ void GBufferedImage::setRGB(double x, double y, const std::string& rgb) {
     setRGB(x, y, convertColorToRGB(rgb));
 }
 
+void GBufferedImage::setPixels(const uint32_t* pixels, int width, int height, int stride) {
+    checkSize("setPixels", width, height);
+    if (width == (int) m_width && height == (int) m_height) {
+        // same size; only send what changed
+        setPixels(pixels, 0, 0, width, height, stride);
+        return;
+    }
+    if (stride < width) {
+        error("GBufferedImage::setPixels: stride cannot be less than width");
+    }
+
+    m_pixels.resize(height, width, /* retain */ false);
+    for (int row = 0; row < height; row++) {
+        const uint32_t* source = pixels + (size_t) row * stride;
+        for (int col = 0; col < width; col++) {
+            m_pixels[row][col] = (int) (source[col] & 0xffffff);
+        }
+    }
+    m_width = width;
+    m_height = height;
+    sendAllPixels();
+}
+
+void GBufferedImage::setPixels(const uint32_t* pixels, int x, int y, int width, int height, int stride) {
+    checkSize("setPixels", width, height);
+    if (stride < width) {
+        error("GBufferedImage::setPixels: stride cannot be less than width");
+    }
+    if (width == 0 || height == 0) {
+        return;
+    }
+    checkIndex("setPixels", x, y);
+    checkIndex("setPixels", x + width - 1, y + height - 1);
+
+    // store the new pixels, collecting the ones that changed into rectangles
+    // of one color: runs of changed pixels along each row, each merged with
+    // an identical run directly above it if there is one; give up collecting
+    // once there are too many rectangles to be worth sending
+    size_t fullUpdateLength = 4 * (size_t) m_width * (size_t) m_height;   // 4 Base64 characters per pixel
+    size_t maxRuns = fullUpdateLength / FILL_REGION_COMMAND_LENGTH;
+    std::vector<PixelRun> finished;
+    std::vector<PixelRun> above;
+    std::vector<PixelRun> current;
+    bool sendAll = false;
+    for (int row = 0; row < height; row++) {
+        const uint32_t* source = pixels + (size_t) row * stride;
+        int* dest = &m_pixels[y + row][x];
+        if (sendAll) {
+            for (int col = 0; col < width; col++) {
+                dest[col] = (int) (source[col] & 0xffffff);
+            }
+            continue;
+        }
+        size_t aboveIndex = 0;
+        current.clear();
+        for (int col = 0; col < width; ) {
+            int rgb = (int) (source[col] & 0xffffff);
+            if (dest[col] == rgb) {
+                col++;
+                continue;
+            }
+            PixelRun run = { x + col, y + row, 0, 1, rgb };
+            while (col < width && (int) (source[col] & 0xffffff) == rgb && dest[col] != rgb) {
+                dest[col++] = rgb;
+            }
+            run.width = x + col - run.x;
+
+            // runs on the row above that end before this one can grow no further
+            while (aboveIndex < above.size() && above[aboveIndex].x < run.x) {
+                finished.push_back(above[aboveIndex++]);
+            }
+            if (aboveIndex < above.size() && above[aboveIndex].x == run.x
+                    && above[aboveIndex].width == run.width && above[aboveIndex].rgb == rgb) {
+                run.y = above[aboveIndex].y;
+                run.height = above[aboveIndex].height + 1;
+                aboveIndex++;
+            }
+            current.push_back(run);
+        }
+        finished.insert(finished.end(), above.begin() + aboveIndex, above.end());
+        above.swap(current);
+        sendAll = finished.size() + above.size() > maxRuns;
+    }
+
+    if (sendAll) {
+        sendAllPixels();
+        return;
+    }
+    finished.insert(finished.end(), above.begin(), above.end());
+    for (const PixelRun& run : finished) {
+        stanfordcpplib::getPlatform()->gbufferedimage_fillRegion(this, run.x, run.y, run.width, run.height, run.rgb);
+    }
+}
+
 Grid<int> GBufferedImage::toGrid() const {
     return m_pixels;
 }
@@ -481,6 +593,16 @@ void GBufferedImage::init(double x, double y, double width, double height,
     }
 }
 
+void GBufferedImage::sendAllPixels() {
+    // encode the bytes into a base64 string so it can go through
+    // the process pipe to the Java back-end
+    std::string pixelString = GBufferedImage::gridToPixelString(m_pixels);
+    std::string encoded = Base64::encode(pixelString);
+
+    // update the back-end with all of the pretty new pixels
+    stanfordcpplib::getPlatform()->gbufferedimage_updateAllPixels(this, encoded);
+}
+
 bool operator ==(const GBufferedImage& img1, const GBufferedImage& img2) {
     return img1.equals(img2);
 }
@@ -5,6 +5,9 @@
  * See gbufferedimage.cpp for implementation of each member.
  *
  * @author Marty Stepp
+ * @version 2026/10/19
+ * - added setPixels for bulk updates from a raw pixel buffer, sending only
+ *   the pixels that changed
  * @version 2017/09/28
  * - added getFilename
  * @version 2016/10/28
@@ -34,6 +37,7 @@
 #ifndef _gbufferedimage_h
 #define _gbufferedimage_h
 
+#include <cstdint>
 #include "grid.h"
 #include "ginteractors.h"
 #include "gobjects.h"
@@ -138,6 +142,7 @@ public:
      * Private; clients should not use these functions.
      */
     static std::string gridToPixelString(const Grid<int>& grid);
+    static std::string pixelsToPixelString(const uint32_t* pixels, int width, int height, int stride);
     static Grid<int> pixelStringToGrid(const std::string& base64text);
     static void pixelStringToGrid(const std::string& base64text, Grid<int>& grid);
 
@@ -299,6 +304,29 @@ public:
      */
     void setRGB(double x, double y, int rgb);
     void setRGB(double x, double y, const std::string& rgb);
+
+    /*
+     * Copies a block of pixels from a buffer in memory into this image.
+     * The buffer holds one 32-bit integer per pixel in the same format as
+     * setRGB (any alpha component in bits 24-31 is ignored), in row-major
+     * order; row r of the block starts at pixels[r * stride], so a block cut
+     * out of a larger buffer can be passed without copying it first.
+     *
+     * The first version replaces the whole image, resizing it to the given
+     * width and height if needed.  The second overwrites only the rectangle
+     * with top-left corner (x, y) and the given size.
+     *
+     * Only pixels whose color actually changes are sent to the back-end.
+     * They are sent as filled rectangles when that is cheaper, which makes
+     * redrawing a small dirty region of a large image, or a mostly flat one,
+     * quick; otherwise the whole image is sent in one bulk update.  Either
+     * way, this is much faster than calling setRGB on each pixel.
+     *
+     * Throws an error if the rectangle goes outside the bounds of the image,
+     * if the size is negative or too large, or if stride is less than width.
+     */
+    void setPixels(const uint32_t* pixels, int width, int height, int stride);
+    void setPixels(const uint32_t* pixels, int x, int y, int width, int height, int stride);
     
     /*
      * Converts this image into a grid of RGB pixels.
@@ -337,6 +365,11 @@ private:
      */
     void init(double x, double y, double width, double height, int rgb);
 
+    /*
+     * Sends every pixel in m_pixels to the back-end in a single command.
+     */
+    void sendAllPixels();
+
     // allow operators to see private data inside image
     friend bool operator ==(const GBufferedImage& img1, const GBufferedImage& img2);
     friend bool operator !=(const GBufferedImage& img1, const GBufferedImage& img2);
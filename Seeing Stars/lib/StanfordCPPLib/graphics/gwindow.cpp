@@ -5,6 +5,8 @@
  * to the appropriate methods in the Platform class, which is implemented
  * separately for each architecture.
  * 
+ * @version 2026/10/19
+ * - added setPixels from a raw pixel buffer
  * @version 2017/12/18
  * - added drawImage
  * @version 2017/10/25
@@ -1025,6 +1027,13 @@ void GWindow::setPixels(const Grid<int>& pixels) {
     stanfordcpplib::getPlatform()->gwindow_setPixels(*this, pixels);
 }
 
+void GWindow::setPixels(const uint32_t* pixels, int width, int height, int stride) {
+    if (width < 0 || height < 0 || stride < width) {
+        error("GWindow::setPixels: invalid width, height, or stride");
+    }
+    stanfordcpplib::getPlatform()->gwindow_setPixels(*this, pixels, width, height, stride);
+}
+
 void GWindow::setPixelsARGB(const Grid<int>& pixelsARGB) {
     stanfordcpplib::getPlatform()->gwindow_setPixels(*this, pixelsARGB);
 }
@@ -4,6 +4,8 @@
  * This file defines the <code>GWindow</code> class which supports
  * drawing graphical objects on the screen.
  * 
+ * @version 2026/10/19
+ * - added setPixels from a raw pixel buffer
  * @version 2018/06/23
  * - added addToRegion overloads that accept const reference
  * - added convertRGBToColor that accepts three rgb integers
@@ -46,6 +48,7 @@
 #ifndef _gwindow_h
 #define _gwindow_h
 
+#include <cstdint>
 #include <initializer_list>
 #include <string>
 #include "grid.h"
@@ -805,6 +808,15 @@ public:
      */
     void setPixels(const Grid<int>& pixels);
 
+    /*
+     * Sets the pixel value at all (x, y) positions in the canvas from a
+     * buffer of RGB integers in row-major order, where row r starts at
+     * pixels[r * stride].  Sends the pixels to the back-end as one bulk
+     * update without first copying them into a Grid.
+     * Throws an error if stride is less than width.
+     */
+    void setPixels(const uint32_t* pixels, int width, int height, int stride);
+
     /*
      * Sets the pixel value at all (x, y) positions in the canvas from
      * the given grid of ARGB integers in [row][col] order.
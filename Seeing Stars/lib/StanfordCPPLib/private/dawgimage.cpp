@@ -0,0 +1,306 @@
+/*
+ * File: dawgimage.cpp
+ * -------------------
+ * This file implements the lexicon images declared in dawgimage.h.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#include "dawgimage.h"
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <vector>
+#ifndef _WIN32
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+namespace stanfordcpplib {
+
+static const char IMAGE_MAGIC[DawgImage::MAGIC_LENGTH] = { 'D', 'A', 'W', 'G', 'I', 'M', 'G', '\0' };
+static const std::uint32_t IMAGE_BYTE_ORDER = 0x01020304;
+static const std::uint32_t IMAGE_BYTE_ORDER_SWAPPED = 0x04030201;
+static const std::uint32_t IMAGE_VERSION = 1;
+
+/*
+ * An image is this header followed by edgeCount edges, each a 32-bit word in
+ * the byte order recorded in byteOrder.  In each word, the low 5 bits are the
+ * letter, the next two are the last-edge and accept flags, and the top 24 are
+ * the index of the first of the edge's children, which is how DawgLexicon's
+ * Edge bitfields lay themselves out in a word on either byte order.  The
+ * header is 32 bytes, so the edges are aligned wherever the image is.
+ */
+struct DawgImageHeader {
+    char magic[DawgImage::MAGIC_LENGTH];
+    std::uint32_t byteOrder;
+    std::uint32_t version;
+    std::uint32_t startIndex;
+    std::uint32_t edgeCount;
+    std::uint32_t wordCount;
+    std::uint32_t reserved;
+};
+
+static const std::uint32_t EDGE_LAST_EDGE = 1 << 5;
+static const std::uint32_t EDGE_ACCEPT = 1 << 6;
+static const int EDGE_CHILDREN_SHIFT = 8;
+
+// the largest edge array a binary lexicon file can describe, since children
+// are 24-bit indexes
+static const long MAX_EDGES = long(1) << 24;
+
+/*
+ * Counts the words below the run of sibling edges starting at index, the way
+ * DawgLexicon::countDawgWords does, but remembering the count for each run,
+ * since a DAWG shares its runs and walking every path could take a very long
+ * time.  Returns -1 if the runs loop back on themselves.
+ */
+static long countWords(const std::vector<std::uint32_t>& edges, std::uint32_t index,
+                       std::vector<long>& counts) {
+    if (counts[index] == -2) {
+        return -1;
+    }
+    if (counts[index] >= 0) {
+        return counts[index];
+    }
+    counts[index] = -2;
+    long count = 0;
+    for (std::uint32_t i = index; ; i++) {
+        std::uint32_t edge = edges[i];
+        if (edge & EDGE_ACCEPT) {
+            count++;
+        }
+        std::uint32_t children = edge >> EDGE_CHILDREN_SHIFT;
+        if (children != 0) {
+            long below = countWords(edges, children, counts);
+            if (below < 0) {
+                return -1;
+            }
+            count += below;
+        }
+        if (edge & EDGE_LAST_EDGE) {
+            break;
+        }
+    }
+    counts[index] = count;
+    return count;
+}
+
+bool DawgImage::isImage(const char* prefix, size_t length) {
+    return length >= MAGIC_LENGTH && memcmp(prefix, IMAGE_MAGIC, MAGIC_LENGTH) == 0;
+}
+
+DawgImage* DawgImage::open(const std::string& filename, std::string& errorMessage) {
+#ifdef _WIN32
+    std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
+    if (input.fail()) {
+        errorMessage = "Couldn't open lexicon image " + filename;
+        return nullptr;
+    }
+    return read(input, errorMessage);
+#else // !_WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        errorMessage = "Couldn't open lexicon image " + filename;
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(DawgImageHeader)) {
+        close(fd);
+        errorMessage = "Improperly formed lexicon image " + filename;
+        return nullptr;
+    }
+    size_t regionSize = size_t(info.st_size);
+    void* region = mmap(nullptr, regionSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        errorMessage = "Couldn't map lexicon image " + filename;
+        return nullptr;
+    }
+    if (!validate(region, regionSize, errorMessage)) {
+        munmap(region, regionSize);
+        return nullptr;
+    }
+    return new DawgImage(region, regionSize, /* mapped */ true);
+#endif // _WIN32
+}
+
+DawgImage* DawgImage::read(std::istream& input, std::string& errorMessage) {
+    DawgImageHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (input.gcount() != std::streamsize(sizeof(header))) {
+        errorMessage = "Improperly formed lexicon image";
+        return nullptr;
+    }
+    // check the header before trusting its edge count with an allocation
+    if (!validate(&header, sizeof(header) + size_t(header.edgeCount) * sizeof(std::uint32_t),
+                  errorMessage)) {
+        return nullptr;
+    }
+
+    size_t regionSize = sizeof(header) + size_t(header.edgeCount) * sizeof(std::uint32_t);
+    char* region = static_cast<char*>(::operator new(regionSize));
+    memcpy(region, &header, sizeof(header));
+    std::streamsize edgeBytes = std::streamsize(regionSize - sizeof(header));
+    input.read(region + sizeof(header), edgeBytes);
+    if (input.gcount() != edgeBytes) {
+        ::operator delete(region);
+        errorMessage = "Improperly formed lexicon image";
+        return nullptr;
+    }
+    return new DawgImage(region, regionSize, /* mapped */ false);
+}
+
+/*
+ * Implementation notes: convert
+ * -----------------------------
+ * The binary lexicon file format is
+ * DAWG:<startnode index>:<num bytes>:<num bytes block of edge data>
+ * with the edges in big-endian order.  Every edge is checked here, so that an
+ * image can be used without looking at its edges again when it's loaded.
+ */
+bool DawgImage::convert(std::istream& dawg, std::ostream& image, std::string& errorMessage) {
+    char firstFour[4];
+    long startIndex = -1;
+    long numBytes = -1;
+    dawg.read(firstFour, 4);
+    dawg.get();
+    dawg >> startIndex;
+    dawg.get();
+    dawg >> numBytes;
+    dawg.get();
+    if (dawg.fail() || memcmp(firstFour, "DAWG", 4) != 0
+            || startIndex < 0 || numBytes < 0 || numBytes % 4 != 0
+            || numBytes / 4 > MAX_EDGES) {
+        errorMessage = "Improperly formed lexicon file";
+        return false;
+    }
+
+    std::uint32_t edgeCount = std::uint32_t(numBytes / 4);
+    std::vector<unsigned char> bytes(static_cast<size_t>(numBytes));
+    dawg.read(reinterpret_cast<char*>(bytes.data()), numBytes);
+    if (dawg.gcount() != numBytes) {
+        errorMessage = "Improperly formed lexicon file (it ends too soon)";
+        return false;
+    }
+    std::vector<std::uint32_t> edges(edgeCount);
+    for (std::uint32_t i = 0; i < edgeCount; i++) {
+        const unsigned char* p = &bytes[4 * size_t(i)];
+        edges[i] = (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16)
+                | (std::uint32_t(p[2]) << 8) | std::uint32_t(p[3]);
+    }
+
+    // every child index has to be inside the array, and the array has to end
+    // a run, so that walking any run of edges stops inside it
+    long wordCount = 0;
+    if (edgeCount > 0) {
+        if (startIndex >= long(edgeCount) || !(edges[edgeCount - 1] & EDGE_LAST_EDGE)) {
+            errorMessage = "Improperly formed lexicon file";
+            return false;
+        }
+        for (std::uint32_t edge : edges) {
+            if ((edge >> EDGE_CHILDREN_SHIFT) >= edgeCount) {
+                errorMessage = "Improperly formed lexicon file";
+                return false;
+            }
+        }
+        std::vector<long> counts(edgeCount, -1);
+        wordCount = countWords(edges, std::uint32_t(startIndex), counts);
+        if (wordCount < 0 || wordCount > 0x7fffffffL) {
+            errorMessage = "Improperly formed lexicon file (its edges form a cycle)";
+            return false;
+        }
+    }
+
+    DawgImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IMAGE_MAGIC, MAGIC_LENGTH);
+    header.byteOrder = IMAGE_BYTE_ORDER;
+    header.version = IMAGE_VERSION;
+    header.startIndex = edgeCount > 0 ? std::uint32_t(startIndex) : 0;
+    header.edgeCount = edgeCount;
+    header.wordCount = std::uint32_t(wordCount);
+    image.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    image.write(reinterpret_cast<const char*>(edges.data()),
+                std::streamsize(edges.size() * sizeof(std::uint32_t)));
+    image.flush();
+    if (image.fail()) {
+        errorMessage = "Couldn't write lexicon image";
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Implementation notes: validate
+ * ------------------------------
+ * Only the header is checked.  Looking at the edges would touch every page of
+ * the image, which is the cost that mapping it is meant to avoid; convert has
+ * already checked them.
+ */
+bool DawgImage::validate(const void* region, size_t regionSize, std::string& errorMessage) {
+    const DawgImageHeader* header = static_cast<const DawgImageHeader*>(region);
+    if (regionSize < sizeof(DawgImageHeader) || !isImage(header->magic, MAGIC_LENGTH)) {
+        errorMessage = "Not a lexicon image";
+        return false;
+    }
+    if (header->byteOrder == IMAGE_BYTE_ORDER_SWAPPED) {
+        errorMessage = "Lexicon image was made on a machine with the other byte order;"
+                       " convert the lexicon again on this one";
+        return false;
+    }
+    if (header->byteOrder != IMAGE_BYTE_ORDER || header->version != IMAGE_VERSION) {
+        errorMessage = "Unsupported lexicon image version";
+        return false;
+    }
+    if (header->edgeCount > MAX_EDGES
+            || regionSize != sizeof(DawgImageHeader) + size_t(header->edgeCount) * sizeof(std::uint32_t)
+            || (header->edgeCount > 0 && header->startIndex >= header->edgeCount)) {
+        errorMessage = "Improperly formed lexicon image";
+        return false;
+    }
+    return true;
+}
+
+DawgImage::DawgImage(void* region, size_t regionSize, bool mapped)
+        : m_region(region),
+          m_regionSize(regionSize),
+          m_mapped(mapped),
+          m_header(static_cast<const DawgImageHeader*>(region)) {
+    // empty
+}
+
+DawgImage::~DawgImage() {
+#ifndef _WIN32
+    if (m_mapped) {
+        munmap(m_region, m_regionSize);
+        return;
+    }
+#endif // _WIN32
+    ::operator delete(m_region);
+}
+
+const std::uint32_t* DawgImage::edges() const {
+    return reinterpret_cast<const std::uint32_t*>(m_header + 1);
+}
+
+std::uint32_t DawgImage::edgeCount() const {
+    return m_header->edgeCount;
+}
+
+std::uint32_t DawgImage::startIndex() const {
+    return m_header->startIndex;
+}
+
+std::uint32_t DawgImage::wordCount() const {
+    return m_header->wordCount;
+}
+
+bool DawgImage::isMapped() const {
+    return m_mapped;
+}
+
+} // namespace stanfordcpplib
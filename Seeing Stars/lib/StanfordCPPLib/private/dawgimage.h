@@ -0,0 +1,123 @@
+/*
+ * File: dawgimage.h
+ * -----------------
+ * This file defines the <code>DawgImage</code> class, a lexicon's DAWG in a
+ * form that can be mapped straight into memory.
+ *
+ * The binary lexicon files read by <code>DawgLexicon</code> hold their edges
+ * in big-endian order, so loading one means reading every edge into memory
+ * of its own and byte-swapping it, and then walking the whole DAWG to count
+ * its words.  An image holds the same edges already in the byte order of the
+ * machine that made it, after a header that records that order and the word
+ * count, so a lexicon can use the file's pages as they are.  The pages are
+ * mapped read-only and shared, so every process that loads the same image
+ * shares one copy of it in memory, and loading costs about the same however
+ * big the lexicon is.
+ *
+ * An image file is made from a binary lexicon file with
+ * <code>convert</code>, which is what tools/dawgimage.cpp does.  It is only
+ * good on machines with the byte order of the one that made it; opening it
+ * anywhere else fails with a message saying so.  This file has no
+ * dependencies on the rest of the library, so that the tool can use it too.
+ *
+ * A mapped image is used as it is, without being checked again, for as long
+ * as the lexicon lives.  So an image file must never be rewritten in place;
+ * replace it by renaming a complete new file over it, as tools/dawgimage.cpp
+ * does, and programs that already have it mapped keep the old one.
+ *
+ * On Windows, an image is read into memory rather than mapped.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#ifndef _dawgimage_h
+#define _dawgimage_h
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace stanfordcpplib {
+
+struct DawgImageHeader;
+
+class DawgImage {
+public:
+    /*
+     * The number of bytes at the start of a file that identify it as an image.
+     */
+    static const size_t MAGIC_LENGTH = 8;
+
+    /*
+     * Returns true if the given bytes, the first ones in a file, are the
+     * start of an image.
+     */
+    static bool isImage(const char* prefix, size_t length);
+
+    /*
+     * Maps the image file with the given name read-only.
+     * Returns nullptr and sets errorMessage if the file can't be opened or
+     * isn't a valid image for this machine.
+     */
+    static DawgImage* open(const std::string& filename, std::string& errorMessage);
+
+    /*
+     * Reads an image from the start of the given stream into memory of its
+     * own, for images that aren't in a file of their own.
+     * Returns nullptr and sets errorMessage if the stream doesn't hold a valid
+     * image for this machine.
+     */
+    static DawgImage* read(std::istream& input, std::string& errorMessage);
+
+    /*
+     * Reads a lexicon in the binary DAWG format from dawg and writes it to
+     * image as an image for this machine.
+     * Returns false and sets errorMessage if dawg isn't a well-formed binary
+     * lexicon or image can't be written.
+     */
+    static bool convert(std::istream& dawg, std::ostream& image, std::string& errorMessage);
+
+    virtual ~DawgImage();
+
+    /*
+     * The edges, in DawgLexicon's in-memory layout, and how many there are.
+     */
+    const std::uint32_t* edges() const;
+    std::uint32_t edgeCount() const;
+
+    /*
+     * The index of the first of the edges out of the DAWG's root.
+     */
+    std::uint32_t startIndex() const;
+
+    /*
+     * The number of words in the DAWG.
+     */
+    std::uint32_t wordCount() const;
+
+    /*
+     * Returns true if the image is mapped from its file rather than read
+     * into memory of its own.
+     */
+    bool isMapped() const;
+
+private:
+    DawgImage(void* region, size_t regionSize, bool mapped);
+
+    static bool validate(const void* region, size_t regionSize, std::string& errorMessage);
+
+    void* m_region;
+    size_t m_regionSize;
+    bool m_mapped;
+    const DawgImageHeader* m_header;
+
+    // images own their memory; copying one makes no sense
+    DawgImage(const DawgImage&);
+    DawgImage& operator =(const DawgImage&);
+};
+
+} // namespace stanfordcpplib
+
+#endif // _dawgimage_h
@@ -4,6 +4,18 @@
  * This file implements the platform interface by passing commands to
  * a Java back end that manages the display.
  * 
+ * @version 2026/10/19
+ * - added gtimer_lookup
+ * - instrumented putPipe and getResult (see instrument.h)
+ * - trace spans for each putPipe command, named by opcode
+ * - Unix initPipe can attach to a pre-started back-end from a pool daemon
+ *   (see SPL_BACKEND_SOCKET and tools/splbackendd.cpp); the request carries the
+ *   program's display, locale, Java and library environment
+ * - optional shared-memory transport to the back-end (see SPL_TRANSPORT and
+ *   shmtransport.h)
+ * - each command, and each long command's chunks together, go out in one write
+ * - added gwindow_setPixels from a raw pixel buffer; bulk pixel commands are
+ *   built without extra copies
  * @version 2018/07/08
  * - bug fix for GTimer deletion
  * @version 2018/06/24
@@ -120,12 +132,18 @@
 #  include <sys/types.h>
 #  include <sys/stat.h>
 #  include <sys/resource.h>
+#  include <sys/socket.h>
+#  include <sys/time.h>
+#  include <sys/uio.h>
+#  include <sys/un.h>
+#  include <sys/wait.h>
 #  include <dirent.h>
 #  include <errno.h>
 #  include <pwd.h>
 #  include <stdint.h>
 #  include <unistd.h>
 
+extern char** environ;
 extern void error(const std::string& msg);
 
 /*
@@ -171,6 +189,7 @@ static int& pout(bool check = true) {
 #include <vector>
 #include "private/consolestreambuf.h"
 #include "private/forwardingstreambuf.h"
+#include "private/shmtransport.h"
 #include "private/static.h"
 #include "private/version.h"
 #include "base64.h"
@@ -187,6 +206,7 @@ static int& pout(bool check = true) {
 #include "gtimer.h"
 #include "gtypes.h"
 #include "hashmap.h"
+#include "instrument.h"
 #include "queue.h"
 #include "stack.h"
 #include "strlib.h"
@@ -237,7 +257,11 @@ static GEvent parseTableEvent(TokenScanner& scanner, EventType type);
 static GEvent parseTimerEvent(TokenScanner& scanner, EventType type);
 static GEvent parseWindowEvent(TokenScanner& scanner, EventType type);
 static std::string& programName();
+#ifdef SPL_ENABLE_TRACING
+static std::string pipeOpcode(const std::string& line);
+#endif // SPL_ENABLE_TRACING
 static void putPipe(const std::string& line);
+static void putPipeFrame(const std::string& lines);
 static void putPipeLongString(const std::string& line);
 // static int scanChar(TokenScanner& scanner);
 static GDimension scanDimension(const std::string& str);
@@ -845,6 +869,18 @@ void Platform::gwindow_setPixels(const GWindow& gw, const Grid<int>& grid) {
     putPipe(os.str());
 }
 
+void Platform::gwindow_setPixels(const GWindow& gw, const uint32_t* pixels, int width, int height, int stride) {
+    // Base64 needs no quoting, so the pixels can be appended to the command as is
+    std::ostringstream os;
+    os << "GWindow.setPixels(\"" << gw.gwd << "\", \"";
+    std::string base64 = Base64::encode(GBufferedImage::pixelsToPixelString(pixels, width, height, stride));
+    std::string command = os.str();
+    command.reserve(command.length() + base64.length() + 2);
+    command += base64;
+    command += "\")";
+    putPipe(command);
+}
+
 void Platform::gwindow_toBack(const GWindow& gw) {
     std::ostringstream os;
     os << "GWindow.toBack(\"" << gw.gwd << "\")";
@@ -899,6 +935,18 @@ void Platform::gtimer_delete(const GTimer& timer) {
     }
 }
 
+// returns the data of the live timer whose GTimerData::id is the given number,
+// or nullptr if there is no such timer; used to re-target recorded timer events
+GTimerData* Platform::gtimer_lookup(int instanceNumber) {
+    for (const std::string& id : STATIC_VARIABLE(timerTable)) {
+        GTimerData* gtd = STATIC_VARIABLE(timerTable).get(id);
+        if (gtd->id == instanceNumber) {
+            return gtd;
+        }
+    }
+    return nullptr;
+}
+
 void Platform::gtimer_start(const GTimer& timer) {
     std::string id = timer.getID();
     std::ostringstream os;
@@ -1493,9 +1541,14 @@ void Platform::gbufferedimage_setRGB(GObject* gobj, double x, double y,
 
 void Platform::gbufferedimage_updateAllPixels(GObject* gobj,
                                               const std::string& base64) {
+    // the pixels can run to megabytes; avoid copying them through a stream
     std::ostringstream os;
-    os << "GBufferedImage.updateAllPixels(\"" << gobj << "\", \"" << base64 << "\")";
-    putPipe(os.str());
+    os << "GBufferedImage.updateAllPixels(\"" << gobj << "\", \"";
+    std::string command = os.str();
+    command.reserve(command.length() + base64.length() + 2);
+    command += base64;
+    command += "\")";
+    putPipe(command);
 }
 
 GDimension Platform::gimage_constructor(GObject* gobj, const std::string& filename) {
@@ -2643,16 +2696,39 @@ void setExitEnabled(bool enabled) {
 } // namespace stanfordcpplib
 
 
+#ifdef SPL_ENABLE_TRACING
+// the command name at the start of a line sent to the back-end, such as
+// "GWindow.create"; chunks of a long command have none, so they get a generic name
+static std::string pipeOpcode(const std::string& line) {
+    size_t paren = line.find('(');
+    if (paren == std::string::npos || paren == 0) {
+        return "putPipe(data)";
+    }
+    for (size_t i = 0; i < paren; i++) {
+        if (!isalnum(static_cast<unsigned char>(line[i])) && line[i] != '.' && line[i] != '_') {
+            return "putPipe(data)";
+        }
+    }
+    return line.substr(0, paren);
+}
+#endif // SPL_ENABLE_TRACING
+
 static void putPipeLongString(const std::string& line) {
-    // break into chunks
+    // break into chunks, and send them all at once rather than one write per chunk
     // precondition: line does not contain substring "LongCommand.end()"
-    putPipe("LongCommand.begin()");
+    static const std::string BEGIN = "LongCommand.begin()\n";
+    static const std::string END = "LongCommand.end()\n";
     size_t len = line.length();
-    for (size_t i = 0; i < len; i += STATIC_VARIABLE(PIPE_MAX_COMMAND_LENGTH)) {
-        std::string chunk = line.substr(i, std::min(STATIC_VARIABLE(PIPE_MAX_COMMAND_LENGTH), len - i));
-        putPipe(chunk);
+    size_t chunkLength = STATIC_VARIABLE(PIPE_MAX_COMMAND_LENGTH);
+    std::string frame;
+    frame.reserve(BEGIN.length() + len + len / chunkLength + 1 + END.length());
+    frame += BEGIN;
+    for (size_t i = 0; i < len; i += chunkLength) {
+        frame.append(line, i, std::min(chunkLength, len - i));
+        frame += '\n';
     }
-    putPipe("LongCommand.end()");
+    frame += END;
+    putPipeFrame(frame);
 }
 
 void parseArgs(int argc, char** argv) {
@@ -2778,17 +2854,24 @@ static void initPipe() {
 
 // Windows implementation; see Unix implementation elsewhere in this file
 static void putPipe(const std::string& line) {
+    SPL_INSTRUMENT("Platform::putPipe");
+    SPL_TRACE("putPipe", pipeOpcode(line));
     if (line.length() > STATIC_VARIABLE(PIPE_MAX_COMMAND_LENGTH)) {
         putPipeLongString(line);
         return;
     }
     
-    DWORD nch;
 #ifdef PIPE_DEBUG
     fprintf(stderr, "putPipe(\"%s\")\n", line.c_str());  fflush(stderr);
 #endif // PIPE_DEBUG
-    if (!WinCheck(WriteFile(STATIC_VARIABLE(wrToJBE), line.c_str(), line.length(), &nch, nullptr))) return;
-    if (!WinCheck(WriteFile(STATIC_VARIABLE(wrToJBE), "\n", 1, &nch, nullptr))) return;
+    putPipeFrame(line + "\n");
+}
+
+// Windows implementation; see Unix implementation elsewhere in this file
+// (lines must each end in a newline)
+static void putPipeFrame(const std::string& lines) {
+    DWORD nch;
+    if (!WinCheck(WriteFile(STATIC_VARIABLE(wrToJBE), lines.c_str(), lines.length(), &nch, nullptr))) return;
     WinCheck(FlushFileBuffers(STATIC_VARIABLE(wrToJBE)));
 }
 
@@ -2825,17 +2908,6 @@ static std::string getPipe() {
 
 /* Linux/Mac implementation of interface to Java back end */
 
-// Unix implementation; see Windows implementation elsewhere in this file
-static bool LinCheck(ssize_t result) {
-    if (result == EPIPE) {
-        // fputs("Error from Java back-end subprocess.\n", stderr);
-        // throw InterruptedIOException();
-        return false;
-    } else {
-        return true;
-    }
-}
-
 #ifndef SPL_HEADLESS_MODE
 // Unix implementation; see Windows implementation elsewhere in this file
 static void sigPipeHandler(int /*signum*/) {
@@ -2849,9 +2921,241 @@ static void sigPipeHandler(int /*signum*/) {
 }
 #endif // SPL_HEADLESS_MODE
 
+// Unix implementation; see Windows implementation elsewhere in this file
+// returns the command line that launches the Java back-end, as an argument list
+static std::vector<std::string> getJavaBackEndCommand(const std::string& jarName) {
+    std::vector<std::string> command;
+    command.push_back(getJavaCommand());
+#ifdef __APPLE__
+    command.push_back("-Xdock:name=" + programName());
+#else // !APPLE
+#ifdef SPL_HEADLESS_MODE
+    command.push_back("-Djava.awt.headless=true");
+#endif // SPL_HEADLESS_MODE
+#endif // APPLE
+    command.push_back("-jar");
+    command.push_back(jarName);
+    command.push_back(programName());
+    return command;
+}
+
+// Unix implementation; see Windows implementation elsewhere in this file
+// true for the environment variables that a back-end depends on, which are
+// sent to the back-end pool daemon with each request; must match the
+// daemon's list (isRelayedVariable in tools/splbackendd.cpp)
+static bool isBackEndEnvironmentVariable(const std::string& name) {
+    static const char* const NAMES[] = {
+        "CLASSPATH", "DISPLAY", "JAVA_HOME", "JAVA_TOOL_OPTIONS", "LANG", "LANGUAGE",
+        "PATH", "WAYLAND_DISPLAY", "XAUTHORITY", "_JAVA_OPTIONS"
+    };
+    for (const char* relayed : NAMES) {
+        if (name == relayed) {
+            return true;
+        }
+    }
+    return startsWith(name, "LC_") || startsWith(name, "SPL_");
+}
+
+// Unix implementation; see Windows implementation elsewhere in this file
+// tries to take over an already-started Java back-end from the back-end pool
+// daemon (tools/splbackendd.cpp) listening on the Unix domain socket named by
+// the SPL_BACKEND_SOCKET environment variable.  The daemon only hands over a
+// back-end that was launched with exactly this command in this directory,
+// with this program's values of the variables isBackEndEnvironmentVariable
+// picks out (its display, locale, Java and library settings).
+// returns false if there is no daemon or it has nothing suitable; the caller
+// should then start a back-end of its own
+static bool attachToWarmBackEnd(const std::vector<std::string>& command) {
+    const char* socketPath = getenv("SPL_BACKEND_SOCKET");
+    if (!socketPath || !*socketPath) {
+        return false;
+    }
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        return false;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return false;
+    }
+    // don't let a wedged daemon hang program startup
+    timeval timeout = { 2, 0 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (connect(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(sock);
+        return false;
+    }
+
+    // request: working directory, the number of environment entries, each
+    // NAME=value entry, then each argument, each NUL-terminated, then an empty
+    // string to end the list.  the entries are sorted so that the same
+    // environment always makes the same request
+    std::vector<std::string> environment;
+    for (char** entry = environ; *entry; entry++) {
+        std::string name(*entry, strcspn(*entry, "="));
+        if ((*entry)[name.length()] == '=' && !name.empty()
+                && isBackEndEnvironmentVariable(name)) {
+            environment.push_back(*entry);
+        }
+    }
+    std::sort(environment.begin(), environment.end());
+
+    std::string request = stanfordcpplib::getPlatform()->filelib_getCurrentDirectory();
+    request += '\0';
+    request += integerToString(static_cast<int>(environment.size()));
+    request += '\0';
+    for (const std::string& entry : environment) {
+        request += entry;
+        request += '\0';
+    }
+    for (const std::string& arg : command) {
+        request += arg;
+        request += '\0';
+    }
+    request += '\0';
+    size_t sent = 0;
+    while (sent < request.length()) {
+        ssize_t count = write(sock, request.data() + sent, request.length() - sent);
+        if (count <= 0) {
+            close(sock);
+            return false;
+        }
+        sent += count;
+    }
+
+    // reply: 'Y' with the back-end's stdin and stdout attached, or 'N'
+    char status = 'N';
+    iovec data = { &status, 1 };
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(2 * sizeof(int))];
+    } control;
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+    ssize_t received = recvmsg(sock, &message, 0);
+    close(sock);
+
+    int fds[2] = { -1, -1 };
+    cmsghdr* header = received == 1 ? CMSG_FIRSTHDR(&message) : nullptr;
+    if (header && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS
+            && header->cmsg_len == CMSG_LEN(2 * sizeof(int))) {
+        memcpy(fds, CMSG_DATA(header), sizeof(fds));
+    }
+    if (status != 'Y' || fds[0] < 0 || fds[1] < 0) {
+        if (fds[0] >= 0) close(fds[0]);
+        if (fds[1] >= 0) close(fds[1]);
+        return false;
+    }
+
+    pout(/* check */ false) = fds[0];
+    pin(/* check */ false) = fds[1];
+    return true;
+}
+
+// Unix implementation; see Windows implementation elsewhere in this file
+// the shared-memory transport to the back-end, if one is in use (see
+// initSharedMemoryTransport); otherwise nullptr, and the pipes are used
+static stanfordcpplib::ShmTransport*& shmTransport() {
+    static stanfordcpplib::ShmTransport* transport = nullptr;
+    return transport;
+}
+
+static void unlinkSharedMemory() {
+    if (shmTransport()) {
+        shmTransport()->unlink();
+    }
+}
+
+// Unix implementation; see Windows implementation elsewhere in this file
+// sets up a shared-memory region for talking to the back-end, in place of
+// the pipes, and launches a back-end that uses it.  the back-end is told the
+// region's name with a "--transport=shm:NAME" argument after its usual ones.
+// if the SPL_SHM_SERVER environment variable is set, it names a program to run
+// as the back-end instead of the Java one (such as tools/splshmstub.cpp).
+// returns false if the region can't be made; the caller should use pipes
+static bool initSharedMemoryTransport(std::vector<std::string> command) {
+    std::string name = "/spl-" + integerToString(getpid());
+    stanfordcpplib::ShmTransport* transport = stanfordcpplib::ShmTransport::create(name);
+    if (!transport) {
+        return false;
+    }
+
+    const char* server = getenv("SPL_SHM_SERVER");
+    if (server && *server) {
+        command.clear();
+        command.push_back(server);
+        command.push_back(programName());
+    }
+    command.push_back("--transport=shm:" + name);
+
+    int child = fork();
+    if (child == 0) {
+        std::vector<char*> argv;
+        for (std::string& arg : command) {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+        execvp(argv[0], argv.data());
+
+        // use stderr directly rather than cerr because graphical console is unreachable
+        fputs("***\n", stderr);
+        fputs("*** STANFORD C++ LIBRARY ERROR:\n", stderr);
+        fputs(("*** Unable to launch back-end " + command[0] + " for shared-memory transport\n").c_str(), stderr);
+        fputs("***\n", stderr);
+        fflush(stderr);
+        _exit(1);
+    } else if (child < 0) {
+        transport->unlink();
+        delete transport;
+        return false;
+    }
+
+    // a blocked read would otherwise wait forever for a back-end that has died
+    transport->setPeerCheck([child]() {
+        pid_t result = waitpid(child, nullptr, WNOHANG);
+        return result == 0 || (result < 0 && kill(child, 0) == 0);
+    });
+    shmTransport() = transport;
+
+    // the back-end removes the region's name when it attaches; if it never
+    // does, don't leave the name behind
+    atexit(unlinkSharedMemory);
+    return true;
+}
+
 // Unix implementation; see Windows implementation elsewhere in this file
 static void initPipe() {
     std::string jarName = getSplJarPath();
+    std::vector<std::string> command = getJavaBackEndCommand(jarName);
+
+    const char* transport = getenv("SPL_TRANSPORT");
+    if (transport && std::string(transport) == "shm") {
+        if (initSharedMemoryTransport(command)) {
+            STATIC_VARIABLE(cppLibPid) = getpid();
+            return;
+        }
+        // use stderr directly rather than cerr because graphical console is unreachable
+        fputs("*** Unable to set up shared-memory transport; using pipes instead.\n", stderr);
+        fflush(stderr);
+    }
+
+    if (attachToWarmBackEnd(command)) {
+        STATIC_VARIABLE(cppLibPid) = getpid();
+#ifndef SPL_HEADLESS_MODE
+        signal(SIGPIPE, sigPipeHandler);
+#endif // SPL_HEADLESS_MODE
+        return;
+    }
     
     int toJBE[2], fromJBE[2];
     if (pipe(toJBE) != 0) {
@@ -2870,22 +3174,15 @@ static void initPipe() {
         dup2(fromJBE[1], 1);
         close(fromJBE[0]);
         close(fromJBE[1]);
-        std::string javaCommand = getJavaCommand();
-        
-#ifdef __APPLE__
-        std::string option = "-Xdock:name=" + programName();
-        int execlpResult = execlp(javaCommand.c_str(), javaCommand.c_str(), option.c_str(), "-jar", jarName.c_str(),
-               programName().c_str(), nullptr);
-        std::string fullCommand = javaCommand + " " + option + " -jar " + jarName + " " + programName();
-#else // !APPLE
-#ifdef SPL_HEADLESS_MODE
-        int execlpResult = execlp(javaCommand.c_str(), javaCommand.c_str(), "-Djava.awt.headless=true", "-jar", jarName.c_str(), programName().c_str(), nullptr);
-        std::string fullCommand = javaCommand + " -jar " + jarName + " " + programName();
-#else // !SPL_HEADLESS_MODE
-        int execlpResult = execlp(javaCommand.c_str(), javaCommand.c_str(), "-jar", jarName.c_str(), programName().c_str(), nullptr);
-        std::string fullCommand = javaCommand + " -Djava.awt.headless=true -jar " + jarName + " " + programName();
-#endif // SPL_HEADLESS_MODE
-#endif // APPLE
+
+        std::vector<char*> argv;
+        std::string fullCommand;
+        for (std::string& arg : command) {
+            argv.push_back(&arg[0]);
+            fullCommand += (fullCommand.empty() ? "" : " ") + arg;
+        }
+        argv.push_back(nullptr);
+        int execlpResult = execvp(argv[0], argv.data());
         
         // if we get here, the execlp call failed, so show error message
         // use stderr directly rather than cerr because graphical console is unreachable
@@ -2928,6 +3225,8 @@ static void initPipe() {
 
 // Unix implementation; see Windows implementation elsewhere in this file
 static void putPipe(const std::string& line) {
+    SPL_INSTRUMENT("Platform::putPipe");
+    SPL_TRACE("putPipe", pipeOpcode(line));
     if (line.length() > STATIC_VARIABLE(PIPE_MAX_COMMAND_LENGTH)) {
         putPipeLongString(line);
         return;
@@ -2935,8 +3234,29 @@ static void putPipe(const std::string& line) {
 #ifdef PIPE_DEBUG
     fprintf(stderr, "putPipe(\"%s\")\n", line.c_str());  fflush(stderr);
 #endif
-    LinCheck(write(pout(), line.c_str(), line.length()));
-    LinCheck(write(pout(), "\n", 1));
+    putPipeFrame(line + "\n");
+}
+
+// Unix implementation; see Windows implementation elsewhere in this file
+// (lines must each end in a newline)
+static void putPipeFrame(const std::string& lines) {
+    if (shmTransport()) {
+        // as with the pipe, a back-end that has gone away shows up on the next read
+        shmTransport()->write(lines.data(), lines.length());
+        return;
+    }
+    // a large frame may go through the pipe in several pieces
+    for (size_t written = 0; written < lines.length(); ) {
+        ssize_t count = write(pout(), lines.data() + written, lines.length() - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            // as before, a back-end that has gone away shows up on the next read
+            return;
+        }
+        written += count;
+    }
 }
 
 // Unix implementation; see Windows implementation elsewhere in this file
@@ -2945,6 +3265,15 @@ static std::string getPipe() {
     fprintf(stderr, "getPipe(): waiting ...\n");  fflush(stderr);
 #endif
     std::string line = "";
+    if (shmTransport()) {
+        if (!shmTransport()->readLine(line)) {
+            throw InterruptedIOException();
+        }
+#ifdef PIPE_DEBUG
+        fprintf(stderr, "getPipe(): returning \"%s\"\n", line.c_str());  fflush(stderr);
+#endif
+        return line;
+    }
     int charsRead = 0;
     int charsReadMax = STATIC_VARIABLE(PIPE_MAX_COMMAND_LENGTH) + 100;
     while (charsRead < charsReadMax) {
@@ -2970,6 +3299,7 @@ static std::string getPipe() {
 
 static std::string getResult(bool consumeAcks, bool stopOnEvent,
                              const std::string& caller) {
+    SPL_INSTRUMENT("Platform::getResult");
     while (true) {
 #ifdef PIPE_DEBUG
         fprintf(stderr, "getResult(consumeAcks=%s, stopOnEvent=%s, caller=%s)\n",
@@ -5,6 +5,9 @@
  * the platform-specific parts of the StanfordCPPLib package.  This file is
  * logically part of the implementation and is not interesting to clients.
  *
+ * @version 2026/10/19
+ * - added gtimer_lookup
+ * - added gwindow_setPixels from a raw pixel buffer
  * @version 2018/06/24
  * - added gformattedpane_get/setContentType
  * @version 2018/06/23
@@ -68,6 +71,7 @@
 #ifndef _platform_h
 #define _platform_h
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "gevents.h"
@@ -311,6 +315,7 @@ public:
 
     void gtimer_constructor(const GTimer& timer, double delay);
     void gtimer_delete(const GTimer& timer);
+    GTimerData* gtimer_lookup(int instanceNumber);
     void gtimer_pause(double milliseconds);
     void gtimer_start(const GTimer& timer);
     void gtimer_stop(const GTimer& timer);
@@ -349,6 +354,7 @@ public:
     void gwindow_setLocationSaved(const GWindow& gw, bool value);
     void gwindow_setPixel(const GWindow& gw, int x, int y, int rgb, bool repaint = true);
     void gwindow_setPixels(const GWindow& gw, const Grid<int>& grid);
+    void gwindow_setPixels(const GWindow& gw, const uint32_t* pixels, int width, int height, int stride);
     void gwindow_setRegionAlignment(const GWindow& gw, const std::string& region, const std::string& align);
     void gwindow_setRepaintImmediately(const GWindow& gw, bool value);
     void gwindow_setResizable(const GWindow& gw, bool value);
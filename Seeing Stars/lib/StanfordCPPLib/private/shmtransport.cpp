@@ -0,0 +1,345 @@
+/*
+ * File: shmtransport.cpp
+ * ----------------------
+ * This file implements the shared-memory transport declared in shmtransport.h.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#ifndef _WIN32
+
+#include "shmtransport.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <new>
+#include <unistd.h>
+#ifdef __linux__
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#endif // __linux__
+
+namespace stanfordcpplib {
+
+static const std::uint32_t SHM_MAGIC = 0x53504c52;   // "SPLR"
+static const std::uint32_t SHM_VERSION = 1;
+static const size_t CACHE_LINE = 64;
+
+// ring sizes are kept between these powers of two
+static const size_t MIN_CAPACITY = 4096;
+static const size_t MAX_CAPACITY = size_t(1) << 30;
+
+// how many times to poll before going to sleep (on a multiprocessor; with
+// one processor, the other side can't make progress while we spin), and how
+// long to sleep before checking that the other side is still alive
+static const int SPIN_COUNT = 2000;
+static const long WAIT_SLICE_NS = 20 * 1000 * 1000;
+
+struct ShmHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t capacity;
+    char padding[CACHE_LINE - 3 * sizeof(std::uint32_t)];
+};
+
+/*
+ * One direction of the transport.  head and tail count all bytes ever
+ * written and read, modulo 2^32, so the ring is empty when they are equal
+ * and full when they differ by the capacity.  Each is written by one side
+ * only and sits on its own cache line.  The signal words count wake-ups and
+ * are what the sleeping side waits on; the waiting flags let the other side
+ * skip the wake-up system call when nobody is asleep.
+ */
+struct ShmRing {
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> head;
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> tail;
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> dataSignal;
+    std::atomic<std::uint32_t> consumerWaiting;
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> spaceSignal;
+    std::atomic<std::uint32_t> producerWaiting;
+    alignas(CACHE_LINE) std::uint32_t capacity;
+
+    char* data() {
+        return reinterpret_cast<char*>(this + 1);
+    }
+};
+
+static size_t regionSizeFor(size_t capacity) {
+    return sizeof(ShmHeader) + 2 * (sizeof(ShmRing) + capacity);
+}
+
+static ShmRing* ringAt(void* region, size_t capacity, int index) {
+    char* base = static_cast<char*>(region) + sizeof(ShmHeader);
+    return reinterpret_cast<ShmRing*>(base + index * (sizeof(ShmRing) + capacity));
+}
+
+static int spinCount() {
+    static const int count = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SPIN_COUNT : 0;
+    return count;
+}
+
+static inline void cpuRelax() {
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// sleeps until *word no longer holds expected, someone wakes us, or a
+// WAIT_SLICE_NS time slice passes, whichever comes first
+static void waitOn(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+#ifdef __linux__
+    timespec timeout = { 0, WAIT_SLICE_NS };
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else // !__linux__
+    // no cross-process futex; poll at a fine granularity instead
+    timespec nap = { 0, 50 * 1000 };
+    for (long slept = 0; slept < WAIT_SLICE_NS && word.load() == expected; slept += nap.tv_nsec) {
+        nanosleep(&nap, nullptr);
+    }
+#endif // __linux__
+}
+
+static void wake(std::atomic<std::uint32_t>& word, std::atomic<std::uint32_t>& waiting) {
+    word.fetch_add(1);
+#ifdef __linux__
+    if (waiting.load()) {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+#else // !__linux__
+    (void) waiting;
+#endif // __linux__
+}
+
+ShmTransport* ShmTransport::create(const std::string& name, size_t capacity) {
+    size_t ringCapacity = MIN_CAPACITY;
+    while (ringCapacity < capacity && ringCapacity < MAX_CAPACITY) {
+        ringCapacity <<= 1;
+    }
+    size_t regionSize = regionSizeFor(ringCapacity);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (ftruncate(fd, regionSize) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* region = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    ShmRing* rings[2];
+    for (int i = 0; i < 2; i++) {
+        rings[i] = new (ringAt(region, ringCapacity, i)) ShmRing();
+        rings[i]->head.store(0);
+        rings[i]->tail.store(0);
+        rings[i]->dataSignal.store(0);
+        rings[i]->consumerWaiting.store(0);
+        rings[i]->spaceSignal.store(0);
+        rings[i]->producerWaiting.store(0);
+        rings[i]->capacity = std::uint32_t(ringCapacity);
+    }
+
+    // the header goes last; a back-end that sees a valid header sees valid rings
+    ShmHeader* header = static_cast<ShmHeader*>(region);
+    header->version = SHM_VERSION;
+    header->capacity = std::uint32_t(ringCapacity);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHM_MAGIC;
+
+    // ring 0 carries commands to the back-end; ring 1 carries its replies
+    return new ShmTransport(name, region, regionSize, rings[0], rings[1]);
+}
+
+ShmTransport* ShmTransport::attach(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(ShmHeader)) {
+        close(fd);
+        return nullptr;
+    }
+    size_t regionSize = size_t(info.st_size);
+    void* region = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        return nullptr;
+    }
+
+    ShmHeader* header = static_cast<ShmHeader*>(region);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->magic != SHM_MAGIC || header->version != SHM_VERSION
+            || regionSizeFor(header->capacity) != regionSize) {
+        munmap(region, regionSize);
+        return nullptr;
+    }
+    shm_unlink(name.c_str());
+
+    size_t capacity = header->capacity;
+    return new ShmTransport(name, region, regionSize,
+                            ringAt(region, capacity, 1), ringAt(region, capacity, 0));
+}
+
+ShmTransport::ShmTransport(const std::string& name, void* region, size_t regionSize,
+                           ShmRing* outgoing, ShmRing* incoming)
+        : m_name(name),
+          m_region(region),
+          m_regionSize(regionSize),
+          m_outgoing(outgoing),
+          m_incoming(incoming),
+          m_pendingStart(0) {
+    // empty
+}
+
+ShmTransport::~ShmTransport() {
+    munmap(m_region, m_regionSize);
+}
+
+void ShmTransport::setPeerCheck(std::function<bool ()> isPeerAlive) {
+    m_isPeerAlive = isPeerAlive;
+}
+
+const std::string& ShmTransport::name() const {
+    return m_name;
+}
+
+void ShmTransport::unlink() {
+    shm_unlink(m_name.c_str());
+}
+
+bool ShmTransport::waitForData() {
+    ShmRing& ring = *m_incoming;
+    for (int i = 0, spins = spinCount(); i < spins; i++) {
+        if (ring.head.load(std::memory_order_acquire) != ring.tail.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        cpuRelax();
+    }
+    while (true) {
+        // announce that we're about to sleep, then look once more, so that a
+        // producer either sees the announcement or we see its data
+        std::uint32_t signal = ring.dataSignal.load();
+        ring.consumerWaiting.store(1);
+        if (ring.head.load() != ring.tail.load(std::memory_order_relaxed)) {
+            ring.consumerWaiting.store(0);
+            return true;
+        }
+        waitOn(ring.dataSignal, signal);
+        ring.consumerWaiting.store(0);
+        if (ring.head.load(std::memory_order_acquire) != ring.tail.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        if (m_isPeerAlive && !m_isPeerAlive()) {
+            return false;
+        }
+    }
+}
+
+bool ShmTransport::waitForSpace() {
+    ShmRing& ring = *m_outgoing;
+    for (int i = 0, spins = spinCount(); i < spins; i++) {
+        if (ring.head.load(std::memory_order_relaxed) - ring.tail.load(std::memory_order_acquire) < ring.capacity) {
+            return true;
+        }
+        cpuRelax();
+    }
+    while (true) {
+        std::uint32_t signal = ring.spaceSignal.load();
+        ring.producerWaiting.store(1);
+        if (ring.head.load(std::memory_order_relaxed) - ring.tail.load() < ring.capacity) {
+            ring.producerWaiting.store(0);
+            return true;
+        }
+        waitOn(ring.spaceSignal, signal);
+        ring.producerWaiting.store(0);
+        if (ring.head.load(std::memory_order_relaxed) - ring.tail.load(std::memory_order_acquire) < ring.capacity) {
+            return true;
+        }
+        if (m_isPeerAlive && !m_isPeerAlive()) {
+            return false;
+        }
+    }
+}
+
+bool ShmTransport::write(const char* data, size_t length) {
+    ShmRing& ring = *m_outgoing;
+    size_t mask = ring.capacity - 1;
+    while (length > 0) {
+        std::uint32_t head = ring.head.load(std::memory_order_relaxed);
+        std::uint32_t tail = ring.tail.load(std::memory_order_acquire);
+        size_t space = ring.capacity - (head - tail);
+        if (space == 0) {
+            if (!waitForSpace()) {
+                return false;
+            }
+            continue;
+        }
+
+        size_t count = std::min(space, length);
+        size_t offset = head & mask;
+        size_t first = std::min(count, ring.capacity - offset);
+        memcpy(ring.data() + offset, data, first);
+        memcpy(ring.data(), data + first, count - first);
+        ring.head.store(head + std::uint32_t(count), std::memory_order_release);
+        wake(ring.dataSignal, ring.consumerWaiting);
+
+        data += count;
+        length -= count;
+    }
+    return true;
+}
+
+bool ShmTransport::writeLine(const std::string& line) {
+    return write(line.data(), line.length()) && write("\n", 1);
+}
+
+bool ShmTransport::readLine(std::string& line) {
+    ShmRing& ring = *m_incoming;
+    size_t mask = ring.capacity - 1;
+    size_t searchFrom = m_pendingStart;
+    while (true) {
+        size_t newline = m_pending.find('\n', searchFrom);
+        if (newline != std::string::npos) {
+            line.assign(m_pending, m_pendingStart, newline - m_pendingStart);
+            m_pendingStart = newline + 1;
+
+            // drop consumed bytes once they make up most of the buffer
+            if (m_pendingStart > m_pending.length() / 2) {
+                m_pending.erase(0, m_pendingStart);
+                m_pendingStart = 0;
+            }
+            return true;
+        }
+        searchFrom = m_pending.length();
+
+        if (!waitForData()) {
+            return false;
+        }
+        std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        std::uint32_t head = ring.head.load(std::memory_order_acquire);
+        size_t count = head - tail;
+        size_t offset = tail & mask;
+        size_t first = std::min(count, ring.capacity - offset);
+        m_pending.append(ring.data() + offset, first);
+        m_pending.append(ring.data(), count - first);
+        ring.tail.store(tail + std::uint32_t(count), std::memory_order_release);
+        wake(ring.spaceSignal, ring.producerWaiting);
+    }
+}
+
+} // namespace stanfordcpplib
+
+#endif // _WIN32
@@ -0,0 +1,126 @@
+/*
+ * File: shmtransport.h
+ * --------------------
+ * This file defines the <code>ShmTransport</code> class, an alternative to
+ * the anonymous pipes normally used to talk to the Java back-end process.
+ *
+ * The transport is a POSIX shared-memory region holding two single-producer,
+ * single-consumer ring buffers of bytes: one carries commands from the C++
+ * library to the back-end, the other carries results and events back.  The
+ * messages themselves are the same newline-terminated lines sent over the
+ * pipes, so the protocol is unchanged; only the copying through the kernel
+ * and the read() call per character go away.  A side that finds its ring
+ * empty (or full) spins briefly, then sleeps on a futex (Linux) until the
+ * other side signals it, waking periodically to check that the other side
+ * is still alive.
+ *
+ * The C++ library creates the region and passes its name to the back-end
+ * when launching it (see initPipe in platform.cpp); the back-end attaches to
+ * it by name.  This file has no dependencies on the rest of the library, so
+ * a stand-alone back-end (such as tools/splshmstub.cpp) can use it too.
+ *
+ * Not available on Windows.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#ifndef _shmtransport_h
+#define _shmtransport_h
+
+#ifndef _WIN32
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace stanfordcpplib {
+
+struct ShmRing;
+
+class ShmTransport {
+public:
+    /*
+     * Creates a new shared-memory region with the given name (which should
+     * start with a slash, as in "/spl-1234") and rings of the given size in
+     * bytes, rounded up to a power of two.  This is the C++ library's side.
+     * Returns nullptr if the region can't be created.
+     */
+    static ShmTransport* create(const std::string& name, size_t capacity = 1 << 20);
+
+    /*
+     * Attaches to a region made by create.  This is the back-end's side.
+     * The name is unlinked once attached, so nothing is left behind in
+     * the file system once both sides exit.
+     * Returns nullptr if there is no such region or it isn't valid.
+     */
+    static ShmTransport* attach(const std::string& name);
+
+    virtual ~ShmTransport();
+
+    /*
+     * Sets a function that reports whether the other side is still running.
+     * While waiting for the other side, it is called every few milliseconds;
+     * once it returns false, readLine and writeLine give up and return false.
+     */
+    void setPeerCheck(std::function<bool ()> isPeerAlive);
+
+    /*
+     * Sends one line, appending the newline.  Blocks while the outgoing ring
+     * is full.  Returns false if the other side has gone away.
+     */
+    bool writeLine(const std::string& line);
+
+    /*
+     * Sends raw bytes, such as several lines already joined by newlines.
+     * Blocks while the outgoing ring is full.  Returns false if the other
+     * side has gone away.
+     */
+    bool write(const char* data, size_t length);
+
+    /*
+     * Receives one line, without its newline.  Blocks until a whole line
+     * arrives.  Returns false if the other side has gone away.
+     */
+    bool readLine(std::string& line);
+
+    /*
+     * Returns the name the region was created with.
+     */
+    const std::string& name() const;
+
+    /*
+     * Removes the region's name from the file system, if it is still there.
+     * The region itself lives on until both sides have unmapped it.
+     */
+    void unlink();
+
+private:
+    ShmTransport(const std::string& name, void* region, size_t regionSize,
+                 ShmRing* outgoing, ShmRing* incoming);
+
+    bool waitForData();
+    bool waitForSpace();
+
+    std::string m_name;
+    void* m_region;
+    size_t m_regionSize;
+    ShmRing* m_outgoing;
+    ShmRing* m_incoming;
+    std::function<bool ()> m_isPeerAlive;
+
+    // bytes received but not yet returned as part of a line, starting at
+    // m_pendingStart (consumed bytes are dropped in bulk, not line by line)
+    std::string m_pending;
+    size_t m_pendingStart;
+
+    // transports own a mapping; copying one makes no sense
+    ShmTransport(const ShmTransport&);
+    ShmTransport& operator =(const ShmTransport&);
+};
+
+} // namespace stanfordcpplib
+
+#endif // _WIN32
+
+#endif // _shmtransport_h
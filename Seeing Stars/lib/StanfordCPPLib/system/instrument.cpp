@@ -0,0 +1,352 @@
+/*
+ * File: instrument.cpp
+ * --------------------
+ * This file implements the instrumentation layer declared in instrument.h.
+ *
+ * @version 2026/10/19
+ * - initial version
+ * - added Chrome trace_event spans
+ */
+
+#include "instrument.h"
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace instrument {
+
+// set by the SIGUSR1 handler; checked (cheaply) each time a ScopedTimer finishes
+static std::atomic<bool> dumpRequested(false);
+
+#ifndef _WIN32
+static void requestDump(int /*signum*/) {
+    dumpRequested.store(true, std::memory_order_relaxed);
+}
+#endif // _WIN32
+
+static void dumpAtExit() {
+    dump();
+}
+
+// registry of all histograms by name, kept in a function so that it is safe to
+// use during static initialization (the platform pipe is used that early)
+static std::map<std::string, std::unique_ptr<LatencyHistogram>>& registry() {
+    static std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+    return histograms;
+}
+
+static std::mutex& registryLock() {
+    static std::mutex lock;
+    return lock;
+}
+
+LatencyHistogram::LatencyHistogram(const std::string& name)
+        : m_name(name),
+          m_count(0),
+          m_total(0),
+          m_max(0) {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * Values below 2 * SUB_BUCKET_COUNT get a bucket each.  Above that, a value
+ * whose highest set bit is bit b lands in one of the SUB_BUCKET_COUNT buckets
+ * for bit b, chosen by the SUB_BUCKET_BITS bits just below bit b.
+ */
+int LatencyHistogram::bucketFor(std::uint64_t value) {
+    if (value < std::uint64_t(2 * SUB_BUCKET_COUNT)) {
+        return int(value);
+    }
+    int topBit = 63 - __builtin_clzll(value);
+    int shift = topBit - SUB_BUCKET_BITS;
+    int subBucket = int((value >> shift) & (SUB_BUCKET_COUNT - 1));
+    return 2 * SUB_BUCKET_COUNT + (topBit - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+std::uint64_t LatencyHistogram::midpointOf(int bucket) {
+    if (bucket < 2 * SUB_BUCKET_COUNT) {
+        return std::uint64_t(bucket);
+    }
+    int topBit = (bucket - 2 * SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT + SUB_BUCKET_BITS + 1;
+    int subBucket = (bucket - 2 * SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+    int shift = topBit - SUB_BUCKET_BITS;
+    std::uint64_t low = (std::uint64_t(1) << topBit) | (std::uint64_t(subBucket) << shift);
+    return low + (std::uint64_t(1) << shift) / 2;
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) {
+    m_buckets[bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    std::uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (nanoseconds > max
+           && !m_max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+        // compare_exchange_weak reloaded max; try again
+    }
+}
+
+const std::string& LatencyHistogram::name() const {
+    return m_name;
+}
+
+std::uint64_t LatencyHistogram::count() const {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    std::uint64_t n = count();
+    return n == 0 ? 0.0 : double(m_total.load(std::memory_order_relaxed)) / n;
+}
+
+std::uint64_t LatencyHistogram::max() const {
+    return m_max.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::percentile(double percent) const {
+    std::uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+
+    // nearest-rank: the smallest bucket at or below which percent% of values lie
+    double exactRank = std::ceil(percent / 100.0 * n);
+    std::uint64_t rank = exactRank < 1 ? 1 : exactRank > n ? n : std::uint64_t(exactRank);
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // a bucket's midpoint can overshoot the largest value actually seen
+            return std::min(midpointOf(i), max());
+        }
+    }
+    return max();
+}
+
+LatencyHistogram& histogram(const std::string& name) {
+    std::lock_guard<std::mutex> guard(registryLock());
+    auto& histograms = registry();
+    if (histograms.empty()) {
+        // first histogram: arrange for the results to be reported
+        std::atexit(dumpAtExit);
+#ifndef _WIN32
+        std::signal(SIGUSR1, requestDump);
+#endif // _WIN32
+    }
+
+    std::unique_ptr<LatencyHistogram>& result = histograms[name];
+    if (!result) {
+        result.reset(new LatencyHistogram(name));
+    }
+    return *result;
+}
+
+ScopedTimer::ScopedTimer(LatencyHistogram& histogram)
+        : m_histogram(histogram),
+          m_start(std::chrono::steady_clock::now()) {
+    // empty
+}
+
+ScopedTimer::~ScopedTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    m_histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+    if (dumpRequested.load(std::memory_order_relaxed) && dumpRequested.exchange(false)) {
+        dump();
+    }
+}
+
+/*
+ * Each thread appends finished spans to its own buffer.  The buffers are owned
+ * by a global list rather than by the threads, so that spans recorded by a
+ * thread that has since exited still make it into the trace; each has its own
+ * lock, which only writeTrace ever contends for.
+ */
+struct TraceRecord {
+    const char* category;
+    std::string name;
+    double start;      // microseconds since traceEpoch()
+    double duration;   // microseconds
+};
+
+struct TraceBuffer {
+    int threadId;
+    std::mutex lock;
+    std::vector<TraceRecord> records;
+};
+
+static void writeTraceAtExit();
+
+static std::vector<std::unique_ptr<TraceBuffer>>& traceBuffers() {
+    static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    return buffers;
+}
+
+static std::mutex& traceBuffersLock() {
+    static std::mutex lock;
+    return lock;
+}
+
+static std::chrono::steady_clock::time_point traceEpoch() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return epoch;
+}
+
+static TraceBuffer& threadTraceBuffer() {
+    static thread_local TraceBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> guard(traceBuffersLock());
+        auto& buffers = traceBuffers();
+        if (buffers.empty()) {
+            // first span from anywhere: arrange for the trace to be written
+            std::atexit(writeTraceAtExit);
+        }
+        buffers.emplace_back(new TraceBuffer());
+        buffer = buffers.back().get();
+        buffer->threadId = int(buffers.size());
+    }
+    return *buffer;
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string result;
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') {
+            result += '\\';
+            result += ch;
+        } else if (static_cast<unsigned char>(ch) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            result += escaped;
+        } else {
+            result += ch;
+        }
+    }
+    return result;
+}
+
+TraceSpan::TraceSpan(const char* category, const std::string& name)
+        : m_category(category),
+          m_name(name) {
+    // fix the epoch before reading the clock, so that the first span (and any
+    // span around it) doesn't start before the epoch
+    traceEpoch();
+    m_start = std::chrono::steady_clock::now();
+}
+
+TraceSpan::~TraceSpan() {
+    auto end = std::chrono::steady_clock::now();
+    TraceBuffer& buffer = threadTraceBuffer();
+    typedef std::chrono::duration<double, std::micro> Microseconds;
+    TraceRecord record = {
+        m_category,
+        std::move(m_name),
+        std::chrono::duration_cast<Microseconds>(m_start - traceEpoch()).count(),
+        std::chrono::duration_cast<Microseconds>(end - m_start).count()
+    };
+    std::lock_guard<std::mutex> guard(buffer.lock);
+    buffer.records.push_back(std::move(record));
+}
+
+void writeTrace(std::ostream& out) {
+    std::lock_guard<std::mutex> guard(traceBuffersLock());
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (const auto& buffer : traceBuffers()) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->lock);
+        out << (first ? "" : ",") << std::endl
+            << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadId
+            << ", \"args\": {\"name\": \"" << (buffer->threadId == 1 ? "main" : "thread " + std::to_string(buffer->threadId)) << "\"}}";
+        first = false;
+        for (const TraceRecord& record : buffer->records) {
+            out << "," << std::endl
+                << "{\"name\": \"" << jsonEscape(record.name) << "\""
+                << ", \"cat\": \"" << record.category << "\""
+                << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+                << ", \"ts\": " << record.start
+                << ", \"dur\": " << record.duration << "}";
+        }
+    }
+    out << std::endl << "]}" << std::endl;
+    out.flush();
+}
+
+static void writeTraceAtExit() {
+    const char* filename = std::getenv("SPL_TRACE_FILE");
+    std::ofstream out(filename && *filename ? filename : "trace.json");
+    writeTrace(out);
+}
+
+void dump(std::ostream& out, bool json) {
+    std::lock_guard<std::mutex> guard(registryLock());
+    const double NS_PER_US = 1000.0;
+
+    std::ostringstream result;
+    result << std::fixed << std::setprecision(1);
+    if (json) {
+        result << "{\"histograms\": [";
+        bool first = true;
+        for (const auto& entry : registry()) {
+            const LatencyHistogram& h = *entry.second;
+            result << (first ? "" : ",") << std::endl
+                   << "  {\"name\": \"" << h.name() << "\""
+                   << ", \"count\": " << h.count()
+                   << ", \"mean_us\": " << h.mean() / NS_PER_US
+                   << ", \"p50_us\": " << h.percentile(50) / NS_PER_US
+                   << ", \"p90_us\": " << h.percentile(90) / NS_PER_US
+                   << ", \"p99_us\": " << h.percentile(99) / NS_PER_US
+                   << ", \"max_us\": " << h.max() / NS_PER_US << "}";
+            first = false;
+        }
+        result << std::endl << "]}" << std::endl;
+    } else {
+        result << std::left << std::setw(40) << "histogram (microseconds)" << std::right
+               << std::setw(10) << "count" << std::setw(11) << "mean"
+               << std::setw(11) << "p50" << std::setw(11) << "p90"
+               << std::setw(11) << "p99" << std::setw(11) << "max" << std::endl;
+        for (const auto& entry : registry()) {
+            const LatencyHistogram& h = *entry.second;
+            result << std::left << std::setw(40) << h.name() << std::right
+                   << std::setw(10) << h.count()
+                   << std::setw(11) << h.mean() / NS_PER_US
+                   << std::setw(11) << h.percentile(50) / NS_PER_US
+                   << std::setw(11) << h.percentile(90) / NS_PER_US
+                   << std::setw(11) << h.percentile(99) / NS_PER_US
+                   << std::setw(11) << h.max() / NS_PER_US << std::endl;
+        }
+    }
+    out << result.str();
+    out.flush();
+}
+
+void dump() {
+    const char* filename = std::getenv("SPL_INSTRUMENT_FILE");
+    if (!filename || !*filename) {
+        // use stderr directly rather than cerr because graphical console may be unreachable
+        std::ostringstream out;
+        dump(out, /* json */ false);
+        fputs(out.str().c_str(), stderr);
+        fflush(stderr);
+        return;
+    }
+
+    std::string name = filename;
+    bool json = name.length() >= 5 && name.substr(name.length() - 5) == ".json";
+    std::ofstream out(filename);
+    dump(out, json);
+}
+
+} // namespace instrument
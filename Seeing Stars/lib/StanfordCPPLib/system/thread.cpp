@@ -2,6 +2,9 @@
  * File: thread.cpp
  * ----------------
  * This file implements the platform-independent parts of the thread package.
+ *
+ * @version 2026/10/19
+ * - added ThreadPool, a work-stealing task scheduler
  */
 
 /*************************************************************************/
@@ -22,10 +25,15 @@
 /* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
 /*************************************************************************/
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include "thread.h"
+#include "error.h"
 #include "private/tplatform.h"
 
 Thread::Thread() {
@@ -85,3 +93,246 @@ static void forkWithVoid(void *arg) {
     StartWithVoid* startup = (StartWithVoid*) arg;
     startup->fn();
 }
+
+/*
+ * Implementation notes: ThreadPool
+ * --------------------------------
+ * Each worker's queue is a deque behind its own mutex.  Queue operations are
+ * short, and the owner and thieves work at opposite ends, so the locks are
+ * rarely contended; a lock-free deque would save little for the size of task
+ * this is meant for.
+ *
+ * A worker records which pool it belongs to in thread-local variables, so
+ * that submit and parallelFor can tell when they are being called from one of
+ * the pool's own tasks.
+ */
+
+namespace {
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local int currentWorker = -1;
+
+int defaultWorkerCount() {
+    const char* setting = std::getenv("SPL_THREADS");
+    if (setting) {
+        int count = std::atoi(setting);
+        if (count > 0) {
+            return count;
+        }
+    }
+    return std::max(1, (int) std::thread::hardware_concurrency());
+}
+}
+
+ThreadPool::ThreadPool() {
+    start(defaultWorkerCount());
+}
+
+ThreadPool::ThreadPool(int numWorkers) {
+    if (numWorkers < 1) {
+        error("ThreadPool::constructor: must have at least one worker");
+    }
+    start(numWorkers);
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+void ThreadPool::start(int numWorkers) {
+    m_pending = 0;
+    m_stopping = false;
+    m_nextQueue = 0;
+    m_tasksRun = 0;
+    m_steals = 0;
+    m_idleMicroseconds = 0;
+
+    /* Every queue has to exist before any worker starts looking in them. */
+    for (int i = 0; i < numWorkers; i++) {
+        m_workers.emplace_back(new Worker);
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        m_workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        if (m_stopping) {
+            return;
+        }
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+int ThreadPool::getWorkerCount() const {
+    return (int) m_workers.size();
+}
+
+ThreadPoolStats ThreadPool::getStats() const {
+    ThreadPoolStats stats;
+    stats.tasksRun = m_tasksRun;
+    stats.steals = m_steals;
+    stats.idleSeconds = m_idleMicroseconds / 1e6;
+    return stats;
+}
+
+int ThreadPool::currentWorkerIndex() const {
+    return currentPool == this ? currentWorker : -1;
+}
+
+void ThreadPool::enqueue(Task task) {
+    /* A worker keeps its own tasks; anything else is dealt out in turn. */
+    int index = currentWorkerIndex();
+    if (index < 0) {
+        index = (int) (m_nextQueue++ % m_workers.size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        /* The pool's own tasks may still add more while it drains. */
+        if (m_stopping && currentWorkerIndex() < 0) {
+            error("ThreadPool::submit: the pool has been shut down");
+        }
+        std::lock_guard<std::mutex> queueLock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+        m_pending++;
+    }
+    m_wakeup.notify_one();
+}
+
+bool ThreadPool::runOneTask(int workerIndex) {
+    Task task;
+    bool found = false;
+
+    /* Newest of our own tasks first... */
+    {
+        Worker& self = *m_workers[workerIndex];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (!self.tasks.empty()) {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    /* ... then the oldest of someone else's. */
+    for (size_t i = 1; !found && i < m_workers.size(); i++) {
+        Worker& victim = *m_workers[(workerIndex + i) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+            m_steals++;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+    m_pending--;
+    task();
+    m_tasksRun++;
+    return true;
+}
+
+void ThreadPool::workerLoop(int workerIndex) {
+    currentPool = this;
+    currentWorker = workerIndex;
+
+    while (true) {
+        if (runOneTask(workerIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        if (m_pending > 0) {
+            continue;   // something arrived since we looked
+        }
+        if (m_stopping) {
+            break;
+        }
+
+        auto sleepStart = std::chrono::steady_clock::now();
+        m_wakeup.wait(lock);
+        m_idleMicroseconds += (std::uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - sleepStart).count();
+    }
+}
+
+void ThreadPool::parallelFor(int start, int end, const std::function<void (int)>& body,
+                             int grainSize) {
+    if (start >= end) {
+        return;
+    }
+    int count = end - start;
+    if (grainSize <= 0) {
+        grainSize = std::max(1, count / (getWorkerCount() * 8));
+    }
+    int chunks = (count + grainSize - 1) / grainSize;
+
+    /* What the chunks share with each other and with this thread. */
+    struct Progress {
+        std::mutex mutex;
+        std::condition_variable finished;
+        int remaining;
+        std::exception_ptr failure;
+    };
+    std::shared_ptr<Progress> progress = std::make_shared<Progress>();
+    progress->remaining = chunks;
+
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        int from = start + chunk * grainSize;
+        int to = std::min(end, from + grainSize);
+        enqueue([progress, &body, from, to] {
+            std::exception_ptr failure;
+            try {
+                for (int i = from; i < to; i++) {
+                    body(i);
+                }
+            } catch (...) {
+                failure = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(progress->mutex);
+            if (failure && !progress->failure) {
+                progress->failure = failure;
+            }
+            if (--progress->remaining == 0) {
+                progress->finished.notify_all();
+            }
+        });
+    }
+
+    /* A worker that blocked here could leave the pool with nobody to run the
+     * chunks, so it helps with whatever tasks there are instead.
+     */
+    int self = currentWorkerIndex();
+    std::unique_lock<std::mutex> lock(progress->mutex);
+    while (progress->remaining > 0) {
+        if (self < 0) {
+            progress->finished.wait(lock);
+        } else {
+            lock.unlock();
+            if (!runOneTask(self)) {
+                std::this_thread::yield();
+            }
+            lock.lock();
+        }
+    }
+
+    if (progress->failure) {
+        std::rethrow_exception(progress->failure);
+    }
+}
+
+ThreadPool& getDefaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -4,6 +4,8 @@
  * This file exports a simple, platform-independent thread abstraction,
  * along with simple tools for concurrency control.
  *
+ * @version 2026/10/19
+ * - added ThreadPool, a work-stealing task scheduler
  * @version 2017/10/24
  * - re-inserted into library (why was it removed?)
  */
@@ -11,7 +13,18 @@
 #ifndef _thread_h
 #define _thread_h
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 /* Forward definition */
 
@@ -220,6 +233,174 @@ private:
 
 #define synchronized(lock) for (Lock_State ls(lock) ; ls.advance(); )
 
+/*
+ * Type: ThreadPoolStats
+ * ---------------------
+ * Counters describing the work a <code>ThreadPool</code> has done since it
+ * was created: how many tasks its workers have run, how many of those a
+ * worker had to steal from another worker's queue, and the total time its
+ * workers have spent asleep waiting for something to do.
+ */
+struct ThreadPoolStats {
+    std::uint64_t tasksRun;
+    std::uint64_t steals;
+    double idleSeconds;
+};
+
+/*
+ * Class: ThreadPool
+ * -----------------
+ * This class runs tasks on a fixed set of worker threads, so that a program
+ * can do work in the background or spread a computation across cores without
+ * managing threads itself:
+ *
+ *<pre>
+ *    ThreadPool pool;
+ *    std::future<int> answer = pool.submit([] { return slowComputation(); });
+ *    pool.parallelFor(0, rows, [&](int row) { ... process one row ... });
+ *    ... answer.get() ...
+ *</pre>
+ *
+ * Each worker keeps its own queue of tasks.  Tasks submitted by a worker go
+ * on that worker's queue, which it runs newest first while the data they use
+ * is likely still in its cache.  A worker with nothing left to do steals the
+ * oldest task from another worker's queue, so the load evens out without
+ * every worker contending for one shared queue.
+ */
+class ThreadPool {
+public:
+    /*
+     * Constructor: ThreadPool
+     * Usage: ThreadPool pool;
+     *        ThreadPool pool(numWorkers);
+     * -----------------------------------
+     * Creates a pool with the given number of worker threads, which must be
+     * at least one.  By default there is one worker per core.
+     */
+    ThreadPool();
+    explicit ThreadPool(int numWorkers);
+
+    /*
+     * Destructor: ~ThreadPool
+     * -----------------------
+     * Shuts the pool down; see <code>shutdown</code>.
+     */
+    ~ThreadPool();
+
+    /*
+     * Method: submit
+     * Usage: std::future<T> result = pool.submit(fn);
+     * -----------------------------------------------
+     * Queues a call to <code>fn</code>, which takes no arguments, to be run
+     * on one of the workers, and returns a future that will hold its result
+     * (or the exception it throws).  A task that waits on the future of
+     * another task can tie up a worker, so tasks that need to wait for other
+     * work should use <code>parallelFor</code> instead.
+     */
+    template <typename Function>
+    std::future<typename std::result_of<Function()>::type> submit(Function fn);
+
+    /*
+     * Method: parallelFor
+     * Usage: pool.parallelFor(start, end, body);
+     *        pool.parallelFor(start, end, body, grainSize);
+     * -----------------------------------------------------
+     * Calls <code>body(i)</code> for every <code>i</code> with
+     * <code>start &lt;= i &lt; end</code>, spread across the workers, and
+     * waits for all of the calls to finish.  The range is handed out in
+     * chunks of <code>grainSize</code> indices; by default the chunks are
+     * sized to give each worker several.  If any call throws, the first
+     * exception thrown is rethrown here once the others have finished.
+     *
+     * This may be called from inside a task on the same pool; the calling
+     * worker then runs tasks itself while it waits, rather than sitting idle.
+     */
+    void parallelFor(int start, int end, const std::function<void (int)>& body,
+                     int grainSize = 0);
+
+    /*
+     * Method: shutdown
+     * Usage: pool.shutdown();
+     * -----------------------
+     * Runs every task that has already been submitted, then stops the
+     * workers.  Submitting work after this is an error.  Calling it again
+     * does nothing.
+     */
+    void shutdown();
+
+    /*
+     * Method: getWorkerCount
+     * Usage: int count = pool.getWorkerCount();
+     * -----------------------------------------
+     * Returns the number of worker threads in the pool.
+     */
+    int getWorkerCount() const;
+
+    /*
+     * Method: getStats
+     * Usage: ThreadPoolStats stats = pool.getStats();
+     * -----------------------------------------------
+     * Returns counters describing the work the pool has done so far.
+     */
+    ThreadPoolStats getStats() const;
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in this class is logically part  */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    typedef std::function<void ()> Task;
+
+    /* A worker's queue.  Its owner works at the back; thieves take from the front. */
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    /* Workers with nothing to do sleep on m_wakeup.  m_pending counts tasks
+     * queued but not yet started; it is only incremented with m_sleepMutex
+     * held, so a worker that checks it under the same lock can't miss one.
+     */
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeup;
+    std::atomic<int> m_pending;
+    bool m_stopping;
+
+    /* Where tasks submitted from outside the pool go next. */
+    std::atomic<unsigned> m_nextQueue;
+
+    std::atomic<std::uint64_t> m_tasksRun;
+    std::atomic<std::uint64_t> m_steals;
+    std::atomic<std::uint64_t> m_idleMicroseconds;
+
+    void start(int numWorkers);
+    void enqueue(Task task);
+    bool runOneTask(int workerIndex);
+    void workerLoop(int workerIndex);
+
+    /* Which of this pool's workers the calling thread is, or -1 if none. */
+    int currentWorkerIndex() const;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator =(const ThreadPool&) = delete;
+};
+
+/*
+ * Function: getDefaultThreadPool
+ * Usage: ThreadPool& pool = getDefaultThreadPool();
+ * -------------------------------------------------
+ * Returns a pool shared by the whole program, created the first time it is
+ * asked for.  It has one worker per core, unless the SPL_THREADS environment
+ * variable says how many to use.
+ */
+ThreadPool& getDefaultThreadPool();
+
 int forkForPlatform(void (* fn)(void *), void *dp);
 
 struct StartWithVoid {
@@ -246,4 +427,16 @@ Thread forkThread(void (*fn)(ClientType& data), ClientType& data) {
     return thread;
 }
 
+template <typename Function>
+std::future<typename std::result_of<Function()>::type> ThreadPool::submit(Function fn) {
+    typedef typename std::result_of<Function()>::type Result;
+
+    /* std::function needs something copyable, which packaged_task isn't. */
+    std::shared_ptr<std::packaged_task<Result ()>> task =
+            std::make_shared<std::packaged_task<Result ()>>(fn);
+    std::future<Result> result = task->get_future();
+    enqueue([task] { (*task)(); });
+    return result;
+}
+
 #endif // _thread_h
@@ -1,6 +1,7 @@
 #include "AligningReactor.h"
 #include "FreeformEditorReactor.h"
 #include "strlib.h"
+#include "instrument.h"
 #include <cmath>
 #include <memory>
 using namespace std;
@@ -127,6 +128,7 @@ AligningReactor::~AligningReactor() {
 }
 
 void AligningReactor::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("AligningReactor::handleEvent");
     /* We shouldn't do anything if we aren't in an animation. */
     if (done()) return;
 
@@ -183,10 +185,12 @@ void AligningReactor::installHandlers(StateMachineBuilder& builder) {
     });
 
     /* Transition: Check if we're done, and, if so, go to the indicated spot. */
-    builder.addTransition("AligningReactor", "Done", [](const string& target) {
-        return [target] (shared_ptr<Reactor> reactor) {
-            auto me = static_pointer_cast<AligningReactor>(reactor);
-            return me->done()? trim(target) : "";
-        };
+    builder.addTransition("AligningReactor", "Done", [](StateMachine& machine, const string& target) {
+        Symbol destination = machine.symbols().intern(trim(target));
+
+        return Transition{ TIMER_EVENT, [destination] (Reactor& reactor) {
+            auto& me = static_cast<AligningReactor&>(reactor);
+            return me.done()? destination : kNoSymbol;
+        }};
     });
 }
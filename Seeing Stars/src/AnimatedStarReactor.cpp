@@ -1,5 +1,6 @@
 #include "AnimatedStarReactor.h"
 #include "HTMLWaiterReactor.h"
+#include "instrument.h"
 #include <cmath>
 #include <tuple>
 #include <string>
@@ -130,6 +131,7 @@ void AnimatedStarReactor::handleHyperlinkEvent(GHyperlinkEvent e) {
 }
 
 void AnimatedStarReactor::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("AnimatedStarReactor::handleEvent");
     /* Make sure this is a timer event that we're meant to receive. */
     if (e.getEventClass() == TIMER_EVENT) {
         handleTimerEvent(GTimerEvent(e));
@@ -149,10 +151,12 @@ void AnimatedStarReactor::installHandlers(StateMachineBuilder& builder) {
     });
 
     /* Transition: Check if we're done, and, if so, go to the indicated spot. */
-    builder.addTransition("AnimatedStarReactor", "Done", [](const string& target) {
-        return [target] (shared_ptr<Reactor> reactor) {
-            auto me = static_pointer_cast<HTMLWaiterReactor>(reactor);
-            return me->done()? trim(target) : "";
-        };
+    builder.addTransition("AnimatedStarReactor", "Done", [](StateMachine& machine, const string& target) {
+        Symbol destination = machine.symbols().intern(trim(target));
+
+        return Transition{ HYPERLINK_EVENT, [destination] (Reactor& reactor) {
+            auto& me = static_cast<HTMLWaiterReactor&>(reactor);
+            return me.done()? destination : kNoSymbol;
+        }};
     });
 }
@@ -0,0 +1,347 @@
+#include "EventTrace.h"
+#include "gtimer.h"
+#include "private/platform.h"
+#include "error.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <thread>
+using namespace std;
+
+namespace {
+    /* Header at the start of every trace file; the last character is the format version. */
+    const string kTraceHeader = "StarTrc1";
+
+    /* Record tags. */
+    const char kEventRecord = 'E';
+    const char kStateRecord = 'S';
+
+    /* Percentiles to report, with their column headers. */
+    const vector<pair<string, double>> kPercentiles = {
+        { "p50", 50 }, { "p90", 90 }, { "p99", 99 }, { "max", 100 }
+    };
+
+    /* Writes an unsigned integer in LEB128 format. */
+    void writeVarint(ostream& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.put(char((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.put(char(value));
+    }
+
+    /* Writes a signed integer in LEB128 format, zigzag-encoded so small negatives stay small. */
+    void writeSignedVarint(ostream& out, int64_t value) {
+        writeVarint(out, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+    }
+
+    void writeDouble(ostream& out, double value) {
+        char bytes[sizeof(double)];
+        memcpy(bytes, &value, sizeof(double));
+        out.write(bytes, sizeof(double));
+    }
+
+    void writeString(ostream& out, const string& str) {
+        writeVarint(out, str.size());
+        out.write(str.data(), str.size());
+    }
+
+    uint64_t readVarint(istream& in) {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = in.get();
+            if (byte == istream::traits_type::eof()) error("Trace ended in the middle of a record.");
+
+            result |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return result;
+        }
+        error("Malformed integer in trace.");
+        return 0;
+    }
+
+    int64_t readSignedVarint(istream& in) {
+        uint64_t value = readVarint(in);
+        return int64_t(value >> 1) ^ -int64_t(value & 1);
+    }
+
+    double readDouble(istream& in) {
+        char bytes[sizeof(double)];
+        if (!in.read(bytes, sizeof(double))) error("Trace ended in the middle of a record.");
+
+        double result;
+        memcpy(&result, bytes, sizeof(double));
+        return result;
+    }
+
+    string readString(istream& in) {
+        string result(readVarint(in), '\0');
+        if (!in.read(&result[0], result.size())) error("Trace ended in the middle of a record.");
+        return result;
+    }
+
+    /* Timer IDs have the form address_number, where the number counts up from zero as
+     * timers are created. Addresses change from run to run, but if a trace is replayed
+     * from a fresh start, the same timers get created in the same order, so we record
+     * just the number.
+     */
+    int timerNumberOf(const GTimer& timer) {
+        string id = timer.getID();
+        return stoi(id.substr(id.rfind('_') + 1));
+    }
+
+    string nameOfClass(int eventClass) {
+        switch (eventClass) {
+            case ACTION_EVENT:    return "action";
+            case KEY_EVENT:       return "key";
+            case TIMER_EVENT:     return "timer";
+            case WINDOW_EVENT:    return "window";
+            case MOUSE_EVENT:     return "mouse";
+            case HYPERLINK_EVENT: return "hyperlink";
+            default:              return "other";
+        }
+    }
+
+    /* Nearest-rank percentile of a sorted, nonempty list. */
+    double percentileOf(const vector<double>& sorted, double percentile) {
+        size_t rank = size_t(ceil(percentile / 100.0 * sorted.size()));
+        return sorted[max<size_t>(rank, 1) - 1];
+    }
+}
+
+/* * * * * TraceRecorder implementation * * * * */
+
+TraceRecorder::TraceRecorder(const string& filename) : out(filename, ios::binary) {
+    if (!out) error("Cannot open trace file " + filename);
+
+    out << kTraceHeader;
+    lastRecord = chrono::steady_clock::now();
+}
+
+void TraceRecorder::beginRecord(char tag) {
+    auto now = chrono::steady_clock::now();
+
+    out.put(tag);
+    writeVarint(out, chrono::duration_cast<chrono::microseconds>(now - lastRecord).count());
+
+    lastRecord = now;
+}
+
+void TraceRecorder::onEvent(const GEvent& e) {
+    switch (e.getEventClass()) {
+        case MOUSE_EVENT: case KEY_EVENT: case TIMER_EVENT:
+        case HYPERLINK_EVENT: case ACTION_EVENT: case WINDOW_EVENT:
+            break;
+
+        default:
+            return;
+    }
+
+    beginRecord(kEventRecord);
+    writeVarint(out, e.getEventClass());
+    writeVarint(out, e.getEventType());
+    writeVarint(out, e.getModifiers());
+
+    switch (e.getEventClass()) {
+        case MOUSE_EVENT:
+            writeDouble(out, GMouseEvent(e).getX());
+            writeDouble(out, GMouseEvent(e).getY());
+            break;
+
+        case KEY_EVENT:
+            writeSignedVarint(out, GKeyEvent(e).getKeyChar());
+            writeSignedVarint(out, GKeyEvent(e).getKeyCode());
+            break;
+
+        case TIMER_EVENT:
+            writeVarint(out, timerNumberOf(GTimerEvent(e).getGTimer()));
+            break;
+
+        case HYPERLINK_EVENT:
+            writeString(out, GHyperlinkEvent(e).getUrl());
+            break;
+
+        case ACTION_EVENT:
+            writeString(out, GActionEvent(e).getActionCommand());
+            break;
+
+        default:
+            break;
+    }
+
+    /* The program usually ends by exiting from inside the event loop, so don't hold on to
+     * anything we'd lose at that point.
+     */
+    out.flush();
+}
+
+void TraceRecorder::onStateChanged(const string& state) {
+    beginRecord(kStateRecord);
+    writeString(out, state);
+    out.flush();
+}
+
+/* * * * * TraceReplayer implementation * * * * */
+
+TraceReplayer::TraceReplayer(istream& trace) {
+    string header(kTraceHeader.size(), '\0');
+    if (!trace.read(&header[0], header.size()) || header != kTraceHeader) {
+        error("Not a trace file, or from an incompatible version.");
+    }
+
+    for (int tag; (tag = trace.get()) != istream::traits_type::eof(); ) {
+        Record record = {};
+        record.tag   = char(tag);
+        record.delay = readVarint(trace);
+
+        if (record.tag == kStateRecord) {
+            record.state = readString(trace);
+            expectedStates.push_back(record.state);
+        } else if (record.tag == kEventRecord) {
+            record.eventClass = int(readVarint(trace));
+            record.eventType  = int(readVarint(trace));
+            record.modifiers  = int(readVarint(trace));
+
+            switch (record.eventClass) {
+                case MOUSE_EVENT:
+                    record.x = readDouble(trace);
+                    record.y = readDouble(trace);
+                    break;
+
+                case KEY_EVENT:
+                    record.keyChar = int(readSignedVarint(trace));
+                    record.keyCode = int(readSignedVarint(trace));
+                    break;
+
+                case TIMER_EVENT:
+                    record.timerNumber = int(readVarint(trace));
+                    break;
+
+                case HYPERLINK_EVENT:
+                case ACTION_EVENT:
+                    record.text = readString(trace);
+                    break;
+
+                default:
+                    break;
+            }
+        } else {
+            error("Unknown record type in trace: " + string(1, record.tag));
+        }
+
+        records.push_back(record);
+    }
+}
+
+void TraceReplayer::onStateChanged(const string& state) {
+    if (diverged) return;
+
+    if (statesMatched < expectedStates.size() && expectedStates[statesMatched] == state) {
+        statesMatched++;
+    } else {
+        diverged = true;
+    }
+}
+
+GEvent TraceReplayer::eventFor(const Record& record, StateMachine& machine) const {
+    GWindow& window = machine.graphicsSystem()->window;
+    auto type = EventType(record.eventType);
+
+    GEvent result;
+    switch (record.eventClass) {
+        case MOUSE_EVENT:
+            result = GMouseEvent(type, window, record.x, record.y);
+            break;
+
+        case KEY_EVENT:
+            result = GKeyEvent(type, window, record.keyChar, record.keyCode);
+            break;
+
+        case TIMER_EVENT: {
+            GTimerData* timer = stanfordcpplib::getPlatform()->gtimer_lookup(record.timerNumber);
+            if (timer == nullptr) return GEvent();
+
+            result = GTimerEvent(type, GTimer(timer));
+            break;
+        }
+
+        case HYPERLINK_EVENT:
+            result = GHyperlinkEvent(type, nullptr, record.text);
+            break;
+
+        case ACTION_EVENT:
+            result = GActionEvent(type, nullptr, record.text);
+            break;
+
+        case WINDOW_EVENT:
+            result = GWindowEvent(type, window);
+            break;
+
+        default:
+            return GEvent();
+    }
+
+    result.setModifiers(record.modifiers);
+    return result;
+}
+
+void TraceReplayer::replay(StateMachine& machine, ReplaySpeed speed) {
+    auto due = chrono::steady_clock::now();
+
+    for (const auto& record: records) {
+        /* State records are only there so we can check we're on track. */
+        due += chrono::microseconds(record.delay);
+        if (record.tag != kEventRecord) continue;
+
+        if (speed == ReplaySpeed::RECORDED) this_thread::sleep_until(due);
+
+        /* Timer events can only be replayed if the timer they're for still exists. */
+        GEvent e = eventFor(record, machine);
+        if (!e.isValid()) {
+            eventsSkipped++;
+            continue;
+        }
+
+        auto start = chrono::steady_clock::now();
+        machine.handleEvent(e);
+        auto end = chrono::steady_clock::now();
+
+        latencies.push_back(make_pair(record.eventClass,
+                                      chrono::duration<double, micro>(end - start).count()));
+    }
+}
+
+void TraceReplayer::printReport(ostream& out) const {
+    /* Group the latencies by event class, with an extra group for everything. */
+    map<string, vector<double>> byClass;
+    for (const auto& entry: latencies) {
+        byClass[nameOfClass(entry.first)].push_back(entry.second);
+        byClass["all"].push_back(entry.second);
+    }
+
+    out << "Replayed " << latencies.size() << " events";
+    if (eventsSkipped != 0) out << " (" << eventsSkipped << " skipped)";
+    out << "; latencies in microseconds:" << endl;
+
+    out << setw(10) << "class" << setw(8) << "count";
+    for (const auto& percentile: kPercentiles) {
+        out << setw(11) << percentile.first;
+    }
+    out << endl;
+
+    for (auto& entry: byClass) {
+        sort(entry.second.begin(), entry.second.end());
+
+        out << setw(10) << entry.first << setw(8) << entry.second.size();
+        for (const auto& percentile: kPercentiles) {
+            out << setw(11) << fixed << setprecision(1) << percentileOf(entry.second, percentile.second);
+        }
+        out << endl;
+    }
+
+    if (diverged || statesMatched != expectedStates.size()) {
+        out << "Warning: replay went through different states than the recording; matched "
+            << statesMatched << " of " << expectedStates.size() << "." << endl;
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef EventTrace_Included
+#define EventTrace_Included
+
+#include "StateMachine.h"
+#include "gevents.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Event traces record a session with the StateMachine - every event it handled, when it
+ * handled it, and every state it entered - so that the session can be played back later,
+ * either to reproduce a bug or to time how long each event takes to handle.
+ *
+ * Traces are stored in a compact binary format: a short header, then one record per event or
+ * state change. Each record holds the time since the previous record in microseconds, and
+ * integers are stored as variable-length (LEB128) quantities.
+ *
+ * Only mouse, key, timer, hyperlink, action and window events are recorded. Those are the
+ * only events that the reactors in this program look at.
+ */
+
+/* Type: TraceRecorder
+ *
+ * A plugin that writes every event and state change it sees to a trace file.
+ */
+class TraceRecorder: public Plugin {
+public:
+    /* Begins recording to the given file, reporting an error if it can't be opened. */
+    explicit TraceRecorder(const std::string& filename);
+
+    void onEvent(const GEvent& e) override;
+    void onStateChanged(const std::string& state) override;
+
+private:
+    std::ofstream out;
+
+    /* When the last record was written. */
+    std::chrono::steady_clock::time_point lastRecord;
+
+    /* Writes the header common to all records. */
+    void beginRecord(char tag);
+};
+
+/* Type: ReplaySpeed
+ *
+ * How quickly to play back a trace: with the same pauses between events as when it was
+ * recorded, or with each event delivered as soon as the last one was handled.
+ */
+enum class ReplaySpeed {
+    RECORDED,
+    FAST
+};
+
+/* Type: TraceReplayer
+ *
+ * A plugin that plays a recorded trace back into a StateMachine and measures how long each
+ * event takes to handle. Install it as a plugin before building the state machine so that
+ * it can confirm the machine goes through the same states it did when the trace was made.
+ */
+class TraceReplayer: public Plugin {
+public:
+    /* Loads a trace, reporting an error if it's malformed. */
+    explicit TraceReplayer(std::istream& trace);
+
+    void onStateChanged(const std::string& state) override;
+
+    /* Feeds every recorded event to the given state machine. */
+    void replay(StateMachine& machine, ReplaySpeed speed);
+
+    /* Prints handling latency percentiles for each event class, plus a note if the states
+     * visited didn't match the ones recorded.
+     */
+    void printReport(std::ostream& out) const;
+
+private:
+    struct Record {
+        char tag;
+        std::uint64_t delay;      // Microseconds since the previous record.
+
+        /* State records. */
+        std::string state;
+
+        /* Event records. */
+        int eventClass;
+        int eventType;
+        int modifiers;
+        double x, y;
+        int keyChar, keyCode;
+        int timerNumber;
+        std::string text;         // URL or action command
+    };
+
+    std::vector<Record> records;
+
+    /* Recorded states, and how many of them we've seen again so far. */
+    std::vector<std::string> expectedStates;
+    std::size_t statesMatched = 0;
+    bool diverged = false;
+
+    /* Handling time, in microseconds, of each event replayed, along with its class. */
+    std::vector<std::pair<int, double>> latencies;
+    std::size_t eventsSkipped = 0;
+
+    /* Rebuilds a recorded event, returning an invalid event if that's not possible. */
+    GEvent eventFor(const Record& record, StateMachine& machine) const;
+};
+
+#endif
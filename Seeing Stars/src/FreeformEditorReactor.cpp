@@ -1,6 +1,7 @@
 #include "FreeformEditorReactor.h"
 #include "StarType.h"
 #include "strlib.h"
+#include "instrument.h"
 #include <algorithm>
 #include <limits>
 #include <unordered_map>
@@ -94,6 +95,7 @@ namespace {
 }
 
 void FreeformEditorReactor::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("FreeformEditorReactor::handleEvent");
     if (e.getEventClass() == MOUSE_EVENT) {
         handleMouseEvent(GMouseEvent(e));
     } else if (e.getEventClass() == HYPERLINK_EVENT) {
@@ -188,7 +190,7 @@ void FreeformEditorReactor::installHandlers(StateMachineBuilder& builder) {
     });
 
     /* Transition: Check if we're done, and, if so, go to the indicated spot. */
-    builder.addTransition("FreeformEditorReactor", "Star", [](const string& args) {
+    builder.addTransition("FreeformEditorReactor", "Star", [](StateMachine& machine, const string& args) {
         /* Extract a star type and a destination page. */
         StarType type;
         string destination;
@@ -199,9 +201,11 @@ void FreeformEditorReactor::installHandlers(StateMachineBuilder& builder) {
 
         if (!extractor) error("Could not parse star transition.");
 
-        return [type, destination] (shared_ptr<Reactor> reactor) {
-            auto me = static_pointer_cast<FreeformEditorReactor>(reactor);
-            return me->type() == type? trim(destination) : "";
-        };
+        Symbol destinationID = machine.symbols().intern(trim(destination));
+
+        return Transition{ MOUSE_EVENT | HYPERLINK_EVENT, [type, destinationID] (Reactor& reactor) {
+            auto& me = static_cast<FreeformEditorReactor&>(reactor);
+            return me.type() == type? destinationID : kNoSymbol;
+        }};
     });
 }
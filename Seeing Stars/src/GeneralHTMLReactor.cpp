@@ -1,27 +1,37 @@
 #include "GeneralHTMLReactor.h"
 #include "strlib.h"
+#include "instrument.h"
 using namespace std;
 
+GeneralHTMLReactor::GeneralHTMLReactor(const SymbolTable& symbols) : symbols(symbols) {
+    // Handled by initializer
+}
+
+/* Links that no transition mentions were never interned, so they show up as kNoSymbol and
+ * can't match anything.
+ */
 void GeneralHTMLReactor::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("GeneralHTMLReactor::handleEvent");
     if (e.getEventClass() == HYPERLINK_EVENT) {
-        lastLink = GHyperlinkEvent(e).getUrl();
+        lastLink = symbols.lookup(GHyperlinkEvent(e).getUrl());
     }
 }
 
-string GeneralHTMLReactor::lastLinkClicked() const {
+Symbol GeneralHTMLReactor::lastLinkClicked() const {
     return lastLink;
 }
 
 /* Script integration. */
 void GeneralHTMLReactor::installHandlers(StateMachineBuilder& builder) {
     /* Constructor: Decorate the previous reactor. */
-    builder.addReactor("GeneralHTMLReactor", [](StateMachine &,
+    builder.addReactor("GeneralHTMLReactor", [](StateMachine& machine,
                                                 const std::string &) {
-        return make_shared<GeneralHTMLReactor>();
+        return make_shared<GeneralHTMLReactor>(machine.symbols());
     });
 
     /* Transition: Report links clicked on the given page. */
-    builder.addTransition("GeneralHTMLReactor", "Link", [](const string& args) {
+    builder.addTransition("GeneralHTMLReactor", "Link", [](StateMachine& machine,
+                                                          const string& args) {
         /* Extract the name of the link being clicked on. */
         string link;
         string destination;
@@ -32,9 +42,12 @@ void GeneralHTMLReactor::installHandlers(StateMachineBuilder& builder) {
 
         if (!extractor) error("Could not parse star transition.");
 
-        return [link, destination] (shared_ptr<Reactor> reactor) {
-            auto me = static_pointer_cast<GeneralHTMLReactor>(reactor);
-            return me->lastLinkClicked() == link? trim(destination) : "";
-        };
+        Symbol linkID        = machine.symbols().intern(link);
+        Symbol destinationID = machine.symbols().intern(trim(destination));
+
+        return Transition{ HYPERLINK_EVENT, [linkID, destinationID] (Reactor& reactor) {
+            auto& me = static_cast<GeneralHTMLReactor&>(reactor);
+            return me.lastLinkClicked() == linkID? destinationID : kNoSymbol;
+        }};
     });
 }
@@ -13,19 +13,27 @@
  */
 class GeneralHTMLReactor: public Reactor {
 public:
+    /* Constructs a reactor that interprets links using the given symbol table. */
+    explicit GeneralHTMLReactor(const SymbolTable& symbols);
+
     void handleEvent(GEvent e) override;
 
     /* Returns whether a link has been clicked that hasn't been handled yet. */
     bool hasUnreadLink() const;
 
-    /* Returns the last link clicked, or the empty string if nothing was clicked. */
-    std::string lastLinkClicked() const;
+    /* Returns the symbol for the last link clicked, or kNoSymbol if nothing was clicked or
+     * the link clicked isn't one that any transition cares about.
+     */
+    Symbol lastLinkClicked() const;
 
     static void installHandlers(StateMachineBuilder& builder);
 
 private:
+    /* Table used to look up link names. */
+    const SymbolTable& symbols;
+
     /* The last link clicked. */
-    std::string lastLink;
+    Symbol lastLink = kNoSymbol;
 };
 
 #endif
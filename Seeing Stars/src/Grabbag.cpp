@@ -1,24 +1,31 @@
 #include "Grabbag.h"
 #include "error.h"
 #include <cstdint>
-#include <vector>
+#include <utility>
 using namespace std;
 
 namespace {
-    /* Decodes a string that's been encoded using the COBS format. */
+    /* Reads the next packet from a stream encoded in COBS format, XORing each decoded byte
+     * with rotated copies of the given key (if there is one) as it's produced. Returns
+     * whether there was a packet to read.
+     */
     const size_t kTooLong = 254;
-    string decode(const string& data) {
-      string result;
+    bool readPacket(istream& source, const string& key, string& result) {
+      result.clear();
 
-      size_t index = 0;
+      bool isFirst = true;
       uint8_t lastJump = 0;
       while (true) {
-        /* If we're at a null byte, we're done. */
-        if (data[index] == '\0') return result;
+        /* Packets end in a null byte. The very last packet in the stream might not have one,
+         * in which case hitting the end of the stream also ends the packet.
+         */
+        int code = source.get();
+        if (code == istream::traits_type::eof()) return !isFirst;
+        if (code == '\0') return true;
 
         /* Otherwise, this is the distance to the next zero byte. */
-        uint8_t distance = static_cast<uint8_t>(data[index]);
-        if (index + distance >= data.size()) error("Jump would take us out of packet?");
+        uint8_t distance = static_cast<uint8_t>(code);
+        size_t start = result.size();
 
         /* Add in this zero byte if it wasn't artificially added in. We can tell if something
          * was artificially added because either
@@ -26,63 +33,39 @@ namespace {
          *  1. It's the very first byte, which is always artificial, or
          *  2. The jump size to reach this point exceeds what can happen naturally.
          */
-        if (index != 0 && lastJump != kTooLong + 1) result += '\0';
-
-        /* Add all the characters up to the next zero byte. */
-        result += data.substr(index + 1, distance - 1);
-
-        /* Scoot forward to this zero byte. */
-        index += distance;
+        if (!isFirst && lastJump != kTooLong + 1) result += '\0';
 
+        /* Add all the characters up to the next zero byte. If we run out of characters or
+         * find a null along the way, the jump would have taken us out of the packet.
+         */
+        size_t runStart = result.size();
+        result.resize(runStart + distance - 1);
+        source.read(&result[runStart], distance - 1);
+        if (size_t(source.gcount()) != size_t(distance - 1) ||
+            result.find('\0', runStart) != string::npos) {
+          error("Jump would take us out of packet?");
+        }
+
+        /* Unscramble what we just added. */
+        if (!key.empty()) {
+          for (size_t i = start; i < result.size(); i++) {
+            result[i] = char(key[i % key.size()] ^ result[i]);
+          }
+        }
+
+        isFirst = false;
         lastJump = distance;
       }
     }
-
-    /* Given a stream encoded in COBS format, converts that stream back into a list of strings. */
-    vector<string> fromCOBS(istream& source) {
-      vector<string> result;
-
-      /* Keep pulling data, delimited by null bytes. */
-      for (string entry; getline(source, entry, '\0'); ) {
-        result.push_back(decode(entry + '\0'));
-      }
-
-      return result;
-    }
-
-    /* XORs one string with rotated copies of the given key. */
-    string xorWith(const string& key, const string& input) {
-      string result;
-
-      for (size_t i = 0; i < input.size(); i++) {
-        result += char(key[i % key.size()] ^ input[i]);
-      }
-
-      return result;
-    }
 }
 
 Grabbag::Grabbag(istream& source) {
-    /* Get a list of all the packets in the source stream. */
-    auto packets = fromCOBS(source);
-
-    /* There should be an odd number of packets here - the header contains an XOR key,
-     * and then we're looking at pairs of filename/contents pairs.
-     */
-    if (packets.size() % 2 != 1) error("Expected an odd number of packets.");
-
-    /* The first packet is the XOR key. */
-    string key = packets[0];
-    if (key.empty()) error("Empty XOR key?");
-
-    /* Proceed to decode the rest of the packets. */
-    for (size_t i = 1; i < packets.size(); i += 2) {
-        string filename = xorWith(key, packets[i]);
-        string contents = xorWith(key, packets[i + 1]);
+    GrabbagReader reader(source);
 
+    for (string filename, contents; reader.next(filename, contents); ) {
         /* Confirm that this file doesn't already exist. */
         if (files.count(filename)) error("Duplicate file: " + filename);
-        files[filename] = contents;
+        files.emplace(move(filename), move(contents));
     }
 }
 
@@ -94,3 +77,28 @@ string Grabbag::contentsOf(const string& filename) const {
     if (!fileExists(filename)) error("File does not exist: " + filename);
     return files.at(filename);
 }
+
+vector<string> Grabbag::filenames() const {
+    vector<string> result;
+    for (const auto& entry: files) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+GrabbagReader::GrabbagReader(istream& source) : source(source) {
+    /* There should be an odd number of packets here - the header contains an XOR key,
+     * and then we're looking at pairs of filename/contents pairs. The first packet is
+     * the XOR key.
+     */
+    if (!readPacket(source, "", key)) error("Expected an odd number of packets.");
+    if (key.empty()) error("Empty XOR key?");
+}
+
+bool GrabbagReader::next(string& filename, string& contents) {
+    contents.clear();
+    if (!readPacket(source, key, filename)) return false;
+
+    if (!readPacket(source, key, contents)) error("Expected an odd number of packets.");
+    return true;
+}
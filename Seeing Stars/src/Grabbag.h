@@ -3,6 +3,7 @@
 
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include <fstream>
 
 /* A type that can read grabbag files. Each grabbag file represents the contents of
@@ -21,9 +22,35 @@ public:
      */
     std::string contentsOf(const std::string& filename) const;
 
+    /* Returns the names of all the files in the grabbag, in no particular order. */
+    std::vector<std::string> filenames() const;
+
 private:
     std::unordered_map<std::string, std::string> files;
 };
 
+/* A type that reads the entries of a grabbag file one at a time. Each entry is decoded as
+ * soon as its bytes have been read from the stream, so the stream doesn't need to be
+ * seekable, only one entry is held in memory at a time, and clients that only want a few
+ * files can stop reading early.
+ */
+class GrabbagReader {
+public:
+    /* Constructs a GrabbagReader that pulls entries from the given source. The source
+     * must outlive the reader.
+     */
+    explicit GrabbagReader(std::istream& source);
+
+    /* Reads the next filename/contents pair from the grabbag. Returns whether there was
+     * such a pair; if not, the arguments are left empty.
+     */
+    bool next(std::string& filename, std::string& contents);
+
+private:
+    std::istream& source;
+
+    /* XOR key read from the header packet. */
+    std::string key;
+};
 
 #endif
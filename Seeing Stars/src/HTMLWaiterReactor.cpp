@@ -1,5 +1,6 @@
 #include "HTMLWaiterReactor.h"
 #include "strlib.h"
+#include "instrument.h"
 using namespace std;
 
 HTMLWaiterReactor::HTMLWaiterReactor(shared_ptr<Reactor> previous) : previous(previous) {
@@ -7,6 +8,7 @@ HTMLWaiterReactor::HTMLWaiterReactor(shared_ptr<Reactor> previous) : previous(pr
 }
 
 void HTMLWaiterReactor::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("HTMLWaiterReactor::handleEvent");
     if (e.getEventClass() == HYPERLINK_EVENT &&
         GHyperlinkEvent(e).getUrl() == "next") {
         isDone = true;
@@ -27,10 +29,12 @@ void HTMLWaiterReactor::installHandlers(StateMachineBuilder& builder) {
     });
 
     /* Transition: Check if we're done, and, if so, go to the indicated spot. */
-    builder.addTransition("HTMLWaiterReactor", "Done", [](const string& target) {
-        return [target] (shared_ptr<Reactor> reactor) {
-            auto me = static_pointer_cast<HTMLWaiterReactor>(reactor);
-            return me->done()? trim(target) : "";
-        };
+    builder.addTransition("HTMLWaiterReactor", "Done", [](StateMachine& machine, const string& target) {
+        Symbol destination = machine.symbols().intern(trim(target));
+
+        return Transition{ HYPERLINK_EVENT, [destination] (Reactor& reactor) {
+            auto& me = static_cast<HTMLWaiterReactor&>(reactor);
+            return me.done()? destination : kNoSymbol;
+        }};
     });
 }
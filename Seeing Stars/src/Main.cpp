@@ -7,13 +7,22 @@
 #include "StateMachine.h"
 #include "GeneralHTMLReactor.h"
 #include "SummaryReactor.h"
+#include "StarGalleryReactor.h"
 #include "Grabbag.h"
+#include "EventTrace.h"
 #include "gwindow.h"
 #include "gobjects.h"
 #include "gevents.h"
 #include "ginteractors.h"
+#include "strlib.h"
+#include "error.h"
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <future>
+#include <unordered_map>
 using namespace std;
 
 namespace {
@@ -28,6 +37,15 @@ namespace {
     const string kInjectionSite   = "<!-- Inject ";
     const string kInjectionCloser = "-->";
 
+    /* Environment variables controlling session traces. Setting kRecordVariable to a filename
+     * records this session to that file. Setting kReplayVariable to a filename instead plays
+     * that recording back, with the same timing as the original unless kReplaySpeedVariable
+     * is "fast", then reports how long each event took to handle and exits.
+     */
+    const char* const kRecordVariable      = "STARS_RECORD_TRACE";
+    const char* const kReplayVariable      = "STARS_REPLAY_TRACE";
+    const char* const kReplaySpeedVariable = "STARS_REPLAY_SPEED";
+
     /* Constructs the graphics system. */
     shared_ptr<GraphicsSystem> makeGraphics() {
         shared_ptr<GraphicsSystem> result = make_shared<GraphicsSystem>();
@@ -76,23 +94,110 @@ namespace {
         }
     }
 
-    /* Data sourcing function for a Grabbag. */
-    StateReader grabbagReader(const string& grabbagFile) {
+    /* Prefix and suffix of the names of state files within the grabbag. */
+    const string kStatePrefix = "states/";
+    const string kStateSuffix = ".state";
+
+    /* How long each step of startup took, in milliseconds. */
+    struct StartupTimes {
+        double graphics;     // Launching the back-end and making the window (main thread)
+        double decode;       // Decoding the grabbag (worker thread)
+        double expand;       // Filling in the injection sites in every state (worker thread)
+        double join;         // Time the main thread spent waiting on the worker
+        double firstState;   // Entering the first state
+        double total;
+    };
+
+    double millisecondsSince(chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    /* The text of every state, with injection sites already filled in, along with the grabbag
+     * it came from.
+     */
+    struct StateTexts {
+        Grabbag grabbag;
+        unordered_map<string, string> expanded;
+
+        explicit StateTexts(istream& source) : grabbag(source) {}
+    };
+
+    /* Decodes the grabbag and expands every state in it. This runs on a worker thread while
+     * the main thread waits for the Java back-end, so it mustn't touch the graphics system.
+     */
+    shared_ptr<const StateTexts> loadStates(const string& grabbagFile, StartupTimes& times) {
+        auto start = chrono::steady_clock::now();
+
         ifstream input(grabbagFile);
         if (!input) error("Cannot open grabbag file " + grabbagFile);
 
-        Grabbag grabbag(input);
+        auto result = make_shared<StateTexts>(input);
+        times.decode = millisecondsSince(start);
 
-        return [grabbag](const string& filename) {
-            string text = grabbag.contentsOf("states/" + filename + ".state");
+        start = chrono::steady_clock::now();
+        for (const string& filename: result->grabbag.filenames()) {
+            if (!startsWith(filename, kStatePrefix) || !endsWith(filename, kStateSuffix)) continue;
+
+            /* A state with a broken injection site might never be visited, so leave it to be
+             * expanded, and to report its error, if and when it is.
+             */
+            try {
+                result->expanded[filename] = replaceInjectionSitesIn(result->grabbag.contentsOf(filename),
+                                                                     result->grabbag);
+            } catch (const ErrorException &) {
+                // Handled when the state is read.
+            }
+        }
+        times.expand = millisecondsSince(start);
+
+        return result;
+    }
+
+    /* Data sourcing function for a set of preloaded states. */
+    StateReader stateReader(shared_ptr<const StateTexts> states) {
+        return [states](const string& name) {
+            string filename = kStatePrefix + name + kStateSuffix;
+
+            /* States that couldn't be expanded ahead of time get expanded now, which reports
+             * whatever was wrong with them.
+             */
+            auto itr = states->expanded.find(filename);
+            string text = itr != states->expanded.end()? itr->second
+                                                       : replaceInjectionSitesIn(states->grabbag.contentsOf(filename),
+                                                                                 states->grabbag);
 
             /* TODO: With C++14 support, use make_unique. */
-            return unique_ptr<istringstream>(new istringstream(replaceInjectionSitesIn(text, grabbag)));
+            return unique_ptr<istringstream>(new istringstream(text));
         };
     }
 
-    shared_ptr<StateMachine> createStateMachine() {
-        StateMachineBuilder builder(makeGraphics(), "Welcome", grabbagReader("assignment.grabbag"));
+    void printStartupTimes(const StartupTimes& times) {
+        /* Use stderr directly; cerr would open the graphical console. */
+        fprintf(stderr, "Startup (ms): back-end + window %.1f | grabbag decode %.1f, state expansion %.1f"
+                        " (overlapped) | waited on loading %.1f | first state %.1f | total %.1f\n",
+                times.graphics, times.decode, times.expand, times.join, times.firstState, times.total);
+        fflush(stderr);
+    }
+
+    /* Sets up the state machine. The Java back-end was launched when the library initialized,
+     * so while this thread waits for it to make the window, another decodes the grabbag and
+     * prepares the states. The two meet before the first state is entered.
+     */
+    shared_ptr<StateMachine> createStateMachine(shared_ptr<Plugin> tracer) {
+        auto start = chrono::steady_clock::now();
+        StartupTimes times = {};
+
+        auto states = async(launch::async, loadStates, "assignment.grabbag", ref(times));
+
+        auto phase = chrono::steady_clock::now();
+        auto graphics = makeGraphics();
+        times.graphics = millisecondsSince(phase);
+
+        phase = chrono::steady_clock::now();
+        StateMachineBuilder builder(graphics, "Welcome", stateReader(states.get()));
+        times.join = millisecondsSince(phase);
+
+        if (tracer) builder.addPlugin("Trace", tracer);
 
         AligningReactor::installHandlers(builder);
         AnimatedStarReactor::installHandlers(builder);
@@ -100,14 +205,42 @@ namespace {
         HTMLWaiterReactor::installHandlers(builder);
         GeneralHTMLReactor::installHandlers(builder);
         RadialEditorReactor::installHandlers(builder);
+        StarGalleryReactor::installHandlers(builder);
         SummaryReactor::installHandlers(builder);
 
-        return builder.build();
+        phase = chrono::steady_clock::now();
+        auto result = builder.build();
+        times.firstState = millisecondsSince(phase);
+        times.total = millisecondsSince(start);
+
+        printStartupTimes(times);
+        return result;
     }
 }
 
 int main() {
-    auto stateMachine = createStateMachine();
+    shared_ptr<Plugin> tracer;
+    shared_ptr<TraceReplayer> replayer;
+
+    if (const char* replayFile = getenv(kReplayVariable)) {
+        ifstream trace(replayFile, ios::binary);
+        if (!trace) error("Cannot open trace file " + string(replayFile));
+
+        replayer = make_shared<TraceReplayer>(trace);
+        tracer = replayer;
+    } else if (const char* recordFile = getenv(kRecordVariable)) {
+        tracer = make_shared<TraceRecorder>(recordFile);
+    }
+
+    auto stateMachine = createStateMachine(tracer);
+
+    if (replayer) {
+        const char* speed = getenv(kReplaySpeedVariable);
+        replayer->replay(*stateMachine, speed && string(speed) == "fast"? ReplaySpeed::FAST
+                                                                       : ReplaySpeed::RECORDED);
+        replayer->printReport(cout);
+        return 0;
+    }
 
     while (true) {
         stateMachine->handleEvent(waitForEvent());
@@ -1,5 +1,6 @@
 #include "RadialEditorReactor.h"
 #include "strlib.h"
+#include "instrument.h"
 #include <string>
 #include <sstream>
 using namespace std;
@@ -91,6 +92,7 @@ void RadialEditorReactor::handleHyperlinkEvent(GHyperlinkEvent e) {
 }
 
 void RadialEditorReactor::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("RadialEditorReactor::handleEvent");
     if (e.getEventClass() == MOUSE_EVENT) {
         handleMouseEvent(GMouseEvent(e));
     } else if (e.getEventClass() == HYPERLINK_EVENT) {
@@ -106,7 +108,7 @@ void RadialEditorReactor::installHandlers(StateMachineBuilder& builder) {
     });
 
     /* Transition: Check if we're done, and, if so, go to the indicated spot. */
-    builder.addTransition("RadialEditorReactor", "Star", [](const string& args) {
+    builder.addTransition("RadialEditorReactor", "Star", [](StateMachine& machine, const string& args) {
         /* Extract a star type and a destination page. */
         StarType type;
         string destination;
@@ -117,10 +119,12 @@ void RadialEditorReactor::installHandlers(StateMachineBuilder& builder) {
 
         if (!extractor) error("Could not parse star transition.");
 
-        return [type, destination] (shared_ptr<Reactor> reactor) {
-            auto me = static_pointer_cast<RadialEditorReactor>(reactor);
-            return me->type() == type? trim(destination) : "";
-        };
+        Symbol destinationID = machine.symbols().intern(trim(destination));
+
+        return Transition{ MOUSE_EVENT | HYPERLINK_EVENT, [type, destinationID] (Reactor& reactor) {
+            auto& me = static_cast<RadialEditorReactor&>(reactor);
+            return me.type() == type? destinationID : kNoSymbol;
+        }};
     });
 }
 
@@ -0,0 +1,309 @@
+#include "Raster.h"
+#include "error.h"
+#include "gmath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+const uint32_t Raster::kOpaque;
+
+namespace {
+    /* Liang-Barsky clipping: trims the segment from (x0, y0) to (x1, y1) to the box
+     * [minX, maxX] x [minY, maxY], returning whether anything is left.
+     */
+    bool clip(double& x0, double& y0, double& x1, double& y1,
+              double minX, double minY, double maxX, double maxY) {
+        double dx = x1 - x0;
+        double dy = y1 - y0;
+        double tMin = 0, tMax = 1;
+
+        /* Each boundary limits t from one side, depending on which way the line crosses it. */
+        const double p[] = { -dx, dx, -dy, dy };
+        const double q[] = { x0 - minX, maxX - x0, y0 - minY, maxY - y0 };
+        for (int i = 0; i < 4; i++) {
+            if (floatingPointEqual(p[i], 0)) {
+                if (q[i] < 0) return false;      // Parallel to this boundary and outside it
+            } else {
+                double t = q[i] / p[i];
+                if (p[i] < 0) tMin = max(tMin, t);
+                else          tMax = min(tMax, t);
+            }
+        }
+        if (tMin > tMax) return false;
+
+        x1 = x0 + tMax * dx;
+        y1 = y0 + tMax * dy;
+        x0 = x0 + tMin * dx;
+        y0 = y0 + tMin * dy;
+        return true;
+    }
+
+    /* Divides by 255, rounding to nearest, for any x up to 255 * 255 (Blinn's trick). */
+    inline uint32_t divideBy255(uint32_t x) {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    /* Color with its channels premultiplied by its alpha, as stored in the raster. */
+    uint32_t premultiply(uint32_t color) {
+        uint32_t alpha = color >> 24;
+        if (alpha == 0xFF) return color;
+
+        return (alpha << 24)
+             | (divideBy255(((color >> 16) & 0xFF) * alpha) << 16)
+             | (divideBy255(((color >>  8) & 0xFF) * alpha) <<  8)
+             |  divideBy255(( color        & 0xFF) * alpha);
+    }
+
+    /* Blends a color, at the given opacity, over one pixel. Each channel of the result,
+     * alpha included, is  source * alpha + destination * (255 - alpha), over 255.
+     */
+    inline uint32_t blend(uint32_t dst, uint32_t color, uint32_t alpha) {
+        uint32_t inverse = 255 - alpha;
+        return (divideBy255(255                    * alpha + ( dst >> 24)         * inverse) << 24)
+             | (divideBy255(((color >> 16) & 0xFF) * alpha + ((dst >> 16) & 0xFF) * inverse) << 16)
+             | (divideBy255(((color >>  8) & 0xFF) * alpha + ((dst >>  8) & 0xFF) * inverse) <<  8)
+             |  divideBy255(( color        & 0xFF) * alpha + ( dst        & 0xFF) * inverse);
+    }
+
+    /* Blends a color, at the given opacity, over a run of pixels. This is where the insides of
+     * lines and discs get drawn, so it does four pixels at a time where SSE2 is available;
+     * the arithmetic is exactly that of blend, so the results are the same either way.
+     */
+    void blendSpan(uint32_t* span, int count, uint32_t color, uint32_t alpha) {
+        if (alpha == 0) return;
+        if (alpha == 255) {
+            std::fill(span, span + count, premultiply(color | Raster::kOpaque));
+            return;
+        }
+
+        int i = 0;
+#ifdef __SSE2__
+        /* Two pixels' worth of 16-bit channels (B, G, R, A in memory order) in each half. */
+        const __m128i zero    = _mm_setzero_si128();
+        const __m128i inverse = _mm_set1_epi16(short(255 - alpha));
+        const __m128i source  = _mm_set_epi16(short(255 * alpha + 128),
+                                              short(((color >> 16) & 0xFF) * alpha + 128),
+                                              short(((color >>  8) & 0xFF) * alpha + 128),
+                                              short(( color        & 0xFF) * alpha + 128),
+                                              short(255 * alpha + 128),
+                                              short(((color >> 16) & 0xFF) * alpha + 128),
+                                              short(((color >>  8) & 0xFF) * alpha + 128),
+                                              short(( color        & 0xFF) * alpha + 128));
+        for (; i + 4 <= count; i += 4) {
+            __m128i* where = reinterpret_cast<__m128i*>(span + i);
+            __m128i dst    = _mm_loadu_si128(where);
+
+            __m128i low  = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), inverse), source);
+            __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), inverse), source);
+            low  = _mm_srli_epi16(_mm_add_epi16(low,  _mm_srli_epi16(low,  8)), 8);
+            high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+            _mm_storeu_si128(where, _mm_packus_epi16(low, high));
+        }
+#endif
+        for (; i < count; i++) {
+            span[i] = blend(span[i], color, alpha);
+        }
+    }
+
+    /* Narrows [low, high] to the values of x with minimum <= slope * x + offset <= maximum. */
+    void restrictTo(double slope, double offset, double minimum, double maximum,
+                    double& low, double& high) {
+        if (fabs(slope) < 1e-12) {
+            if (offset < minimum || offset > maximum) {
+                low  = 1;   // Nothing qualifies, so leave an empty interval
+                high = 0;
+            }
+            return;
+        }
+
+        double from = (minimum - offset) / slope;
+        double to   = (maximum - offset) / slope;
+        if (from > to) swap(from, to);
+        low  = max(low, from);
+        high = min(high, to);
+    }
+
+    /* Finds the x coordinates where the horizontal line at height y crosses the set of points
+     * within radius of the segment from (x0, y0) to (x1, y1), returning whether it does.
+     */
+    bool capsuleSpan(double x0, double y0, double x1, double y1, double radius, double y,
+                     double& low, double& high) {
+        low  =  HUGE_VAL;
+        high = -HUGE_VAL;
+
+        /* The shape is convex, so its intersection with the line is one interval, covering
+         * the intersections with each of the two end discs and the rectangle between them.
+         */
+        const double centerXs[] = { x0, x1 };
+        const double centerYs[] = { y0, y1 };
+        for (int end = 0; end < 2; end++) {
+            double dy = y - centerYs[end];
+            if (fabs(dy) <= radius) {
+                double halfWidth = sqrt(radius * radius - dy * dy);
+                low  = min(low,  centerXs[end] - halfWidth);
+                high = max(high, centerXs[end] + halfWidth);
+            }
+        }
+
+        double length = hypot(x1 - x0, y1 - y0);
+        if (length > 0) {
+            double ux = (x1 - x0) / length, uy = (y1 - y0) / length;
+            double from = -HUGE_VAL, to = HUGE_VAL;
+
+            /* Distance across the segment, and then along it, are both linear in x. */
+            restrictTo(-uy, uy * x0 + ux * (y - y0), -radius, radius, from, to);
+            restrictTo( ux, uy * (y - y0) - ux * x0,  0,      length, from, to);
+            if (from <= to) {
+                low  = min(low,  from);
+                high = max(high, to);
+            }
+        }
+        return low <= high;
+    }
+
+    /* Distance from (x, y) to the segment from (x0, y0) to (x1, y1). */
+    double distanceToSegment(double x, double y, double x0, double y0, double x1, double y1) {
+        double dx = x1 - x0, dy = y1 - y0;
+        double lengthSquared = dx * dx + dy * dy;
+        double t = lengthSquared > 0? ((x - x0) * dx + (y - y0) * dy) / lengthSquared : 0;
+        t = max(0.0, min(1.0, t));
+        return hypot(x - (x0 + t * dx), y - (y0 + t * dy));
+    }
+}
+
+Raster::Raster(int width, int height, uint32_t background)
+    : theWidth(width), theHeight(height) {
+    if (width < 0 || height < 0) error("Raster dimensions cannot be negative.");
+    pixels.assign(size_t(width) * height, premultiply(background));
+}
+
+int Raster::width() const {
+    return theWidth;
+}
+
+int Raster::height() const {
+    return theHeight;
+}
+
+void Raster::fill(uint32_t color) {
+    std::fill(pixels.begin(), pixels.end(), premultiply(color));
+}
+
+uint32_t Raster::pixelAt(int x, int y) const {
+    return pixels[size_t(y) * theWidth + x];
+}
+
+uint32_t* Raster::data() {
+    return pixels.data();
+}
+
+const uint32_t* Raster::data() const {
+    return pixels.data();
+}
+
+/* Bresenham's algorithm, after clipping so that the inner loop needn't check bounds. */
+void Raster::drawLine(double x0, double y0, double x1, double y1, uint32_t color) {
+    if (theWidth == 0 || theHeight == 0) return;
+    if (!clip(x0, y0, x1, y1, 0, 0, theWidth - 1, theHeight - 1)) return;
+
+    int x = int(lround(x0)), y = int(lround(y0));
+    int xEnd = int(lround(x1)), yEnd = int(lround(y1));
+
+    int dx =  abs(xEnd - x), stepX = x < xEnd? 1 : -1;
+    int dy = -abs(yEnd - y), stepY = y < yEnd? 1 : -1;
+    int err = dx + dy;
+    color = premultiply(color);
+
+    while (true) {
+        pixels[size_t(y) * theWidth + x] = color;
+        if (x == xEnd && y == yEnd) break;
+
+        int err2 = 2 * err;
+        if (err2 >= dy) { err += dy; x += stepX; }
+        if (err2 <= dx) { err += dx; y += stepY; }
+    }
+}
+
+void Raster::strokeLine(double x0, double y0, double x1, double y1, double thickness,
+                        uint32_t color) {
+    fillCapsule(x0, y0, x1, y1, thickness / 2.0, color, 0, 0, theWidth, theHeight);
+}
+
+void Raster::strokeLine(double x0, double y0, double x1, double y1, double thickness,
+                        uint32_t color, int clipX, int clipY, int clipWidth, int clipHeight) {
+    fillCapsule(x0, y0, x1, y1, thickness / 2.0, color, clipX, clipY, clipWidth, clipHeight);
+}
+
+void Raster::fillDisc(double centerX, double centerY, double radius, uint32_t color) {
+    fillCapsule(centerX, centerY, centerX, centerY, radius, color, 0, 0, theWidth, theHeight);
+}
+
+/* A pixel is treated as covered by however much of the unit-wide band across the shape's edge
+ * lies on the inside of its center, which is close to exact for shapes much larger than a
+ * pixel. Each row then splits into a run of fully covered pixels, which is blended as one
+ * span, and a pixel or two at either end whose coverage is worked out individually.
+ */
+void Raster::fillCapsule(double x0, double y0, double x1, double y1, double radius,
+                         uint32_t color, int clipX, int clipY, int clipWidth, int clipHeight) {
+    /* The clipping rectangle, as inclusive bounds inside the raster. */
+    int left   = max(0, clipX);
+    int top    = max(0, clipY);
+    int right  = min(theWidth,  clipX + clipWidth)  - 1;
+    int bottom = min(theHeight, clipY + clipHeight) - 1;
+    if (radius <= 0 || left > right || top > bottom) return;
+    uint32_t alpha = color >> 24;
+
+    double outer = radius + 0.5;
+    double inner = radius - 0.5;
+
+    /* Only rows near the part of the segment that's near the clipping rectangle can have
+     * anything to draw. Without this, a long diagonal line clipped to a small rectangle would
+     * have every row it spans checked, though it only crosses the rectangle in a few.
+     */
+    double nearX0 = x0, nearY0 = y0, nearX1 = x1, nearY1 = y1;
+    if (!clip(nearX0, nearY0, nearX1, nearY1, left - outer, top - outer,
+              right + 1 + outer, bottom + 1 + outer)) return;
+    int rowMin = max(top,    int(floor(min(nearY0, nearY1) - outer)));
+    int rowMax = min(bottom, int(ceil (max(nearY0, nearY1) + outer)));
+
+    for (int row = rowMin; row <= rowMax; row++) {
+        double y = row + 0.5;   // Pixel centers are at half-integer coordinates
+
+        double low, high;
+        if (!capsuleSpan(x0, y0, x1, y1, outer, y, low, high)) continue;
+        int first = max(left,  int(ceil (low  - 0.5)));
+        int last  = min(right, int(floor(high - 0.5)));
+        if (first > last) continue;
+
+        /* Fully covered run, if any; it starts past the last pixel if there isn't one. */
+        int solidFirst = last + 1, solidLast = last;
+        if (inner > 0 && capsuleSpan(x0, y0, x1, y1, inner, y, low, high)) {
+            solidFirst = max(first, int(ceil (low  - 0.5)));
+            solidLast  = min(last,  int(floor(high - 0.5)));
+            if (solidFirst > solidLast) {
+                solidFirst = last + 1;
+                solidLast  = last;
+            }
+        }
+
+        uint32_t* line = pixels.data() + size_t(row) * theWidth;
+        for (int col = first; col <= last; col++) {
+            if (col == solidFirst) {
+                blendSpan(line + solidFirst, solidLast - solidFirst + 1, color, alpha);
+                col = solidLast;
+                continue;
+            }
+
+            double coverage = outer - distanceToSegment(col + 0.5, y, x0, y0, x1, y1);
+            if (coverage <= 0) continue;
+            uint32_t edgeAlpha = uint32_t(lround(alpha * min(1.0, coverage)));
+            line[col] = blend(line[col], color, edgeAlpha);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef Raster_Included
+#define Raster_Included
+
+#include <cstdint>
+#include <vector>
+
+/* Type: Raster
+ *
+ * An image held in memory that can be drawn into without talking to the Java back-end.
+ * Drawing thousands of lines this way and then showing the result with a single
+ * GBufferedImage::setPixels call is far cheaper than making a GLine for each of them, and
+ * since nothing here depends on the back-end, the same drawing code can be run headless to
+ * produce reference images.
+ *
+ * Pixels are 0xAARRGGBB, one per uint32_t in row-major order, with the color channels
+ * premultiplied by alpha. Colors passed in are 0xAARRGGBB but not premultiplied, so
+ * Raster::kOpaque | 0xFF0000 is solid red. (setPixels ignores the alpha byte, so anything
+ * being shown should be drawn over an opaque background.)
+ */
+class Raster {
+public:
+    Raster(int width, int height, std::uint32_t background = kOpaque | 0xFFFFFF);
+
+    /* Alpha for a fully opaque color; OR it with an 0xRRGGBB color. */
+    static const std::uint32_t kOpaque = 0xFF000000;
+
+    int width() const;
+    int height() const;
+
+    /* Sets every pixel to the given color. */
+    void fill(std::uint32_t color);
+
+    /* Draws a one-pixel-wide line between the given points, without anti-aliasing, by
+     * replacing the pixels it passes through. Anything outside the raster is clipped away.
+     */
+    void drawLine(double x0, double y0, double x1, double y1, std::uint32_t color);
+
+    /* Draws an anti-aliased line of the given thickness between the given points, with
+     * round ends, blending it over what's already there.
+     */
+    void strokeLine(double x0, double y0, double x1, double y1, double thickness,
+                    std::uint32_t color);
+
+    /* As above, but only touching pixels in the given rectangle, so that several threads can
+     * draw into different parts of the same raster at once. Pixels that are drawn come out
+     * exactly as they would without the clipping.
+     */
+    void strokeLine(double x0, double y0, double x1, double y1, double thickness,
+                    std::uint32_t color, int clipX, int clipY, int clipWidth, int clipHeight);
+
+    /* Draws an anti-aliased filled circle, blending it over what's already there. */
+    void fillDisc(double centerX, double centerY, double radius, std::uint32_t color);
+
+    /* Pixel access. Coordinates must be in bounds. */
+    std::uint32_t pixelAt(int x, int y) const;
+
+    /* The pixels themselves, width() per row, for handing to GBufferedImage::setPixels. */
+    std::uint32_t* data();
+    const std::uint32_t* data() const;
+
+private:
+    int theWidth;
+    int theHeight;
+    std::vector<std::uint32_t> pixels;
+
+    /* Fills every point within radius of the segment from (x0, y0) to (x1, y1); a disc is
+     * the case where the ends coincide.
+     */
+    void fillCapsule(double x0, double y0, double x1, double y1, double radius,
+                     std::uint32_t color, int clipX, int clipY, int clipWidth, int clipHeight);
+};
+
+#endif
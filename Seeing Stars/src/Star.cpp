@@ -1,4 +1,5 @@
 #include "Star.h"
+#include "instrument.h"
 #include <string>
 #include <unordered_map>
 using namespace std;
@@ -7,20 +8,20 @@ using namespace std;
 const double StarPoint::kRadius   = 10;
 const double StarLine::kThickness = 4;
 
-namespace {
-    const string kLineColor        = "#0000FF";
+const string StarLine::kColor        = "#0000FF";
 
-    const string kPointBorderColor = "#000040";
-    const string kPointFillColor   = "#000080";
+const string StarPoint::kBorderColor = "#000040";
+const string StarPoint::kFillColor   = "#000080";
 
+namespace {
     const double kWindowPadding = 20;
 }
 
 StarPoint::StarPoint(GPoint pt) {
     graphicsPoint = new GOval(pt.getX() - kRadius, pt.getY() - kRadius, 2 * kRadius, 2 * kRadius);
     graphicsPoint->setFilled(true);
-    graphicsPoint->setColor(kPointBorderColor);
-    graphicsPoint->setFillColor(kPointFillColor);
+    graphicsPoint->setColor(kBorderColor);
+    graphicsPoint->setFillColor(kFillColor);
 }
 StarPoint::StarPoint(double x, double y) : StarPoint(GPoint(x, y)) {
     // Handled by delegation
@@ -37,7 +38,7 @@ StarLine::StarLine(StarPoint* src, StarPoint* dst) : src(src), dst(dst) {
     graphicsLine = new GLine(src->center().getX(), src->center().getY(),
                              dst->center().getX(), dst->center().getY());
     graphicsLine->setLineWidth(kThickness);
-    graphicsLine->setColor(kLineColor);
+    graphicsLine->setColor(kColor);
 }
 
 /* StarGraphics constructor holds a handle to the window. */
@@ -105,6 +106,7 @@ StarPoint* pointAt(const Star& g, const GPoint& pt) {
     return pointAt(g, pt.getX(), pt.getY());
 }
 StarPoint* pointAt(const Star& g, double x, double y) {
+    SPL_INSTRUMENT("pointAt");
     for (auto point: g.points()) {
         double dx = point->center().getX() - x;
         double dy = point->center().getY() - y;
@@ -164,6 +166,7 @@ namespace {
  * a star.
  */
 StarType starTypeOf(const Star& graphics, const vector<StarPoint *>& order) {
+    SPL_INSTRUMENT("starTypeOf");
     /* If there are no points, there isn't a star. */
     if (graphics.points().size() == 0) return kNotAStar;
 
@@ -4,6 +4,7 @@
 #include "StarType.h"
 #include "gobjects.h"
 #include "gwindow.h"
+#include <string>
 #include <unordered_set>
 #include <vector>
 #include <utility>
@@ -22,6 +23,10 @@ struct StarPoint {
 
     /* Radius of a StarPoint. */
     static const double kRadius;
+
+    /* Colors of a StarPoint's outline and interior. */
+    static const std::string kBorderColor;
+    static const std::string kFillColor;
 };
 
 /* Type: StarLine
@@ -37,6 +42,9 @@ struct StarLine {
 
     /* Thickness of a line. */
     static const double kThickness;
+
+    /* Color of a line. */
+    static const std::string kColor;
 };
 
 /* Type: Star
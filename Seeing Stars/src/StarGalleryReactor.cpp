@@ -0,0 +1,195 @@
+#include "StarGalleryReactor.h"
+#include "HTMLWaiterReactor.h"
+#include "strlib.h"
+#include "error.h"
+#include "instrument.h"
+#include <cmath>
+#include <string>
+using namespace std;
+
+namespace {
+    /* Largest star shown if the state doesn't say. */
+    const size_t kDefaultMaxPoints = 40;
+
+    /* Cells smaller than this can't show anything recognizable. */
+    const int kMinCellSize = 3;
+
+    /* Space left between a star and the edge of its cell. */
+    const double kCellPadding = 1;
+
+    /* Space reserved under the gallery for the caption, and where the caption goes in it. */
+    const double kCaptionHeight   = 24;
+    const double kCaptionBaseline = 18;
+    const double kCaptionIndent   = 8;
+
+    /* Colors: stars drawn in a single stroke in one color, compound stars (ones that fall
+     * apart into several smaller figures) in another.
+     */
+    const uint32_t kBackgroundColor = 0xFFFFFF;
+    const uint32_t kStarColor       = Raster::kOpaque | 0xFF0000;
+    const uint32_t kCompoundColor   = Raster::kOpaque | 0x808080;
+
+    size_t gcd(size_t a, size_t b) {
+        while (b != 0) {
+            size_t next = a % b;
+            a = b;
+            b = next;
+        }
+        return a;
+    }
+}
+
+GalleryLayout galleryLayoutFor(size_t maxPoints, int width, int height) {
+    GalleryLayout result;
+    for (size_t numPoints = 3; numPoints <= maxPoints; numPoints++) {
+        for (size_t stepSize = 1; 2 * stepSize < numPoints; stepSize++) {
+            result.stars.push_back({ numPoints, stepSize });
+        }
+    }
+    if (result.stars.empty()) error("The gallery needs at least one star to show.");
+    if (width < kMinCellSize || height < kMinCellSize) error("There's no room for the gallery.");
+
+    /* Start from the cell size that would use the whole area were there no rounding, and
+     * shrink until every row fits.
+     */
+    size_t count = result.stars.size();
+    int cellSize = int(sqrt(double(width) * height / count));
+    for (; cellSize >= kMinCellSize; cellSize--) {
+        int columns = width / cellSize;
+        size_t rows = (count + columns - 1) / columns;
+        if (rows * cellSize <= size_t(height)) {
+            result.cellSize = cellSize;
+            result.columns  = columns;
+            return result;
+        }
+    }
+
+    error("Too many stars (" + to_string(count) + ") to fit in the gallery.");
+    return result;
+}
+
+/* Each thumbnail matches the layout radialLayoutFor uses for a full-size star: point 0 at
+ * the bottom, the rest going clockwise.
+ */
+void renderGallery(const GalleryLayout& layout, Raster& raster) {
+    /* Stars with the same number of points share their points' directions from the center,
+     * so those are only worked out when the number of points changes.
+     */
+    vector<double> cosines, sines;
+    vector<double> xs, ys;
+    for (size_t i = 0; i < layout.stars.size(); i++) {
+        const StarType& type = layout.stars[i];
+
+        if (cosines.size() != type.numPoints) {
+            double thetaStep = -2 * M_PI / type.numPoints;
+            double thetaBase =  3 * M_PI / 2 + (type.numPoints % 2) * thetaStep / 2.0;
+
+            cosines.resize(type.numPoints);
+            sines.resize(type.numPoints);
+            for (size_t point = 0; point < type.numPoints; point++) {
+                cosines[point] = cos(thetaBase + thetaStep * point);
+                sines[point]   = sin(thetaBase + thetaStep * point);
+            }
+        }
+
+        double radius  = layout.cellSize / 2.0 - kCellPadding;
+        double centerX = (i % layout.columns) * layout.cellSize + layout.cellSize / 2.0;
+        double centerY = (i / layout.columns) * layout.cellSize + layout.cellSize / 2.0;
+
+        xs.resize(type.numPoints);
+        ys.resize(type.numPoints);
+        for (size_t point = 0; point < type.numPoints; point++) {
+            xs[point] = centerX + radius * cosines[point];
+            ys[point] = centerY - radius * sines[point]; // Y coordinate is inverted
+        }
+
+        /* Every point connects to the one stepSize further on. For a compound star that
+         * traces out several figures rather than one, but it's the same set of lines.
+         */
+        uint32_t color = gcd(type.numPoints, type.stepSize) == 1? kStarColor : kCompoundColor;
+        for (size_t src = 0; src < type.numPoints; src++) {
+            size_t dst = (src + type.stepSize) % type.numPoints;
+            raster.drawLine(xs[src], ys[src], xs[dst], ys[dst], color);
+        }
+    }
+}
+
+StarGalleryReactor::StarGalleryReactor(GWindow& window, size_t maxPoints)
+    : window(window), captioned(kNotAStar) {
+    int width  = int(window.getCanvasWidth());
+    int height = int(window.getCanvasHeight() - kCaptionHeight);
+    layout = galleryLayoutFor(maxPoints, width, height);
+
+    /* Draw everything here, then send it to the back-end in one go. */
+    Raster raster(width, height, Raster::kOpaque | kBackgroundColor);
+    renderGallery(layout, raster);
+
+    image = new GBufferedImage(0, 0, width, height, int(kBackgroundColor));
+    image->setPixels(raster.data(), width, height, raster.width());
+    window.add(image);
+
+    caption = new GLabel("", kCaptionIndent, height + kCaptionBaseline);
+    window.add(caption);
+}
+
+StarGalleryReactor::~StarGalleryReactor() {
+    window.remove(image);
+    delete image;
+
+    window.remove(caption);
+    delete caption;
+}
+
+StarType StarGalleryReactor::starAt(double x, double y) const {
+    if (x < 0 || y < 0) return kNotAStar;
+
+    int column = int(x) / layout.cellSize;
+    int row    = int(y) / layout.cellSize;
+    if (column >= layout.columns) return kNotAStar;
+
+    size_t index = size_t(row) * layout.columns + column;
+    return index < layout.stars.size()? layout.stars[index] : kNotAStar;
+}
+
+void StarGalleryReactor::handleMouseEvent(GMouseEvent e) {
+    if (e.getEventType() != MOUSE_MOVED) return;
+
+    /* Only talk to the back-end when the caption needs to change. */
+    StarType type = starAt(e.getX(), e.getY());
+    if (type != captioned) {
+        caption->setLabel(type == kNotAStar? "" : to_string(type));
+        captioned = type;
+    }
+}
+
+void StarGalleryReactor::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("StarGalleryReactor::handleEvent");
+    if (e.getEventClass() == MOUSE_EVENT) {
+        handleMouseEvent(GMouseEvent(e));
+    }
+}
+
+/* Script integration. */
+void StarGalleryReactor::installHandlers(StateMachineBuilder& builder) {
+    /* Constructor: Optionally, the largest number of points to show. As with the animated
+     * star, we're wrapped in an HTMLWaiterReactor so the page can move on.
+     */
+    builder.addReactor("StarGalleryReactor", [](StateMachine& machine,
+                                                const string& args) {
+        string limit = trim(args);
+        int maxPoints = limit.empty()? int(kDefaultMaxPoints) : stringToInteger(limit);
+        if (maxPoints < 3) error("StarGalleryReactor needs stars with at least three points.");
+
+        return make_shared<HTMLWaiterReactor>(make_shared<StarGalleryReactor>(machine.graphicsSystem()->window, maxPoints));
+    });
+
+    /* Transition: Check if we're done, and, if so, go to the indicated spot. */
+    builder.addTransition("StarGalleryReactor", "Done", [](StateMachine& machine, const string& target) {
+        Symbol destination = machine.symbols().intern(trim(target));
+
+        return Transition{ HYPERLINK_EVENT, [destination] (Reactor& reactor) {
+            auto& me = static_cast<HTMLWaiterReactor&>(reactor);
+            return me.done()? destination : kNoSymbol;
+        }};
+    });
+}
@@ -0,0 +1,68 @@
+#ifndef StarGalleryReactor_Included
+#define StarGalleryReactor_Included
+
+#include "Reactor.h"
+#include "StateMachine.h"
+#include "StarType.h"
+#include "Raster.h"
+#include "gbufferedimage.h"
+#include "gobjects.h"
+#include <cstddef>
+#include <vector>
+
+/* Type: GalleryLayout
+ *
+ * Where each star goes in the gallery: the stars are laid out in order, left to right and
+ * then top to bottom, in square cells of the given size.
+ */
+struct GalleryLayout {
+    int cellSize;
+    int columns;
+    std::vector<StarType> stars;
+};
+
+/* Lays out every star { n / k } with 3 <= n <= maxPoints and 1 <= k < n / 2 in an area of the
+ * given size, with cells as large as will fit.
+ */
+GalleryLayout galleryLayoutFor(std::size_t maxPoints, int width, int height);
+
+/* Draws every star in the layout into the raster. */
+void renderGallery(const GalleryLayout& layout, Raster& raster);
+
+/* Reactor that shows an overview of many stars at once, as thumbnails in a grid, and names
+ * whichever one the mouse is over.
+ *
+ * There can be hundreds of thousands of lines in the gallery, far too many to make a GLine
+ * for each, so the whole thing is drawn into a Raster and shown as a single image.
+ */
+class StarGalleryReactor: public Reactor {
+public:
+    StarGalleryReactor(GWindow& window, std::size_t maxPoints);
+    ~StarGalleryReactor();
+
+    void handleEvent(GEvent e) override;
+
+    static void installHandlers(StateMachineBuilder& builder);
+
+private /* helpers */:
+    void handleMouseEvent(GMouseEvent e);
+
+    /* Which star is at the given location, or kNotAStar if none is. */
+    StarType starAt(double x, double y) const;
+
+private /* state */:
+    GWindow& window;
+
+    GalleryLayout layout;
+
+    /* The rendered gallery. */
+    GBufferedImage* image;
+
+    /* Names the star under the mouse. */
+    GLabel* caption;
+
+    /* Star the caption currently names. */
+    StarType captioned;
+};
+
+#endif
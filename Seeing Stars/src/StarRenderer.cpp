@@ -0,0 +1,182 @@
+#include "StarRenderer.h"
+#include "gwindow.h"
+#include "instrument.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+using namespace std;
+
+namespace {
+    /* Same padding radialLayoutFor leaves around a star. */
+    const double kWindowPadding = 20;
+
+    /* Tiles are small enough that there are plenty to share out between threads, and large
+     * enough that few strokes need drawing in more than a handful of them.
+     */
+    const int kTileSize = 64;
+
+    uint32_t rasterColorFor(const string& color) {
+        return Raster::kOpaque | uint32_t(convertColorToRGB(color));
+    }
+
+    /* Appends the strokes for a point: a filled disc with a one-pixel border straddling its
+     * edge, as GOval draws it.
+     */
+    void addPoint(StarScene& scene, double x, double y) {
+        static const uint32_t borderColor = rasterColorFor(StarPoint::kBorderColor);
+        static const uint32_t fillColor   = rasterColorFor(StarPoint::kFillColor);
+
+        scene.push_back({ x, y, x, y, 2 * StarPoint::kRadius + 1, borderColor });
+        scene.push_back({ x, y, x, y, 2 * StarPoint::kRadius - 1, fillColor });
+    }
+
+    void addLine(StarScene& scene, double x0, double y0, double x1, double y1) {
+        static const uint32_t lineColor = rasterColorFor(StarLine::kColor);
+        scene.push_back({ x0, y0, x1, y1, StarLine::kThickness, lineColor });
+    }
+
+    /* Whether any part of the segment from (x0, y0) to (x1, y1) lies in the given box. This
+     * is Liang-Barsky clipping, as in Raster, without computing the clipped segment.
+     */
+    bool segmentMeetsBox(double x0, double y0, double x1, double y1,
+                         double left, double top, double right, double bottom) {
+        double dx = x1 - x0;
+        double dy = y1 - y0;
+        double tMin = 0, tMax = 1;
+
+        const double p[] = { -dx, dx, -dy, dy };
+        const double q[] = { x0 - left, right - x0, y0 - top, bottom - y0 };
+        for (int i = 0; i < 4; i++) {
+            if (fabs(p[i]) < 1e-12) {
+                if (q[i] < 0) return false;
+            } else {
+                double t = q[i] / p[i];
+                if (p[i] < 0) tMin = max(tMin, t);
+                else          tMax = min(tMax, t);
+            }
+        }
+        return tMin <= tMax;
+    }
+
+    /* Adds a stroke to the bin of every tile it might touch: every tile that its segment
+     * passes within reach of, counting a tile's corners as within reach of a little more
+     * than they really are.
+     */
+    void binStroke(const Stroke& stroke, uint32_t index, int columns, int rows,
+                   vector<vector<uint32_t>>& bins) {
+        double reach = stroke.thickness / 2.0 + 1;
+        int firstColumn = max(0,           int(floor((min(stroke.x0, stroke.x1) - reach) / kTileSize)));
+        int lastColumn  = min(columns - 1, int(floor((max(stroke.x0, stroke.x1) + reach) / kTileSize)));
+        int firstRow    = max(0,           int(floor((min(stroke.y0, stroke.y1) - reach) / kTileSize)));
+        int lastRow     = min(rows - 1,    int(floor((max(stroke.y0, stroke.y1) + reach) / kTileSize)));
+
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                if (segmentMeetsBox(stroke.x0, stroke.y0, stroke.x1, stroke.y1,
+                                    column * kTileSize - reach,       row * kTileSize - reach,
+                                    (column + 1) * kTileSize + reach, (row + 1) * kTileSize + reach)) {
+                    bins[size_t(row) * columns + column].push_back(index);
+                }
+            }
+        }
+    }
+}
+
+StarScene sceneFor(const Star& star) {
+    StarScene result;
+
+    vector<tuple<double, double, double, double>> lines;
+    for (auto line: star.lines()) {
+        lines.emplace_back(line->src->center().getX(), line->src->center().getY(),
+                           line->dst->center().getX(), line->dst->center().getY());
+    }
+    sort(lines.begin(), lines.end());
+    for (const auto& line: lines) {
+        addLine(result, get<0>(line), get<1>(line), get<2>(line), get<3>(line));
+    }
+
+    vector<pair<double, double>> centers;
+    for (auto point: star.points()) {
+        centers.emplace_back(point->center().getX(), point->center().getY());
+    }
+    sort(centers.begin(), centers.end());
+    for (const auto& center: centers) {
+        addPoint(result, center.first, center.second);
+    }
+
+    return result;
+}
+
+StarScene sceneFor(StarType type, double width, double height) {
+    /* Same layout as radialLayoutFor. */
+    double thetaStep = -2 * M_PI / type.numPoints;
+    double thetaBase =  3 * M_PI / 2 + (type.numPoints % 2) * thetaStep / 2.0;
+
+    double radius  = min(width, height) / 2.0 - StarPoint::kRadius - kWindowPadding;
+    double centerX = width  / 2.0;
+    double centerY = height / 2.0;
+
+    vector<double> xs, ys;
+    for (size_t i = 0; i < type.numPoints; i++) {
+        double theta = thetaBase + thetaStep * i;
+        xs.push_back(centerX + radius * cos(theta));
+        ys.push_back(centerY - radius * sin(theta)); // Y coordinate is inverted
+    }
+
+    StarScene result;
+    if (type.stepSize != 0) {
+        for (size_t src = 0; src < type.numPoints; src++) {
+            size_t dst = (src + type.stepSize) % type.numPoints;
+            addLine(result, xs[src], ys[src], xs[dst], ys[dst]);
+        }
+    }
+    for (size_t i = 0; i < type.numPoints; i++) {
+        addPoint(result, xs[i], ys[i]);
+    }
+    return result;
+}
+
+void renderScene(const StarScene& scene, Raster& raster) {
+    SPL_INSTRUMENT("renderScene");
+    for (const Stroke& stroke: scene) {
+        raster.strokeLine(stroke.x0, stroke.y0, stroke.x1, stroke.y1, stroke.thickness, stroke.color);
+    }
+}
+
+void renderSceneTiled(const StarScene& scene, Raster& raster, ThreadPool& pool) {
+    SPL_INSTRUMENT("renderSceneTiled");
+
+    int columns = (raster.width()  + kTileSize - 1) / kTileSize;
+    int rows    = (raster.height() + kTileSize - 1) / kTileSize;
+    vector<vector<uint32_t>> bins(size_t(columns) * rows);
+    for (size_t i = 0; i < scene.size(); i++) {
+        binStroke(scene[i], uint32_t(i), columns, rows, bins);
+    }
+
+    /* Draw the busiest tiles first, so that no thread is left with a big one at the end
+     * while the others sit idle. Each worker runs the tiles it's given newest first, so
+     * they're handed out quietest first.
+     */
+    vector<size_t> order;
+    for (size_t tile = 0; tile < bins.size(); tile++) {
+        if (!bins[tile].empty()) order.push_back(tile);
+    }
+    sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return bins[lhs].size() < bins[rhs].size();
+    });
+
+    pool.parallelFor(0, int(order.size()), [&](int claimed) {
+        size_t tile = order[claimed];
+        int x = int(tile % columns) * kTileSize;
+        int y = int(tile / columns) * kTileSize;
+        for (uint32_t index: bins[tile]) {
+            const Stroke& stroke = scene[index];
+            raster.strokeLine(stroke.x0, stroke.y0, stroke.x1, stroke.y1, stroke.thickness,
+                              stroke.color, x, y, kTileSize, kTileSize);
+        }
+    }, 1);
+}
+
+void renderStar(const Star& star, Raster& raster) {
+    renderScene(sceneFor(star), raster);
+}
@@ -0,0 +1,57 @@
+#ifndef StarRenderer_Included
+#define StarRenderer_Included
+
+#include "Star.h"
+#include "StarType.h"
+#include "Raster.h"
+#include "thread.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Type: Stroke
+ *
+ * One anti-aliased shape to draw into a Raster: everything within thickness / 2 of the
+ * segment from (x0, y0) to (x1, y1). A stroke whose ends coincide is a disc.
+ */
+struct Stroke {
+    double x0, y0, x1, y1;
+    double thickness;
+    std::uint32_t color;
+};
+
+/* Type: StarScene
+ *
+ * Everything needed to draw a star, as the strokes that make it up in the order they're
+ * drawn: lines underneath, then points on top.
+ */
+using StarScene = std::vector<Stroke>;
+
+/* Builds the scene for a star the way the window shows it. Lines and points are put in a
+ * fixed order, not whatever order the star's hash tables hold them in, so that the same star
+ * always comes out the same.
+ */
+StarScene sceneFor(const Star& star);
+
+/* Builds the scene for the star { p / q } laid out as radialLayoutFor would in a window of
+ * the given size, without needing a window or any StarPoints or StarLines.
+ */
+StarScene sceneFor(StarType type, double width, double height);
+
+/* Draws a scene into a raster, one stroke after another, on this thread. */
+void renderScene(const StarScene& scene, Raster& raster);
+
+/* Draws a scene into a raster using the workers of the given thread pool.
+ *
+ * The raster is split into square tiles, each stroke is binned into the tiles it touches,
+ * and the pool's workers draw the tiles, each one's strokes in scene order. Every pixel
+ * belongs to exactly one tile and sees the same strokes in the same order no matter which
+ * thread draws it, so the image is the same for any number of threads.
+ */
+void renderSceneTiled(const StarScene& scene, Raster& raster,
+                      ThreadPool& pool = getDefaultThreadPool());
+
+/* Convenience: renderScene(sceneFor(star), raster). */
+void renderStar(const Star& star, Raster& raster);
+
+#endif
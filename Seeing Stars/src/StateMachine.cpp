@@ -1,5 +1,6 @@
 #include "StateMachine.h"
 #include "strlib.h"
+#include "instrument.h"
 #include <string>
 #include <sstream>
 using namespace std;
@@ -42,14 +43,23 @@ namespace {
 /* * * * * StateMachine implementation * * * * */
 
 /* React to an event by forwarding the event down to the underlying reactor and seeing if we
- * need to change state.
+ * need to change state. Only transitions that depend on this kind of event get checked.
  */
 void StateMachine::handleEvent(GEvent e) {
+    SPL_INSTRUMENT("StateMachine::handleEvent");
+
+    for (auto& entry: plugins) {
+        entry.second->onEvent(e);
+    }
+
     reactor->handleEvent(e);
 
-    for (auto& transition: transitions) {
-        auto dest = transition(reactor);
-        if (dest != "") {
+    auto candidates = transitionsByClass.find(e.getEventClass());
+    if (candidates == transitionsByClass.end()) return;
+
+    for (size_t index: candidates->second) {
+        Symbol dest = transitions[index].test(*reactor);
+        if (dest != kNoSymbol) {
             setState(dest);
             break;
         }
@@ -67,7 +77,10 @@ void StateMachine::handleEvent(GEvent e) {
  *                             be done AFTER specifying the reactor, as transitions are reactor-
  *                             specific.
  */
-void StateMachine::setState(const string& state) {
+void StateMachine::setState(Symbol stateID) {
+    SPL_INSTRUMENT("StateMachine::setState");
+    const string& state = symbolTable.nameOf(stateID);
+
     /* Report that we've changed state. */
     for (auto& entry: plugins) {
         entry.second->onStateChanged(state);
@@ -129,6 +142,7 @@ void StateMachine::setReactor(istream& command, string& reactorName) {
 
     /* Clear out any transitions; they're now stale. */
     transitions.clear();
+    transitionsByClass.clear();
 }
 
 void StateMachine::addTransition(istream& command, const string& reactorName) {
@@ -146,7 +160,14 @@ void StateMachine::addTransition(istream& command, const string& reactorName) {
     string args;
     getline(command, args);
 
-    transitions.push_back(transitionConstructors.at(reactorName).at(transitionType)(args));
+    transitions.push_back(transitionConstructors.at(reactorName).at(transitionType)(*this, args));
+
+    /* File the transition under each event class it depends on. */
+    for (int eventClass = ACTION_EVENT; eventClass <= HYPERLINK_EVENT; eventClass <<= 1) {
+        if (transitions.back().eventClasses & eventClass) {
+            transitionsByClass[eventClass].push_back(transitions.size() - 1);
+        }
+    }
 }
 
 shared_ptr<GraphicsSystem> StateMachine::graphicsSystem() const {
@@ -162,6 +183,14 @@ shared_ptr<Plugin> StateMachine::pluginNamed(const string& name) const {
     return plugins.at(name);
 }
 
+SymbolTable& StateMachine::symbols() {
+    return symbolTable;
+}
+
+const SymbolTable& StateMachine::symbols() const {
+    return symbolTable;
+}
+
 /* * * * * StateMachineBuilder implementation * * * * */
 StateMachineBuilder::StateMachineBuilder(shared_ptr<GraphicsSystem> graphics,
                                          const string& initialState,
@@ -200,6 +229,6 @@ void StateMachineBuilder::addPlugin(const string& name, std::shared_ptr<Plugin>
 
 shared_ptr<StateMachine> StateMachineBuilder::build() const {
     auto machine = make_shared<StateMachine>(result);
-    machine->setState(initialState);
+    machine->setState(machine->symbols().intern(initialState));
     return machine;
 }
@@ -2,6 +2,7 @@
 #define StateMachine_Included
 
 #include "Reactor.h"
+#include "SymbolTable.h"
 #include "ginteractors.h"
 #include "gwindow.h"
 #include "gevents.h"
@@ -34,24 +35,38 @@ struct GraphicsSystem {
 using ReactorConstructor =
   std::function<std::shared_ptr<Reactor> (StateMachine&, const std::string& args)>;
 
-/* Type: Transition
+/* Type: TransitionTest
  *
- * Function that takes as input the current reactor, then returns the name of the next state
- * to transition to, or the empty string if no transition is requested.
+ * Function that takes as input the current reactor, then returns the symbol naming the next
+ * state to transition to, or kNoSymbol if no transition is requested.
+ */
+using TransitionTest =
+  std::function<Symbol (Reactor &)>;
+
+/* Type: Transition
  *
- * TODO: Once we get C++17 support, we should change this to use std::optional<std::string>.
+ * A transition test, along with the classes of events (a mask of EventClassType values) that
+ * can cause it to fire. After each event, the StateMachine only runs the tests whose mask
+ * includes that event's class, so, for example, a transition that waits on a hyperlink isn't
+ * evaluated on every timer tick.
  */
-using Transition =
-  std::function<std::string (std::shared_ptr<Reactor>)>;
+struct Transition {
+    int eventClasses;
+    TransitionTest test;
+};
 
 /* Type: TransitionConstructor
  *
- * Function that constructs a transition given the arguments to the transition.
- * TransitionConstructors are stored hierarchically and are associated with a specific type of
- * Reactor.
+ * Function that constructs a transition given the arguments to the transition and the current
+ * state machine. TransitionConstructors are stored hierarchically and are associated with a
+ * specific type of Reactor.
+ *
+ * Transitions are evaluated over and over as events arrive, so anything they compare against
+ * (destination states, link names, etc.) should be trimmed and interned here, once, using the
+ * machine's symbol table.
  */
 using TransitionConstructor =
-  std::function<Transition (const std::string &)>;
+  std::function<Transition (StateMachine&, const std::string &)>;
 
 /* Type: StateReader
  *
@@ -64,13 +79,16 @@ using StateReader =
 /* Type: Plugin
  *
  * A type representing something that can plug into the StateMachine. It receives updates
- * about what transitions are being followed.
+ * about what transitions are being followed and, optionally, about every event handled.
  */
 class Plugin {
 public:
     virtual ~Plugin() = default;
 
     virtual void onStateChanged(const std::string& state) = 0;
+
+    /* Called with each event before the StateMachine handles it. Does nothing by default. */
+    virtual void onEvent(const GEvent &) {}
 };
 
 /* Type: StateMachine
@@ -89,12 +107,16 @@ public:
     /* Accessors for plugins. */
     std::shared_ptr<Plugin> pluginNamed(const std::string& name) const;
 
+    /* Symbol table used to intern state names, links, and the like. */
+    SymbolTable& symbols();
+    const SymbolTable& symbols() const;
+
 private /* helpers */:
     friend class StateMachineBuilder;
     StateMachine() = default;
 
     /* Changes state. */
-    void setState(const std::string& state);
+    void setState(Symbol state);
 
     /* Parses individual lines of the config script. */
     void setHTML(std::istream& command);
@@ -105,6 +127,11 @@ private /* state */:
     std::shared_ptr<Reactor> reactor;
     std::vector<Transition>  transitions;
 
+    /* For each event class, the indices of the transitions that can fire after an event of
+     * that class, in the order the transitions were added.
+     */
+    std::unordered_map<int, std::vector<std::size_t>> transitionsByClass;
+
     std::unordered_map<std::string, ReactorConstructor> reactorConstructors;
     std::unordered_map<std::string,
       std::unordered_map<std::string, TransitionConstructor>
@@ -114,6 +141,8 @@ private /* state */:
 
     StateReader reader;
 
+    SymbolTable symbolTable;
+
     std::unordered_map<std::string, std::shared_ptr<Plugin>> plugins;
 };
 
@@ -2,6 +2,7 @@
 #include "goptionpane.h"
 #include "strlib.h"
 #include "base64.h"
+#include "instrument.h"
 #include <vector>
 #include <random>
 using namespace std;
@@ -115,6 +116,7 @@ SummaryReactor::SummaryReactor(StateMachine& machine) {
 }
 
 void SummaryReactor::handleEvent(GEvent) {
+    SPL_INSTRUMENT("SummaryReactor::handleEvent");
     // Do nothing.
 }
 
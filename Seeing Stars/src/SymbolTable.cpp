@@ -0,0 +1,26 @@
+#include "SymbolTable.h"
+#include "error.h"
+#include <limits>
+using namespace std;
+
+const Symbol kNoSymbol = numeric_limits<Symbol>::max();
+
+Symbol SymbolTable::intern(const string& name) {
+    auto itr = symbols.find(name);
+    if (itr != symbols.end()) return itr->second;
+
+    Symbol result = names.size();
+    names.push_back(name);
+    symbols[name] = result;
+    return result;
+}
+
+Symbol SymbolTable::lookup(const string& name) const {
+    auto itr = symbols.find(name);
+    return itr == symbols.end()? kNoSymbol : itr->second;
+}
+
+const string& SymbolTable::nameOf(Symbol symbol) const {
+    if (symbol >= names.size()) error("Unknown symbol.");
+    return names[symbol];
+}
@@ -0,0 +1,51 @@
+#ifndef SymbolTable_Included
+#define SymbolTable_Included
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+/* Type: Symbol
+ *
+ * A small integer standing in for an interned string. Two symbols from the same table are
+ * equal if and only if the strings they were interned from are equal, so comparing symbols
+ * is a single integer comparison.
+ */
+using Symbol = std::size_t;
+
+/* Constant: kNoSymbol
+ *
+ * A symbol that doesn't correspond to any string.
+ */
+extern const Symbol kNoSymbol;
+
+/* Type: SymbolTable
+ *
+ * A table mapping strings to the symbols that represent them and back.
+ */
+class SymbolTable {
+public:
+    /* Returns the symbol for the given string, assigning it a fresh one if this string
+     * hasn't been seen before.
+     */
+    Symbol intern(const std::string& name);
+
+    /* Returns the symbol for the given string, or kNoSymbol if that string was never
+     * interned. This never adds anything to the table.
+     */
+    Symbol lookup(const std::string& name) const;
+
+    /* Returns the string that the given symbol was interned from. */
+    const std::string& nameOf(Symbol symbol) const;
+
+private:
+    std::unordered_map<std::string, Symbol> symbols;
+
+    /* A deque, rather than a vector, so that references handed out by nameOf stay valid
+     * as more symbols are added.
+     */
+    std::deque<std::string> names;
+};
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * File: IncompleteElementTests.cpp
+ * --------------------------------
+ * Compile-time checks that the collections built on Vector can still be
+ * members of their own element type, the way a tree or a graph node often
+ * holds its children.  This file has nothing to run: if it compiles, the
+ * checks pass.  It is part of every build through the src/test/ glob in
+ * SeeingStars.pro.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#include "priorityqueue.h"
+#include "queue.h"
+#include "stack.h"
+#include "vector.h"
+#include <type_traits>
+
+namespace {
+
+struct VectorNode {
+    Vector<VectorNode> children;
+};
+
+struct StackNode {
+    Stack<StackNode> pending;
+};
+
+struct QueueNode {
+    Queue<QueueNode> waiting;
+};
+
+struct PriorityQueueNode {
+    PriorityQueue<PriorityQueueNode> frontier;
+};
+
+// moving a node moves its Vector, so Vector's move constructor can't
+// depend on whether the node moves without throwing
+static_assert(std::is_nothrow_move_constructible<VectorNode>::value,
+              "a node holding a Vector of nodes should be movable");
+
+} // namespace
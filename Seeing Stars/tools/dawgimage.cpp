@@ -0,0 +1,124 @@
+/*
+ * File: dawgimage.cpp
+ * -------------------
+ * Converts a binary lexicon file (such as English.dat) into a lexicon image
+ * (lib/StanfordCPPLib/private/dawgimage.h), which DawgLexicon maps into
+ * memory instead of reading and byte-swapping edge by edge.
+ *
+ * Build it with
+ *
+ *     g++ -std=c++11 -O2 -I lib/StanfordCPPLib -o dawgimage \
+ *         tools/dawgimage.cpp lib/StanfordCPPLib/private/dawgimage.cpp
+ *
+ * and run it with
+ *
+ *     ./dawgimage English.dat English.dawgimg
+ *
+ * then load the image wherever the lexicon file was loaded, as in
+ * DawgLexicon english("English.dawgimg").  An image only works on machines
+ * with the byte order of the one that converted it, so convert the lexicon
+ * on (or for) the machine that will use it rather than shipping one image
+ * everywhere.
+ *
+ * Running programs map their image straight from the file and never check
+ * it again, so an image must never be changed in place: truncating or
+ * rewriting it would crash them, or have them walk new edges with old
+ * indexes.  An image must only ever be replaced by writing a whole new file
+ * and renaming it over the old one, which leaves the old file (and the
+ * programs mapping it) alone until they let go of it.  That's what this
+ * tool does: it writes the image to a temporary file in the same directory
+ * and renames it into place once it's complete.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#include "private/dawgimage.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#ifndef _WIN32
+#  include <sys/stat.h>
+#  include <cstdlib>
+#  include <unistd.h>
+#endif // _WIN32
+
+namespace {
+
+// creates an empty temporary file next to the given one and returns its
+// name, or an empty string if it can't; it's readable the way a new file
+// would be, since the image will take its place
+std::string createTemporaryFile(const std::string& filename) {
+#ifdef _WIN32
+    std::string name = filename + ".tmp";
+    std::ofstream(name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    return name;
+#else // !_WIN32
+    std::string pattern = filename + ".XXXXXX";
+    int fd = mkstemp(&pattern[0]);
+    if (fd < 0) {
+        return "";
+    }
+    mode_t mask = umask(0);
+    umask(mask);
+    fchmod(fd, 0666 & ~mask);
+    close(fd);
+    return pattern;
+#endif // _WIN32
+}
+
+// moves the temporary file over the target in one step
+bool replaceFile(const std::string& temporaryName, const std::string& filename) {
+#ifdef _WIN32
+    // Windows won't rename over an existing file; images aren't mapped there
+    std::remove(filename.c_str());
+#endif // _WIN32
+    return std::rename(temporaryName.c_str(), filename.c_str()) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: dawgimage LEXICON.dat IMAGE" << std::endl;
+        return 2;
+    }
+    std::string dawgName = argv[1];
+    std::string imageName = argv[2];
+
+    std::ifstream dawg(dawgName.c_str(), std::ios::in | std::ios::binary);
+    if (dawg.fail()) {
+        std::cerr << "dawgimage: cannot open " << dawgName << std::endl;
+        return 1;
+    }
+    std::string temporaryName = createTemporaryFile(imageName);
+    std::ofstream image;
+    if (!temporaryName.empty()) {
+        image.open(temporaryName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+    if (temporaryName.empty() || image.fail()) {
+        std::cerr << "dawgimage: cannot create a temporary file next to " << imageName << std::endl;
+        return 1;
+    }
+
+    std::string errorMessage;
+    if (!stanfordcpplib::DawgImage::convert(dawg, image, errorMessage)) {
+        std::cerr << "dawgimage: " << dawgName << ": " << errorMessage << std::endl;
+        image.close();
+        std::remove(temporaryName.c_str());
+        return 1;
+    }
+    image.close();
+    if (image.fail()) {
+        std::cerr << "dawgimage: cannot write " << temporaryName << std::endl;
+        std::remove(temporaryName.c_str());
+        return 1;
+    }
+    if (!replaceFile(temporaryName, imageName)) {
+        std::cerr << "dawgimage: cannot rename " << temporaryName << " to " << imageName << std::endl;
+        std::remove(temporaryName.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,399 @@
+/*
+ * File: splbackendd.cpp
+ * ---------------------
+ * A daemon that keeps Java back-end processes started ahead of time, so that
+ * a program using the Stanford C++ library can skip JVM start-up.
+ *
+ * Normally each program forks and execs "java -jar spl.jar" when it starts
+ * and waits for the JVM to come up.  With this daemon running, and with the
+ * SPL_BACKEND_SOCKET environment variable naming its socket, the library
+ * instead asks the daemon for a back-end.  It sends the directory it is
+ * running in, the parts of its environment that a back-end depends on (see
+ * isRelayedVariable), and the exact command it would have run; if the daemon
+ * has a back-end that was started with that command in that directory and
+ * that environment, it passes the back-end's stdin and stdout over the socket
+ * and the program carries on as if it had started the back-end itself.
+ * Otherwise the program starts its own, as usual, and the daemon starts one
+ * for that request so the next run finds it waiting.
+ *
+ * The daemon is Unix-only and is not part of the project build; build it with
+ *
+ *     g++ -std=c++11 -O2 -o splbackendd tools/splbackendd.cpp
+ *
+ * and run it as
+ *
+ *     splbackendd [-n per-command-pool-size] [socket-path]
+ *
+ * The socket path defaults to $SPL_BACKEND_SOCKET.  Only processes owned by
+ * the same user may use the socket.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+// longest request a client may send (working directory, environment and
+// command line)
+const size_t MAX_REQUEST_LENGTH = 64 * 1024;
+
+// most distinct commands to keep back-ends for; the least recently requested
+// command's back-ends are shut down to make room for a new one
+const size_t MAX_COMMANDS = 8;
+
+struct BackEnd {
+    pid_t pid;
+    int toBackEnd;     // write end of the back-end's stdin
+    int fromBackEnd;   // read end of the back-end's stdout
+};
+
+// started back-ends, keyed by request (directory, environment and command line)
+std::map<std::string, std::deque<BackEnd>> pool;
+
+// requests, most recently seen first
+std::list<std::string> recentRequests;
+
+size_t poolSize = 1;
+
+void closeBackEnd(const BackEnd& backEnd) {
+    // the back-end exits when it sees end-of-file on its stdin
+    close(backEnd.toBackEnd);
+    close(backEnd.fromBackEnd);
+}
+
+bool isAlive(const BackEnd& backEnd) {
+    // SIGCHLD is ignored, so exited children are reaped immediately
+    return kill(backEnd.pid, 0) == 0;
+}
+
+// true for the environment variables that clients send with their requests
+// and that back-ends are started with; must match the library's list in
+// platform.cpp (isBackEndEnvironmentVariable)
+bool isRelayedVariable(const std::string& name) {
+    static const char* const NAMES[] = {
+        "CLASSPATH", "DISPLAY", "JAVA_HOME", "JAVA_TOOL_OPTIONS", "LANG", "LANGUAGE",
+        "PATH", "WAYLAND_DISPLAY", "XAUTHORITY", "_JAVA_OPTIONS"
+    };
+    for (const char* relayed : NAMES) {
+        if (name == relayed) {
+            return true;
+        }
+    }
+    return name.compare(0, 3, "LC_") == 0 || name.compare(0, 4, "SPL_") == 0;
+}
+
+// splits a request into its working directory, environment and argument
+// list.  a request is a list of NUL-terminated strings ended by an empty one:
+// the directory, the number of environment entries, that many NAME=value
+// entries, then the arguments.  returns false if it isn't well formed
+bool parseRequest(const std::string& request, std::string& directory,
+                  std::vector<std::string>& environment,
+                  std::vector<std::string>& command) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start < request.length()) {
+        size_t end = request.find('\0', start);
+        if (end == std::string::npos || end == start) {
+            break;
+        }
+        parts.push_back(request.substr(start, end - start));
+        start = end + 1;
+    }
+    if (parts.size() < 2) {
+        return false;
+    }
+
+    directory = parts[0];
+    char* end = nullptr;
+    errno = 0;
+    unsigned long entries = strtoul(parts[1].c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || !isdigit(static_cast<unsigned char>(parts[1][0]))
+            || entries > parts.size() - 2) {
+        return false;
+    }
+    for (size_t i = 2; i < 2 + entries; i++) {
+        size_t equals = parts[i].find('=');
+        if (equals == std::string::npos || equals == 0
+                || !isRelayedVariable(parts[i].substr(0, equals))) {
+            return false;
+        }
+        environment.push_back(parts[i]);
+    }
+    command.assign(parts.begin() + 2 + entries, parts.end());
+    return !command.empty();
+}
+
+// gives the calling process the client's values of the relayed variables in
+// place of the daemon's; called in a back-end's child process before exec
+void applyEnvironment(const std::vector<std::string>& environment) {
+    std::vector<std::string> inherited;
+    for (char** entry = environ; *entry; entry++) {
+        std::string name(*entry, strcspn(*entry, "="));
+        if (isRelayedVariable(name)) {
+            inherited.push_back(name);
+        }
+    }
+    for (const std::string& name : inherited) {
+        unsetenv(name.c_str());
+    }
+    for (const std::string& entry : environment) {
+        size_t equals = entry.find('=');
+        setenv(entry.substr(0, equals).c_str(), entry.c_str() + equals + 1, /* overwrite */ 1);
+    }
+}
+
+bool startBackEnd(const std::string& request, BackEnd& result) {
+    std::string directory;
+    std::vector<std::string> environment;
+    std::vector<std::string> command;
+    if (!parseRequest(request, directory, environment, command)) {
+        return false;
+    }
+
+    int toJBE[2], fromJBE[2];
+    if (pipe(toJBE) != 0) {
+        return false;
+    }
+    if (pipe(fromJBE) != 0) {
+        close(toJBE[0]);
+        close(toJBE[1]);
+        return false;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        // keep terminal signals aimed at the daemon away from its back-ends
+        setsid();
+        dup2(toJBE[0], 0);
+        dup2(fromJBE[1], 1);
+        close(toJBE[0]);
+        close(toJBE[1]);
+        close(fromJBE[0]);
+        close(fromJBE[1]);
+        if (chdir(directory.c_str()) != 0) {
+            _exit(1);
+        }
+        applyEnvironment(environment);
+        std::vector<char*> argv;
+        for (std::string& arg : command) {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+        execvp(argv[0], argv.data());
+        _exit(1);
+    }
+
+    close(toJBE[0]);
+    close(fromJBE[1]);
+    if (child < 0) {
+        close(toJBE[1]);
+        close(fromJBE[0]);
+        return false;
+    }
+
+    // our ends must not leak into the next back-end we start, or this one
+    // would never see end-of-file when its program exits
+    fcntl(toJBE[1], F_SETFD, FD_CLOEXEC);
+    fcntl(fromJBE[0], F_SETFD, FD_CLOEXEC);
+    result.pid = child;
+    result.toBackEnd = toJBE[1];
+    result.fromBackEnd = fromJBE[0];
+    return true;
+}
+
+// marks a request as the most recently seen, evicting the oldest if need be
+void touch(const std::string& request) {
+    recentRequests.remove(request);
+    recentRequests.push_front(request);
+    while (recentRequests.size() > MAX_COMMANDS) {
+        for (const BackEnd& backEnd : pool[recentRequests.back()]) {
+            closeBackEnd(backEnd);
+        }
+        pool.erase(recentRequests.back());
+        recentRequests.pop_back();
+    }
+}
+
+// starts back-ends for a request until it has a full pool
+void refill(const std::string& request) {
+    std::deque<BackEnd>& backEnds = pool[request];
+    while (backEnds.size() < poolSize) {
+        BackEnd backEnd;
+        if (!startBackEnd(request, backEnd)) {
+            std::cerr << "splbackendd: could not start back-end" << std::endl;
+            return;
+        }
+        backEnds.push_back(backEnd);
+    }
+}
+
+bool readRequest(int client, std::string& request) {
+    char buffer[4096];
+    while (request.length() < MAX_REQUEST_LENGTH) {
+        ssize_t count = read(client, buffer, sizeof(buffer));
+        if (count <= 0) {
+            return false;
+        }
+        request.append(buffer, count);
+        // an empty string ends the request, so it ends in two NULs
+        if (request.length() >= 2 && request[request.length() - 1] == '\0'
+                && request[request.length() - 2] == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+void sendReply(int client, const BackEnd* backEnd) {
+    char status = backEnd ? 'Y' : 'N';
+    iovec data = { &status, 1 };
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(2 * sizeof(int))];
+    } control;
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    if (backEnd) {
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(2 * sizeof(int));
+        int fds[2] = { backEnd->toBackEnd, backEnd->fromBackEnd };
+        memcpy(CMSG_DATA(header), fds, sizeof(fds));
+    }
+    sendmsg(client, &message, 0);
+}
+
+bool sameUser(int client) {
+#ifdef SO_PEERCRED
+    ucred credentials;
+    socklen_t length = sizeof(credentials);
+    return getsockopt(client, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0
+            && credentials.uid == getuid();
+#else // !SO_PEERCRED
+    uid_t uid;
+    gid_t gid;
+    return getpeereid(client, &uid, &gid) == 0 && uid == getuid();
+#endif // SO_PEERCRED
+}
+
+void serve(int client) {
+    timeval timeout = { 2, 0 };
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    std::string directory;
+    std::vector<std::string> environment;
+    std::vector<std::string> command;
+    if (!sameUser(client) || !readRequest(client, request)
+            || !parseRequest(request, directory, environment, command)) {
+        close(client);
+        return;
+    }
+    touch(request);
+
+    std::deque<BackEnd>& backEnds = pool[request];
+    while (!backEnds.empty() && !isAlive(backEnds.front())) {
+        closeBackEnd(backEnds.front());
+        backEnds.pop_front();
+    }
+    if (backEnds.empty()) {
+        sendReply(client, nullptr);
+    } else {
+        // once handed over, the back-end belongs to the client
+        BackEnd backEnd = backEnds.front();
+        backEnds.pop_front();
+        sendReply(client, &backEnd);
+        closeBackEnd(backEnd);
+    }
+    close(client);
+    refill(request);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string socketPath;
+    if (getenv("SPL_BACKEND_SOCKET")) {
+        socketPath = getenv("SPL_BACKEND_SOCKET");
+    }
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            poolSize = std::max(1, atoi(argv[++i]));
+        } else {
+            socketPath = arg;
+        }
+    }
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.length() >= sizeof(address.sun_path)) {
+        std::cerr << "usage: splbackendd [-n pool-size] [socket-path]" << std::endl
+                  << "(socket path defaults to $SPL_BACKEND_SOCKET)" << std::endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+
+    signal(SIGCHLD, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+
+    // neither the listening socket nor a client's connection may leak into a
+    // back-end, or a back-end could accept connections meant for the daemon
+    // and keep its socket alive after the daemon exits
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server >= 0) {
+        fcntl(server, F_SETFD, FD_CLOEXEC);
+    }
+    unlink(socketPath.c_str());
+    mode_t oldMask = umask(0077);
+    bool bound = server >= 0
+            && bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    umask(oldMask);
+    if (!bound || listen(server, 16) != 0) {
+        perror("splbackendd");
+        return 1;
+    }
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+        if (client < 0) {
+            if (errno != EINTR) {
+                perror("splbackendd: accept");
+            }
+            continue;
+        }
+        fcntl(client, F_SETFD, FD_CLOEXEC);
+        serve(client);
+    }
+}
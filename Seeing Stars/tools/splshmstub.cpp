@@ -0,0 +1,231 @@
+/*
+ * File: splshmstub.cpp
+ * --------------------
+ * A stand-in for the Java back-end, written in C++, for exercising the
+ * shared-memory transport (lib/StanfordCPPLib/private/shmtransport.h) on a
+ * machine without Java.
+ *
+ * It understands the commands that a program without windows sends: creating
+ * and moving GRects, getting and setting GFormattedPane text, timers and their
+ * events, console output and the start-up version handshake, and it accepts
+ * (and discards) GBufferedImage updates.  That covers the benchmarks in bench/.
+ * It warns on stderr about any other command and ignores it, so a program that
+ * waits for a reply to such a command will hang.
+ *
+ * Build it with
+ *
+ *     g++ -std=c++11 -O2 -I lib/StanfordCPPLib -o splshmstub \
+ *         tools/splshmstub.cpp lib/StanfordCPPLib/private/shmtransport.cpp
+ *
+ * (add -lrt on older Linux systems) and run a program against it with
+ *
+ *     SPL_TRANSPORT=shm SPL_SHM_SERVER=/path/to/splshmstub ./SeeingStars
+ *
+ * Given no --transport=shm:NAME argument, it talks over stdin and stdout
+ * instead, as the Java back-end normally does.
+ *
+ * @version 2026/10/19
+ * - initial version
+ */
+
+#include "private/shmtransport.h"
+#include "private/version.h"
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const std::string TRANSPORT_FLAG = "--transport=shm:";
+
+// the line-level transport, over shared memory or stdin/stdout
+std::unique_ptr<stanfordcpplib::ShmTransport> transport;
+
+bool readLine(std::string& line) {
+    if (transport) {
+        return transport->readLine(line);
+    }
+    return bool(std::getline(std::cin, line));
+}
+
+void writeLine(const std::string& line) {
+    if (transport) {
+        transport->writeLine(line);
+    } else {
+        std::cout << line << '\n' << std::flush;
+    }
+}
+
+void reply(const std::string& result) {
+    writeLine("result:" + result);
+}
+
+// pulls the quoted strings and bare numbers out of a command's arguments
+void parseArguments(const std::string& command, std::vector<std::string>& strings,
+                    std::vector<double>& numbers) {
+    size_t i = command.find('(');
+    while (i != std::string::npos && ++i < command.length()) {
+        char ch = command[i];
+        if (ch == '"') {
+            std::string value;
+            for (i++; i < command.length() && command[i] != '"'; i++) {
+                if (command[i] == '\\' && i + 1 < command.length()) {
+                    i++;
+                }
+                value += command[i];
+            }
+            strings.push_back(value);
+        } else if (isdigit(static_cast<unsigned char>(ch)) || ch == '-' || ch == '.') {
+            size_t end = command.find_first_of(",)", i);
+            numbers.push_back(atof(command.substr(i, end - i).c_str()));
+            i = end - 1;
+        }
+    }
+}
+
+struct Rect {
+    double x, y, width, height;
+};
+
+struct Timer {
+    double period;     // in milliseconds
+    bool running;
+    std::chrono::steady_clock::time_point due;
+};
+
+std::map<std::string, Rect> rects;
+std::map<std::string, std::string> paneTexts;
+std::map<std::string, Timer> timers;
+std::set<std::string> unknownCommands;
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+void sendLong(const std::string& result) {
+    const size_t CHUNK = 2000;
+    if (result.length() <= CHUNK) {
+        reply(result);
+        return;
+    }
+    writeLine("result_long:");
+    for (size_t i = 0; i < result.length(); i += CHUNK) {
+        writeLine(result.substr(i, CHUNK));
+    }
+    writeLine("result_long:end");
+}
+
+// replies to a wait for, or poll for, an event; only timers make events here
+void handleEventRequest(bool wait) {
+    auto next = timers.end();
+    for (auto itr = timers.begin(); itr != timers.end(); ++itr) {
+        if (itr->second.running && (next == timers.end() || itr->second.due < next->second.due)) {
+            next = itr;
+        }
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (next == timers.end() || (!wait && next->second.due > now)) {
+        reply("");
+        return;
+    }
+
+    std::this_thread::sleep_until(next->second.due);
+    next->second.due += std::chrono::microseconds(long(next->second.period * 1000));
+    double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::ostringstream event;
+    event << "event:timerTicked(\"" << next->first << "\", " << time << ")";
+    writeLine(event.str());
+}
+
+void handleCommand(const std::string& command) {
+    std::string opcode = command.substr(0, command.find('('));
+    std::vector<std::string> strings;
+    std::vector<double> numbers;
+    parseArguments(command, strings, numbers);
+
+    if (opcode == "StanfordCppLib.getJbeVersion") {
+        reply(STANFORD_JAVA_BACKEND_MINIMUM_VERSION);
+    } else if (opcode == "JBEConsole.getTitle") {
+        reply("Console");
+    } else if (opcode == "GTimer.pause") {
+        reply("ok");
+    } else if (opcode == "GRect.create" && numbers.size() == 2) {
+        rects[strings[0]] = { 0, 0, numbers[0], numbers[1] };
+    } else if (opcode == "GObject.setLocation" && numbers.size() == 2) {
+        rects[strings[0]].x = numbers[0];
+        rects[strings[0]].y = numbers[1];
+    } else if (opcode == "GObject.getBounds") {
+        const Rect& rect = rects[strings[0]];
+        std::ostringstream result;
+        result << "GRectangle(" << rect.x << ", " << rect.y << ", " << rect.width << ", " << rect.height << ")";
+        reply(result.str());
+    } else if (opcode == "GObject.delete") {
+        rects.erase(strings[0]);
+    } else if (opcode == "GFormattedPane.setText" && strings.size() == 2) {
+        paneTexts[strings[0]] = strings[1];
+        reply("ok");
+    } else if (opcode == "GFormattedPane.getText") {
+        sendLong(paneTexts[strings[0]]);
+    } else if (opcode == "GTimer.create" && numbers.size() == 1) {
+        timers[strings[0]] = { numbers[0], false, std::chrono::steady_clock::now() };
+    } else if (opcode == "GTimer.startTimer") {
+        Timer& timer = timers[strings[0]];
+        timer.running = true;
+        timer.due = std::chrono::steady_clock::now() + std::chrono::microseconds(long(timer.period * 1000));
+    } else if (opcode == "GTimer.stopTimer") {
+        timers[strings[0]].running = false;
+    } else if (opcode == "GTimer.deleteTimer") {
+        timers.erase(strings[0]);
+    } else if (opcode == "GEvent.waitForEvent" || opcode == "GEvent.getNextEvent") {
+        handleEventRequest(opcode == "GEvent.waitForEvent");
+    } else if (opcode == "StanfordCppLib.setCppVersion" || opcode == "GFormattedPane.create"
+               || opcode.compare(0, 11, "JBEConsole.") == 0
+               || opcode.compare(0, 15, "GBufferedImage.") == 0) {
+        // nothing to do, and no reply expected
+    } else if (unknownCommands.insert(opcode).second) {
+        std::cerr << "splshmstub: ignoring unsupported command " << opcode << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, TRANSPORT_FLAG.length(), TRANSPORT_FLAG) == 0) {
+            std::string name = arg.substr(TRANSPORT_FLAG.length());
+            transport.reset(stanfordcpplib::ShmTransport::attach(name));
+            if (!transport) {
+                std::cerr << "splshmstub: cannot attach to shared memory " << name << std::endl;
+                return 1;
+            }
+            // the program that launched us is the other side
+            pid_t parent = getppid();
+            transport->setPeerCheck([parent]() { return getppid() == parent; });
+        }
+    }
+
+    std::string line;
+    std::string longCommand;
+    bool inLongCommand = false;
+    while (readLine(line)) {
+        if (line == "LongCommand.begin()") {
+            inLongCommand = true;
+            longCommand.clear();
+        } else if (line == "LongCommand.end()") {
+            inLongCommand = false;
+            handleCommand(longCommand);
+        } else if (inLongCommand) {
+            longCommand += line;
+        } else {
+            handleCommand(line);
+        }
+    }
+    return 0;
+}